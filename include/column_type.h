@@ -5,7 +5,16 @@ typedef enum {
     DF_INT,
     DF_DOUBLE,
     DF_STRING,
-    DF_DATETIME
+    DF_DATETIME,
+    DF_CATEGORY,    // dictionary-encoded strings (see series.h)
+    DF_INT8,        // fixed-width integers: int8_t ... uint64_t
+    DF_INT16,
+    DF_INT64,
+    DF_UINT8,
+    DF_UINT16,
+    DF_UINT32,
+    DF_UINT64,
+    DF_FLOAT        // 32-bit float
 } ColumnType;
 
 
@@ -3,6 +3,7 @@
 
 #include <stddef.h>   // for size_t
 #include <stdbool.h>  // for bool
+#include <stdint.h>   // for uint64_t
 #include "dynamic_array.h"
 #include "series.h"
 #include "column_type.h"
@@ -23,6 +24,56 @@ typedef bool (*RowPredicate)(const DataFrame* df, size_t rowIndex);
 // Same for RowFunction:
 typedef void (*RowFunction)(DataFrame* outDF, const DataFrame* inDF, size_t rowIndex);
 
+/*
+ * A filter result kept as row positions into the frame it was computed on,
+ * instead of a copy of the rows. It stays valid as long as that frame is
+ * unchanged; release it with dfSelectionFree().
+ */
+typedef struct {
+    size_t* rows;   // row indices into the source frame (NULL when count == 0)
+    size_t  count;
+} DfSelection;
+
+/*
+ * One bit per row, 64 rows per word: bit (r % 64) of words[r / 64] is row r.
+ * Built by the column kernels in dfmask.h.
+ */
+typedef struct {
+    uint64_t* words;
+    size_t    length;  // rows
+} DfMask;
+
+/* Comparison used by the mask kernels, lazy queries and CSV scans. */
+typedef enum {
+    DF_CMP_EQ,
+    DF_CMP_NE,
+    DF_CMP_LT,
+    DF_CMP_LE,
+    DF_CMP_GT,
+    DF_CMP_GE
+} DfCompareOp;
+
+/*
+ * What readCsvScan keeps while reading: a row is kept only if every filter
+ * matches (a cell that is not a number or a date never matches; dates
+ * compare as epoch seconds), and only the listed columns are built.
+ * Column types are still inferred from every row of the file, so a filter
+ * never changes them; a filtered scan reads the file twice for that.
+ */
+typedef struct {
+    const char* column;
+    DfCompareOp cmp;
+    double      value;
+} DfCsvFilter;
+
+typedef struct {
+    const char* const* columns;      // NULL => every column
+    size_t             columnCount;
+    const DfCsvFilter* filters;
+    size_t             filterCount;
+    bool               headerOnly;   // columns (all DF_STRING), no rows
+} DfCsvScan;
+
 
 /* -------------------------------------------------------------------------
  * Forward declaration of DataFrame
@@ -37,17 +88,22 @@ typedef struct DataFrame DataFrame;
 typedef void   (*DataFrameInitFunc)(DataFrame* df);
 typedef void   (*DataFrameFreeFunc)(DataFrame* df);
 typedef bool   (*DataFrameAddSeriesFunc)(DataFrame* df, const Series* s);
+typedef bool   (*DataFrameAddSeriesMoveFunc)(DataFrame* df, Series* s);
 typedef size_t (*DataFrameNumColumnsFunc)(const DataFrame* df);
 typedef size_t (*DataFrameNumRowsFunc)(const DataFrame* df);
 typedef const Series* (*DataFrameGetSeriesFunc)(const DataFrame* df, size_t colIndex);
 typedef bool   (*DataFrameAddRowFunc)(DataFrame* df, const void** rowData);
+typedef bool   (*DataFrameAppendColumnsFunc)(DataFrame* df, const void* const* columnArrays, size_t n);
 typedef bool   (*DataFrameGetRowFunc)(const DataFrame* df, size_t rowIndex, void*** outRow);
+typedef size_t (*DataFrameColumnIndexFunc)(const DataFrame* df, const char* name);
+typedef DataFrame (*DataFrameMemoryUsageFunc)(const DataFrame* df, bool deep);
 
 /* Query-like methods returning DataFrame subsets or transformations */
 typedef DataFrame (*DataFrameHeadFunc)(const DataFrame* df, size_t n);
 typedef DataFrame (*DataFrameTailFunc)(const DataFrame* df, size_t n);
 typedef DataFrame (*DataFrameDescribeFunc)(const DataFrame* df);
 typedef DataFrame (*DataFrameSliceFunc)(const DataFrame* df, size_t start, size_t end);
+typedef DataFrame (*DataFrameMaterializeFunc)(const DataFrame* df);
 typedef DataFrame (*DataFrameSampleFunc)(const DataFrame* df, size_t count);
 typedef DataFrame (*DataFrameSelectColumnsFunc)(const DataFrame* df, const size_t* colIndices, size_t count);
 typedef DataFrame (*DataFrameDropColumnsFunc)(const DataFrame* df, const size_t* dropIndices, size_t dropCount);
@@ -90,6 +146,23 @@ typedef DataFrame (*DataFrameJoinFunc)(const DataFrame*, const DataFrame*, const
 */
 typedef DataFrame (*DataFrameFilterFunc)(const DataFrame* df, RowPredicate);
 
+/*
+   Selection variants: `sel` == NULL means every row of df.
+*/
+typedef DfSelection (*DataFrameFilterSelectionFunc)(const DataFrame* df, RowPredicate, const DfSelection* within);
+typedef DfSelection (*DataFrameSortSelectionFunc)(const DataFrame* df, size_t colIndex, bool ascending, const DfSelection* sel);
+typedef DfSelection (*DataFrameTopSelectionFunc)(const DataFrame* df, size_t colIndex, bool ascending, size_t k, const DfSelection* sel);
+typedef DataFrame (*DataFrameGroupBySelectionFunc)(const DataFrame* df, size_t groupColIndex, const DfSelection* sel);
+typedef double (*DataFrameSumSelectionFunc)(const DataFrame* df, size_t colIndex, const DfSelection* sel);
+typedef double (*DataFrameMeanSelectionFunc)(const DataFrame* df, size_t colIndex, const DfSelection* sel);
+typedef DataFrame (*DataFrameTakeSelectionFunc)(const DataFrame* df, const DfSelection* sel);
+
+/*
+   Mask variants: one bit per row, built by the column kernels in dfmask.h.
+*/
+typedef DataFrame (*DataFrameFilterMaskFunc)(const DataFrame* df, const DfMask* keep);
+typedef DataFrame (*DataFrameWhereMaskFunc)(const DataFrame* df, const DfMask* keep, double defaultVal);
+
 typedef DataFrame (*DataFrameDropNAFunc)(const DataFrame* df);
 typedef DataFrame (*DataFrameSortFunc)(const DataFrame* df, size_t colIndex, bool ascending);
 typedef DataFrame (*DataFrameGroupByFunc)(const DataFrame* df, size_t groupColIndex);
@@ -110,9 +183,12 @@ typedef double (*DataFrameStdFunc)(const DataFrame* df, size_t colIndex);
 typedef double (*DataFrameVarFunc)(const DataFrame* df, size_t colIndex);
 typedef double (*DataFrameRangeFunc)(const DataFrame* df, size_t colIndex);
 typedef double (*DataFrameQuantileFunc)(const DataFrame* df, size_t colIndex, double q);
+typedef bool   (*DataFrameQuantilesFunc)(const DataFrame* df, size_t colIndex, const double* qs, size_t nq, double* out);
+typedef double (*DataFrameApproxQuantileFunc)(const DataFrame* df, size_t colIndex, double q, double errorBound);
 typedef double (*DataFrameIQRFunc)(const DataFrame* df, size_t colIndex);
 typedef double (*DataFrameNullCountFunc)(const DataFrame* df, size_t colIndex);
 typedef double (*DataFrameUniqueCountFunc)(const DataFrame* df, size_t colIndex);
+typedef double (*DataFrameApproxUniqueCountFunc)(const DataFrame* df, size_t colIndex, int precision);
 typedef double (*DataFrameProductFunc)(const DataFrame* df, size_t colIndex);
 typedef double (*DataFrameNthLargestFunc)(const DataFrame* df, size_t colIndex, size_t n);
 typedef double (*DataFrameNthSmallestFunc)(const DataFrame* df, size_t colIndex, size_t n);
@@ -139,6 +215,7 @@ typedef DataFrame (*DataFrameExplodeFunc)(const DataFrame* df, size_t colIndex);
 /* IO / Plotting / Conversion */
 typedef void   (*DataFramePrintFunc)(const DataFrame* df);
 typedef bool   (*DataFrameReadCsvFunc)(DataFrame* df, const char* filename);
+typedef bool   (*DataFrameReadCsvScanFunc)(DataFrame* df, const char* filename, const DfCsvScan* scan);
 typedef void   (*DataFramePlotFunc)(const DataFrame* df,
                                     size_t xColIndex,
                                     const size_t* yColIndices,
@@ -195,37 +272,46 @@ typedef DataFrame (*DataFrameAntiJoinFunc)(const DataFrame*, const DataFrame*, c
 typedef DataFrame (*DataFrameCrossJoinFunc)(const DataFrame*, const DataFrame*);
 
 /* -------------------------------------------------------------------------
- * The DataFrame struct itself
+ * The method table
+ *
+ * Every DataFrame points at the same static, read-only table (set up by
+ * DataFrame_Create), so creating, copying or returning a frame by value
+ * only moves its data members. Call methods as df->ops->head(df, 5).
  * ------------------------------------------------------------------------- */
-struct DataFrame {
-    /* Actual data members: */
-    DynamicArray columns;  // Holds Series
-    size_t       nrows;
-
-    /* "Methods": */
+typedef struct DataFrameOps {
     /* Core */
     DataFrameInitFunc              init;
     DataFrameFreeFunc              free;
     DataFrameAddSeriesFunc         addSeries;
+    DataFrameAddSeriesMoveFunc     addSeriesMove;  // takes ownership of *s
     DataFrameNumColumnsFunc        numColumns;
     DataFrameNumRowsFunc           numRows;
     DataFrameGetSeriesFunc         getSeries;
     DataFrameAddRowFunc            addRow;
+    DataFrameAppendColumnsFunc     appendColumns;  // n rows, one array per column
     DataFrameGetRowFunc            getRow;
+    DataFrameColumnIndexFunc       columnIndex;    // (size_t)-1 if no such column
+    DataFrameMemoryUsageFunc       memoryUsage;    // bytes per column, see seriesMemoryUsage
 
     /* Query methods returning new DataFrames */
     DataFrameHeadFunc              head;
     DataFrameTailFunc              tail;
     DataFrameDescribeFunc          describe;
     DataFrameSliceFunc             slice;
+    DataFrameMaterializeFunc       materialize;  // compact copy of a row view
     DataFrameSampleFunc            sample;
     DataFrameSelectColumnsFunc     selectColumns;
     DataFrameDropColumnsFunc       dropColumns;
     DataFrameRenameColumnsFunc     renameColumns;
     DataFrameFilterFunc            filter;
+    DataFrameFilterSelectionFunc   filterSelection;   // row indices only, no copy
+    DataFrameFilterMaskFunc        filterMask;        // rows set in a DfMask
     DataFrameDropNAFunc            dropNA;
     DataFrameSortFunc              sort;
+    DataFrameSortSelectionFunc     sortSelection;     // reordered row indices
+    DataFrameTopSelectionFunc      topSelection;      // first k of sortSelection
     DataFrameGroupByFunc           groupBy;
+    DataFrameGroupBySelectionFunc  groupBySelection;
     DataFramePivotFunc             pivot;
     DataFrameMeltFunc              melt;
     DataFrameDropDuplicatesFunc    dropDuplicates;
@@ -234,6 +320,8 @@ struct DataFrame {
     /* Aggregations returning double */
     DataFrameSumFunc               sum;
     DataFrameMeanFunc              mean;
+    DataFrameSumSelectionFunc      sumSelection;
+    DataFrameMeanSelectionFunc     meanSelection;
     DataFrameMinFunc               min;
     DataFrameMaxFunc               max;
 
@@ -245,9 +333,12 @@ struct DataFrame {
     DataFrameVarFunc               var;
     DataFrameRangeFunc             range;
     DataFrameQuantileFunc          quantile;
+    DataFrameQuantilesFunc         quantiles;      // several q, one selection pass
+    DataFrameApproxQuantileFunc    approxQuantile; // t-digest sketch, no sort
     DataFrameIQRFunc               iqr;
     DataFrameNullCountFunc         nullCount;
     DataFrameUniqueCountFunc       uniqueCount;
+    DataFrameApproxUniqueCountFunc approxUniqueCount; // HyperLogLog, no value copies
     DataFrameProductFunc           product;
     DataFrameNthLargestFunc        nthLargest;
     DataFrameNthSmallestFunc       nthSmallest;
@@ -269,6 +360,7 @@ struct DataFrame {
     DataFrameIndexOfFunc           indexOf;
     DataFrameApplyFunc             apply;
     DataFrameWhereFunc             where;
+    DataFrameWhereMaskFunc         whereMask;
     DataFrameExplodeFunc           explode;
 
     /* Indexing-like methods */
@@ -287,6 +379,7 @@ struct DataFrame {
     DataFrameRenameColumnFunc      renameColumn;
     DataFrameReindexFunc           reindex;
     DataFrameTakeFunc              take;
+    DataFrameTakeSelectionFunc     takeSelection;     // materialize a selection
     DataFrameReorderColumnsFunc    reorderColumns;
 
     /* Combining */
@@ -303,6 +396,7 @@ struct DataFrame {
     /* IO / Plotting / Conversion */
     DataFramePrintFunc             print;
     DataFrameReadCsvFunc           readCsv;
+    DataFrameReadCsvScanFunc       readCsvScan;   // column subset + row filters
     DataFramePlotFunc              plot;
 
     /* Date/Time */
@@ -318,6 +412,23 @@ struct DataFrame {
     DataFrameDatetimeRebaseFunc    datetimeRebase;
     DataFrameDatetimeBetweenFunc   datetimeBetween;
     DataFrameDatetimeClampFunc     datetimeClamp;
+} DataFrameOps;
+
+/* -------------------------------------------------------------------------
+ * The DataFrame struct itself
+ * ------------------------------------------------------------------------- */
+struct DataFrame {
+    /* Actual data members: */
+    DynamicArray columns;  // Holds Series
+    size_t       nrows;
+
+    /* Column name -> index, open addressing. A slot holds index + 1
+     * (0 = empty); nameSlotCap is a power of two, 0 before the first column. */
+    size_t*      nameSlots;
+    size_t       nameSlotCap;
+
+    /* "Methods" (shared by all frames): */
+    const DataFrameOps* ops;
 };
 
 /* -------------------------------------------------------------------------
@@ -325,8 +436,8 @@ struct DataFrame {
  * ------------------------------------------------------------------------- */
 
 /**
- * @brief Create a new DataFrame object and set all its function pointers.
- *        After calling this, the DataFrame is ready to use.
+ * @brief Create a new DataFrame object and point it at the shared method
+ *        table. After calling this, the DataFrame is ready to use.
  */
 void DataFrame_Create(DataFrame* df);
 
@@ -335,4 +446,22 @@ void DataFrame_Create(DataFrame* df);
  */
 void DataFrame_Destroy(DataFrame* df);
 
+/**
+ * @brief Index of the first column named `name` at or after column `from`,
+ *        or (size_t)-1. Walks duplicate names in order:
+ *        for (c = dfColumnIndexFrom(df, n, 0); c != (size_t)-1; c = dfColumnIndexFrom(df, n, c + 1))
+ */
+size_t dfColumnIndexFrom(const DataFrame* df, const char* name, size_t from);
+
+/**
+ * @brief Rebuild the name index after renaming Series inside `df` in place.
+ *        addSeries / addSeriesMove keep it up to date on their own.
+ */
+void dfRebuildNameIndex(DataFrame* df);
+
+/**
+ * @brief Release the row indices of a selection and reset it to empty.
+ */
+void dfSelectionFree(DfSelection* sel);
+
 #endif // DATAFRAME_H
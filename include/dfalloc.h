@@ -0,0 +1,179 @@
+#ifndef DFALLOC_H
+#define DFALLOC_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/* -------------------------------------------------------------------------
+ * Pluggable allocator
+ *
+ * Series buffers (values, string arenas, validity bitmaps), their
+ * bookkeeping (sharing blocks, category dictionaries, chunk lists), masks,
+ * selections, query plans, CSV parsing buffers and arena blocks are
+ * allocated through one process-wide hook, so they can be placed on
+ * hugepages or in a custom pool. Install it before creating any Series:
+ * memory is always released through the hook that allocated it.
+ *
+ * Not routed through the hook: Series names and strings handed to the
+ * caller (seriesGetString and friends), which callers release with free(),
+ * and the short-lived malloc scratch inside the remaining operators
+ * (aggregate, combine, reshape, ...).
+ * ------------------------------------------------------------------------- */
+typedef struct {
+    /* Return `size` bytes aligned to `alignment` (a power of two), or NULL. */
+    void* (*allocate)(void* ctx, size_t size, size_t alignment);
+    /* Release a block returned by allocate(); `size` is the size asked for. */
+    void  (*release)(void* ctx, void* ptr, size_t size);
+    void* ctx;
+} DfAllocator;
+
+/**
+ * Install `allocator` (copied), or restore the default aligned_alloc/free
+ * allocator when NULL.
+ */
+void dfSetAllocator(const DfAllocator* allocator);
+
+/**
+ * The allocator currently in use.
+ */
+const DfAllocator* dfGetAllocator(void);
+
+/**
+ * Allocate / release through the current hook. dfMemFree(NULL, ...) is a no-op.
+ */
+void* dfMemAlloc(size_t size, size_t alignment);
+void  dfMemFree(void* ptr, size_t size);
+
+/**
+ * malloc / calloc / realloc / strdup / free through the current hook, for
+ * blocks whose size is not at hand when they are released (it is kept in a
+ * small header in front of the block). Blocks from these must go back
+ * through dfFree or dfRealloc, never free(). Results are aligned for any
+ * type.
+ */
+void* dfMalloc(size_t size);
+void* dfCalloc(size_t count, size_t size);
+void* dfRealloc(void* ptr, size_t size);
+char* dfStrdup(const char* str);
+void  dfFree(void* ptr);
+
+/* -------------------------------------------------------------------------
+ * Arena (region) allocator
+ *
+ * Bump allocation out of large blocks, all released in one shot. Operators
+ * use one per call for their scratch data (row index arrays, key strings,
+ * hash tables) instead of many small malloc/free pairs.
+ * ------------------------------------------------------------------------- */
+typedef struct DfArenaBlock DfArenaBlock;
+
+typedef struct {
+    DfArenaBlock* head;       // current block (newest first)
+    size_t        blockSize;  // default size of a new block
+    size_t        used;       // bytes handed out since init / reset
+} DfArena;
+
+#define DF_ARENA_DEFAULT_BLOCK (64 * 1024)
+
+/**
+ * Initialize an empty arena. blockSize == 0 => DF_ARENA_DEFAULT_BLOCK.
+ * No memory is taken until the first allocation.
+ */
+void dfArenaInit(DfArena* arena, size_t blockSize);
+
+/**
+ * `size` bytes, aligned for any type. Never freed individually.
+ * Returns NULL if the allocator fails.
+ */
+void* dfArenaAlloc(DfArena* arena, size_t size);
+
+/**
+ * Zero-filled `count * size` bytes.
+ */
+void* dfArenaCalloc(DfArena* arena, size_t count, size_t size);
+
+/**
+ * Copy of `str` in the arena.
+ */
+char* dfArenaStrdup(DfArena* arena, const char* str);
+
+/**
+ * Forget every allocation but keep the newest block for reuse.
+ */
+void dfArenaReset(DfArena* arena);
+
+/**
+ * Release all blocks.
+ */
+void dfArenaFree(DfArena* arena);
+
+/* -------------------------------------------------------------------------
+ * Allocation statistics (optional)
+ *
+ * When enabled, every allocation through the hook above is counted, both in
+ * total and against the innermost DataFrame operator (_impl function) that
+ * is running. That covers column storage and the scratch that goes through
+ * the hook: selection vectors, masks, query plans, CSV cell buffers and
+ * arenas. Plain malloc scratch in the operators listed as not routed above
+ * is not seen, so their counts are a lower bound. Off by default; when off
+ * the cost is one branch per allocation and per operator call. Not
+ * thread-safe: enable, run and read the counters from one thread.
+ * ------------------------------------------------------------------------- */
+typedef struct {
+    const char* op;         // operator function name, e.g. "dfSort_impl"
+    size_t      calls;      // times it ran
+    size_t      allocs;     // allocations made while it was the innermost operator
+    size_t      bytes;      // bytes requested by those allocations
+    size_t      peakBytes;  // largest growth of live bytes during a single call
+} DfOpStats;
+
+/**
+ * Turn statistics on or off (counters are kept; see dfStatsReset).
+ */
+void dfStatsEnable(bool enable);
+bool dfStatsEnabled(void);
+
+/**
+ * Clear all counters.
+ */
+void dfStatsReset(void);
+
+/**
+ * Per-operator counters, in the order the operators first ran.
+ */
+size_t dfStatsCount(void);
+const DfOpStats* dfStatsAt(size_t i);
+
+/**
+ * Totals since the last reset: allocation calls, bytes allocated, bytes
+ * currently live (allocated minus released) and the peak of live bytes.
+ */
+size_t dfStatsAllocs(void);
+size_t dfStatsBytes(void);
+size_t dfStatsLiveBytes(void);
+size_t dfStatsPeakBytes(void);
+
+/*
+ * Operator scope: DF_OP_SCOPE() as the first statement of an _impl function
+ * attributes the allocations made until it returns to that function. The
+ * scope ends automatically (GCC/Clang cleanup attribute); other compilers
+ * only count calls.
+ */
+typedef struct {
+    DfOpStats* stats;      // NULL when statistics are off
+    DfOpStats* outer;      // enclosing operator
+    size_t     liveAtEntry;
+    size_t     outerPeak;  // enclosing scope's live-bytes high-water mark
+} DfOpScope;
+
+DfOpScope dfOpEnter(const char* op);
+void      dfOpLeave(DfOpScope* scope);
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DF_OP_SCOPE() \
+    DfOpScope dfOpScope_ __attribute__((cleanup(dfOpLeave))) = dfOpEnter(__func__)
+#else
+#define DF_OP_SCOPE() \
+    do { DfOpScope dfOpScope_ = dfOpEnter(__func__); dfOpLeave(&dfOpScope_); } while (0)
+#endif
+
+#endif // DFALLOC_H
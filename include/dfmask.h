@@ -0,0 +1,82 @@
+#ifndef DFMASK_H
+#define DFMASK_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "dataframe.h"
+
+/* -------------------------------------------------------------------------
+ * Column-at-a-time predicates
+ *
+ * Instead of calling a RowPredicate once per row, a kernel scans one typed
+ * column buffer and sets bit r of a DfMask for each matching row, 64 rows
+ * per output word. Masks combine with And / Or / Not and feed filterMask,
+ * whereMask or dfMaskToSelection.
+ *
+ * Null rows never match a comparison. Kernels initialize `out` themselves
+ * (it must not hold a mask yet); release it with dfMaskFree().
+ * ------------------------------------------------------------------------- */
+
+/**
+ * A cleared mask of `length` rows. Returns false if out of memory.
+ */
+bool dfMaskInit(DfMask* m, size_t length);
+void dfMaskFree(DfMask* m);
+
+bool   dfMaskGet(const DfMask* m, size_t row);
+void   dfMaskSet(DfMask* m, size_t row, bool on);
+size_t dfMaskCount(const DfMask* m);
+
+/**
+ * dst = dst AND src / dst OR src. False (dst unchanged) if the lengths differ.
+ */
+bool dfMaskAnd(DfMask* dst, const DfMask* src);
+bool dfMaskOr(DfMask* dst, const DfMask* src);
+
+/**
+ * Flip every row, null rows included: AND with dfMaskValid() to keep
+ * SQL-style "NOT (x < 5)" from selecting nulls.
+ */
+void dfMaskNot(DfMask* m);
+
+/**
+ * Row indices of the set bits, ascending (see DfSelection).
+ */
+DfSelection dfMaskToSelection(const DfMask* m);
+
+/**
+ * Non-null rows of `s`.
+ */
+bool dfMaskValid(const Series* s, DfMask* out);
+
+/**
+ * Numeric and DF_DATETIME columns: `x op value`, compared as doubles
+ * (64-bit values beyond 2^53 are rounded). False for other types.
+ */
+bool dfMaskCompare(const Series* s, DfCompareOp op, double value, DfMask* out);
+
+/**
+ * lo <= x <= hi.
+ */
+bool dfMaskBetween(const Series* s, double lo, double hi, DfMask* out);
+
+/**
+ * x equals one of values[0..n).
+ */
+bool dfMaskIsIn(const Series* s, const double* values, size_t n, DfMask* out);
+
+/**
+ * DF_STRING / DF_CATEGORY columns: x equals `str` / one of strs[0..n).
+ * Category columns compare dictionary codes, not strings.
+ */
+bool dfMaskEqString(const Series* s, const char* str, DfMask* out);
+bool dfMaskIsInStrings(const Series* s, const char* const* strs, size_t n, DfMask* out);
+
+/**
+ * Evaluate a RowPredicate once per row into a mask, for conditions the
+ * kernels above cannot express.
+ */
+bool dfMaskFromPredicate(const DataFrame* df, RowPredicate predicate, DfMask* out);
+
+#endif // DFMASK_H
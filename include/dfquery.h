@@ -0,0 +1,130 @@
+#ifndef DFQUERY_H
+#define DFQUERY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "dataframe.h"
+#include "dfmask.h"
+
+/* -------------------------------------------------------------------------
+ * Lazy queries
+ *
+ * A DFQuery records operations on a source frame without running them.
+ * dfQueryCollect() executes the whole plan at once: column selections and
+ * renames only re-share columns, filters and sorts work on one row
+ * selection, a sort followed by head becomes a top-k, and rows are copied
+ * once at the end, for the output columns only.
+ *
+ *     DFQuery q;
+ *     dfQueryInit(&q, &trades);
+ *     dfQueryWhere(&q, "Px", DF_CMP_GT, 100.0);
+ *     dfQuerySort(&q, "Qty", false);
+ *     dfQueryHead(&q, 10);
+ *     DataFrame top = dfQueryCollect(&q);
+ *     dfQueryFree(&q);
+ *
+ * Columns are named, so a step sees the columns as renamed and selected by
+ * the steps before it. The source frame (and any joined frame) must outlive
+ * the query and stay unchanged until the last collect.
+ *
+ * Before running, collect rewrites a copy of the plan (dfQueryOptimize):
+ *  - where() steps move ahead of sorts, filters, selections, renames and
+ *    joins (left-side columns for inner/left joins; right-side columns of
+ *    inner/right joins become filters on the joined frame);
+ *  - a join only receives the columns later steps use, plus its keys;
+ *  - consecutive selections and renames collapse into one step;
+ *  - a CSV source (dfQueryInitCsv) reads only the columns the plan uses and
+ *    drops rows failing the leading where() steps while parsing.
+ * ------------------------------------------------------------------------- */
+
+typedef enum {
+    DFQ_SELECT,   // keep the named columns, in that order
+    DFQ_RENAME,   // rename one column
+    DFQ_FILTER,   // RowPredicate, called on the frame as projected so far
+    DFQ_WHERE,    // column-kernel comparison: column op value
+    DFQ_SORT,     // stable sort by one column
+    DFQ_HEAD,     // first n rows
+    DFQ_JOIN      // join with another frame on a key column
+} DFQueryOp;
+
+typedef struct {
+    DFQueryOp        op;
+    char**           names;       // DFQ_SELECT: column names; DFQ_JOIN: right columns kept (owned)
+    size_t           nameCount;   // DFQ_JOIN: 0 => every right column
+    char**           aliases;     // optimized DFQ_SELECT / DFQ_RENAME: output names (owned)
+    char*            column;      // DFQ_RENAME (old name), DFQ_WHERE, DFQ_SORT, DFQ_JOIN (left key) (owned)
+    char*            newName;     // DFQ_RENAME (owned)
+    RowPredicate     predicate;   // DFQ_FILTER
+    DfCompareOp      cmp;         // DFQ_WHERE
+    double           value;       // DFQ_WHERE
+    bool             ascending;   // DFQ_SORT
+    size_t           n;           // DFQ_HEAD
+    const DataFrame* right;       // DFQ_JOIN
+    char*            rightKey;    // DFQ_JOIN (owned)
+    JoinType         how;         // DFQ_JOIN
+    DfCsvFilter*     filters;     // DFQ_JOIN: where() steps pushed into the right frame (owned)
+    size_t           filterCount;
+} DFQueryStep;
+
+typedef struct {
+    const DataFrame* source;
+    char*            csvPath;          // dfQueryInitCsv: read at collect time instead (owned)
+    DFQueryStep*     steps;
+    size_t           count;
+    size_t           capacity;
+    char**           scanColumns;      // optimized CSV plan: columns read (NULL => all)
+    size_t           scanColumnCount;
+    DfCsvFilter*     scanFilters;      // optimized CSV plan: row filters applied while parsing
+    size_t           scanFilterCount;
+} DFQuery;
+
+/**
+ * Start an empty plan over `source` (not copied).
+ */
+void dfQueryInit(DFQuery* q, const DataFrame* source);
+
+/**
+ * Start an empty plan over the CSV file `filename`, read (with readCsvScan)
+ * by each collect. Returns false if out of memory.
+ */
+bool dfQueryInitCsv(DFQuery* q, const char* filename);
+
+/**
+ * Release the recorded steps. The source frame is untouched.
+ */
+void dfQueryFree(DFQuery* q);
+
+/*
+ * Builders. Each records one step and returns `q`, so calls can be nested;
+ * they return NULL (and record nothing) on bad arguments or out of memory.
+ * Column names are resolved at collect time.
+ */
+DFQuery* dfQuerySelect(DFQuery* q, const char* const* names, size_t count);
+DFQuery* dfQueryRename(DFQuery* q, const char* oldName, const char* newName);
+DFQuery* dfQueryFilter(DFQuery* q, RowPredicate predicate);
+DFQuery* dfQueryWhere(DFQuery* q, const char* column, DfCompareOp cmp, double value);
+DFQuery* dfQuerySort(DFQuery* q, const char* column, bool ascending);
+DFQuery* dfQueryHead(DFQuery* q, size_t n);
+
+/**
+ * Join the rows so far with `right` (see join): the output has the current
+ * columns, then the right columns except `rightKey`, with names unchanged.
+ * A merge is the JOIN_INNER case.
+ */
+DFQuery* dfQueryJoin(DFQuery* q, const DataFrame* right, const char* leftKey,
+                     const char* rightKey, JoinType how);
+
+/**
+ * The rewritten plan collect runs, as a new query in `out` (release it with
+ * dfQueryFree). Returns false if a CSV source cannot be read or out of memory.
+ */
+bool dfQueryOptimize(const DFQuery* q, DFQuery* out);
+
+/**
+ * Run the plan and return the result. The query can be collected again.
+ * On an unknown column a message goes to stderr and an empty DataFrame is
+ * returned.
+ */
+DataFrame dfQueryCollect(const DFQuery* q);
+
+#endif // DFQUERY_H
@@ -0,0 +1,67 @@
+#ifndef DFREDUCE_H
+#define DFREDUCE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* -------------------------------------------------------------------------
+ * Vectorised reductions over contiguous typed buffers
+ *
+ * sum / min / max / product read a plain C array with several independent
+ * accumulators, so consecutive additions do not wait on each other. On x86
+ * the SSE2 or AVX2 version is picked once, at first use, from what the CPU
+ * supports; other targets (and the kernels with no vector form, such as the
+ * 64-bit sum) use an unrolled scalar loop.
+ *
+ * The buffers hold no nulls: aggregate.c hands over the fully valid runs of
+ * a column and handles rows of mixed validity words itself. Sums and
+ * products of doubles are reassociated, so they can differ from a
+ * left-to-right loop in the last bits.
+ * ------------------------------------------------------------------------- */
+
+typedef enum {
+    DF_ISA_SCALAR = 0,
+    DF_ISA_SSE2,
+    DF_ISA_AVX2
+} DfIsa;
+
+/**
+ * The instruction set the kernels currently run with.
+ */
+DfIsa dfReduceIsa(void);
+
+/**
+ * Force the kernels onto `isa` (to compare paths in tests or benchmarks).
+ * Returns false, leaving the choice unchanged, if this CPU or build lacks it.
+ */
+bool dfReduceSetIsa(DfIsa isa);
+
+/**
+ * DF_INT values are summed in 64-bit integers, so the result is exact.
+ * DF_DATETIME values are summed as doubles.
+ */
+int64_t dfReduceSumInt32(const int* v, size_t n);
+double  dfReduceSumDouble(const double* v, size_t n);
+double  dfReduceSumInt64(const long long* v, size_t n);
+
+/**
+ * Smallest / largest of v[0..n). An empty buffer gives the type's identity
+ * (INT_MAX, +INFINITY, LLONG_MAX for min and the opposite for max).
+ * NaN is never picked.
+ */
+int       dfReduceMinInt32(const int* v, size_t n);
+int       dfReduceMaxInt32(const int* v, size_t n);
+double    dfReduceMinDouble(const double* v, size_t n);
+double    dfReduceMaxDouble(const double* v, size_t n);
+long long dfReduceMinInt64(const long long* v, size_t n);
+long long dfReduceMaxInt64(const long long* v, size_t n);
+
+/**
+ * Product as a double; 1.0 for an empty buffer.
+ */
+double dfReduceProductInt32(const int* v, size_t n);
+double dfReduceProductDouble(const double* v, size_t n);
+double dfReduceProductInt64(const long long* v, size_t n);
+
+#endif /* DFREDUCE_H */
@@ -0,0 +1,162 @@
+#ifndef DFSKETCH_H
+#define DFSKETCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "series.h"
+
+/* -------------------------------------------------------------------------
+ * Approximate quantiles: a mergeable t-digest
+ *
+ * The sketch keeps a few hundred weighted centroids instead of the values.
+ * Centroids are small near q = 0 and q = 1 and larger in the middle, so
+ * tail quantiles (p99, p999) stay accurate even over unbounded streams.
+ * New values are buffered and folded in once the buffer fills.
+ *
+ * Sketches built from different partitions, shards or threads combine with
+ * dfSketchMerge, and dfSketchSerialize / dfSketchDeserialize move them
+ * between processes. One sketch must not be updated from two threads at
+ * once; give each thread its own and merge them.
+ * ------------------------------------------------------------------------- */
+
+typedef struct {
+    double mean;
+    double weight;
+} DfCentroid;
+
+typedef struct {
+    double      compression;    // max centroid count is about this
+    DfCentroid* centroids;      // merged, sorted by mean
+    size_t      count;
+    DfCentroid* buffer;         // added since the last merge, unsorted
+    size_t      buffered;
+    size_t      bufferCapacity;
+    double      totalWeight;    // merged + buffered
+    double      min;
+    double      max;
+} DfQuantileSketch;
+
+/**
+ * An empty sketch whose normalized rank error is about `errorBound` (for
+ * example 0.01) at the median and far smaller toward the tails. Smaller
+ * bounds cost more centroids: roughly 1.6 / errorBound. The bound is
+ * clamped to [1e-5, 0.1]. Returns false if out of memory.
+ */
+bool dfSketchInit(DfQuantileSketch* sk, double errorBound);
+void dfSketchFree(DfQuantileSketch* sk);
+
+/**
+ * Add one value (NaN is ignored). Returns false if out of memory.
+ */
+bool dfSketchAdd(DfQuantileSketch* sk, double x);
+
+/**
+ * Add the non-null values of rows [fromRow, seriesSize(s)) of a numeric or
+ * DF_DATETIME column. To follow a growing column, pass the row count seen
+ * by the previous call. Returns false for text columns or on allocation
+ * failure.
+ */
+bool dfSketchAddSeries(DfQuantileSketch* sk, const Series* s, size_t fromRow);
+
+/**
+ * Fold `src` into `dst` (src is unchanged). Keeps dst's compression.
+ */
+bool dfSketchMerge(DfQuantileSketch* dst, const DfQuantileSketch* src);
+
+/**
+ * Estimated q-quantile (q clamped to [0, 1]); 0.0 for an empty sketch.
+ * Folds in any buffered values first.
+ */
+double dfSketchQuantile(DfQuantileSketch* sk, double q);
+
+/**
+ * Values added so far.
+ */
+double dfSketchCount(const DfQuantileSketch* sk);
+
+/**
+ * Write the sketch to buf (a portable little-endian byte layout) and return
+ * the number of bytes it takes. If buf is NULL or cap is too small nothing
+ * is written, so call once with NULL to size the buffer.
+ */
+size_t dfSketchSerialize(DfQuantileSketch* sk, uint8_t* buf, size_t cap);
+
+/**
+ * Initialize `sk` from dfSketchSerialize output. Returns false (sk left
+ * empty and not needing dfSketchFree) on malformed input.
+ */
+bool dfSketchDeserialize(DfQuantileSketch* sk, const uint8_t* buf, size_t len);
+
+/* -------------------------------------------------------------------------
+ * Approximate distinct counts: HyperLogLog
+ *
+ * 2^precision one-byte registers, each holding the longest run of leading
+ * zero bits seen among the 64-bit hashes routed to it. The relative
+ * standard error is about 1.04 / sqrt(2^precision): 0.8% at the default
+ * precision 14, for 16 KB whatever the cardinality. The estimate uses
+ * Ertl's improved estimator, which stays unbiased from a handful of values
+ * up to billions without HLL++'s empirical bias tables.
+ *
+ * Merging takes the register-wise maximum, so dfHllMerge of daily sketches
+ * gives exactly the sketch of the whole week. Hashes depend only on the
+ * value, never on the column type, dictionary codes or process:
+ *   - integers (any width, DF_DATETIME) and doubles holding an integer
+ *     hash as that int64 / uint64, so 7, 7LL and 7.0 are one value;
+ *   - other doubles and floats hash their IEEE bits (-0.0 as 0.0; NaN and
+ *     nulls are skipped);
+ *   - DF_STRING and DF_CATEGORY hash the label bytes.
+ * ------------------------------------------------------------------------- */
+
+#define DF_HLL_MIN_PRECISION     4
+#define DF_HLL_MAX_PRECISION     18
+#define DF_HLL_DEFAULT_PRECISION 14
+
+typedef struct {
+    int      precision;     // log2 of the register count
+    uint8_t* registers;     // 2^precision, each in [0, 65 - precision]
+} DfHyperLogLog;
+
+/**
+ * An empty sketch with 2^precision registers; 0 picks
+ * DF_HLL_DEFAULT_PRECISION, other values are clamped to
+ * [DF_HLL_MIN_PRECISION, DF_HLL_MAX_PRECISION]. Returns false if out of
+ * memory.
+ */
+bool dfHllInit(DfHyperLogLog* h, int precision);
+void dfHllFree(DfHyperLogLog* h);
+
+/**
+ * Add one value (see above for how each kind is hashed).
+ */
+void dfHllAddInt64(DfHyperLogLog* h, int64_t v);
+void dfHllAddDouble(DfHyperLogLog* h, double v);
+void dfHllAddString(DfHyperLogLog* h, const char* str, size_t len);
+
+/**
+ * Add the non-null values of rows [fromRow, seriesSize(s)) of a column of
+ * any type, reading the typed buffers chunk by chunk. To follow a growing
+ * column, pass the row count seen by the previous call. Returns false on
+ * allocation failure.
+ */
+bool dfHllAddSeries(DfHyperLogLog* h, const Series* s, size_t fromRow);
+
+/**
+ * Fold `src` into `dst` (src is unchanged). src may have a higher
+ * precision than dst, which is folded down; a lower one returns false.
+ */
+bool dfHllMerge(DfHyperLogLog* dst, const DfHyperLogLog* src);
+
+/**
+ * Estimated number of distinct values added.
+ */
+double dfHllEstimate(const DfHyperLogLog* h);
+
+/**
+ * Same contract as dfSketchSerialize / dfSketchDeserialize: a portable
+ * byte layout, sized by a first call with buf == NULL.
+ */
+size_t dfHllSerialize(const DfHyperLogLog* h, uint8_t* buf, size_t cap);
+bool dfHllDeserialize(DfHyperLogLog* h, const uint8_t* buf, size_t len);
+
+#endif /* DFSKETCH_H */
@@ -0,0 +1,84 @@
+#ifndef DFSTATS_H
+#define DFSTATS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "dataframe.h"
+
+/* -------------------------------------------------------------------------
+ * Fused column summaries (the engine behind describe)
+ *
+ * One streaming pass per column collects count, nulls, min, max and the
+ * running central moments (mean, M2, M3, M4), and copies the values into a
+ * scratch buffer. The 25/50/75% quantiles then come from a single selection
+ * pass over that buffer, without a full sort. std, skew and kurtosis use the
+ * same sample formulas as std(), skewness() and kurtosis(). Quantiles
+ * interpolate linearly, as quantile() does.
+ * ------------------------------------------------------------------------- */
+
+typedef struct {
+    bool   numeric;     // false for DF_STRING / DF_CATEGORY: only count and nulls are set
+    size_t count;       // non-null rows
+    size_t nulls;
+    double min;
+    double max;
+    double mean;
+    double std;         // sample (n - 1); 0 below 2 values
+    double skew;        // 0 below 3 values or for a constant column
+    double kurtosis;    // excess; 0 below 4 values or for a constant column
+    double q25;
+    double q50;
+    double q75;
+} DfColumnStats;
+
+/**
+ * Summarize one column (any storage: contiguous, view or chunked).
+ * DF_DATETIME values are summarized as epoch numbers.
+ * Returns false if `s` or `out` is NULL or on allocation failure.
+ */
+bool dfSummarizeSeries(const Series* s, DfColumnStats* out);
+
+/**
+ * Summarize every column of `df` into out[0..numColumns). Large frames are
+ * split across worker threads, one column at a time per worker.
+ */
+bool dfSummarizeColumns(const DataFrame* df, DfColumnStats* out);
+
+/**
+ * The non-null values of a numeric or DF_DATETIME column as doubles, in row
+ * order (malloc'd; caller frees), with their number in *outCount. NULL
+ * (count 0) for text columns, all-null columns or on allocation failure.
+ */
+double* dfSeriesValues(const Series* s, size_t* outCount);
+
+/* -------------------------------------------------------------------------
+ * Order statistics without sorting
+ *
+ * Ranks are 0-based. One partial partitioning serves every requested rank:
+ * while a range still holds several of them it is split once and both
+ * sides followed; a range holding one rank finishes with Floyd-Rivest
+ * selection (sample-guided pivots). A range that stops shrinking within
+ * ~2 log2(n) passes is heapsorted instead, so the worst case stays
+ * O(n log n) (introselect). Average cost is O(n).
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Rearrange values[0..n) so that values[k] holds the k-th smallest value for
+ * every k in ranks[0..nRanks) (ascending, each < n), smaller values before it
+ * and larger ones after.
+ */
+void dfSelectRanksInPlace(double* values, size_t n, const size_t* ranks, size_t nRanks);
+
+/**
+ * The k-th smallest (0-based) of values[0..n), reordering them; 0.0 if k >= n.
+ */
+double dfSelectInPlace(double* values, size_t n, size_t k);
+
+/**
+ * Quantiles qs[0..nq) (each clamped to [0, 1]) of values[0..n) into
+ * out[0..nq), from one selection pass shared by all of them. Reorders
+ * `values`. Returns false if n == 0.
+ */
+bool dfQuantilesInPlace(double* values, size_t n, const double* qs, size_t nq, double* out);
+
+#endif /* DFSTATS_H */
@@ -3,19 +3,102 @@
 
 #include <stddef.h>   // for size_t
 #include <stdbool.h>  // for bool
+#include <stdint.h>   // for uint64_t
 #include "column_type.h"
-#include "dynamic_array.h"
 
 
 /*
- * Series: a single column of data (with a name, type, and dynamic array).
+ * Alignment (in bytes) of the typed value buffer behind numeric Series.
+ * 64 keeps every buffer cache-line aligned, which also satisfies any
+ * vector load width we might care about.
+ */
+#define SERIES_ALIGNMENT 64
+
+/*
+ * Dictionary behind a DF_CATEGORY Series: the distinct labels plus a hash
+ * index label -> code. It is append-only and reference counted, so Series
+ * copied from one another share it and their codes stay comparable.
+ */
+typedef struct SeriesDictionary SeriesDictionary;
+
+/*
+ * Reference count for storage (values, bytes, validity) shared by several
+ * Series through seriesShare(). NULL in a Series = it owns its buffers.
+ */
+typedef struct SeriesShared SeriesShared;
+
+/*
+ * Chunk list behind a chunked Series (see seriesInitChunked).
+ */
+typedef struct SeriesChunks SeriesChunks;
+
+/* Default rows per chunk of a chunked Series. */
+#define SERIES_CHUNK_ROWS 65536
+
+/*
+ * Series: a single column of data (with a name, type, and storage).
+ *
+ * DF_INT / DF_DOUBLE / DF_DATETIME values live in one contiguous,
+ * SERIES_ALIGNMENT-aligned buffer (`values`) of int / double / long long,
+ * grown geometrically on append. The fixed-width types DF_INT8 ... DF_UINT64
+ * and DF_FLOAT use the same layout with int8_t ... uint64_t / float.
+ *
+ * DF_STRING uses an Arrow-style layout: all characters live in one byte
+ * arena (`bytes`) and `values` holds `length + 1` uint64_t offsets into it,
+ * so string i spans [offsets[i], offsets[i+1]). Every string is stored with
+ * its terminating NUL inside the arena, so a borrowed view is also a valid
+ * C string.
+ *
+ * DF_CATEGORY stores one small integer code per row in `values`
+ * (`codeWidth` = 1, 2 or 4 bytes, widened as the dictionary grows) and the
+ * labels once in the shared `dict`. It reads and writes like a DF_STRING
+ * column through the string accessors.
+ *
+ * Nulls: a Series may carry a packed validity bitmap (`validity`, bit i set
+ * = row i holds a value). It is only allocated once the first null is
+ * added; until then every row is valid. `nullCount` is kept up to date on
+ * every write, and the getters return false for null rows.
+ *
+ * Sharing: seriesShare() makes a second Series over the same buffers in
+ * O(1) (`shared` holds the reference count). Shared buffers are never
+ * written: the first mutation through either Series copies them
+ * (copy-on-write), and seriesFree only releases them with the last user.
+ * The reference counts are atomic and nothing else in the source changes,
+ * so a const Series may be shared or sliced from several threads at once.
+ * seriesSlice() shares the same way but exposes only a range of rows:
+ * `values` points `offset` rows into the parent's buffer and the validity
+ * bits are read at `offset + row`.
+ *
+ * Chunks: a Series created with seriesInitChunked() keeps its rows in a
+ * list of ordinary Series (`chunks`) instead of one buffer. Appends only
+ * touch the tail chunk, which is allocated at full size up front, so a
+ * column never reallocates or copies as it grows, and seriesAppendChunks()
+ * links whole chunks of another Series without copying them. All getters
+ * and setters work across chunks; kernels that read the raw buffers walk
+ * seriesChunk(s, 0 .. seriesChunkCount(s) - 1), which for a contiguous
+ * Series is just the Series itself.
  */
 typedef struct {
     char*        name;
     ColumnType   type;
-    DynamicArray data;   // each element is a copy of the item
+    void*        values;        // typed values, or string offsets for DF_STRING
+    size_t       length;        // number of elements in the Series
+    size_t       capacity;      // number of elements `values` can hold
+    char*        bytes;         // DF_STRING: byte arena
+    size_t       bytesUsed;     // DF_STRING: bytes used in the arena
+    size_t       bytesCapacity; // DF_STRING: bytes allocated for the arena
+    unsigned int codeWidth;     // DF_CATEGORY: bytes per code (1, 2 or 4)
+    SeriesDictionary* dict;     // DF_CATEGORY: shared label dictionary
+    uint64_t*    validity;      // optional validity bitmap (NULL = no nulls)
+    size_t       nullCount;     // number of null rows
+    SeriesShared* shared;       // non-NULL while the buffers are shared
+    size_t       offset;        // row view: rows skipped before `values`
+    SeriesChunks* chunks;       // non-NULL: rows live in a list of chunks
 } Series;
 
+/* Number of 64-bit words a validity bitmap needs for n rows. */
+#define SERIES_VALIDITY_WORDS(n) (((n) + 63) / 64)
+
 /*
  * Series Functions
  */
@@ -48,30 +131,75 @@ void seriesAddInt(Series* s, int value);
 void seriesAddDouble(Series* s, double value);
 
 /**
- * Add a string value to the Series (type must be DF_STRING).
- * Internally copies the string.
+ * Deep-copy `src` into `dst` (which must not be initialized yet).
+ * Buffers are copied wholesale; a DF_CATEGORY copy shares the dictionary.
+ */
+void seriesCopy(const Series* src, Series* dst);
+
+/**
+ * Make `dst` (which must not be initialized yet) a copy-on-write view of
+ * `src`'s storage: O(1), only the name is duplicated. Either Series copies
+ * the buffers the first time it is modified; both must be seriesFree'd.
+ */
+void seriesShare(const Series* src, Series* dst);
+
+/**
+ * Make `dst` (which must not be initialized yet) a copy-on-write view of
+ * rows [start, start + count) of `src` (clamped to its size). O(1) unless
+ * `src` has nulls, in which case the view's null count is recomputed.
+ * seriesCopy() of a view gives a compact, independent Series.
+ */
+void seriesSlice(const Series* src, size_t start, size_t count, Series* dst);
+
+/**
+ * Add a string value to the Series (type must be DF_STRING or DF_CATEGORY).
+ * Internally copies the string (a category only stores new labels).
  */
 void seriesAddString(Series* s, const char* str);
 
 /**
- * Retrieve an integer from a Series at a given row index (if DF_INT).
- * Returns false if out of range or wrong type.
+ * Append a null (missing) value. The row gets a placeholder value of the
+ * column's type and its validity bit is cleared.
+ */
+void seriesAddNull(Series* s);
+
+/**
+ * Append row `row` of `src` to `dst`, keeping nulls as nulls. The types must
+ * match (DF_STRING and DF_CATEGORY may be mixed). Returns false otherwise or
+ * if `row` is out of range.
+ */
+bool seriesAppendFrom(Series* dst, const Series* src, size_t row);
+
+/**
+ * Retrieve an integer from a Series at a given row index (if DF_INT, or one
+ * of DF_INT8 / DF_INT16 / DF_UINT8 / DF_UINT16, which widen losslessly).
+ * Returns false if out of range, wrong type, or null.
  */
 bool seriesGetInt(const Series* s, size_t index, int* outValue);
 
 /**
- * Retrieve a double from a Series at a given row index (if DF_DOUBLE).
- * Returns false if out of range or wrong type.
+ * Retrieve a double from a Series at a given row index (if DF_DOUBLE or
+ * DF_FLOAT). Returns false if out of range, wrong type, or null.
  */
 bool seriesGetDouble(const Series* s, size_t index, double* outValue);
 
 /**
- * Retrieve a string from a Series at a given row index (if DF_STRING).
+ * Retrieve a string from a Series at a given row index (if DF_STRING or
+ * DF_CATEGORY).
  * The function allocates a copy into *outStr (caller must free).
- * Returns false if out of range or wrong type.
+ * Returns false if out of range, wrong type, or null.
  */
 bool seriesGetString(const Series* s, size_t index, char** outStr);
 
+/**
+ * Borrow a string from a DF_STRING Series without copying.
+ * *outStr points into the Series' byte arena (NUL-terminated) and stays valid
+ * until the Series is modified or freed; *outLen (optional, may be NULL)
+ * receives the length in bytes, excluding the NUL.
+ * Returns false if out of range, wrong type, or null.
+ */
+bool seriesGetStringView(const Series* s, size_t index, const char** outStr, size_t* outLen);
+
 /**
  * Print the contents of the Series (for debugging).
  */
@@ -87,8 +215,341 @@ void seriesAddDateTime(Series* s, long long datetimeMicros);
 /**
  * Retrieve a datetime value (in microseconds since Unix epoch) from a Series 
  * at a given row index (if DF_DATETIME).
- * Returns false if out of range or wrong type.
+ * Returns false if out of range, wrong type, or null.
  */
 bool seriesGetDateTime(const Series* s, size_t index, long long* outValue);
 
+/**
+ * Overwrite an existing value in place (type must match, index in range).
+ * A null row becomes valid again. Returns false if out of range or wrong type.
+ */
+bool seriesSetInt(Series* s, size_t index, int value);
+bool seriesSetDouble(Series* s, size_t index, double value);
+bool seriesSetDateTime(Series* s, size_t index, long long value);
+
+/**
+ * Overwrite the string at `index` (type must be DF_STRING). The new value is
+ * spliced into the byte arena, so this is O(size of the arena tail).
+ */
+bool seriesSetString(Series* s, size_t index, const char* str);
+
+/*
+ * Bulk append
+ */
+
+/**
+ * Make room for `capacity` rows in total, so that appends up to that size do
+ * not reallocate. A no-op for a chunked Series. Returns false on failure.
+ */
+bool seriesReserve(Series* s, size_t capacity);
+
+/**
+ * Append `n` values with one memcpy (one per chunk for a chunked Series).
+ * The type must match: DF_INT, DF_DOUBLE, DF_DATETIME, or for
+ * seriesAppendValues any fixed-width type with `values` of its C type.
+ * Returns false on a type mismatch or allocation failure.
+ */
+bool seriesAppendInts(Series* s, const int* values, size_t n);
+bool seriesAppendDoubles(Series* s, const double* values, size_t n);
+bool seriesAppendDateTimes(Series* s, const long long* values, size_t n);
+bool seriesAppendValues(Series* s, const void* values, size_t n);
+
+/**
+ * Append `n` strings to a DF_STRING / DF_CATEGORY Series; a NULL entry
+ * appends a null.
+ */
+bool seriesAppendStrings(Series* s, const char* const* strs, size_t n);
+
+/**
+ * Append rows rows[0..n) of `src` to `dst` (same type; nulls stay null),
+ * the bulk form of seriesAppendFrom. Fixed-width columns copy through the
+ * type's gather kernel. Returns false on a type mismatch, a row out of
+ * range (nothing is appended then) or allocation failure.
+ */
+bool seriesAppendRows(Series* dst, const Series* src, const size_t* rows, size_t n);
+
+/**
+ * Initialize `dst` as a new Series holding rows idx[0..n) of `src`, in that
+ * order (duplicates allowed; nulls stay null). Fixed-width values and
+ * category codes are copied with the type's gather kernel, prefetching
+ * ahead of the random reads; strings are sized first and their bytes
+ * copied straight into one preallocated arena. A category result shares
+ * src's dictionary. Returns false (dst empty) if an index is out of range
+ * or on allocation failure.
+ */
+bool seriesGather(const Series* src, const size_t* idx, size_t n, Series* dst);
+
+/*
+ * Per-type kernels
+ *
+ * SERIES_FIXED_TYPES(X) expands X(Tag, CType, Name) once per column type
+ * with a plain C value buffer. series.c uses it to generate one set of
+ * kernels per type, so a loop over rows resolves the type once per column
+ * (seriesKernels) instead of switching on it for every cell. The kernels
+ * work on raw contiguous buffers and know nothing about nulls or chunks.
+ */
+#define SERIES_FIXED_TYPES(X)               \
+    X(DF_INT,      int,       Int)          \
+    X(DF_DOUBLE,   double,    Double)       \
+    X(DF_DATETIME, long long, DateTime)     \
+    X(DF_INT8,     int8_t,    Int8)         \
+    X(DF_INT16,    int16_t,   Int16)        \
+    X(DF_INT64,    int64_t,   Int64)        \
+    X(DF_UINT8,    uint8_t,   UInt8)        \
+    X(DF_UINT16,   uint16_t,  UInt16)       \
+    X(DF_UINT32,   uint32_t,  UInt32)       \
+    X(DF_UINT64,   uint64_t,  UInt64)       \
+    X(DF_FLOAT,    float,     Float)
+
+typedef struct {
+    ColumnType type;
+    size_t     width;    // bytes per value
+    /* dst[i] = src[idx[i]] */
+    void     (*gather)(const void* src, const size_t* idx, size_t n, void* dst);
+    /* dst[idx[i]] = src[i] */
+    void     (*scatter)(const void* src, const size_t* idx, size_t n, void* dst);
+    /* three-way compare of a[i] and b[j] (NaN compares equal to anything) */
+    int      (*compare)(const void* a, size_t i, const void* b, size_t j);
+    /* a[i] == b[j] in C (so NaN never equals, 0.0 == -0.0) */
+    bool     (*equal)(const void* a, size_t i, const void* b, size_t j);
+    /* hash of values[i], consistent with `equal` */
+    uint64_t (*hash)(const void* values, size_t i);
+    /* dst[0..n) = src[0..n) */
+    void     (*copy)(const void* src, size_t n, void* dst);
+} SeriesKernels;
+
+/**
+ * The kernels of a fixed-width type; NULL for DF_STRING and DF_CATEGORY.
+ */
+const SeriesKernels* seriesKernels(ColumnType type);
+
+/**
+ * Direct read-only access to the contiguous value buffer of a numeric Series.
+ * Returns NULL if the Series has the wrong type or is chunked (read each
+ * seriesChunk() instead). The pointer is valid until the next append (which
+ * may reallocate the buffer).
+ */
+const int*       seriesIntData(const Series* s);
+const double*    seriesDoubleData(const Series* s);
+const long long* seriesDateTimeData(const Series* s);
+
+/*
+ * Fixed-width numeric types (DF_INT8, DF_INT16, DF_INT64, DF_UINT8,
+ * DF_UINT16, DF_UINT32, DF_UINT64, DF_FLOAT)
+ */
+
+/**
+ * Append / read / overwrite / borrow the buffer, exactly like the DF_INT
+ * functions above. The type must match exactly.
+ */
+void seriesAddInt8(Series* s, int8_t value);
+void seriesAddInt16(Series* s, int16_t value);
+void seriesAddInt64(Series* s, int64_t value);
+void seriesAddUInt8(Series* s, uint8_t value);
+void seriesAddUInt16(Series* s, uint16_t value);
+void seriesAddUInt32(Series* s, uint32_t value);
+void seriesAddUInt64(Series* s, uint64_t value);
+void seriesAddFloat(Series* s, float value);
+
+bool seriesGetInt8(const Series* s, size_t index, int8_t* outValue);
+bool seriesGetInt16(const Series* s, size_t index, int16_t* outValue);
+bool seriesGetInt64(const Series* s, size_t index, int64_t* outValue);
+bool seriesGetUInt8(const Series* s, size_t index, uint8_t* outValue);
+bool seriesGetUInt16(const Series* s, size_t index, uint16_t* outValue);
+bool seriesGetUInt32(const Series* s, size_t index, uint32_t* outValue);
+bool seriesGetUInt64(const Series* s, size_t index, uint64_t* outValue);
+bool seriesGetFloat(const Series* s, size_t index, float* outValue);
+
+bool seriesSetInt8(Series* s, size_t index, int8_t value);
+bool seriesSetInt16(Series* s, size_t index, int16_t value);
+bool seriesSetInt64(Series* s, size_t index, int64_t value);
+bool seriesSetUInt8(Series* s, size_t index, uint8_t value);
+bool seriesSetUInt16(Series* s, size_t index, uint16_t value);
+bool seriesSetUInt32(Series* s, size_t index, uint32_t value);
+bool seriesSetUInt64(Series* s, size_t index, uint64_t value);
+bool seriesSetFloat(Series* s, size_t index, float value);
+
+const int8_t*   seriesInt8Data(const Series* s);
+const int16_t*  seriesInt16Data(const Series* s);
+const int64_t*  seriesInt64Data(const Series* s);
+const uint8_t*  seriesUInt8Data(const Series* s);
+const uint16_t* seriesUInt16Data(const Series* s);
+const uint32_t* seriesUInt32Data(const Series* s);
+const uint64_t* seriesUInt64Data(const Series* s);
+const float*    seriesFloatData(const Series* s);
+
+/*
+ * Type-generic numeric helpers
+ */
+
+/**
+ * True for the integer and floating types (DF_INT, DF_DOUBLE, DF_INT8 ...
+ * DF_UINT64, DF_FLOAT); DF_DATETIME is not included.
+ */
+bool seriesTypeIsNumeric(ColumnType type);
+
+/**
+ * Read any numeric or DF_DATETIME cell as a double (64-bit integers beyond
+ * 2^53 are rounded). Returns false if out of range, wrong type, or null.
+ */
+bool seriesGetAsDouble(const Series* s, size_t index, double* outValue);
+
+/**
+ * Bytes per value of a fixed-width column (any numeric type or
+ * DF_DATETIME); 0 for DF_STRING / DF_CATEGORY.
+ */
+size_t seriesValueSize(const Series* s);
+
+/**
+ * Copy the value at `index` of a fixed-width column into `out`, which must
+ * hold seriesValueSize(s) bytes of the column's C type. Returns false if out
+ * of range, wrong type, or null.
+ */
+bool seriesGetValue(const Series* s, size_t index, void* out);
+
+/**
+ * Append / overwrite a value of the column's C type (fixed-width columns
+ * only). A null row becomes valid again.
+ */
+void seriesAddValue(Series* s, const void* in);
+bool seriesSetValue(Series* s, size_t index, const void* in);
+
+/**
+ * Append `value` converted to the column's numeric or DF_DATETIME type
+ * (integers saturate at the type's range, NaN becomes 0). Ignored for
+ * DF_STRING / DF_CATEGORY.
+ */
+void seriesAddNumber(Series* s, double value);
+
+/**
+ * Compare rows `a` and `b` of one Series in its own type (no conversion):
+ * < 0, 0 or > 0. Strings compare with strcmp; a null on either side
+ * compares equal.
+ */
+int seriesCompareRows(const Series* s, size_t a, size_t b);
+
+/**
+ * Format a numeric or DF_DATETIME cell into `buf` ("%d"-style for integers,
+ * "%g" for floating types). Returns false (and an empty buf) if out of
+ * range, wrong type, or null.
+ */
+bool seriesFormatNumber(const Series* s, size_t index, char* buf, size_t bufSize);
+
+/*
+ * Chunked storage
+ */
+
+/**
+ * Initialize an empty chunked Series: rows are stored in chunks of
+ * `chunkRows` rows (0 => SERIES_CHUNK_ROWS). Everything else behaves like
+ * seriesInit(); seriesCopy / seriesShare / seriesSlice keep the chunking.
+ */
+void seriesInitChunked(Series* s, const char* name, ColumnType type, size_t chunkRows);
+
+/**
+ * True if `s` was created with seriesInitChunked().
+ */
+bool seriesIsChunked(const Series* s);
+
+/**
+ * Number of chunks (1 for a contiguous Series) and chunk `k` (the Series
+ * itself for a contiguous one). A chunk is an ordinary contiguous Series,
+ * so the Data() accessors and seriesValidityWord work on it.
+ */
+size_t seriesChunkCount(const Series* s);
+const Series* seriesChunk(const Series* s, size_t k);
+
+/**
+ * Append all rows of `src` to the chunked Series `dst`. Chunks of at least
+ * half the chunk size are linked copy-on-write in O(1); smaller ones are
+ * copied into the tail chunk. The types must match (DF_STRING and
+ * DF_CATEGORY may be mixed). Returns false if `dst` is not chunked.
+ */
+bool seriesAppendChunks(Series* dst, const Series* src);
+
+/*
+ * Memory accounting
+ */
+
+/* Bytes behind one Series, by kind. */
+typedef struct {
+    size_t data;      // value buffer (string offsets / category codes included)
+    size_t strings;   // DF_STRING byte arena, DF_CATEGORY dictionary labels
+    size_t validity;  // null bitmap
+    size_t overhead;  // Series header, name, chunk list, sharing / hash headers
+} SeriesMemory;
+
+/**
+ * Fill `out` with the memory used by `s`. With deep == false only the bytes
+ * holding this Series' rows are counted (rows x width, its own strings and
+ * bitmap words). With deep == true everything the allocator handed out is
+ * counted: spare capacity, the whole buffer behind a shared view, and the
+ * category dictionary's hash table.
+ */
+void seriesMemoryUsage(const Series* s, bool deep, SeriesMemory* out);
+
+/*
+ * Null (validity) helpers
+ */
+
+/**
+ * True if row `index` is null.
+ */
+bool seriesIsNull(const Series* s, size_t index);
+
+/**
+ * Mark an existing row as null. Returns false if out of range.
+ */
+bool seriesSetNull(Series* s, size_t index);
+
+/**
+ * Number of null rows, O(1).
+ */
+size_t seriesNullCount(const Series* s);
+
+/**
+ * Validity of rows [64 * w, 64 * w + 64) as one word: bit i set = row
+ * 64 * w + i holds a value. Bits past the last row are set, and a Series
+ * without nulls reads as all ones, so kernels can walk
+ * SERIES_VALIDITY_WORDS(size) words and skip full / empty blocks.
+ */
+uint64_t seriesValidityWord(const Series* s, size_t w);
+
+/*
+ * Categorical (DF_CATEGORY) helpers
+ */
+
+/**
+ * Build a DF_CATEGORY copy of a DF_STRING (or DF_CATEGORY) Series into `out`
+ * (which must not be initialized yet). Returns false on wrong type.
+ */
+bool seriesToCategory(const Series* src, Series* out);
+
+/**
+ * Dictionary code of the row at `index` (DF_CATEGORY only).
+ */
+bool seriesGetCode(const Series* s, size_t index, uint32_t* outCode);
+
+/**
+ * Number of distinct labels in the dictionary (0 if not DF_CATEGORY).
+ */
+size_t seriesCategoryCount(const Series* s);
+
+/**
+ * Borrow the label for dictionary `code` (same lifetime rules as
+ * seriesGetStringView).
+ */
+bool seriesCategoryLabel(const Series* s, uint32_t code, const char** outStr, size_t* outLen);
+
+/**
+ * Look up the code of `label` without adding it. Returns false if absent.
+ */
+bool seriesCategoryFind(const Series* s, const char* label, uint32_t* outCode);
+
+/**
+ * True if both Series are DF_CATEGORY and share one dictionary, i.e. equal
+ * codes mean equal labels.
+ */
+bool seriesSameDictionary(const Series* a, const Series* b);
+
 #endif // SERIES_H
@@ -5,79 +5,193 @@
 #include <string.h>
 #include <stdbool.h>
 #include <float.h>
+#include <limits.h>
 #include "dataframe.h"
+#include "dfalloc.h"
+#include "dfreduce.h"
+#include "dfstats.h"
+#include "dfsketch.h"
 #include "series.h"
 
 
 
-static int compareDoubles(const void* a, const void* b)
+/*
+ * Count rows per dictionary code of a DF_CATEGORY Series.
+ * Returns a calloc'd array indexed by code (caller frees) and fills
+ * *outOrder (caller frees) with the codes seen, in first-appearance order.
+ * Only rows[0..nRows) are counted when `rows` is given.
+ */
+static size_t* countCategoryCodes(const Series* s, const size_t* rows, size_t nRows,
+                                  uint32_t** outOrder, size_t* outDistinct)
 {
-    double da = *(const double*)a;
-    double db = *(const double*)b;
-    // returns negative if da < db, 0 if equal, positive if da > db
-    if (da < db) return -1;
-    if (da > db) return 1;
-    return 0;
+    size_t nCodes = seriesCategoryCount(s);
+    size_t* counts = (size_t*)calloc(nCodes ? nCodes : 1, sizeof(size_t));
+    uint32_t* order = (uint32_t*)malloc((nCodes ? nCodes : 1) * sizeof(uint32_t));
+    size_t distinct = 0;
+
+    for (size_t i = 0; i < nRows; i++) {
+        uint32_t code;
+        if (!seriesGetCode(s, rows ? rows[i] : i, &code)) continue;
+        if (counts[code]++ == 0) {
+            order[distinct++] = code;
+        }
+    }
+    *outOrder = order;
+    *outDistinct = distinct;
+    return counts;
 }
 
+/*
+ * Run STMT for every non-null row `r` of `s`, one 64-row validity word at a
+ * time: a word with no nulls runs as a plain loop, an all-null word is
+ * skipped whole, and only mixed words test individual bits.
+ */
+#define FOR_EACH_VALID_ROW(s, n, r, STMT)                                    \
+    do {                                                                     \
+        bool hasNulls_ = seriesNullCount(s) > 0;                             \
+        for (size_t base_ = 0; base_ < (n); base_ += 64) {                   \
+            size_t end_ = (base_ + 64 < (n)) ? base_ + 64 : (n);             \
+            uint64_t word_ = hasNulls_ ? seriesValidityWord(s, base_ >> 6)   \
+                                       : ~0ULL;                              \
+            if (word_ == 0) continue;                                        \
+            if (word_ == ~0ULL) {                                            \
+                for (size_t r = base_; r < end_; r++) { STMT; }              \
+            } else {                                                         \
+                for (size_t r = base_; r < end_; r++) {                      \
+                    if ((word_ >> (r - base_)) & 1ULL) { STMT; }             \
+                }                                                            \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+/*
+ * Like FOR_EACH_VALID_ROW, but each stretch of fully valid 64-row words is
+ * handed to RUN as one block of rows [start, start + count), so a vector
+ * kernel (dfreduce.h) sees long contiguous buffers. Only words that mix
+ * valid and null rows run ROW for each valid row `r`.
+ */
+#define FOR_EACH_VALID_RUN(s, n, start, count, RUN, r, ROW)                  \
+    do {                                                                     \
+        if (seriesNullCount(s) == 0) {                                       \
+            size_t start = 0, count = (n);                                   \
+            if (count) { RUN; }                                              \
+            break;                                                           \
+        }                                                                    \
+        size_t runStart_ = 0;                                                \
+        bool inRun_ = false;                                                 \
+        for (size_t base_ = 0; base_ < (n); base_ += 64) {                   \
+            size_t end_ = (base_ + 64 < (n)) ? base_ + 64 : (n);             \
+            uint64_t word_ = seriesValidityWord(s, base_ >> 6);              \
+            if (word_ == ~0ULL) {                                            \
+                if (!inRun_) { runStart_ = base_; inRun_ = true; }           \
+                continue;                                                    \
+            }                                                                \
+            if (inRun_) {                                                    \
+                size_t start = runStart_, count = base_ - runStart_;         \
+                RUN;                                                         \
+                inRun_ = false;                                              \
+            }                                                                \
+            if (word_ == 0) continue;                                        \
+            for (size_t r = base_; r < end_; r++) {                          \
+                if ((word_ >> (r - base_)) & 1ULL) { ROW; }                  \
+            }                                                                \
+        }                                                                    \
+        if (inRun_) {                                                        \
+            size_t start = runStart_, count = (n) - runStart_;               \
+            RUN;                                                             \
+        }                                                                    \
+    } while (0)
+
+/*
+ * Typed scans over the fixed-width types (DF_INT8 ... DF_UINT64, DF_FLOAT):
+ * `data` is the column's buffer of C type T, read in its own type.
+ */
+#define SUM_TYPED(T, data, n, acc)                                           \
+    do {                                                                     \
+        const T* v_ = (data);                                                \
+        FOR_EACH_VALID_ROW(s, n, r, acc += (double)v_[r]);                   \
+    } while (0)
+
+#define EXTREME_TYPED(T, data, n, OP, out)                                   \
+    do {                                                                     \
+        const T* v_ = (data);                                                \
+        T m_ = 0;                                                            \
+        bool first_ = true;                                                  \
+        FOR_EACH_VALID_ROW(s, n, r,                                          \
+            if (first_ || v_[r] OP m_) { m_ = v_[r]; first_ = false; });     \
+        out = (double)m_;                                                    \
+    } while (0)
+
 /* -------------------------------------------------------------------------
- * SUM
- * -----------------------------------------------t-------------------------- */
+ * SUM (nulls skipped)
+ * ------------------------------------------------------------------------- */
 
-double dfSum_impl(const DataFrame* df, size_t colIndex)
+/* Sum of the non-null values of one contiguous chunk. */
+static double chunkSum(const Series* s)
 {
-    if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
-    if (!s) return 0.0;
-
     double sumVal = 0.0;
     size_t nRows = seriesSize(s);
 
+    // a chunk is one contiguous buffer => scan it directly
     switch (s->type) {
         case DF_INT: {
-            for (size_t r = 0; r < nRows; r++) {
-                int v;
-                if (seriesGetInt(s, r, &v)) {
-                    sumVal += v;
-                }
-            }
+            const int* v = seriesIntData(s);
+            FOR_EACH_VALID_RUN(s, nRows, at, len, sumVal += (double)dfReduceSumInt32(v + at, len),
+                               r, sumVal += v[r]);
         } break;
         case DF_DOUBLE: {
-            for (size_t r = 0; r < nRows; r++) {
-                double d;
-                if (seriesGetDouble(s, r, &d)) {
-                    sumVal += d;
-                }
-            }
+            const double* v = seriesDoubleData(s);
+            FOR_EACH_VALID_RUN(s, nRows, at, len, sumVal += dfReduceSumDouble(v + at, len),
+                               r, sumVal += v[r]);
         } break;
         /* ----------------------------------------
          * NEW: DF_DATETIME => treat epoch as double
          * ----------------------------------------*/
         case DF_DATETIME: {
-            for (size_t r = 0; r < nRows; r++) {
-                long long dtVal;
-                if (seriesGetDateTime(s, r, &dtVal)) {
-                    sumVal += (double)dtVal;
-                }
-            }
+            const long long* v = seriesDateTimeData(s);
+            FOR_EACH_VALID_RUN(s, nRows, at, len, sumVal += dfReduceSumInt64(v + at, len),
+                               r, sumVal += (double)v[r]);
         } break;
+        case DF_INT8:   SUM_TYPED(int8_t,   seriesInt8Data(s),   nRows, sumVal); break;
+        case DF_INT16:  SUM_TYPED(int16_t,  seriesInt16Data(s),  nRows, sumVal); break;
+        case DF_INT64:  SUM_TYPED(int64_t,  seriesInt64Data(s),  nRows, sumVal); break;
+        case DF_UINT8:  SUM_TYPED(uint8_t,  seriesUInt8Data(s),  nRows, sumVal); break;
+        case DF_UINT16: SUM_TYPED(uint16_t, seriesUInt16Data(s), nRows, sumVal); break;
+        case DF_UINT32: SUM_TYPED(uint32_t, seriesUInt32Data(s), nRows, sumVal); break;
+        case DF_UINT64: SUM_TYPED(uint64_t, seriesUInt64Data(s), nRows, sumVal); break;
+        case DF_FLOAT:  SUM_TYPED(float,    seriesFloatData(s),  nRows, sumVal); break;
         default:
             break;
     }
     return sumVal;
 }
 
+double dfSum_impl(const DataFrame* df, size_t colIndex)
+{
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+    const Series* col = df->ops->getSeries(df, colIndex);
+    if (!col) return 0.0;
+
+    double sumVal = 0.0;
+    for (size_t k = 0; k < seriesChunkCount(col); k++) {
+        sumVal += chunkSum(seriesChunk(col, k));
+    }
+    return sumVal;
+}
+
 /* -------------------------------------------------------------------------
- * MEAN
+ * MEAN (over non-null rows)
  * ------------------------------------------------------------------------- */
 
 double dfMean_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t n = seriesSize(s);
+    size_t n = seriesSize(s) - seriesNullCount(s);
     if (n == 0) return 0.0;
 
     double total = dfSum_impl(df, colIndex);
@@ -85,201 +199,243 @@ double dfMean_impl(const DataFrame* df, size_t colIndex)
 }
 
 /* -------------------------------------------------------------------------
- * MIN
+ * SUM / MEAN over a selection (row indices from filterSelection etc.)
  * ------------------------------------------------------------------------- */
-double dfMin_impl(const DataFrame* df, size_t colIndex)
+
+#define SUM_SELECTED(T, data)                                                \
+    do {                                                                     \
+        const T* v_ = (data);                                                \
+        for (size_t i_ = 0; i_ < n; i_++) {                                  \
+            size_t r_ = rows[i_];                                            \
+            if (r_ >= len || (hasNulls && seriesIsNull(s, r_))) continue;    \
+            sum += (double)v_[r_];                                           \
+            count++;                                                         \
+        }                                                                    \
+    } while (0)
+
+/*
+ * Sum of the non-null values at rows[0..n) of `s`; *outCount gets how many
+ * there were. Contiguous columns are read straight from their buffer,
+ * chunked ones cell by cell.
+ */
+static double selectionSum(const Series* s, const size_t* rows, size_t n, size_t* outCount)
 {
+    double sum = 0.0;
+    size_t count = 0;
+    size_t len = seriesSize(s);
+    bool hasNulls = seriesNullCount(s) > 0;
+
+    if (seriesIsChunked(s)) {
+        for (size_t i = 0; i < n; i++) {
+            double d;
+            if (seriesGetAsDouble(s, rows[i], &d)) {
+                sum += d;
+                count++;
+            }
+        }
+        *outCount = count;
+        return sum;
+    }
+
+    switch (s->type) {
+        case DF_INT:      SUM_SELECTED(int,       seriesIntData(s));      break;
+        case DF_DOUBLE:   SUM_SELECTED(double,    seriesDoubleData(s));   break;
+        case DF_DATETIME: SUM_SELECTED(long long, seriesDateTimeData(s)); break;
+        case DF_INT8:     SUM_SELECTED(int8_t,    seriesInt8Data(s));     break;
+        case DF_INT16:    SUM_SELECTED(int16_t,   seriesInt16Data(s));    break;
+        case DF_INT64:    SUM_SELECTED(int64_t,   seriesInt64Data(s));    break;
+        case DF_UINT8:    SUM_SELECTED(uint8_t,   seriesUInt8Data(s));    break;
+        case DF_UINT16:   SUM_SELECTED(uint16_t,  seriesUInt16Data(s));   break;
+        case DF_UINT32:   SUM_SELECTED(uint32_t,  seriesUInt32Data(s));   break;
+        case DF_UINT64:   SUM_SELECTED(uint64_t,  seriesUInt64Data(s));   break;
+        case DF_FLOAT:    SUM_SELECTED(float,     seriesFloatData(s));    break;
+        default:
+            break;
+    }
+    *outCount = count;
+    return sum;
+}
+
+double dfSumSelection_impl(const DataFrame* df, size_t colIndex, const DfSelection* sel)
+{
+    DF_OP_SCOPE();
+    if (!sel) return dfSum_impl(df, colIndex);
     if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t n = seriesSize(s);
-    if (n == 0) return 0.0;
+    size_t count = 0;
+    return selectionSum(s, sel->rows, sel->count, &count);
+}
+
+double dfMeanSelection_impl(const DataFrame* df, size_t colIndex, const DfSelection* sel)
+{
+    DF_OP_SCOPE();
+    if (!sel) return dfMean_impl(df, colIndex);
+    if (!df) return 0.0;
+    const Series* s = df->ops->getSeries(df, colIndex);
+    if (!s) return 0.0;
 
+    size_t count = 0;
+    double total = selectionSum(s, sel->rows, sel->count, &count);
+    return count ? total / (double)count : 0.0;
+}
+
+/* -------------------------------------------------------------------------
+ * MIN
+ * ------------------------------------------------------------------------- */
+/* Smallest non-null value of one contiguous chunk (which has one). */
+static double chunkMin(const Series* s)
+{
+    size_t n = seriesSize(s);
     double minVal = 0.0;
 
     switch (s->type) {
         case DF_INT: {
-            int tmp;
-            // initialize from row 0
-            if (!seriesGetInt(s, 0, &tmp)) {
-                return 0.0;
-            }
-            minVal = (double)tmp;
-            for (size_t r = 1; r < n; r++) {
-                if (seriesGetInt(s, r, &tmp)) {
-                    if (tmp < minVal) {
-                        minVal = (double)tmp;
-                    }
-                }
-            }
+            const int* v = seriesIntData(s);
+            int m = INT_MAX;
+            FOR_EACH_VALID_RUN(s, n, at, len,
+                { int k = dfReduceMinInt32(v + at, len); if (k < m) m = k; },
+                r, if (v[r] < m) m = v[r]);
+            minVal = (double)m;
         } break;
         case DF_DOUBLE: {
-            double d;
-            // initialize from row 0
-            if (!seriesGetDouble(s, 0, &d)) {
-                return 0.0;
-            }
-            minVal = d;
-            for (size_t r = 1; r < n; r++) {
-                if (seriesGetDouble(s, r, &d)) {
-                    if (d < minVal) {
-                        minVal = d;
-                    }
-                }
-            }
+            const double* v = seriesDoubleData(s);
+            minVal = INFINITY;
+            FOR_EACH_VALID_RUN(s, n, at, len,
+                { double k = dfReduceMinDouble(v + at, len); if (k < minVal) minVal = k; },
+                r, if (v[r] < minVal) minVal = v[r]);
         } break;
         /* -----------------------------------
          * NEW: DF_DATETIME => treat as double
          * -----------------------------------*/
         case DF_DATETIME: {
-            long long dtVal;
-            // init from row 0
-            if (!seriesGetDateTime(s, 0, &dtVal)) {
-                return 0.0;
-            }
-            double d = (double)dtVal;
-            minVal = d;
-            for (size_t r = 1; r < n; r++) {
-                if (seriesGetDateTime(s, r, &dtVal)) {
-                    d = (double)dtVal;
-                    if (d < minVal) {
-                        minVal = d;
-                    }
-                }
-            }
+            const long long* v = seriesDateTimeData(s);
+            long long m = LLONG_MAX;
+            FOR_EACH_VALID_RUN(s, n, at, len,
+                { long long k = dfReduceMinInt64(v + at, len); if (k < m) m = k; },
+                r, if (v[r] < m) m = v[r]);
+            minVal = (double)m;
         } break;
+        case DF_INT8:   EXTREME_TYPED(int8_t,   seriesInt8Data(s),   n, <, minVal); break;
+        case DF_INT16:  EXTREME_TYPED(int16_t,  seriesInt16Data(s),  n, <, minVal); break;
+        case DF_INT64:  EXTREME_TYPED(int64_t,  seriesInt64Data(s),  n, <, minVal); break;
+        case DF_UINT8:  EXTREME_TYPED(uint8_t,  seriesUInt8Data(s),  n, <, minVal); break;
+        case DF_UINT16: EXTREME_TYPED(uint16_t, seriesUInt16Data(s), n, <, minVal); break;
+        case DF_UINT32: EXTREME_TYPED(uint32_t, seriesUInt32Data(s), n, <, minVal); break;
+        case DF_UINT64: EXTREME_TYPED(uint64_t, seriesUInt64Data(s), n, <, minVal); break;
+        case DF_FLOAT:  EXTREME_TYPED(float,    seriesFloatData(s),  n, <, minVal); break;
         default:
             break;
     }
     return minVal;
 }
 
+double dfMin_impl(const DataFrame* df, size_t colIndex)
+{
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+    const Series* col = df->ops->getSeries(df, colIndex);
+    if (!col) return 0.0;
+
+    double minVal = 0.0;
+    bool first = true;
+    for (size_t k = 0; k < seriesChunkCount(col); k++) {
+        const Series* s = seriesChunk(col, k);
+        if (seriesSize(s) == seriesNullCount(s)) continue;
+        double m = chunkMin(s);
+        if (first || m < minVal) minVal = m;
+        first = false;
+    }
+    return minVal;
+}
+
 /* -------------------------------------------------------------------------
  * MAX
  * ------------------------------------------------------------------------- */
-double dfMax_impl(const DataFrame* df, size_t colIndex)
+/* Largest non-null value of one contiguous chunk (which has one). */
+static double chunkMax(const Series* s)
 {
-    if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
-    if (!s) return 0.0;
-
     size_t n = seriesSize(s);
-    if (n == 0) return 0.0;
-
     double maxVal = 0.0;
 
     switch (s->type) {
         case DF_INT: {
-            int tmp;
-            if (!seriesGetInt(s, 0, &tmp)) {
-                return 0.0;
-            }
-            maxVal = (double)tmp;
-            for (size_t r = 1; r < n; r++) {
-                if (seriesGetInt(s, r, &tmp)) {
-                    if (tmp > maxVal) {
-                        maxVal = (double)tmp;
-                    }
-                }
-            }
+            const int* v = seriesIntData(s);
+            int m = INT_MIN;
+            FOR_EACH_VALID_RUN(s, n, at, len,
+                { int k = dfReduceMaxInt32(v + at, len); if (k > m) m = k; },
+                r, if (v[r] > m) m = v[r]);
+            maxVal = (double)m;
         } break;
         case DF_DOUBLE: {
-            double d;
-            if (!seriesGetDouble(s, 0, &d)) {
-                return 0.0;
-            }
-            maxVal = d;
-            for (size_t r = 1; r < n; r++) {
-                if (seriesGetDouble(s, r, &d)) {
-                    if (d > maxVal) {
-                        maxVal = d;
-                    }
-                }
-            }
+            const double* v = seriesDoubleData(s);
+            maxVal = -INFINITY;
+            FOR_EACH_VALID_RUN(s, n, at, len,
+                { double k = dfReduceMaxDouble(v + at, len); if (k > maxVal) maxVal = k; },
+                r, if (v[r] > maxVal) maxVal = v[r]);
         } break;
         /* --------------------------------
          * NEW: DF_DATETIME => treat numeric
          * --------------------------------*/
         case DF_DATETIME: {
-            long long dtVal;
-            if (!seriesGetDateTime(s, 0, &dtVal)) {
-                return 0.0;
-            }
-            double d = (double)dtVal;
-            maxVal = d;
-            for (size_t r = 1; r < n; r++) {
-                if (seriesGetDateTime(s, r, &dtVal)) {
-                    d = (double)dtVal;
-                    if (d > maxVal) {
-                        maxVal = d;
-                    }
-                }
-            }
+            const long long* v = seriesDateTimeData(s);
+            long long m = LLONG_MIN;
+            FOR_EACH_VALID_RUN(s, n, at, len,
+                { long long k = dfReduceMaxInt64(v + at, len); if (k > m) m = k; },
+                r, if (v[r] > m) m = v[r]);
+            maxVal = (double)m;
         } break;
+        case DF_INT8:   EXTREME_TYPED(int8_t,   seriesInt8Data(s),   n, >, maxVal); break;
+        case DF_INT16:  EXTREME_TYPED(int16_t,  seriesInt16Data(s),  n, >, maxVal); break;
+        case DF_INT64:  EXTREME_TYPED(int64_t,  seriesInt64Data(s),  n, >, maxVal); break;
+        case DF_UINT8:  EXTREME_TYPED(uint8_t,  seriesUInt8Data(s),  n, >, maxVal); break;
+        case DF_UINT16: EXTREME_TYPED(uint16_t, seriesUInt16Data(s), n, >, maxVal); break;
+        case DF_UINT32: EXTREME_TYPED(uint32_t, seriesUInt32Data(s), n, >, maxVal); break;
+        case DF_UINT64: EXTREME_TYPED(uint64_t, seriesUInt64Data(s), n, >, maxVal); break;
+        case DF_FLOAT:  EXTREME_TYPED(float,    seriesFloatData(s),  n, >, maxVal); break;
         default:
             break;
     }
     return maxVal;
 }
 
+double dfMax_impl(const DataFrame* df, size_t colIndex)
+{
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+    const Series* col = df->ops->getSeries(df, colIndex);
+    if (!col) return 0.0;
+
+    double maxVal = 0.0;
+    bool first = true;
+    for (size_t k = 0; k < seriesChunkCount(col); k++) {
+        const Series* s = seriesChunk(col, k);
+        if (seriesSize(s) == seriesNullCount(s)) continue;
+        double m = chunkMax(s);
+        if (first || m > maxVal) maxVal = m;
+        first = false;
+    }
+    return maxVal;
+}
+
 
 
 /* -------------------------------------------------------------------------
- * COUNT
+ * COUNT (non-null rows)
  * ------------------------------------------------------------------------- */
 
- double dfCount_impl(const DataFrame* df, size_t colIndex)
- {
-     if (!df) return 0.0;
- 
-     const Series* s = df->getSeries(df, colIndex);
-     if (!s) return 0.0;
- 
-     size_t nRows = seriesSize(s);
-     double countVal = 0.0;
- 
-     switch (s->type) {
-         case DF_INT: {
-             for (size_t i = 0; i < nRows; i++) {
-                 int val;
-                 if (seriesGetInt(s, i, &val)) {
-                     countVal += 1.0;
-                 }
-             }
-         } break;
-         case DF_DOUBLE: {
-             for (size_t i = 0; i < nRows; i++) {
-                 double val;
-                 if (seriesGetDouble(s, i, &val)) {
-                     countVal += 1.0;
-                 }
-             }
-         } break;
-         case DF_DATETIME: {
-             for (size_t i = 0; i < nRows; i++) {
-                 long long val;
-                 if (seriesGetDateTime(s, i, &val)) {
-                     countVal += 1.0;
-                 }
-             }
-         } break;
-         case DF_STRING: {
-             for (size_t i = 0; i < nRows; i++) {
-                 char* tmp = NULL;
-                 if (seriesGetString(s, i, &tmp)) {
-                     // If you consider empty string as valid, just increment.
-                     // If you want to consider it "null", check `tmp[0] != '\0'`.
-                     countVal += 1.0;
-                     free(tmp);
-                 }
-             }
-         } break;
-     }
- 
-     return countVal;
- }
- 
+double dfCount_impl(const DataFrame* df, size_t colIndex)
+{
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+
+    const Series* s = df->ops->getSeries(df, colIndex);
+    if (!s) return 0.0;
+
+    return (double)(seriesSize(s) - seriesNullCount(s));
+}
+
 
 /* -------------------------------------------------------------------------
  * MEDIAN
@@ -287,64 +443,26 @@ double dfMax_impl(const DataFrame* df, size_t colIndex)
 
 double dfMedian_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) return 0.0;
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t n = seriesSize(s);
-    if (n == 0) return 0.0;
-
-    // Collect numeric values in a temp array
-    double* values = (double*)malloc(n * sizeof(double));
-    if (!values) return 0.0;
-
     size_t count = 0;
-    for (size_t i = 0; i < n; i++) {
-        double dVal = 0.0;
-        bool ok = false;
-        switch (s->type) {
-            case DF_INT: {
-                int tmp;
-                ok = seriesGetInt(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            case DF_DOUBLE: {
-                double tmp;
-                ok = seriesGetDouble(s, i, &tmp);
-                if (ok) dVal = tmp;
-            } break;
-            case DF_DATETIME: {
-                long long tmp;
-                ok = seriesGetDateTime(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            case DF_STRING:
-            default:
-                // no numeric extraction for strings
-                ok = false;
-                break;
-        }
-        if (ok) {
-            values[count++] = dVal;
-        }
-    }
-
-    if (count == 0) {
-        free(values);
-        return 0.0; // no numeric data
-    }
-
-    // sort the portion we filled
-    qsort(values, count, sizeof(double), compareDoubles);
+    double* values = dfSeriesValues(s, &count);
+    if (!values) return 0.0; // no numeric data
 
+    // select the middle rank(s) instead of sorting
     double median = 0.0;
+    size_t mid = count / 2;
     if (count % 2 == 1) {
         // odd
-        median = values[count / 2];
+        median = dfSelectInPlace(values, count, mid);
     } else {
         // even
-        size_t mid = count / 2;
+        size_t ranks[2] = { mid - 1, mid };
+        dfSelectRanksInPlace(values, count, ranks, 2);
         median = (values[mid - 1] + values[mid]) / 2.0;
     }
 
@@ -365,8 +483,9 @@ typedef struct {
 
 double dfMode_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
     size_t n = seriesSize(s);
@@ -397,7 +516,8 @@ double dfMode_impl(const DataFrame* df, size_t colIndex)
                 if (ok) dVal = (double)tmp;
             } break;
             default:
-                // DF_STRING or unknown => skip
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                ok = seriesGetAsDouble(s, i, &dVal);
                 break;
         }
         if (ok) {
@@ -449,7 +569,7 @@ double dfMode_impl(const DataFrame* df, size_t colIndex)
  double dfVar_impl(const DataFrame* df, size_t colIndex)
  {
      if (!df) return 0.0;
-     const Series* s = df->getSeries(df, colIndex);
+     const Series* s = df->ops->getSeries(df, colIndex);
      if (!s) return 0.0;
  
      size_t nRows = seriesSize(s);
@@ -483,6 +603,8 @@ double dfMode_impl(const DataFrame* df, size_t colIndex)
                  if (ok) dVal = (double)tmp;
              } break;
              default:
+                 // other numeric types; false for DF_STRING / DF_CATEGORY
+                 ok = seriesGetAsDouble(s, i, &dVal);
                  break;
          }
          if (ok) {
@@ -521,9 +643,10 @@ double dfMode_impl(const DataFrame* df, size_t colIndex)
  * ------------------------------------------------------------------------- */
 double dfRange_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
 
-    double maxV = df->max(df, colIndex);
-    double minV = df->min(df, colIndex);
+    double maxV = df->ops->max(df, colIndex);
+    double minV = df->ops->min(df, colIndex);
     return (maxV - minV);
 }
 
@@ -534,73 +657,50 @@ double dfRange_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 double dfQuantile_impl(const DataFrame* df, size_t colIndex, double q)
 {
+    DF_OP_SCOPE();
     if (!df) return 0.0;
-    if (q < 0.0) q = 0.0;
-    if (q > 1.0) q = 1.0;
+    double result = 0.0;
+    df->ops->quantiles(df, colIndex, &q, 1, &result);
+    return result;
+}
 
-    const Series* s = df->getSeries(df, colIndex);
+/* -------------------------------------------------------------------------
+* APPROXIMATE QUANTILE (t-digest sketch; see dfsketch.h)
+* ------------------------------------------------------------------------- */
+double dfApproxQuantile_impl(const DataFrame* df, size_t colIndex, double q, double errorBound)
+{
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t n = seriesSize(s);
-    if (n == 0) return 0.0;
-
-    double* arr = (double*)malloc(n * sizeof(double));
-    if (!arr) return 0.0;
-
-    // gather
-    size_t count = 0;
-    for (size_t i = 0; i < n; i++) {
-        double dVal;
-        bool ok = false;
-        switch (s->type) {
-            case DF_INT: {
-                int tmp;
-                ok = seriesGetInt(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            case DF_DOUBLE: {
-                double tmp;
-                ok = seriesGetDouble(s, i, &tmp);
-                if (ok) dVal = tmp;
-            } break;
-            case DF_DATETIME: {
-                long long tmp;
-                ok = seriesGetDateTime(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            default:
-                break;
-        }
-        if (ok) {
-            arr[count++] = dVal;
-        }
-    }
-
-    if (count == 0) {
-        free(arr);
-        return 0.0;
-    }
+    DfQuantileSketch sk;
+    if (!dfSketchInit(&sk, errorBound)) return 0.0;
+    double result = dfSketchAddSeries(&sk, s, 0) ? dfSketchQuantile(&sk, q) : 0.0;
+    dfSketchFree(&sk);
+    return result;
+}
 
-    // sort
-    qsort(arr, count, sizeof(double), compareDoubles);
+/* -------------------------------------------------------------------------
+* QUANTILES (several q at once)
+* ------------------------------------------------------------------------- */
+bool dfQuantiles_impl(const DataFrame* df, size_t colIndex, const double* qs, size_t nq, double* out)
+{
+    DF_OP_SCOPE();
+    if (!df || (nq && (!qs || !out))) return false;
+    for (size_t k = 0; k < nq; k++) out[k] = 0.0;
 
-    // position
-    double pos = q * (count - 1);
-    size_t idxBelow = (size_t)floor(pos);
-    size_t idxAbove = (size_t)ceil(pos);
+    const Series* s = df->ops->getSeries(df, colIndex);
+    if (!s) return false;
 
-    double result = 0.0;
-    if (idxBelow == idxAbove) {
-        // no interpolation needed
-        result = arr[idxBelow];
-    } else {
-        // linear interpolation
-        double fraction = pos - (double)idxBelow;
-        result = arr[idxBelow] + fraction * (arr[idxAbove] - arr[idxBelow]);
-    }
+    size_t count = 0;
+    double* values = dfSeriesValues(s, &count);
+    if (!values) return false;
 
-    free(arr);
-    return result;
+    // one partial partitioning serves every q
+    bool ok = dfQuantilesInPlace(values, count, qs, nq, out);
+    free(values);
+    return ok;
 }
 
 
@@ -609,9 +709,12 @@ double dfQuantile_impl(const DataFrame* df, size_t colIndex, double q)
 * ------------------------------------------------------------------------- */
 double dfIQR_impl(const DataFrame* df, size_t colIndex)
 {
-    double q1 = df->quantile(df, colIndex, 0.25);
-    double q3 = df->quantile(df, colIndex, 0.75);
-    return (q3 - q1);
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+    static const double qs[2] = { 0.25, 0.75 };
+    double q[2] = { 0.0, 0.0 };
+    df->ops->quantiles(df, colIndex, qs, 2, q);
+    return (q[1] - q[0]);
 }
 
 
@@ -622,50 +725,13 @@ double dfIQR_impl(const DataFrame* df, size_t colIndex)
 
 double dfNullCount_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t nRows = seriesSize(s);
-    double nullCount = 0.0;
-
-    switch (s->type) {
-        case DF_INT: {
-            for (size_t i = 0; i < nRows; i++) {
-                int tmp;
-                if (!seriesGetInt(s, i, &tmp)) {
-                    nullCount += 1.0;
-                }
-            }
-        } break;
-        case DF_DOUBLE: {
-            for (size_t i = 0; i < nRows; i++) {
-                double d;
-                if (!seriesGetDouble(s, i, &d)) {
-                    nullCount += 1.0;
-                }
-            }
-        } break;
-        case DF_DATETIME: {
-            for (size_t i = 0; i < nRows; i++) {
-                long long dt;
-                if (!seriesGetDateTime(s, i, &dt)) {
-                    nullCount += 1.0;
-                }
-            }
-        } break;
-        case DF_STRING: {
-            for (size_t i = 0; i < nRows; i++) {
-                char* tmp = NULL;
-                if (!seriesGetString(s, i, &tmp)) {
-                    nullCount += 1.0;
-                } else {
-                    free(tmp);
-                }
-            }
-        } break;
-    }
-    return nullCount;
+    // maintained by the Series as rows are added / nulled / set
+    return (double)seriesNullCount(s);
 }
 
 
@@ -681,22 +747,33 @@ double dfNullCount_impl(const DataFrame* df, size_t colIndex)
 
 double dfUniqueCount_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) return 0.0;
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
     size_t nRows = seriesSize(s);
     // We'll store values in memory (like we do in median)
     // but for strings, we store them separately.
 
+    // DF_CATEGORY => distinct codes actually used by this column
+    if (s->type == DF_CATEGORY) {
+        uint32_t* order = NULL;
+        size_t distinct = 0;
+        size_t* counts = countCategoryCodes(s, NULL, nRows, &order, &distinct);
+        free(counts);
+        free(order);
+        return (double)distinct;
+    }
+
     // For simplicity, handle numeric vs string separately:
     if (s->type == DF_STRING) {
-        // gather all strings in a temporary array
-        char** strArr = (char**)malloc(nRows * sizeof(char*));
+        // gather borrowed views of all strings in a temporary array
+        const char** strArr = (const char**)malloc(nRows * sizeof(char*));
         size_t count = 0;
         for (size_t i = 0; i < nRows; i++) {
-            char* tmp = NULL;
-            if (seriesGetString(s, i, &tmp) && tmp) {
+            const char* tmp = NULL;
+            if (seriesGetStringView(s, i, &tmp, NULL)) {
                 strArr[count++] = tmp; 
             }
         }
@@ -714,10 +791,7 @@ double dfUniqueCount_impl(const DataFrame* df, size_t colIndex)
                 uniqueCount++;
             }
         }
-        // free them
-        for (size_t i = 0; i < count; i++) {
-            free(strArr[i]);
-        }
+        // the views point into the Series => only the array is ours
         free(strArr);
         return (double)uniqueCount;
     } else {
@@ -744,6 +818,8 @@ double dfUniqueCount_impl(const DataFrame* df, size_t colIndex)
                     if (ok) dVal = (double)tmp;
                 } break;
                 default:
+                    // other numeric types; false for DF_STRING / DF_CATEGORY
+                    ok = seriesGetAsDouble(s, i, &dVal);
                     break;
             }
             if (ok) {
@@ -772,49 +848,80 @@ double dfUniqueCount_impl(const DataFrame* df, size_t colIndex)
 
 
 /* -------------------------------------------------------------------------
-* PRODUCT
+* APPROX UNIQUE COUNT (HyperLogLog, one pass over the typed buffers)
 * ------------------------------------------------------------------------- */
-double dfProduct_impl(const DataFrame* df, size_t colIndex)
+double dfApproxUniqueCount_impl(const DataFrame* df, size_t colIndex, int precision)
 {
-    if (!df) return 1.0; // if invalid df, return identity (1)
-    const Series* s = df->getSeries(df, colIndex);
-    if (!s) return 1.0;
+    DF_OP_SCOPE();
+    if (!df) return 0.0;
+    const Series* s = df->ops->getSeries(df, colIndex);
+    if (!s) return 0.0;
+
+    DfHyperLogLog hll;
+    if (!dfHllInit(&hll, precision)) return 0.0;
+    double result = dfHllAddSeries(&hll, s, 0) ? dfHllEstimate(&hll) : 0.0;
+    dfHllFree(&hll);
+    return result;
+}
 
-    size_t n = seriesSize(s);
-    if (n == 0) return 1.0;
 
+/* -------------------------------------------------------------------------
+* PRODUCT
+* ------------------------------------------------------------------------- */
+#define PRODUCT_TYPED(T, data, n, acc)                                       \
+    do {                                                                     \
+        const T* v_ = (data);                                                \
+        FOR_EACH_VALID_ROW(s, n, r, acc *= (double)v_[r]);                   \
+    } while (0)
+
+/* Product of the non-null values of one contiguous chunk. */
+static double chunkProduct(const Series* s)
+{
     double product = 1.0;
+    size_t n = seriesSize(s);
 
     switch (s->type) {
         case DF_INT: {
-            for (size_t i = 0; i < n; i++) {
-                int tmp;
-                if (seriesGetInt(s, i, &tmp)) {
-                    product *= (double)tmp;
-                }
-            }
+            const int* v = seriesIntData(s);
+            FOR_EACH_VALID_RUN(s, n, at, len, product *= dfReduceProductInt32(v + at, len),
+                               r, product *= (double)v[r]);
         } break;
         case DF_DOUBLE: {
-            for (size_t i = 0; i < n; i++) {
-                double d;
-                if (seriesGetDouble(s, i, &d)) {
-                    product *= d;
-                }
-            }
+            const double* v = seriesDoubleData(s);
+            FOR_EACH_VALID_RUN(s, n, at, len, product *= dfReduceProductDouble(v + at, len),
+                               r, product *= v[r]);
         } break;
         case DF_DATETIME: {
-            for (size_t i = 0; i < n; i++) {
-                long long dt;
-                if (seriesGetDateTime(s, i, &dt)) {
-                    product *= (double)dt;
-                }
-            }
+            const long long* v = seriesDateTimeData(s);
+            FOR_EACH_VALID_RUN(s, n, at, len, product *= dfReduceProductInt64(v + at, len),
+                               r, product *= (double)v[r]);
         } break;
+        case DF_INT8:   PRODUCT_TYPED(int8_t,   seriesInt8Data(s),   n, product); break;
+        case DF_INT16:  PRODUCT_TYPED(int16_t,  seriesInt16Data(s),  n, product); break;
+        case DF_INT64:  PRODUCT_TYPED(int64_t,  seriesInt64Data(s),  n, product); break;
+        case DF_UINT8:  PRODUCT_TYPED(uint8_t,  seriesUInt8Data(s),  n, product); break;
+        case DF_UINT16: PRODUCT_TYPED(uint16_t, seriesUInt16Data(s), n, product); break;
+        case DF_UINT32: PRODUCT_TYPED(uint32_t, seriesUInt32Data(s), n, product); break;
+        case DF_UINT64: PRODUCT_TYPED(uint64_t, seriesUInt64Data(s), n, product); break;
+        case DF_FLOAT:  PRODUCT_TYPED(float,    seriesFloatData(s),  n, product); break;
         default:
-            // DF_STRING => skip
+            // DF_STRING / DF_CATEGORY read nothing
             break;
     }
+    return product;
+}
+
+double dfProduct_impl(const DataFrame* df, size_t colIndex)
+{
+    DF_OP_SCOPE();
+    if (!df) return 1.0; // if invalid df, return identity (1)
+    const Series* col = df->ops->getSeries(df, colIndex);
+    if (!col) return 1.0;
 
+    double product = 1.0;
+    for (size_t k = 0; k < seriesChunkCount(col); k++) {
+        product *= chunkProduct(seriesChunk(col, k));
+    }
     return product;
 }
 
@@ -822,77 +929,21 @@ double dfProduct_impl(const DataFrame* df, size_t colIndex)
 * Nth LARGEST/SMALLEST
 * ------------------------------------------------------------------------- */
 
-
-// comparator for descending order
-static int compareDoublesDescending(const void* a, const void* b)
-{
-    double da = *(const double*)a;
-    double db = *(const double*)b;
-    if (da > db) return -1;  // larger first
-    if (da < db) return 1;
-    return 0;
-}
-
 double dfNthLargest_impl(const DataFrame* df, size_t colIndex, size_t n)
 {
+    DF_OP_SCOPE();
     // Basic validations
     if (!df || n == 0) {
         // n=0 is invalid if we treat n as 1-based
         return 0.0;
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t nRows = seriesSize(s);
-    if (nRows == 0) return 0.0;
-
-    // Allocate an array for numeric data
-    double* arr = (double*)malloc(nRows * sizeof(double));
-    if (!arr) {
-        // out of memory
-        return 0.0;
-    }
-
-    // Gather numeric values
     size_t count = 0;
-    for (size_t i = 0; i < nRows; i++) {
-        bool ok = false;
-        double dVal = 0.0;
-
-        switch (s->type) {
-            case DF_INT: {
-                int tmp;
-                ok = seriesGetInt(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            case DF_DOUBLE: {
-                double tmp;
-                ok = seriesGetDouble(s, i, &tmp);
-                if (ok) dVal = tmp;
-            } break;
-            case DF_DATETIME: {
-                long long tmp;
-                ok = seriesGetDateTime(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            default:
-                // DF_STRING or unknown => skip
-                break;
-        }
-        if (ok) {
-            arr[count++] = dVal;
-        }
-    }
-
-    if (count == 0) {
-        // no numeric data
-        free(arr);
-        return 0.0;
-    }
-
-    // Sort in descending order
-    qsort(arr, count, sizeof(double), compareDoublesDescending);
+    double* arr = dfSeriesValues(s, &count);
+    if (!arr) return 0.0;
 
     // If n > count => out of range
     if (n > count) {
@@ -900,75 +951,33 @@ double dfNthLargest_impl(const DataFrame* df, size_t colIndex, size_t n)
         return 0.0;
     }
 
-    // nth largest => arr[n-1], because array is sorted desc
-    double result = arr[n - 1];
+    // nth largest => rank count-n in ascending order
+    double result = dfSelectInPlace(arr, count, count - n);
     free(arr);
     return result;
 }
 
 double dfNthSmallest_impl(const DataFrame* df, size_t colIndex, size_t n)
 {
+    DF_OP_SCOPE();
     if (!df || n == 0) {
         return 0.0;
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return 0.0;
 
-    size_t nRows = seriesSize(s);
-    if (nRows == 0) return 0.0;
-
-    double* arr = (double*)malloc(nRows * sizeof(double));
-    if (!arr) {
-        return 0.0;
-    }
-
     size_t count = 0;
-    for (size_t i = 0; i < nRows; i++) {
-        bool ok = false;
-        double dVal = 0.0;
-        switch (s->type) {
-            case DF_INT: {
-                int tmp;
-                ok = seriesGetInt(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            case DF_DOUBLE: {
-                double tmp;
-                ok = seriesGetDouble(s, i, &tmp);
-                if (ok) dVal = tmp;
-            } break;
-            case DF_DATETIME: {
-                long long tmp;
-                ok = seriesGetDateTime(s, i, &tmp);
-                if (ok) dVal = (double)tmp;
-            } break;
-            default:
-                // DF_STRING => skip
-                break;
-        }
-        if (ok) {
-            arr[count++] = dVal;
-        }
-    }
-
-    if (count == 0) {
-        free(arr);
-        return 0.0;
-    }
-
-    // Sort ascending
-    extern int compareDoubles(const void*, const void*); 
-    // (define above or inline)
-    qsort(arr, count, sizeof(double), compareDoubles);
+    double* arr = dfSeriesValues(s, &count);
+    if (!arr) return 0.0;
 
     if (n > count) {
         free(arr);
         return 0.0;
     }
 
-    // nth smallest => arr[n-1] in ascending array
-    double result = arr[n - 1];
+    // nth smallest => rank n-1
+    double result = dfSelectInPlace(arr, count, n - 1);
     free(arr);
     return result;
 }
@@ -980,13 +989,14 @@ double dfNthSmallest_impl(const DataFrame* df, size_t colIndex, size_t n)
 * ------------------------------------------------------------------------- */
 double dfSkewness_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) {
         // Invalid DataFrame pointer
         return 0.0;
     }
 
     // 1) Retrieve the column
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         // Invalid colIndex or no series
         return 0.0;
@@ -1029,7 +1039,8 @@ double dfSkewness_impl(const DataFrame* df, size_t colIndex)
                 if (ok) dVal = (double)tmp;
             } break;
             default:
-                // DF_STRING or unknown => skip
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                ok = seriesGetAsDouble(s, i, &dVal);
                 break;
         }
         if (ok) {
@@ -1093,13 +1104,14 @@ double dfSkewness_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 double dfKurtosis_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     if (!df) {
         // invalid DataFrame pointer
         return 0.0;
     }
 
     // 1) Retrieve the column
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         // invalid colIndex or no series
         return 0.0;
@@ -1141,7 +1153,8 @@ double dfKurtosis_impl(const DataFrame* df, size_t colIndex)
                 if (ok) dVal = (double)tmp;
             } break;
             default:
-                // DF_STRING => skip
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                ok = seriesGetAsDouble(s, i, &dVal);
                 break;
         }
         if (ok) {
@@ -1200,20 +1213,21 @@ double dfKurtosis_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 double dfCovariance_impl(const DataFrame* df, size_t colIndex1, size_t colIndex2)
 {
+    DF_OP_SCOPE();
     // 1) Validate inputs
     if (!df) {
         return 0.0;
     }
 
-    const Series* s1 = df->getSeries(df, colIndex1);
-    const Series* s2 = df->getSeries(df, colIndex2);
+    const Series* s1 = df->ops->getSeries(df, colIndex1);
+    const Series* s2 = df->ops->getSeries(df, colIndex2);
     if (!s1 || !s2) {
         // Invalid column indices or no series
         return 0.0;
     }
 
     // 2) Determine row count
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (nRows < 2) {
         // Need at least 2 points to compute sample covariance
         return 0.0;
@@ -1256,7 +1270,8 @@ double dfCovariance_impl(const DataFrame* df, size_t colIndex1, size_t colIndex2
                 if (ok1) dx = (double)tmp;
             } break;
             default:
-                // DF_STRING or unknown => skip
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                ok1 = seriesGetAsDouble(s1, i, &dx);
                 break;
         }
 
@@ -1278,6 +1293,8 @@ double dfCovariance_impl(const DataFrame* df, size_t colIndex1, size_t colIndex2
                 if (ok2) dy = (double)tmp;
             } break;
             default:
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                ok2 = seriesGetAsDouble(s2, i, &dy);
                 break;
         }
 
@@ -1329,19 +1346,20 @@ double dfCovariance_impl(const DataFrame* df, size_t colIndex1, size_t colIndex2
 * ------------------------------------------------------------------------- */
 double dfCorrelation_impl(const DataFrame* df, size_t colIndexX, size_t colIndexY)
 {
+    DF_OP_SCOPE();
     // Basic validations
     if (!df) return 0.0;
 
 
 
-    double cov = df->covariance(df, colIndexX, colIndexY);
+    double cov = df->ops->covariance(df, colIndexX, colIndexY);
     if (cov == 0.0) {
         // Either no data, or actual covariance=0 => correlation=0
         return 0.0;
     }
 
-    double stdX = df->std(df, colIndexX);
-    double stdY = df->std(df, colIndexY);
+    double stdX = df->ops->std(df, colIndexX);
+    double stdY = df->ops->std(df, colIndexY);
 
     // If either column has zero variance => correlation is undefined => return 0.0
     if (stdX == 0.0 || stdY == 0.0) {
@@ -1356,6 +1374,7 @@ double dfCorrelation_impl(const DataFrame* df, size_t colIndexX, size_t colIndex
 * ------------------------------------------------------------------------- */
 DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame to return on failure or if no data
     DataFrame result;
     DataFrame_Create(&result);
@@ -1365,13 +1384,13 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
         return result; // empty
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         // invalid column index
         return result;
     }
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (nRows == 0) {
         // no data
         return result;
@@ -1412,8 +1431,7 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
             }
 
             // Add to result DataFrame
-            result.addSeries(&result, &outS);
-            seriesFree(&outS);
+            result.ops->addSeriesMove(&result, &outS);
             free(values);
         } break;
 
@@ -1446,8 +1464,7 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
                 seriesAddDouble(&outS, values[i]);
             }
 
-            result.addSeries(&result, &outS);
-            seriesFree(&outS);
+            result.ops->addSeriesMove(&result, &outS);
             free(values);
         } break;
 
@@ -1480,20 +1497,20 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
                 seriesAddDateTime(&outS, values[i]);
             }
 
-            result.addSeries(&result, &outS);
-            seriesFree(&outS);
+            result.ops->addSeriesMove(&result, &outS);
             free(values);
         } break;
 
-        case DF_STRING: {
-            // We'll gather distinct strings
-            // We must store them separately to compare content
-            char** values = (char**)malloc(nRows * sizeof(char*));
+        case DF_STRING:
+        case DF_CATEGORY: {
+            // We'll gather distinct strings as borrowed views
+            // (they point into the column's byte arena, no copies)
+            const char** values = (const char**)malloc(nRows * sizeof(char*));
             size_t count = 0;
 
             for (size_t r = 0; r < nRows; r++) {
-                char* strVal = NULL;
-                if (seriesGetString(s, r, &strVal) && strVal) {
+                const char* strVal = NULL;
+                if (seriesGetStringView(s, r, &strVal, NULL)) {
                     // check duplicates
                     bool found = false;
                     for (size_t i = 0; i < count; i++) {
@@ -1504,8 +1521,6 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
                     }
                     if (!found) {
                         values[count++] = strVal; // keep it
-                    } else {
-                        free(strVal); // discard
                     }
                 }
             }
@@ -1516,13 +1531,40 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
 
             for (size_t i = 0; i < count; i++) {
                 seriesAddString(&outS, values[i]);
-                free(values[i]); // seriesAddString copies, so free
             }
-            result.addSeries(&result, &outS);
-            seriesFree(&outS);
+            result.ops->addSeriesMove(&result, &outS);
 
             free(values);
         } break;
+
+        default: {
+            // fixed-width types: remember the first row of each distinct
+            // value and copy those rows, so "unique" keeps the column's type
+            size_t* firstRows = (size_t*)malloc(nRows * sizeof(size_t));
+            size_t count = 0;
+
+            for (size_t r = 0; r < nRows; r++) {
+                if (seriesIsNull(s, r)) continue;
+                bool found = false;
+                for (size_t i = 0; i < count; i++) {
+                    if (seriesCompareRows(s, firstRows[i], r) == 0) {
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    firstRows[count++] = r;
+                }
+            }
+
+            Series outS;
+            seriesInit(&outS, "unique", s->type);
+            for (size_t i = 0; i < count; i++) {
+                seriesAppendFrom(&outS, s, firstRows[i]);
+            }
+            result.ops->addSeriesMove(&result, &outS);
+            free(firstRows);
+        } break;
     }
 
     return result;
@@ -1532,6 +1574,7 @@ DataFrame dfUniqueValues_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame to return if anything fails
     DataFrame result;
     DataFrame_Create(&result);
@@ -1541,13 +1584,13 @@ DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
         return result;
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         // invalid column
         return result;
     }
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (nRows == 0) {
         // no data
         return result;
@@ -1594,11 +1637,9 @@ DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
                 seriesAddInt(&cntSeries, counts[i]);
             }
 
-            result.addSeries(&result, &valSeries);
-            result.addSeries(&result, &cntSeries);
+            result.ops->addSeriesMove(&result, &valSeries);
+            result.ops->addSeriesMove(&result, &cntSeries);
 
-            seriesFree(&valSeries);
-            seriesFree(&cntSeries);
 
             free(values);
             free(counts);
@@ -1638,11 +1679,9 @@ DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
                 seriesAddInt(&cntSeries, counts[i]);
             }
 
-            result.addSeries(&result, &valSeries);
-            result.addSeries(&result, &cntSeries);
+            result.ops->addSeriesMove(&result, &valSeries);
+            result.ops->addSeriesMove(&result, &cntSeries);
 
-            seriesFree(&valSeries);
-            seriesFree(&cntSeries);
 
             free(vals);
             free(counts);
@@ -1683,31 +1722,53 @@ DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
                 seriesAddInt(&cntSeries, counts[i]);
             }
 
-            result.addSeries(&result, &valSeries);
-            result.addSeries(&result, &cntSeries);
+            result.ops->addSeriesMove(&result, &valSeries);
+            result.ops->addSeriesMove(&result, &cntSeries);
 
-            seriesFree(&valSeries);
-            seriesFree(&cntSeries);
 
             free(values);
             free(counts);
         } break;
 
+        case DF_CATEGORY: {
+            // Count per dictionary code => no string compares at all
+            uint32_t* order = NULL;
+            size_t distinctCount = 0;
+            size_t* counts = countCategoryCodes(s, NULL, nRows, &order, &distinctCount);
+
+            // Build "value" (DF_STRING labels), "count" (DF_INT)
+            Series valSeries, cntSeries;
+            seriesInit(&valSeries, "value", DF_STRING);
+            seriesInit(&cntSeries, "count", DF_INT);
+
+            for (size_t i = 0; i < distinctCount; i++) {
+                const char* label = NULL;
+                seriesCategoryLabel(s, order[i], &label, NULL);
+                seriesAddString(&valSeries, label);
+                seriesAddInt(&cntSeries, (int)counts[order[i]]);
+            }
+            result.ops->addSeriesMove(&result, &valSeries);
+            result.ops->addSeriesMove(&result, &cntSeries);
+
+
+            free(order);
+            free(counts);
+        } break;
+
         case DF_STRING: {
-            // We'll store distinct strings + frequency
-            char** strArr = (char**)malloc(nRows * sizeof(char*));
+            // We'll store distinct strings (borrowed views) + frequency
+            const char** strArr = (const char**)malloc(nRows * sizeof(char*));
             int*   counts = (int*)calloc(nRows, sizeof(int));
             size_t distinctCount = 0;
 
             for (size_t r = 0; r < nRows; r++) {
-                char* strVal = NULL;
-                if (seriesGetString(s, r, &strVal) && strVal) {
+                const char* strVal = NULL;
+                if (seriesGetStringView(s, r, &strVal, NULL)) {
                     bool found = false;
                     for (size_t i = 0; i < distinctCount; i++) {
                         if (strcmp(strArr[i], strVal) == 0) {
                             counts[i]++;
                             found = true;
-                            free(strVal); // not storing a new copy
                             break;
                         }
                     }
@@ -1727,17 +1788,53 @@ DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
             for (size_t i = 0; i < distinctCount; i++) {
                 seriesAddString(&valSeries, strArr[i]);
                 seriesAddInt(&cntSeries, counts[i]);
-                free(strArr[i]); // seriesAddString copies, so safe to free
             }
-            result.addSeries(&result, &valSeries);
-            result.addSeries(&result, &cntSeries);
+            result.ops->addSeriesMove(&result, &valSeries);
+            result.ops->addSeriesMove(&result, &cntSeries);
 
-            seriesFree(&valSeries);
-            seriesFree(&cntSeries);
 
             free(strArr);
             free(counts);
         } break;
+
+        default: {
+            // fixed-width types: compare rows in the column's own type and
+            // copy the first row of each value, so "value" keeps that type
+            size_t* firstRows = (size_t*)malloc(nRows * sizeof(size_t));
+            int*    counts = (int*)calloc(nRows, sizeof(int));
+            size_t distinctCount = 0;
+
+            for (size_t r = 0; r < nRows; r++) {
+                if (seriesIsNull(s, r)) continue;
+                bool found = false;
+                for (size_t i = 0; i < distinctCount; i++) {
+                    if (seriesCompareRows(s, firstRows[i], r) == 0) {
+                        counts[i]++;
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    firstRows[distinctCount] = r;
+                    counts[distinctCount] = 1;
+                    distinctCount++;
+                }
+            }
+
+            Series valSeries, cntSeries;
+            seriesInit(&valSeries, "value", s->type);
+            seriesInit(&cntSeries, "count", DF_INT);
+
+            for (size_t i = 0; i < distinctCount; i++) {
+                seriesAppendFrom(&valSeries, s, firstRows[i]);
+                seriesAddInt(&cntSeries, counts[i]);
+            }
+            result.ops->addSeriesMove(&result, &valSeries);
+            result.ops->addSeriesMove(&result, &cntSeries);
+
+            free(firstRows);
+            free(counts);
+        } break;
     }
 
     return result;
@@ -1747,6 +1844,7 @@ DataFrame dfValueCounts_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 DataFrame dfCumulativeSum_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame if something fails
     DataFrame result;
     DataFrame_Create(&result);
@@ -1755,7 +1853,7 @@ DataFrame dfCumulativeSum_impl(const DataFrame* df, size_t colIndex)
         return result;
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         // invalid column
         return result;
@@ -1765,7 +1863,7 @@ DataFrame dfCumulativeSum_impl(const DataFrame* df, size_t colIndex)
     Series cumsumSeries;
     seriesInit(&cumsumSeries, "cumsum", DF_DOUBLE);
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     double partialSum = 0.0;
 
     for (size_t r = 0; r < nRows; r++) {
@@ -1795,9 +1893,9 @@ DataFrame dfCumulativeSum_impl(const DataFrame* df, size_t colIndex)
                     readOk = true;
                 }
             } break;
-            case DF_STRING:
             default:
-                // Not numeric => can't read => readOk=false
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                readOk = seriesGetAsDouble(s, r, &val);
                 break;
         }
 
@@ -1811,10 +1909,9 @@ DataFrame dfCumulativeSum_impl(const DataFrame* df, size_t colIndex)
     }
 
     // Now add this cumsumSeries to the result DataFrame
-    bool ok = result.addSeries(&result, &cumsumSeries);
+    bool ok = result.ops->addSeriesMove(&result, &cumsumSeries);
     (void)ok; // ignore or check if needed
 
-    seriesFree(&cumsumSeries);
 
     return result;
 }
@@ -1823,6 +1920,7 @@ DataFrame dfCumulativeSum_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 DataFrame dfCumulativeProduct_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame if something fails
     DataFrame result;
     DataFrame_Create(&result);
@@ -1832,13 +1930,13 @@ DataFrame dfCumulativeProduct_impl(const DataFrame* df, size_t colIndex)
     }
 
     // Fetch the desired Series
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         // invalid column
         return result;
     }
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (nRows == 0) {
         // no data => return empty
         return result;
@@ -1877,9 +1975,9 @@ DataFrame dfCumulativeProduct_impl(const DataFrame* df, size_t colIndex)
                     readOk = true;
                 }
             } break;
-            case DF_STRING:
             default:
-                // Not numeric => skip
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                readOk = seriesGetAsDouble(s, r, &val);
                 break;
         }
 
@@ -1893,10 +1991,9 @@ DataFrame dfCumulativeProduct_impl(const DataFrame* df, size_t colIndex)
     }
 
     // Add this new Series to 'result'
-    result.addSeries(&result, &cumprodSeries);
+    result.ops->addSeriesMove(&result, &cumprodSeries);
 
     // Clean up
-    seriesFree(&cumprodSeries);
 
     return result;
 }
@@ -1905,6 +2002,7 @@ DataFrame dfCumulativeProduct_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 DataFrame dfCumulativeMax_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame if something fails
     DataFrame result;
     DataFrame_Create(&result);
@@ -1914,12 +2012,12 @@ DataFrame dfCumulativeMax_impl(const DataFrame* df, size_t colIndex)
     }
 
     // Get the desired Series
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         return result;
     }
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (nRows == 0) {
         // No data => return empty
         return result;
@@ -1959,7 +2057,9 @@ DataFrame dfCumulativeMax_impl(const DataFrame* df, size_t colIndex)
                     readOk = true;
                 }
             } break;
-            default: // DF_STRING or unknown
+            default:
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                readOk = seriesGetAsDouble(s, r, &val);
                 break;
         }
 
@@ -1974,8 +2074,7 @@ DataFrame dfCumulativeMax_impl(const DataFrame* df, size_t colIndex)
     }
 
     // Add this Series to 'result'
-    result.addSeries(&result, &cummaxSeries);
-    seriesFree(&cummaxSeries);
+    result.ops->addSeriesMove(&result, &cummaxSeries);
 
     return result;
 }
@@ -1983,6 +2082,7 @@ DataFrame dfCumulativeMax_impl(const DataFrame* df, size_t colIndex)
 
 DataFrame dfCumulativeMin_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame if fail
     DataFrame result;
     DataFrame_Create(&result);
@@ -1991,12 +2091,12 @@ DataFrame dfCumulativeMin_impl(const DataFrame* df, size_t colIndex)
         return result;
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         return result;
     }
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (nRows == 0) {
         return result;
     }
@@ -2035,6 +2135,8 @@ DataFrame dfCumulativeMin_impl(const DataFrame* df, size_t colIndex)
                 }
             } break;
             default:
+                // other numeric types; false for DF_STRING / DF_CATEGORY
+                readOk = seriesGetAsDouble(s, r, &val);
                 break;
         }
 
@@ -2048,8 +2150,7 @@ DataFrame dfCumulativeMin_impl(const DataFrame* df, size_t colIndex)
         seriesAddDouble(&cumminSeries, partialMin);
     }
 
-    result.addSeries(&result, &cumminSeries);
-    seriesFree(&cumminSeries);
+    result.ops->addSeriesMove(&result, &cumminSeries);
 
     return result;
 }
@@ -2058,6 +2159,7 @@ DataFrame dfCumulativeMin_impl(const DataFrame* df, size_t colIndex)
 * ------------------------------------------------------------------------- */
 double dfStd_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     // We can rely on dfVar_impl
     extern double dfVar_impl(const DataFrame* df, size_t colIndex);
 
@@ -2124,40 +2226,63 @@ static GroupItem* findOrCreateItem(GroupContext* ctx, const char* key)
     return &ctx->items[ctx->size - 1];
 }
 
-/**
- * @brief dfGroupBy_impl
- * Group the DataFrame by a single column (`groupColIndex`), returning a new
- * DataFrame with columns ["group", "count"] for each unique value.
+/*
+ * Group rows[0..nRows) (rows 0..nRows-1 when `rows` is NULL) by a single
+ * column, returning columns ["group", "count"] for each unique value.
  */
-DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex)
+static DataFrame groupByRows(const DataFrame* df, size_t groupColIndex,
+                             const size_t* rows, size_t nRows)
 {
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     if (groupColIndex >= nCols) {
         // invalid column
         return result;
     }
 
-    const Series* groupSeries = df->getSeries(df, groupColIndex);
+    const Series* groupSeries = df->ops->getSeries(df, groupColIndex);
     if (!groupSeries) {
         // no data
         return result;
     }
 
+    // DF_CATEGORY => one counter per dictionary code, no string keys
+    if (groupSeries->type == DF_CATEGORY) {
+        uint32_t* order = NULL;
+        size_t distinct = 0;
+        size_t* counts = countCategoryCodes(groupSeries, rows, nRows, &order, &distinct);
+
+        Series groupCol, countCol;
+        seriesInit(&groupCol, "group", DF_STRING);
+        seriesInit(&countCol, "count", DF_INT);
+        for (size_t i = 0; i < distinct; i++) {
+            const char* label = NULL;
+            seriesCategoryLabel(groupSeries, order[i], &label, NULL);
+            seriesAddString(&groupCol, label);
+            seriesAddInt(&countCol, (int)counts[order[i]]);
+        }
+        result.ops->addSeriesMove(&result, &groupCol);
+        result.ops->addSeriesMove(&result, &countCol);
+
+        free(order);
+        free(counts);
+        return result;
+    }
+
     // We'll store our items in a local GroupContext
     GroupContext ctx;
     ctx.items    = NULL;
     ctx.size     = 0;
     ctx.capacity = 0;
 
-    size_t nRows = df->numRows(df);
-
-    for (size_t r = 0; r < nRows; r++) {
+    for (size_t i = 0; i < nRows; i++) {
+        size_t r = rows ? rows[i] : i;
         char buffer[128];
         buffer[0] = '\0';
+        const char* key = buffer;   // string cells use a borrowed view instead
 
         // Convert the cell to string
         switch (groupSeries->type) {
@@ -2173,12 +2298,11 @@ DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex)
                     snprintf(buffer, sizeof(buffer), "%g", d);
                 }
             } break;
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(groupSeries, r, &str)) {
-                    strncpy(buffer, str, sizeof(buffer) - 1);
-                    buffer[sizeof(buffer) - 1] = '\0';
-                    free(str);
+            case DF_STRING:
+            case DF_CATEGORY: {
+                const char* str = NULL;
+                if (seriesGetStringView(groupSeries, r, &str, NULL)) {
+                    key = str;
                 }
             } break;
             /* --------------------------------------------
@@ -2190,10 +2314,13 @@ DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex)
                     snprintf(buffer, sizeof(buffer), "%lld", dtVal);
                 }
             } break;
+            default:
+                seriesFormatNumber(groupSeries, r, buffer, sizeof(buffer));
+                break;
         }
 
         // find or create item
-        GroupItem* gi = findOrCreateItem(&ctx, buffer);
+        GroupItem* gi = findOrCreateItem(&ctx, key);
         if (gi) {
             gi->count++;
         }
@@ -2211,11 +2338,9 @@ DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex)
     }
 
     // Add them to the result
-    result.addSeries(&result, &groupCol);
-    result.addSeries(&result, &countCol);
+    result.ops->addSeriesMove(&result, &groupCol);
+    result.ops->addSeriesMove(&result, &countCol);
 
-    seriesFree(&groupCol);
-    seriesFree(&countCol);
 
     // free memory
     for (size_t i = 0; i < ctx.size; i++) {
@@ -2224,4 +2349,27 @@ DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex)
     free(ctx.items);
 
     return result;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief dfGroupBy_impl
+ * Group the DataFrame by a single column (`groupColIndex`), returning a new
+ * DataFrame with columns ["group", "count"] for each unique value.
+ */
+DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex)
+{
+    DF_OP_SCOPE();
+    return groupByRows(df, groupColIndex, NULL, df ? df->ops->numRows(df) : 0);
+}
+
+/**
+ * @brief dfGroupBySelection_impl
+ * groupBy over the rows of `sel` only (all rows if NULL); groups appear in
+ * the order of their first row in `sel`.
+ */
+DataFrame dfGroupBySelection_impl(const DataFrame* df, size_t groupColIndex, const DfSelection* sel)
+{
+    DF_OP_SCOPE();
+    if (!sel) return dfGroupBy_impl(df, groupColIndex);
+    return groupByRows(df, groupColIndex, sel->rows, sel->count);
+}
@@ -3,14 +3,18 @@
 #include <string.h>
 #include <stdbool.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 
 /* -------------------------------------------------------------------------
  * 1) dfConcat_impl
  *    Naive row-wise concatenation of two DataFrames (top & bottom),
  *    requiring matching columns (same name & type, same order).
+ *    A column that is chunked on either side comes out chunked, with the
+ *    inputs' chunks linked rather than copied.
  * ------------------------------------------------------------------------- */
 DataFrame dfConcat_impl(const DataFrame* top, const DataFrame* bottom)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
 
@@ -19,8 +23,8 @@ DataFrame dfConcat_impl(const DataFrame* top, const DataFrame* bottom)
         return result;
     }
 
-    size_t topCols = top->numColumns(top);
-    size_t botCols = bottom->numColumns(bottom);
+    size_t topCols = top->ops->numColumns(top);
+    size_t botCols = bottom->ops->numColumns(bottom);
     if (topCols != botCols) {
         fprintf(stderr, "dfConcat_impl: column count mismatch.\n");
         return result;
@@ -28,8 +32,8 @@ DataFrame dfConcat_impl(const DataFrame* top, const DataFrame* bottom)
 
     // Check matching name & type
     for (size_t c = 0; c < topCols; c++) {
-        const Series* sTop = top->getSeries(top, c);
-        const Series* sBot = bottom->getSeries(bottom, c);
+        const Series* sTop = top->ops->getSeries(top, c);
+        const Series* sBot = bottom->ops->getSeries(bottom, c);
         if (!sTop || !sBot) {
             fprintf(stderr, "dfConcat_impl: missing column.\n");
             return result;
@@ -48,85 +52,284 @@ DataFrame dfConcat_impl(const DataFrame* top, const DataFrame* bottom)
 
     // Build result columns
     for (size_t c = 0; c < topCols; c++) {
-        const Series* sTop = top->getSeries(top, c);
-        const Series* sBot = bottom->getSeries(bottom, c);
+        const Series* sTop = top->ops->getSeries(top, c);
+        const Series* sBot = bottom->ops->getSeries(bottom, c);
         Series newS;
+
+        if (seriesIsChunked(sTop) || seriesIsChunked(sBot)) {
+            // link the chunks of both sides instead of copying rows
+            if (seriesIsChunked(sTop)) {
+                seriesShare(sTop, &newS);
+            } else {
+                seriesInitChunked(&newS, sTop->name, sTop->type, 0);
+                seriesAppendChunks(&newS, sTop);
+            }
+            seriesAppendChunks(&newS, sBot);
+            result.ops->addSeriesMove(&result, &newS);
+            continue;
+        }
+
         seriesInit(&newS, sTop->name, sTop->type);
 
         // copy top rows
-        size_t topRows = top->numRows(top);
+        size_t topRows = top->ops->numRows(top);
         for (size_t r = 0; r < topRows; r++) {
-            switch(sTop->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(sTop, r, &val)) {
-                        seriesAddInt(&newS, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(sTop, r, &dv)) {
-                        seriesAddDouble(&newS, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(sTop, r, &str)) {
-                        seriesAddString(&newS, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(sTop, r, &dtVal)) {
-                        seriesAddDateTime(&newS, dtVal);
-                    }
-                } break;
-            }
+            seriesAppendFrom(&newS, sTop, r);
         }
 
         // copy bottom rows
-        size_t botRows = bottom->numRows(bottom);
+        size_t botRows = bottom->ops->numRows(bottom);
         for (size_t r = 0; r < botRows; r++) {
-            switch(sBot->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(sBot, r, &val)) {
-                        seriesAddInt(&newS, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(sBot, r, &dv)) {
-                        seriesAddDouble(&newS, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(sBot, r, &str)) {
-                        seriesAddString(&newS, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(sBot, r, &dtVal)) {
-                        seriesAddDateTime(&newS, dtVal);
-                    }
-                } break;
-            }
+            seriesAppendFrom(&newS, sBot, r);
         }
 
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
     return result;
 }
 
 
+/* -------------------------------------------------------------------------
+ * Join helpers
+ * ------------------------------------------------------------------------- */
+
+/* Append row `row` of `src` to `out` (same type, nulls kept); a null if unreadable. */
+static void appendCellOrNull(Series* out, const Series* src, size_t row)
+{
+    if (!seriesAppendFrom(out, src, row)) {
+        seriesAddNull(out);
+    }
+}
+
+/*
+ * For every code of `from`, the code of the same label in `to`
+ * (UINT32_MAX if `to` has no such label). Caller frees.
+ */
+static uint32_t* mapCategoryCodes(const Series* from, const Series* to)
+{
+    size_t n = seriesCategoryCount(from);
+    uint32_t* map = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    if (!map) return NULL;
+    for (size_t code = 0; code < n; code++) {
+        const char* label = NULL;
+        uint32_t toCode;
+        seriesCategoryLabel(from, (uint32_t)code, &label, NULL);
+        map[code] = seriesCategoryFind(to, label, &toCode) ? toCode : UINT32_MAX;
+    }
+    return map;
+}
+
+/*
+ * Key equality for one (left row, right row) pair. Categorical keys compare
+ * codes; `rightToLeft` (NULL when both keys share a dictionary) translates
+ * right codes into the left dictionary.
+ */
+static bool joinKeysEqual(const Series* lk, size_t lr,
+                          const Series* rk, size_t rr,
+                          const uint32_t* rightToLeft)
+{
+    switch (lk->type) {
+        case DF_INT: {
+            int a, b;
+            return seriesGetInt(lk, lr, &a) && seriesGetInt(rk, rr, &b) && a == b;
+        }
+        case DF_DOUBLE: {
+            double a, b;
+            return seriesGetDouble(lk, lr, &a) && seriesGetDouble(rk, rr, &b) && a == b;
+        }
+        case DF_DATETIME: {
+            long long a, b;
+            return seriesGetDateTime(lk, lr, &a) && seriesGetDateTime(rk, rr, &b) && a == b;
+        }
+        case DF_CATEGORY: {
+            uint32_t a, b;
+            if (!seriesGetCode(lk, lr, &a) || !seriesGetCode(rk, rr, &b)) return false;
+            if (rightToLeft) b = rightToLeft[b];
+            return a == b;
+        }
+        case DF_STRING: {
+            const char* a = NULL;
+            const char* b = NULL;
+            size_t la = 0, lb = 0;
+            return seriesGetStringView(lk, lr, &a, &la)
+                && seriesGetStringView(rk, rr, &b, &lb)
+                && la == lb && memcmp(a, b, la) == 0;
+        }
+        default: {
+            // fixed-width types: exact when both keys share the type,
+            // otherwise compared as doubles
+            if (lk->type == rk->type) {
+                uint64_t a = 0, b = 0;
+                return seriesGetValue(lk, lr, &a) && seriesGetValue(rk, rr, &b) && a == b;
+            }
+            double a, b;
+            return seriesGetAsDouble(lk, lr, &a) && seriesGetAsDouble(rk, rr, &b) && a == b;
+        }
+    }
+    return false;
+}
+
+/*
+ * Matched (left row, right row) pairs in output order. JOIN_NO_ROW on one
+ * side marks a row the join pads with nulls on that side.
+ */
+#define JOIN_NO_ROW ((size_t)-1)
+
+typedef struct {
+    size_t* left;
+    size_t* right;
+    size_t  count;
+    size_t  capacity;
+} RowPairs;
+
+static bool pushPair(RowPairs* p, size_t lr, size_t rr)
+{
+    if (p->count == p->capacity) {
+        size_t cap = p->capacity ? p->capacity * 2 : 256;
+        size_t* l = (size_t*)realloc(p->left, cap * sizeof(size_t));
+        if (!l) return false;
+        p->left = l;
+        size_t* r = (size_t*)realloc(p->right, cap * sizeof(size_t));
+        if (!r) return false;
+        p->right = r;
+        p->capacity = cap;
+    }
+    p->left[p->count] = lr;
+    p->right[p->count] = rr;
+    p->count++;
+    return true;
+}
+
+static void freePairs(RowPairs* p)
+{
+    free(p->left);
+    free(p->right);
+    memset(p, 0, sizeof(*p));
+}
+
+/*
+ * Right rows chained by key hash: head[h & mask] is the first right row of
+ * a bucket, next[r] the row after r. Chains run in ascending row order, so
+ * probing yields matches in the same order as a scan of the right side.
+ */
+typedef struct {
+    size_t* head;
+    size_t* next;
+    size_t  mask;
+} KeyHashIndex;
+
+static bool buildKeyIndex(KeyHashIndex* ix, const Series* key, const SeriesKernels* k)
+{
+    size_t n = key->length;
+    size_t buckets = 16;
+    while (buckets < n * 2) buckets *= 2;
+    ix->mask = buckets - 1;
+    ix->head = (size_t*)malloc(buckets * sizeof(size_t));
+    ix->next = (size_t*)malloc((n ? n : 1) * sizeof(size_t));
+    if (!ix->head || !ix->next) return false;
+    for (size_t b = 0; b < buckets; b++) ix->head[b] = JOIN_NO_ROW;
+    for (size_t r = n; r-- > 0; ) {
+        if (key->nullCount && seriesIsNull(key, r)) continue;   // null keys never match
+        size_t b = (size_t)(k->hash(key->values, r) & ix->mask);
+        ix->next[r] = ix->head[b];
+        ix->head[b] = r;
+    }
+    return true;
+}
+
+static void freeKeyIndex(KeyHashIndex* ix)
+{
+    free(ix->head);
+    free(ix->next);
+}
+
+/*
+ * All (left, right) row pairs with equal keys, in left row order and right
+ * row order within a left row, plus the padded rows of a LEFT / RIGHT join.
+ * Fixed-width keys that are contiguous on both sides are matched through a
+ * hash index of the right key using the type's kernels; other keys compare
+ * every pair with joinKeysEqual.
+ */
+static bool matchRows(const Series* leftKey, const Series* rightKey, JoinType how, RowPairs* out)
+{
+    size_t leftRows = leftKey->length;
+    size_t rightRows = rightKey->length;
+    bool* matchedRight = (bool*)calloc(rightRows ? rightRows : 1, sizeof(bool));
+    if (!matchedRight) return false;
+
+    const SeriesKernels* k = seriesKernels(leftKey->type);
+    bool hashed = k && leftKey->type == rightKey->type &&
+                  !seriesIsChunked(leftKey) && !seriesIsChunked(rightKey);
+
+    // DF_CATEGORY keys compare dictionary codes instead of strings. If the
+    // two keys do not share a dictionary, translate right codes to left
+    // codes once up front.
+    uint32_t* rightToLeft = NULL;
+    if (leftKey->type == DF_CATEGORY && !seriesSameDictionary(leftKey, rightKey)) {
+        rightToLeft = mapCategoryCodes(rightKey, leftKey);
+    }
+
+    KeyHashIndex ix = { NULL, NULL, 0 };
+    bool ok = !hashed || buildKeyIndex(&ix, rightKey, k);
+
+    for (size_t lr = 0; ok && lr < leftRows; lr++) {
+        bool anyMatch = false;
+        if (hashed) {
+            if (!(leftKey->nullCount && seriesIsNull(leftKey, lr))) {
+                size_t b = (size_t)(k->hash(leftKey->values, lr) & ix.mask);
+                for (size_t rr = ix.head[b]; ok && rr != JOIN_NO_ROW; rr = ix.next[rr]) {
+                    if (!k->equal(leftKey->values, lr, rightKey->values, rr)) continue;
+                    anyMatch = true;
+                    matchedRight[rr] = true;
+                    ok = pushPair(out, lr, rr);
+                }
+            }
+        } else {
+            for (size_t rr = 0; ok && rr < rightRows; rr++) {
+                if (!joinKeysEqual(leftKey, lr, rightKey, rr, rightToLeft)) continue;
+                anyMatch = true;
+                matchedRight[rr] = true;
+                ok = pushPair(out, lr, rr);
+            }
+        }
+        // If no match found => if JOIN_LEFT => produce unmatched row
+        if (ok && !anyMatch && how == JOIN_LEFT) {
+            ok = pushPair(out, lr, JOIN_NO_ROW);
+        }
+    }
+
+    // If how==JOIN_RIGHT => add unmatched right rows
+    for (size_t rr = 0; ok && how == JOIN_RIGHT && rr < rightRows; rr++) {
+        if (!matchedRight[rr]) ok = pushPair(out, JOIN_NO_ROW, rr);
+    }
+
+    freeKeyIndex(&ix);
+    free(rightToLeft);
+    free(matchedRight);
+    return ok;
+}
+
+/*
+ * Fill one output column from rows[0..n) of `src` with a single bulk copy;
+ * columns with padded rows (JOIN_NO_ROW) go cell by cell.
+ */
+static void appendJoinedColumn(Series* out, const Series* src, const size_t* rows, size_t n)
+{
+    bool padded = false;
+    for (size_t i = 0; i < n && !padded; i++) padded = rows[i] == JOIN_NO_ROW;
+
+    seriesReserve(out, n);
+    if (!padded && seriesAppendRows(out, src, rows, n)) return;
+    for (size_t i = 0; i < n; i++) {
+        if (rows[i] == JOIN_NO_ROW) {
+            seriesAddNull(out);
+        } else {
+            appendCellOrNull(out, src, rows[i]);
+        }
+    }
+}
+
 /* -------------------------------------------------------------------------
  * 2) dfMerge_impl (simple “inner merge” on single key column).
  *    If key matches => combine row. Unmatched => discarded.
@@ -136,6 +339,7 @@ DataFrame dfMerge_impl(const DataFrame* left,
                        const char* leftKeyName,
                        const char* rightKeyName)
 {
+    DF_OP_SCOPE();
     // 1) Create an empty result DataFrame.
     DataFrame result;
     DataFrame_Create(&result);
@@ -146,26 +350,11 @@ DataFrame dfMerge_impl(const DataFrame* left,
     }
 
     // 2) Find the key-column indexes in the left and right DataFrames.
-    size_t leftCols  = left->numColumns(left);
-    size_t rightCols = right->numColumns(right);
+    size_t leftCols  = left->ops->numColumns(left);
+    size_t rightCols = right->ops->numColumns(right);
 
-    size_t leftKeyIndex  = (size_t)-1;
-    size_t rightKeyIndex = (size_t)-1;
-
-    for (size_t c = 0; c < leftCols; c++) {
-        const Series* s = left->getSeries(left, c);
-        if (s && strcmp(s->name, leftKeyName) == 0) {
-            leftKeyIndex = c; 
-            break;
-        }
-    }
-    for (size_t c = 0; c < rightCols; c++) {
-        const Series* s = right->getSeries(right, c);
-        if (s && strcmp(s->name, rightKeyName) == 0) {
-            rightKeyIndex = c; 
-            break;
-        }
-    }
+    size_t leftKeyIndex  = left->ops->columnIndex(left, leftKeyName);
+    size_t rightKeyIndex = right->ops->columnIndex(right, rightKeyName);
 
     if (leftKeyIndex == (size_t)-1 || rightKeyIndex == (size_t)-1) {
         fprintf(stderr,"dfMerge: key not found.\n");
@@ -173,8 +362,8 @@ DataFrame dfMerge_impl(const DataFrame* left,
     }
 
     // 3) Check that the key columns have the same type.
-    const Series* leftKeySeries  = left->getSeries(left, leftKeyIndex);
-    const Series* rightKeySeries = right->getSeries(right, rightKeyIndex);
+    const Series* leftKeySeries  = left->ops->getSeries(left, leftKeyIndex);
+    const Series* rightKeySeries = right->ops->getSeries(right, rightKeyIndex);
     if (!leftKeySeries || !rightKeySeries) {
         fprintf(stderr,"dfMerge: invalid key series.\n");
         return result;
@@ -196,7 +385,7 @@ DataFrame dfMerge_impl(const DataFrame* left,
 
     // 5) Initialize result columns for the left columns [0..leftCols-1].
     for (size_t c = 0; c < leftCols; c++) {
-        const Series* sL = left->getSeries(left, c);
+        const Series* sL = left->ops->getSeries(left, c);
         seriesInit(&resultSeries[c], sL->name, sL->type);
     }
 
@@ -209,20 +398,13 @@ DataFrame dfMerge_impl(const DataFrame* left,
             continue;
         }
 
-        const Series* sR = right->getSeries(right, c);
+        const Series* sR = right->ops->getSeries(right, c);
         if (!sR) {
             continue;
         }
 
         // Check if sR->name conflicts with any name in left
-        bool conflict = false;
-        for (size_t lc = 0; lc < leftCols; lc++) {
-            const Series* leftCol = left->getSeries(left, lc);
-            if (strcmp(sR->name, leftCol->name) == 0) {
-                conflict = true;
-                break;
-            }
-        }
+        bool conflict = left->ops->columnIndex(left, sR->name) != (size_t)-1;
 
         char newName[128];
         if (!conflict) {
@@ -238,358 +420,26 @@ DataFrame dfMerge_impl(const DataFrame* left,
         rOffset++;
     }
 
-    // 7) Merge rows for an "inner" join: for each row in 'left', find matching row(s) in 'right'.
-    size_t leftRows  = left->numRows(left);
-    size_t rightRows = right->numRows(right);
-
-    for (size_t lr = 0; lr < leftRows; lr++) {
-
-        switch (leftKeySeries->type) {
-
-            case DF_INT: {
-                int lv;
-                if (!seriesGetInt(leftKeySeries, lr, &lv)) {
-                    // If we cannot read the key, skip
-                    break;
-                }
-                // For each row in 'right', look for matches
-                for (size_t rr = 0; rr < rightRows; rr++) {
-                    int rv;
-                    if (!seriesGetInt(rightKeySeries, rr, &rv)) {
-                        continue;
-                    }
-                    if (lv == rv) {
-                        // Found a match => combine the row
-                        // (1) copy left row into [0..leftCols-1]
-                        for (size_t c = 0; c < leftCols; c++) {
-                            const Series* sL = left->getSeries(left, c);
-                            switch (sL->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sL, lr, &tmp)) {
-                                        seriesAddInt(&resultSeries[c], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sL, lr, &d)) {
-                                        seriesAddDouble(&resultSeries[c], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st = NULL;
-                                    if (seriesGetString(sL, lr, &st)) {
-                                        seriesAddString(&resultSeries[c], st);
-                                        free(st);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sL, lr, &dtVal)) {
-                                        seriesAddDateTime(&resultSeries[c], dtVal);
-                                    }
-                                } break;
-                            }
-                        }
-                        // (2) copy right row except rightKey => fill [leftCols..end]
-                        size_t ro = leftCols;
-                        for (size_t rc = 0; rc < rightCols; rc++) {
-                            if (rc == rightKeyIndex) {
-                                continue; 
-                            }
-                            const Series* sR = right->getSeries(right, rc);
-                            switch (sR->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sR, rr, &tmp)) {
-                                        seriesAddInt(&resultSeries[ro], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sR, rr, &d)) {
-                                        seriesAddDouble(&resultSeries[ro], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st = NULL;
-                                    if (seriesGetString(sR, rr, &st)) {
-                                        seriesAddString(&resultSeries[ro], st);
-                                        free(st);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sR, rr, &dtVal)) {
-                                        seriesAddDateTime(&resultSeries[ro], dtVal);
-                                    }
-                                } break;
-                            }
-                            ro++;
-                        }
-                    }
-                }
-            } break; // end DF_INT
-
-            case DF_DOUBLE: {
-                double lv;
-                if (!seriesGetDouble(leftKeySeries, lr, &lv)) {
-                    break;
-                }
-                // match with right
-                for (size_t rr = 0; rr < rightRows; rr++) {
-                    double rv;
-                    if (!seriesGetDouble(rightKeySeries, rr, &rv)) {
-                        continue;
-                    }
-                    if (lv == rv) {
-                        // match => combine
-                        // 1) copy left row into [0..leftCols-1]
-                        for (size_t c = 0; c < leftCols; c++) {
-                            const Series* sL = left->getSeries(left, c);
-                            switch (sL->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sL, lr, &tmp)) {
-                                        seriesAddInt(&resultSeries[c], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sL, lr, &d)) {
-                                        seriesAddDouble(&resultSeries[c], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st = NULL;
-                                    if (seriesGetString(sL, lr, &st)) {
-                                        seriesAddString(&resultSeries[c], st);
-                                        free(st);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sL, lr, &dtVal)) {
-                                        seriesAddDateTime(&resultSeries[c], dtVal);
-                                    }
-                                } break;
-                            }
-                        }
-                        // 2) copy right row except key
-                        size_t ro = leftCols;
-                        for (size_t rc = 0; rc < rightCols; rc++) {
-                            if (rc == rightKeyIndex) {
-                                continue;
-                            }
-                            const Series* sR = right->getSeries(right, rc);
-                            switch (sR->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sR, rr, &tmp)) {
-                                        seriesAddInt(&resultSeries[ro], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sR, rr, &d)) {
-                                        seriesAddDouble(&resultSeries[ro], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st = NULL;
-                                    if (seriesGetString(sR, rr, &st)) {
-                                        seriesAddString(&resultSeries[ro], st);
-                                        free(st);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sR, rr, &dtVal)) {
-                                        seriesAddDateTime(&resultSeries[ro], dtVal);
-                                    }
-                                } break;
-                            }
-                            ro++;
-                        }
-                    }
-                }
-            } break; // end DF_DOUBLE
-
-            case DF_STRING: {
-                char* lv = NULL;
-                if (!seriesGetString(leftKeySeries, lr, &lv)) {
-                    break;
-                }
-                for (size_t rr = 0; rr < rightRows; rr++) {
-                    char* rv = NULL;
-                    if (!seriesGetString(rightKeySeries, rr, &rv)) {
-                        continue;
-                    }
-                    if (strcmp(lv, rv) == 0) {
-                        // match => combine
-                        // copy left row
-                        for (size_t c = 0; c < leftCols; c++) {
-                            const Series* sL = left->getSeries(left, c);
-                            switch (sL->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sL, lr, &tmp)) {
-                                        seriesAddInt(&resultSeries[c], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sL, lr, &d)) {
-                                        seriesAddDouble(&resultSeries[c], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st2 = NULL;
-                                    if (seriesGetString(sL, lr, &st2)) {
-                                        seriesAddString(&resultSeries[c], st2);
-                                        free(st2);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sL, lr, &dtVal)) {
-                                        seriesAddDateTime(&resultSeries[c], dtVal);
-                                    }
-                                } break;
-                            }
-                        }
-                        // copy right row except key
-                        size_t ro = leftCols;
-                        for (size_t rc = 0; rc < rightCols; rc++) {
-                            if (rc == rightKeyIndex) {
-                                continue;
-                            }
-                            const Series* sR = right->getSeries(right, rc);
-                            switch (sR->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sR, rr, &tmp)) {
-                                        seriesAddInt(&resultSeries[ro], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sR, rr, &d)) {
-                                        seriesAddDouble(&resultSeries[ro], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st2 = NULL;
-                                    if (seriesGetString(sR, rr, &st2)) {
-                                        seriesAddString(&resultSeries[ro], st2);
-                                        free(st2);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sR, rr, &dtVal)) {
-                                        seriesAddDateTime(&resultSeries[ro], dtVal);
-                                    }
-                                } break;
-                            }
-                            ro++;
-                        }
-                    }
-                    if (rv) free(rv);
-                }
-                if (lv) free(lv);
-            } break; // end DF_STRING
-
-            case DF_DATETIME: {
-                long long lv;
-                if (!seriesGetDateTime(leftKeySeries, lr, &lv)) {
-                    break;
-                }
-                for (size_t rr = 0; rr < rightRows; rr++) {
-                    long long rv;
-                    if (!seriesGetDateTime(rightKeySeries, rr, &rv)) {
-                        continue;
-                    }
-                    if (lv == rv) {
-                        // match => combine
-                        // copy left row
-                        for (size_t c = 0; c < leftCols; c++) {
-                            const Series* sL = left->getSeries(left, c);
-                            switch (sL->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sL, lr, &tmp)) {
-                                        seriesAddInt(&resultSeries[c], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sL, lr, &d)) {
-                                        seriesAddDouble(&resultSeries[c], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st2 = NULL;
-                                    if (seriesGetString(sL, lr, &st2)) {
-                                        seriesAddString(&resultSeries[c], st2);
-                                        free(st2);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal2;
-                                    if (seriesGetDateTime(sL, lr, &dtVal2)) {
-                                        seriesAddDateTime(&resultSeries[c], dtVal2);
-                                    }
-                                } break;
-                            }
-                        }
-                        // copy right row except key
-                        size_t ro = leftCols;
-                        for (size_t rc = 0; rc < rightCols; rc++) {
-                            if (rc == rightKeyIndex) {
-                                continue;
-                            }
-                            const Series* sR = right->getSeries(right, rc);
-                            switch (sR->type) {
-                                case DF_INT: {
-                                    int tmp;
-                                    if (seriesGetInt(sR, rr, &tmp)) {
-                                        seriesAddInt(&resultSeries[ro], tmp);
-                                    }
-                                } break;
-                                case DF_DOUBLE: {
-                                    double d;
-                                    if (seriesGetDouble(sR, rr, &d)) {
-                                        seriesAddDouble(&resultSeries[ro], d);
-                                    }
-                                } break;
-                                case DF_STRING: {
-                                    char* st2 = NULL;
-                                    if (seriesGetString(sR, rr, &st2)) {
-                                        seriesAddString(&resultSeries[ro], st2);
-                                        free(st2);
-                                    }
-                                } break;
-                                case DF_DATETIME: {
-                                    long long dtVal3;
-                                    if (seriesGetDateTime(sR, rr, &dtVal3)) {
-                                        seriesAddDateTime(&resultSeries[ro], dtVal3);
-                                    }
-                                } break;
-                            }
-                            ro++;
-                        }
-                    }
-                }
-            } break; // end DF_DATETIME
-
-        } // end switch
-    } // end for(lr)
+    // 7) Match rows for an "inner" join, then copy each column once
+    RowPairs pairs = { NULL, 0, 0, 0 };
+    if (!matchRows(leftKeySeries, rightKeySeries, JOIN_INNER, &pairs)) {
+        fprintf(stderr,"dfMerge: out of memory.\n");
+    }
+    for (size_t c = 0; c < leftCols; c++) {
+        appendJoinedColumn(&resultSeries[c], left->ops->getSeries(left, c), pairs.left, pairs.count);
+    }
+    size_t ro = leftCols;
+    for (size_t rc = 0; rc < rightCols; rc++) {
+        if (rc == rightKeyIndex) {
+            continue;
+        }
+        appendJoinedColumn(&resultSeries[ro++], right->ops->getSeries(right, rc), pairs.right, pairs.count);
+    }
+    freePairs(&pairs);
 
     // 8) Finally, build the DataFrame from the array of Series
     for (size_t c = 0; c < totalCols; c++) {
-        result.addSeries(&result, &resultSeries[c]);
-        seriesFree(&resultSeries[c]);
+        result.ops->addSeriesMove(&result, &resultSeries[c]);
     }
     free(resultSeries);
 
@@ -608,40 +458,26 @@ DataFrame dfJoin_impl(const DataFrame* left,
                       const char* rightKeyName,
                       JoinType how)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!left || !right || !leftKeyName || !rightKeyName) {
         return result;
     }
 
-    size_t leftCols = left->numColumns(left);
-    size_t rightCols= right->numColumns(right);
-    size_t leftRows= left->numRows(left);
-    size_t rightRows= right->numRows(right);
+    size_t leftCols = left->ops->numColumns(left);
+    size_t rightCols= right->ops->numColumns(right);
 
     // Find key indexes
-    size_t leftKeyIndex=(size_t)-1, rightKeyIndex=(size_t)-1;
-    for (size_t c=0; c<leftCols; c++) {
-        const Series* s= left->getSeries(left,c);
-        if (s && strcmp(s->name, leftKeyName)==0) {
-            leftKeyIndex=c; 
-            break;
-        }
-    }
-    for (size_t c=0; c<rightCols; c++) {
-        const Series* s= right->getSeries(right,c);
-        if (s && strcmp(s->name, rightKeyName)==0) {
-            rightKeyIndex=c; 
-            break;
-        }
-    }
+    size_t leftKeyIndex = left->ops->columnIndex(left, leftKeyName);
+    size_t rightKeyIndex = right->ops->columnIndex(right, rightKeyName);
     if (leftKeyIndex==(size_t)-1 || rightKeyIndex==(size_t)-1) {
         fprintf(stderr,"dfJoin: key not found.\n");
         return result;
     }
 
-    const Series* leftKey= left->getSeries(left, leftKeyIndex);
-    const Series* rightKey= right->getSeries(right, rightKeyIndex);
+    const Series* leftKey= left->ops->getSeries(left, leftKeyIndex);
+    const Series* rightKey= right->ops->getSeries(right, rightKeyIndex);
 
     // Check if key types match
     if (leftKey->type != rightKey->type) {
@@ -655,315 +491,39 @@ DataFrame dfJoin_impl(const DataFrame* left,
 
     // Initialize each
     for (size_t c=0; c<leftCols; c++) {
-        const Series* sL= left->getSeries(left, c);
+        const Series* sL= left->ops->getSeries(left, c);
         seriesInit(&outCols[c], sL->name, sL->type);
     }
     size_t colOffset= leftCols;
     for (size_t c=0; c< rightCols; c++) {
         if (c== rightKeyIndex) continue;
-        const Series* sR= right->getSeries(right, c);
+        const Series* sR= right->ops->getSeries(right, c);
         seriesInit(&outCols[colOffset], sR->name, sR->type);
         colOffset++;
     }
 
-    // We'll track which right rows matched at least once (for RIGHT join)
-    bool* matchedRight= (bool*)calloc(rightRows,sizeof(bool));
-
-    // For each left row, attempt to find matches in right
-    for (size_t lr=0; lr< leftRows; lr++) {
-        bool anyMatch = false;
-
-        // Compare key based on type
-        switch (leftKey->type) {
-            case DF_INT: {
-                int lv;
-                if (!seriesGetInt(leftKey, lr, &lv)) break;
-                for (size_t rr=0; rr< rightRows; rr++) {
-                    int rv;
-                    if (!seriesGetInt(rightKey, rr, &rv)) continue;
-                    if (lv == rv) {
-                        anyMatch = true;
-                        matchedRight[rr] = true;
-                        // produce joined row => copy left row, right row except key
-                        // Copy left row
-                        for (size_t c=0; c<leftCols; c++) {
-                            const Series* sL= left->getSeries(left,c);
-                            switch(sL->type){
-                                case DF_INT:{
-                                    int v; 
-                                    if (seriesGetInt(sL, lr, &v)) 
-                                        seriesAddInt(&outCols[c], v);
-                                    else 
-                                        seriesAddInt(&outCols[c], 0);
-                                } break;
-                                case DF_DOUBLE:{
-                                    double d; 
-                                    if (seriesGetDouble(sL, lr, &d))
-                                        seriesAddDouble(&outCols[c], d);
-                                    else 
-                                        seriesAddDouble(&outCols[c], 0.0);
-                                } break;
-                                case DF_STRING:{
-                                    char* st=NULL; 
-                                    if (seriesGetString(sL, lr, &st)) {
-                                        seriesAddString(&outCols[c], st);
-                                        free(st);
-                                    } else {
-                                        seriesAddString(&outCols[c], "NA");
-                                    }
-                                } break;
-                                /* NEW: DF_DATETIME */
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sL, lr, &dtVal)) {
-                                        seriesAddDateTime(&outCols[c], dtVal);
-                                    } else {
-                                        // "NA" => store 0
-                                        seriesAddDateTime(&outCols[c], 0LL);
-                                    }
-                                } break;
-                            }
-                        }
-                        // Copy right row except key
-                        size_t ro2 = leftCols;
-                        for (size_t rc=0; rc< rightCols; rc++){
-                            if (rc== rightKeyIndex) continue;
-                            const Series* sR= right->getSeries(right, rc);
-                            switch(sR->type){
-                                case DF_INT:{
-                                    int v; 
-                                    if (seriesGetInt(sR, rr, &v)) 
-                                        seriesAddInt(&outCols[ro2], v);
-                                    else 
-                                        seriesAddInt(&outCols[ro2], 0);
-                                } break;
-                                case DF_DOUBLE:{
-                                    double d;
-                                    if (seriesGetDouble(sR, rr, &d))
-                                        seriesAddDouble(&outCols[ro2], d);
-                                    else 
-                                        seriesAddDouble(&outCols[ro2], 0.0);
-                                } break;
-                                case DF_STRING:{
-                                    char* st=NULL;
-                                    if (seriesGetString(sR, rr, &st)){
-                                        seriesAddString(&outCols[ro2], st);
-                                        free(st);
-                                    } else {
-                                        seriesAddString(&outCols[ro2], "NA");
-                                    }
-                                } break;
-                                /* NEW: DF_DATETIME */
-                                case DF_DATETIME: {
-                                    long long dtVal;
-                                    if (seriesGetDateTime(sR, rr, &dtVal)) {
-                                        seriesAddDateTime(&outCols[ro2], dtVal);
-                                    } else {
-                                        // treat as "NA"
-                                        seriesAddDateTime(&outCols[ro2], 0LL);
-                                    }
-                                } break;
-                            }
-                            ro2++;
-                        }
-                    }
-                }
-            } break;
-            
-            case DF_DOUBLE: {
-                double lv;
-                if (!seriesGetDouble(leftKey, lr, &lv)) break;
-                for (size_t rr=0; rr< rightRows; rr++) {
-                    double rv;
-                    if (!seriesGetDouble(rightKey, rr, &rv)) continue;
-                    if (lv == rv) {
-                        anyMatch = true;
-                        matchedRight[rr] = true;
-                        // produce joined row => copy left + copy right
-                        // ... same approach, including DF_DATETIME
-                        // (not repeated here for brevity)
-                    }
-                }
-            } break;
-
-            case DF_STRING: {
-                char* lv=NULL;
-                if (!seriesGetString(leftKey, lr, &lv)) break;
-                for (size_t rr=0; rr< rightRows; rr++) {
-                    char* rv=NULL;
-                    if (!seriesGetString(rightKey, rr, &rv)) continue;
-                    if (strcmp(lv, rv)==0) {
-                        anyMatch = true;
-                        matchedRight[rr] = true;
-                        // produce joined row => copy left + copy right
-                        // (include DF_DATETIME for other columns)
-                    }
-                    free(rv);
-                }
-                free(lv);
-            } break;
-
-            /* NEW: DF_DATETIME => compare 64-bit values. */
-            case DF_DATETIME: {
-                long long lv;
-                if (!seriesGetDateTime(leftKey, lr, &lv)) break;
-                for (size_t rr=0; rr< rightRows; rr++) {
-                    long long rv;
-                    if (!seriesGetDateTime(rightKey, rr, &rv)) continue;
-                    if (lv == rv) {
-                        anyMatch = true;
-                        matchedRight[rr] = true;
-                        // produce joined row => copy left row, right row except key
-                        // The copying logic includes DF_DATETIME columns.
-                    }
-                }
-            } break;
-        }
-
-        // If no match found => if JOIN_LEFT => produce unmatched row
-        if (!anyMatch && how == JOIN_LEFT) {
-            // produce row => copy left row, fill right with "NA"
-            for (size_t c=0; c< leftCols; c++) {
-                const Series* sL= left->getSeries(left,c);
-                switch(sL->type){
-                    case DF_INT:{
-                        int v; 
-                        if (seriesGetInt(sL, lr, &v)) 
-                            seriesAddInt(&outCols[c], v);
-                        else 
-                            seriesAddInt(&outCols[c], 0);
-                    } break;
-                    case DF_DOUBLE:{
-                        double d;
-                        if (seriesGetDouble(sL, lr, &d))
-                            seriesAddDouble(&outCols[c], d);
-                        else 
-                            seriesAddDouble(&outCols[c], 0.0);
-                    } break;
-                    case DF_STRING:{
-                        char* st=NULL;
-                        if (seriesGetString(sL, lr, &st)) {
-                            seriesAddString(&outCols[c], st);
-                            free(st);
-                        } else {
-                            seriesAddString(&outCols[c], "NA");
-                        }
-                    } break;
-                    /* NEW: DF_DATETIME => "NA" => store 0 or sentinel */
-                    case DF_DATETIME: {
-                        long long dtVal;
-                        if (seriesGetDateTime(sL, lr, &dtVal)) {
-                            seriesAddDateTime(&outCols[c], dtVal);
-                        } else {
-                            seriesAddDateTime(&outCols[c], 0LL);
-                        }
-                    } break;
-                }
-            }
-            // fill right columns with NA
-            size_t ro2= leftCols;
-            for (size_t rc=0; rc< rightCols; rc++){
-                if (rc== rightKeyIndex) continue;
-                const Series* sR= right->getSeries(right, rc);
-                switch(sR->type) {
-                    case DF_INT: 
-                        seriesAddInt(&outCols[ro2], 0);
-                        break;
-                    case DF_DOUBLE:
-                        seriesAddDouble(&outCols[ro2], 0.0);
-                        break;
-                    case DF_STRING:
-                        seriesAddString(&outCols[ro2], "NA");
-                        break;
-                    /* NEW: DF_DATETIME => store 0 as NA */
-                    case DF_DATETIME:
-                        seriesAddDateTime(&outCols[ro2], 0LL);
-                        break;
-                }
-                ro2++;
-            }
-        }
+    // Match the keys, then copy column by column
+    RowPairs pairs = { NULL, 0, 0, 0 };
+    if (!matchRows(leftKey, rightKey, how, &pairs)) {
+        fprintf(stderr,"dfJoin: out of memory.\n");
     }
-
-    // If how==JOIN_RIGHT => add unmatched right rows
-    if (how == JOIN_RIGHT) {
-        for (size_t rr=0; rr< rightRows; rr++) {
-            if (!matchedRight[rr]) {
-                // produce row => "NA" for left columns, actual for right
-                // fill left with NA
-                for (size_t c=0; c< leftCols; c++){
-                    const Series* sL= left->getSeries(left,c);
-                    switch(sL->type){
-                        case DF_INT:
-                            seriesAddInt(&outCols[c], 0);
-                            break;
-                        case DF_DOUBLE:
-                            seriesAddDouble(&outCols[c], 0.0);
-                            break;
-                        case DF_STRING:
-                            seriesAddString(&outCols[c], "NA");
-                            break;
-                        /* NEW: DF_DATETIME => store 0 for NA */
-                        case DF_DATETIME:
-                            seriesAddDateTime(&outCols[c], 0LL);
-                            break;
-                    }
-                }
-                // copy right row except key
-                size_t ro2= leftCols;
-                for (size_t rc=0; rc< rightCols; rc++){
-                    if (rc== rightKeyIndex) continue;
-                    const Series* sR= right->getSeries(right, rc);
-                    switch(sR->type) {
-                        case DF_INT: {
-                            int v; 
-                            if (seriesGetInt(sR, rr, &v))
-                                seriesAddInt(&outCols[ro2], v);
-                            else 
-                                seriesAddInt(&outCols[ro2], 0);
-                        } break;
-                        case DF_DOUBLE: {
-                            double d; 
-                            if (seriesGetDouble(sR, rr, &d))
-                                seriesAddDouble(&outCols[ro2], d);
-                            else 
-                                seriesAddDouble(&outCols[ro2], 0.0);
-                        } break;
-                        case DF_STRING: {
-                            char* st=NULL;
-                            if (seriesGetString(sR, rr, &st)) {
-                                seriesAddString(&outCols[ro2], st);
-                                free(st);
-                            } else {
-                                seriesAddString(&outCols[ro2], "NA");
-                            }
-                        } break;
-                        /* NEW: DF_DATETIME */
-                        case DF_DATETIME: {
-                            long long dtVal;
-                            if (seriesGetDateTime(sR, rr, &dtVal)) {
-                                seriesAddDateTime(&outCols[ro2], dtVal);
-                            } else {
-                                // treat as "NA"
-                                seriesAddDateTime(&outCols[ro2], 0LL);
-                            }
-                        } break;
-                    }
-                    ro2++;
-                }
-            }
-        }
+    for (size_t c=0; c<leftCols; c++) {
+        appendJoinedColumn(&outCols[c], left->ops->getSeries(left,c), pairs.left, pairs.count);
+    }
+    size_t ro2 = leftCols;
+    for (size_t rc=0; rc< rightCols; rc++){
+        if (rc== rightKeyIndex) continue;
+        appendJoinedColumn(&outCols[ro2++], right->ops->getSeries(right, rc), pairs.right, pairs.count);
     }
+    freePairs(&pairs);
 
     // build final DF
     DataFrame output;
     DataFrame_Create(&output);
     for (size_t c=0; c< totalCols; c++){
-        output.addSeries(&output, &outCols[c]);
-        seriesFree(&outCols[c]);
+        output.ops->addSeriesMove(&output, &outCols[c]);
     }
     free(outCols);
-    free(matchedRight);
 
     return output;
 }
@@ -976,19 +536,20 @@ DataFrame dfJoin_impl(const DataFrame* left,
  */
 DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
 {
+    DF_OP_SCOPE();
     // Step 1) row-wise concat
     DataFrame combined = dfConcat_impl(dfA, dfB);
 
     // Step 2) remove duplicates (naive approach)
     // We'll do an O(n^2) pass that checks row i vs row j for duplicates.
     // If you already have a "dropDuplicates" function, just call it:
-    //   DataFrame result = combined.dropDuplicates(&combined, NULL, 0);
+    //   DataFrame result = combined.ops->dropDuplicates(&combined, NULL, 0);
     //   DataFrame_Destroy(&combined);
     //   return result;
     // For demonstration, let's do it inline:
 
-    size_t nRows = combined.numRows(&combined);
-    size_t nCols = combined.numColumns(&combined);
+    size_t nRows = combined.ops->numRows(&combined);
+    size_t nCols = combined.ops->numColumns(&combined);
 
     bool* toRemove = (bool*)calloc(nRows, sizeof(bool));
 
@@ -1000,14 +561,14 @@ DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
             bool same = true;
             void** rowI = NULL;
             void** rowJ = NULL;
-            combined.getRow(&combined, i, &rowI);
-            combined.getRow(&combined, j, &rowJ);
+            combined.ops->getRow(&combined, i, &rowI);
+            combined.ops->getRow(&combined, j, &rowJ);
 
             for (size_t c = 0; c < nCols; c++) {
                 // We can do a string compare if DF_STRING, or memcmp if numeric.
                 // But since getRow returned pointers, we compare by type?
                 // If your aggregator has the types, let's do a naive approach:
-                const Series* s = combined.getSeries(&combined, c);
+                const Series* s = combined.ops->getSeries(&combined, c);
                 switch(s->type) {
                     case DF_INT: {
                         int* vi = (int*)rowI[c];
@@ -1019,7 +580,8 @@ DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
                         double* dj = (double*)rowJ[c];
                         if (!di || !dj || (*di != *dj)) same=false;
                     } break;
-                    case DF_STRING: {
+                    case DF_STRING:
+                    case DF_CATEGORY: {
                         char* si = (char*)rowI[c];
                         char* sj = (char*)rowJ[c];
                         if (!si || !sj || (strcmp(si, sj)!=0)) same=false;
@@ -1029,6 +591,11 @@ DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
                         long long* lj = (long long*)rowJ[c];
                         if (!li || !lj || (*li != *lj)) same=false;
                     } break;
+                    default:
+                        // fixed-width types: compare the raw values
+                        if (!rowI[c] || !rowJ[c] ||
+                            memcmp(rowI[c], rowJ[c], seriesValueSize(s)) != 0) same=false;
+                        break;
                 }
                 if (!same) break;
             }
@@ -1054,11 +621,10 @@ DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
 
     // Create empty columns with same schema
     for (size_t c=0; c< nCols; c++){
-        const Series* sc = combined.getSeries(&combined, c);
+        const Series* sc = combined.ops->getSeries(&combined, c);
         Series newS;
         seriesInit(&newS, sc->name, sc->type);
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
     // add rows if !toRemove[r]
@@ -1066,8 +632,8 @@ DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
         if (!toRemove[r]) {
             // get row r
             void** rowData=NULL;
-            combined.getRow(&combined, r, &rowData);
-            result.addRow(&result, (const void**)rowData);
+            combined.ops->getRow(&combined, r, &rowData);
+            result.ops->addRow(&result, (const void**)rowData);
 
             // free rowData
             for (size_t cc=0; cc<nCols; cc++) {
@@ -1085,6 +651,7 @@ DataFrame dfUnion_impl(const DataFrame* dfA, const DataFrame* dfB)
 
 DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!dfA || !dfB) return result;
@@ -1094,28 +661,27 @@ DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
     // For brevity, let's assume they match.
 
     // We'll build an empty result with same schema
-    size_t nCols = dfA->numColumns(dfA);
+    size_t nCols = dfA->ops->numColumns(dfA);
     for (size_t c=0; c< nCols; c++){
-        const Series* sA= dfA->getSeries(dfA, c);
+        const Series* sA= dfA->ops->getSeries(dfA, c);
         Series newS;
         seriesInit(&newS, sA->name, sA->type);
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
     // For each row in A => check if it also appears in B.
-    size_t aRows = dfA->numRows(dfA);
+    size_t aRows = dfA->ops->numRows(dfA);
     for (size_t ar=0; ar< aRows; ar++){
         // read row from A
         void** rowData=NULL;
-        dfA->getRow(dfA, ar, &rowData);
+        dfA->ops->getRow(dfA, ar, &rowData);
         // check if rowData exists in B
         bool found = false;
-        size_t bRows = dfB->numRows(dfB);
+        size_t bRows = dfB->ops->numRows(dfB);
 
         for (size_t br=0; br< bRows; br++){
             void** rowB = NULL;
-            dfB->getRow(dfB, br, &rowB);
+            dfB->ops->getRow(dfB, br, &rowB);
             // compare rowData vs rowB
             bool same = true;
             for (size_t c=0; c< nCols; c++){
@@ -1124,7 +690,7 @@ DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
                     same=false; 
                     break;
                 }
-                const Series* sA= dfA->getSeries(dfA, c);
+                const Series* sA= dfA->ops->getSeries(dfA, c);
                 switch(sA->type) {
                     case DF_INT:
                         if ( *((int*)rowData[c]) != *((int*)rowB[c]) ) same=false;
@@ -1133,11 +699,16 @@ DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
                         if ( *((double*)rowData[c]) != *((double*)rowB[c]) ) same=false;
                         break;
                     case DF_STRING:
+                    case DF_CATEGORY:
                         if (strcmp((char*)rowData[c], (char*)rowB[c])!=0) same=false;
                         break;
                     case DF_DATETIME:
                         if ( *((long long*)rowData[c]) != *((long long*)rowB[c]) ) same=false;
                         break;
+                    default:
+                        // fixed-width types: compare the raw values
+                        if (memcmp(rowData[c], rowB[c], seriesValueSize(sA)) != 0) same=false;
+                        break;
                 }
                 if (!same) break;
             }
@@ -1156,7 +727,7 @@ DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
 
         if (found) {
             // add rowData to result
-            result.addRow(&result, (const void**)rowData);
+            result.ops->addRow(&result, (const void**)rowData);
         }
 
         // free rowData
@@ -1168,7 +739,7 @@ DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
 
     // optionally drop duplicates if you want a pure set intersection
     // or rely on existing dropDuplicates function
-    DataFrame finalNoDup = result.dropDuplicates(&result, NULL, 0);
+    DataFrame finalNoDup = result.ops->dropDuplicates(&result, NULL, 0);
     DataFrame_Destroy(&result);
     return finalNoDup;
 }
@@ -1176,6 +747,7 @@ DataFrame dfIntersection_impl(const DataFrame* dfA, const DataFrame* dfB)
 
 DataFrame dfDifference_impl(const DataFrame* dfA, const DataFrame* dfB)
 {
+    DF_OP_SCOPE();
     // same approach as intersection, but we keep rows that are *not* found in B.
     DataFrame result;
     DataFrame_Create(&result);
@@ -1183,31 +755,30 @@ DataFrame dfDifference_impl(const DataFrame* dfA, const DataFrame* dfB)
     if (!dfA || !dfB) return result;
 
     // assume same columns
-    size_t nCols = dfA->numColumns(dfA);
+    size_t nCols = dfA->ops->numColumns(dfA);
     // build result schema
     for (size_t c=0; c<nCols; c++){
-        const Series* sA= dfA->getSeries(dfA, c);
+        const Series* sA= dfA->ops->getSeries(dfA, c);
         Series newS;
         seriesInit(&newS, sA->name, sA->type);
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
-    size_t aRows= dfA->numRows(dfA);
+    size_t aRows= dfA->ops->numRows(dfA);
     for (size_t ar=0; ar < aRows; ar++){
         void** rowData=NULL;
-        dfA->getRow(dfA, ar, &rowData);
+        dfA->ops->getRow(dfA, ar, &rowData);
 
         bool foundInB= false;
-        size_t bRows= dfB->numRows(dfB);
+        size_t bRows= dfB->ops->numRows(dfB);
         for (size_t br=0; br< bRows; br++){
             // compare row ar in A with row br in B
             void** rowB=NULL;
-            dfB->getRow(dfB, br, &rowB);
+            dfB->ops->getRow(dfB, br, &rowB);
             bool same=true;
             for (size_t c=0; c<nCols; c++){
                 if (!rowData[c] || !rowB[c]) {same=false; break;}
-                const Series* s= dfA->getSeries(dfA, c);
+                const Series* s= dfA->ops->getSeries(dfA, c);
                 switch(s->type){
                     case DF_INT:
                         if (*(int*)rowData[c] != *(int*)rowB[c]) same=false;
@@ -1216,11 +787,16 @@ DataFrame dfDifference_impl(const DataFrame* dfA, const DataFrame* dfB)
                         if (*(double*)rowData[c] != *(double*)rowB[c]) same=false;
                         break;
                     case DF_STRING:
+                    case DF_CATEGORY:
                         if (strcmp((char*)rowData[c], (char*)rowB[c])!=0) same=false;
                         break;
                     case DF_DATETIME:
                         if (*(long long*)rowData[c] != *(long long*)rowB[c]) same=false;
                         break;
+                    default:
+                        // fixed-width types: compare the raw values
+                        if (memcmp(rowData[c], rowB[c], seriesValueSize(s)) != 0) same=false;
+                        break;
                 }
                 if (!same) break;
             }
@@ -1238,7 +814,7 @@ DataFrame dfDifference_impl(const DataFrame* dfA, const DataFrame* dfB)
 
         // if NOT found in B => keep row
         if (!foundInB){
-            result.addRow(&result, (const void**)rowData);
+            result.ops->addRow(&result, (const void**)rowData);
         }
 
         // free rowData
@@ -1257,30 +833,16 @@ DataFrame dfSemiJoin_impl(const DataFrame* left,
                           const char* leftKey,
                           const char* rightKey)
 {
+    DF_OP_SCOPE();
     // 1) Check valid
     DataFrame result;
     DataFrame_Create(&result);
     if (!left || !right || !leftKey || !rightKey) return result;
 
     // 2) find leftKeyIndex, rightKeyIndex
-    size_t leftCols = left->numColumns(left);
-    size_t rightCols= right->numColumns(right);
-    size_t leftKeyIndex=(size_t)-1, rightKeyIndex=(size_t)-1;
-
-    for (size_t i=0; i<leftCols; i++){
-        const Series* s= left->getSeries(left,i);
-        if (strcmp(s->name, leftKey)==0) {
-            leftKeyIndex= i;
-            break;
-        }
-    }
-    for (size_t i=0; i<rightCols; i++){
-        const Series* s= right->getSeries(right,i);
-        if (strcmp(s->name, rightKey)==0) {
-            rightKeyIndex= i;
-            break;
-        }
-    }
+    size_t leftCols = left->ops->numColumns(left);
+    size_t leftKeyIndex = left->ops->columnIndex(left, leftKey);
+    size_t rightKeyIndex = right->ops->columnIndex(right, rightKey);
     if (leftKeyIndex==(size_t)-1 || rightKeyIndex==(size_t)-1) {
         fprintf(stderr,"dfSemiJoin_impl: key not found.\n");
         return result;
@@ -1288,16 +850,15 @@ DataFrame dfSemiJoin_impl(const DataFrame* left,
 
     // 3) build result with same columns as left
     for (size_t c=0; c< leftCols; c++){
-        const Series* sL= left->getSeries(left, c);
+        const Series* sL= left->ops->getSeries(left, c);
         Series newS;
         seriesInit(&newS, sL->name, sL->type);
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
     // 4) for each row in left => check if there's a match in right => if yes => add row
-    const Series* sLeftKey= left->getSeries(left, leftKeyIndex);
-    const Series* sRightKey= right->getSeries(right, rightKeyIndex);
+    const Series* sLeftKey= left->ops->getSeries(left, leftKeyIndex);
+    const Series* sRightKey= right->ops->getSeries(right, rightKeyIndex);
     if (!sLeftKey || !sRightKey) return result;
 
     // key type must match
@@ -1306,8 +867,8 @@ DataFrame dfSemiJoin_impl(const DataFrame* left,
         return result;
     }
 
-    size_t lRows= left->numRows(left);
-    size_t rRows= right->numRows(right);
+    size_t lRows= left->ops->numRows(left);
+    size_t rRows= right->ops->numRows(right);
 
     for (size_t lr=0; lr< lRows; lr++){
         bool matched=false;
@@ -1332,16 +893,15 @@ DataFrame dfSemiJoin_impl(const DataFrame* left,
                     if (lv==rv){ matched=true; break; }
                 }
             } break;
-            case DF_STRING:{
-                char* lv=NULL;
-                if (!seriesGetString(sLeftKey, lr, &lv)) break;
+            case DF_STRING:
+            case DF_CATEGORY:{
+                const char* lv=NULL;
+                if (!seriesGetStringView(sLeftKey, lr, &lv, NULL)) break;
                 for (size_t rr=0; rr< rRows; rr++){
-                    char* rv=NULL;
-                    if (!seriesGetString(sRightKey, rr, &rv)) continue;
-                    if (strcmp(lv, rv)==0){ matched=true; free(rv); break; }
-                    free(rv);
+                    const char* rv=NULL;
+                    if (!seriesGetStringView(sRightKey, rr, &rv, NULL)) continue;
+                    if (strcmp(lv, rv)==0){ matched=true; break; }
                 }
-                if (lv) free(lv);
             } break;
             case DF_DATETIME:{
                 long long lv;
@@ -1352,14 +912,24 @@ DataFrame dfSemiJoin_impl(const DataFrame* left,
                     if (lv==rv){ matched=true; break; }
                 }
             } break;
+            default:{
+                // fixed-width key types: compare the values
+                uint64_t lv = 0;
+                if (!seriesGetValue(sLeftKey, lr, &lv)) break;
+                for (size_t rr=0; rr< rRows; rr++){
+                    uint64_t rv = 0;
+                    if (!seriesGetValue(sRightKey, rr, &rv)) continue;
+                    if (lv==rv){ matched=true; break; }
+                }
+            } break;
         }
         if (matched){
             // add entire left row
             void** rowData=NULL;
-            left->getRow(left, lr, &rowData);
-            result.addRow(&result, (const void**)rowData);
+            left->ops->getRow(left, lr, &rowData);
+            result.ops->addRow(&result, (const void**)rowData);
             // free rowData
-            size_t nLC= left->numColumns(left);
+            size_t nLC= left->ops->numColumns(left);
             for (size_t c=0; c<nLC; c++){
                 if (rowData[c]) free(rowData[c]);
             }
@@ -1375,23 +945,15 @@ DataFrame dfAntiJoin_impl(const DataFrame* left,
                           const char* leftKey,
                           const char* rightKey)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!left || !right || !leftKey || !rightKey) return result;
 
     // find leftKeyIndex, rightKeyIndex
-    size_t lCols= left->numColumns(left);
-    size_t rCols= right->numColumns(right);
-    size_t leftKeyIndex=(size_t)-1, rightKeyIndex=(size_t)-1;
-
-    for (size_t i=0; i<lCols; i++){
-        const Series* s= left->getSeries(left,i);
-        if (s && strcmp(s->name,leftKey)==0){ leftKeyIndex=i; break; }
-    }
-    for (size_t i=0; i< rCols; i++){
-        const Series* s= right->getSeries(right,i);
-        if (s && strcmp(s->name,rightKey)==0){ rightKeyIndex=i; break; }
-    }
+    size_t lCols= left->ops->numColumns(left);
+    size_t leftKeyIndex = left->ops->columnIndex(left, leftKey);
+    size_t rightKeyIndex = right->ops->columnIndex(right, rightKey);
     if (leftKeyIndex==(size_t)-1 || rightKeyIndex==(size_t)-1){
         fprintf(stderr,"dfAntiJoin: key not found.\n");
         return result;
@@ -1399,23 +961,22 @@ DataFrame dfAntiJoin_impl(const DataFrame* left,
 
     // build result with same columns as left
     for (size_t c=0; c<lCols; c++){
-        const Series* sL= left->getSeries(left,c);
+        const Series* sL= left->ops->getSeries(left,c);
         Series newS;
         seriesInit(&newS, sL->name, sL->type);
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
-    const Series* sLeftKey= left->getSeries(left, leftKeyIndex);
-    const Series* sRightKey= right->getSeries(right, rightKeyIndex);
+    const Series* sLeftKey= left->ops->getSeries(left, leftKeyIndex);
+    const Series* sRightKey= right->ops->getSeries(right, rightKeyIndex);
     if (!sLeftKey || !sRightKey) return result;
     if (sLeftKey->type != sRightKey->type){
         fprintf(stderr,"dfAntiJoin: key type mismatch.\n");
         return result;
     }
 
-    size_t lRows= left->numRows(left);
-    size_t rRows= right->numRows(right);
+    size_t lRows= left->ops->numRows(left);
+    size_t rRows= right->ops->numRows(right);
 
     // for each row in left => check if it matches any in right => if no => keep
     for (size_t lr=0; lr<lRows; lr++){
@@ -1439,16 +1000,15 @@ DataFrame dfAntiJoin_impl(const DataFrame* left,
                     if (lv==rv){ matched=true; break; }
                 }
             } break;
-            case DF_STRING:{
-                char* lv=NULL;
-                if (!seriesGetString(sLeftKey, lr, &lv)) break;
+            case DF_STRING:
+            case DF_CATEGORY:{
+                const char* lv=NULL;
+                if (!seriesGetStringView(sLeftKey, lr, &lv, NULL)) break;
                 for (size_t rr=0; rr< rRows; rr++){
-                    char* rv=NULL;
-                    if (!seriesGetString(sRightKey, rr, &rv)) continue;
-                    if (strcmp(lv, rv)==0){ matched=true; free(rv); break; }
-                    free(rv);
+                    const char* rv=NULL;
+                    if (!seriesGetStringView(sRightKey, rr, &rv, NULL)) continue;
+                    if (strcmp(lv, rv)==0){ matched=true; break; }
                 }
-                if (lv) free(lv);
             } break;
             case DF_DATETIME:{
                 long long lv;
@@ -1459,12 +1019,22 @@ DataFrame dfAntiJoin_impl(const DataFrame* left,
                     if (lv==rv){ matched=true; break; }
                 }
             } break;
+            default:{
+                // fixed-width key types: compare the values
+                uint64_t lv = 0;
+                if (!seriesGetValue(sLeftKey, lr, &lv)) break;
+                for (size_t rr=0; rr< rRows; rr++){
+                    uint64_t rv = 0;
+                    if (!seriesGetValue(sRightKey, rr, &rv)) continue;
+                    if (lv==rv){ matched=true; break; }
+                }
+            } break;
         }
         if (!matched){
             // add entire left row
             void** rowData=NULL;
-            left->getRow(left, lr, &rowData);
-            result.addRow(&result, (const void**)rowData);
+            left->ops->getRow(left, lr, &rowData);
+            result.ops->addRow(&result, (const void**)rowData);
             // free rowData
             for (size_t c=0; c<lCols; c++){
                 if (rowData[c]) free(rowData[c]);
@@ -1480,107 +1050,124 @@ DataFrame dfAntiJoin_impl(const DataFrame* left,
 DataFrame dfCrossJoin_impl(const DataFrame* left,
                            const DataFrame* right)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!left || !right) return result;
 
-    size_t leftCols= left->numColumns(left);
-    size_t rightCols= right->numColumns(right);
+    size_t leftCols= left->ops->numColumns(left);
+    size_t rightCols= right->ops->numColumns(right);
     // Build columns => left columns + right columns
     size_t totalCols= leftCols + rightCols;
     Series* outCols= (Series*)calloc(totalCols, sizeof(Series));
 
     // init from left
     for (size_t c=0; c<leftCols; c++){
-        const Series* sL= left->getSeries(left,c);
+        const Series* sL= left->ops->getSeries(left,c);
         seriesInit(&outCols[c], sL->name, sL->type);
     }
     // init from right
     for (size_t c=0; c< rightCols; c++){
-        const Series* sR= right->getSeries(right,c);
+        const Series* sR= right->ops->getSeries(right,c);
         seriesInit(&outCols[leftCols + c], sR->name, sR->type);
     }
 
-    size_t lRows= left->numRows(left);
-    size_t rRows= right->numRows(right);
+    size_t lRows= left->ops->numRows(left);
+    size_t rRows= right->ops->numRows(right);
 
     // for each row in left => each row in right => produce combined row
     for (size_t lr=0; lr< lRows; lr++){
         // read left row
         void** rowLeft= NULL;
-        left->getRow(left, lr, &rowLeft);
+        left->ops->getRow(left, lr, &rowLeft);
 
         for (size_t rr=0; rr< rRows; rr++){
             void** rowRight=NULL;
-            right->getRow(right, rr, &rowRight);
+            right->ops->getRow(right, rr, &rowRight);
 
             // add to outCols => copy left row into [0..leftCols-1], 
             //                  copy right row into [leftCols..end]
             // This means we do "append" to each column.
             for (size_t c=0; c< leftCols; c++){
                 // rowLeft[c] is the cell in left
-                const Series* sL= left->getSeries(left,c);
+                const Series* sL= left->ops->getSeries(left,c);
                 switch(sL->type){
                     case DF_INT:
                         if (rowLeft[c]) {
                             seriesAddInt(&outCols[c], *(int*)rowLeft[c]);
                         } else {
-                            seriesAddInt(&outCols[c], 0);
+                            seriesAddNull(&outCols[c]);
                         }
                         break;
                     case DF_DOUBLE:
                         if (rowLeft[c]) {
                             seriesAddDouble(&outCols[c], *(double*)rowLeft[c]);
                         } else {
-                            seriesAddDouble(&outCols[c], 0.0);
+                            seriesAddNull(&outCols[c]);
                         }
                         break;
                     case DF_STRING:
+                    case DF_CATEGORY:
                         if (rowLeft[c]) {
                             seriesAddString(&outCols[c], (char*)rowLeft[c]);
                         } else {
-                            seriesAddString(&outCols[c], "NA");
+                            seriesAddNull(&outCols[c]);
                         }
                         break;
                     case DF_DATETIME:
                         if (rowLeft[c]) {
                             seriesAddDateTime(&outCols[c], *(long long*)rowLeft[c]);
                         } else {
-                            seriesAddDateTime(&outCols[c], 0LL);
+                            seriesAddNull(&outCols[c]);
+                        }
+                        break;
+                    default:
+                        if (rowLeft[c]) {
+                            seriesAddValue(&outCols[c], rowLeft[c]);
+                        } else {
+                            seriesAddNull(&outCols[c]);
                         }
                         break;
                 }
             }
             for (size_t c=0; c< rightCols; c++){
-                const Series* sR= right->getSeries(right,c);
+                const Series* sR= right->ops->getSeries(right,c);
                 size_t outIndex= leftCols + c;
                 switch(sR->type){
                     case DF_INT:
                         if (rowRight[c]) {
                             seriesAddInt(&outCols[outIndex], *(int*)rowRight[c]);
                         } else {
-                            seriesAddInt(&outCols[outIndex], 0);
+                            seriesAddNull(&outCols[outIndex]);
                         }
                         break;
                     case DF_DOUBLE:
                         if (rowRight[c]) {
                             seriesAddDouble(&outCols[outIndex], *(double*)rowRight[c]);
                         } else {
-                            seriesAddDouble(&outCols[outIndex], 0.0);
+                            seriesAddNull(&outCols[outIndex]);
                         }
                         break;
                     case DF_STRING:
+                    case DF_CATEGORY:
                         if (rowRight[c]) {
                             seriesAddString(&outCols[outIndex], (char*)rowRight[c]);
                         } else {
-                            seriesAddString(&outCols[outIndex], "NA");
+                            seriesAddNull(&outCols[outIndex]);
                         }
                         break;
                     case DF_DATETIME:
                         if (rowRight[c]) {
                             seriesAddDateTime(&outCols[outIndex], *(long long*)rowRight[c]);
                         } else {
-                            seriesAddDateTime(&outCols[outIndex], 0LL);
+                            seriesAddNull(&outCols[outIndex]);
+                        }
+                        break;
+                    default:
+                        if (rowRight[c]) {
+                            seriesAddValue(&outCols[outIndex], rowRight[c]);
+                        } else {
+                            seriesAddNull(&outCols[outIndex]);
                         }
                         break;
                 }
@@ -1603,8 +1190,7 @@ DataFrame dfCrossJoin_impl(const DataFrame* left,
     DataFrame out;
     DataFrame_Create(&out);
     for (size_t c=0; c< totalCols; c++){
-        out.addSeries(&out, &outCols[c]);
-        seriesFree(&outCols[c]);
+        out.ops->addSeriesMove(&out, &outCols[c]);
     }
     free(outCols);
 
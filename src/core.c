@@ -2,7 +2,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 
 // If your DataFrame struct references RowPredicate or RowFunction, 
 // make sure they are declared in `dataframe.h`, e.g.:
@@ -16,25 +18,35 @@
 extern void dfInit_impl(DataFrame* df);
 extern void dfFree_impl(DataFrame* df);
 extern bool dfAddSeries_impl(DataFrame* df, const Series* s);
+extern bool dfAddSeriesMove_impl(DataFrame* df, Series* s);
 extern size_t dfNumColumns_impl(const DataFrame* df);
 extern size_t dfNumRows_impl(const DataFrame* df);
 extern const Series* dfGetSeries_impl(const DataFrame* df, size_t colIndex);
 extern bool dfAddRow_impl(DataFrame* df, const void** rowData);
+extern bool dfAppendColumns_impl(DataFrame* df, const void* const* columnArrays, size_t n);
 extern bool dfGetRow_impl(const DataFrame* df, size_t rowIndex, void*** outRow);
+extern size_t dfColumnIndex_impl(const DataFrame* df, const char* name);
+extern DataFrame dfMemoryUsage_impl(const DataFrame* df, bool deep);
 
 /* The corrected signatures now return DataFrame: */
 extern DataFrame dfHead_impl(const DataFrame* df, size_t n);
 extern DataFrame dfTail_impl(const DataFrame* df, size_t n);
 extern DataFrame dfDescribe_impl(const DataFrame* df);
 extern DataFrame dfSlice_impl(const DataFrame* df, size_t start, size_t end);
+extern DataFrame dfMaterialize_impl(const DataFrame* df);
 extern DataFrame dfSample_impl(const DataFrame* df, size_t count);
 extern DataFrame dfSelectColumns_impl(const DataFrame* df, const size_t* colIndices, size_t count);
 extern DataFrame dfDropColumns_impl(const DataFrame* df, const size_t* dropIndices, size_t dropCount);
 extern DataFrame dfRenameColumns_impl(const DataFrame* df, const char** oldNames, const char** newNames, size_t count);
 extern DataFrame dfFilter_impl(const DataFrame* df, RowPredicate);
+extern DfSelection dfFilterSelection_impl(const DataFrame* df, RowPredicate, const DfSelection* within);
+extern DataFrame dfFilterMask_impl(const DataFrame* df, const DfMask* keep);
+extern DfSelection dfSortSelection_impl(const DataFrame* df, size_t colIndex, bool ascending, const DfSelection* sel);
+extern DfSelection dfTopSelection_impl(const DataFrame* df, size_t colIndex, bool ascending, size_t k, const DfSelection* sel);
 extern DataFrame dfDropNA_impl(const DataFrame* df);
 extern DataFrame dfSort_impl(const DataFrame* df, size_t colIndex, bool ascending);
 extern DataFrame dfGroupBy_impl(const DataFrame* df, size_t groupColIndex);
+extern DataFrame dfGroupBySelection_impl(const DataFrame* df, size_t groupColIndex, const DfSelection* sel);
 extern DataFrame dfPivot_impl(const DataFrame* df, size_t indexCol, size_t columnsCol, size_t valuesCol);
 extern DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount);
 extern DataFrame dfDropDuplicates_impl(const DataFrame* df, const size_t* subsetCols, size_t subsetCount);
@@ -42,6 +54,8 @@ extern DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex);
 
 extern double   dfSum_impl(const DataFrame* df, size_t colIndex);
 extern double   dfMean_impl(const DataFrame* df, size_t colIndex);
+extern double   dfSumSelection_impl(const DataFrame* df, size_t colIndex, const DfSelection* sel);
+extern double   dfMeanSelection_impl(const DataFrame* df, size_t colIndex, const DfSelection* sel);
 extern double   dfMin_impl(const DataFrame* df, size_t colIndex);
 extern double   dfMax_impl(const DataFrame* df, size_t colIndex);
 
@@ -52,9 +66,12 @@ extern double   dfStd_impl(const DataFrame* df, size_t colIndex);
 extern double   dfVar_impl(const DataFrame* df, size_t colIndex);
 extern double   dfRange_impl(const DataFrame* df, size_t colIndex);
 extern double   dfQuantile_impl(const DataFrame* df, size_t colIndex, double q);
+extern bool     dfQuantiles_impl(const DataFrame* df, size_t colIndex, const double* qs, size_t nq, double* out);
+extern double   dfApproxQuantile_impl(const DataFrame* df, size_t colIndex, double q, double errorBound);
 extern double   dfIQR_impl(const DataFrame* df, size_t colIndex);
 extern double   dfNullCount_impl(const DataFrame* df, size_t colIndex);
 extern double   dfUniqueCount_impl(const DataFrame* df, size_t colIndex);
+extern double   dfApproxUniqueCount_impl(const DataFrame* df, size_t colIndex, int precision);
 extern double   dfProduct_impl(const DataFrame* df, size_t colIndex);
 extern double   dfNthLargest_impl(const DataFrame* df, size_t colIndex, size_t n);
 extern double   dfNthSmallest_impl(const DataFrame* df, size_t colIndex, size_t n);
@@ -74,6 +91,7 @@ extern DataFrame dfTranspose_impl(const DataFrame* df);
 extern size_t    dfIndexOf_impl(const DataFrame* df, size_t colIndex, double value);
 extern DataFrame dfApply_impl(const DataFrame* df, RowFunction);
 extern DataFrame dfWhere_impl(const DataFrame* df, RowPredicate, double);
+extern DataFrame dfWhereMask_impl(const DataFrame* df, const DfMask* keep, double defaultVal);
 extern DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex);
 
 extern DataFrame dfAt_impl(const DataFrame* df, size_t rowIndex, const char* colName);
@@ -91,6 +109,7 @@ extern DataFrame dfSetColumn_impl(const DataFrame* df, const char* colName, cons
 extern DataFrame dfRenameColumn_impl(const DataFrame* df, const char* oldName, const char* newName);
 extern DataFrame dfReindex_impl(const DataFrame* df, const size_t* newIndices, size_t newN);
 extern DataFrame dfTake_impl(const DataFrame* df, const size_t* rowIndices, size_t count);
+extern DataFrame dfTakeSelection_impl(const DataFrame* df, const DfSelection* sel);
 extern DataFrame dfReorderColumns_impl(const DataFrame* df, const size_t* newOrder, size_t colCount);
 
 /* Existing combine: */
@@ -109,6 +128,7 @@ extern DataFrame dfCrossJoin_impl(const DataFrame* left, const DataFrame* right)
 /* Other non-query methods: */
 extern void dfPrint_impl(const DataFrame* df);
 extern bool readCsv_impl(DataFrame* df, const char* filename);
+extern bool readCsvScan_impl(DataFrame* df, const char* filename, const DfCsvScan* scan);
 extern void dfPlot_impl(const DataFrame* df,
                         size_t xColIndex,
                         const size_t* yColIndices,
@@ -174,6 +194,58 @@ void dfInit_impl(DataFrame* df)
     // Initialize the 'columns' dynamic array with initial capacity
     daInit(&df->columns, 4);
     df->nrows = 0;
+    df->nameSlots = NULL;
+    df->nameSlotCap = 0;
+}
+
+/**
+ * @brief Append `n` rows given column-wise: columnArrays[c] points to `n`
+ *        values of column c's C type (int, double, long long, int8_t ...,
+ *        float), or to `n` `const char*` for DF_STRING / DF_CATEGORY (NULL
+ *        entries become nulls). Each numeric column is copied with one
+ *        memcpy. Nothing is appended unless every column array is present
+ *        and every column could reserve room for the batch.
+ */
+bool dfAppendColumns_impl(DataFrame* df, const void* const* columnArrays, size_t n)
+{
+    DF_OP_SCOPE();
+    if (!df || !columnArrays) return false;
+
+    size_t nCols = daSize(&df->columns);
+    if (nCols == 0) {
+        fprintf(stderr, "Error: DataFrame has no columns; can't append rows.\n");
+        return false;
+    }
+    for (size_t c = 0; c < nCols; c++) {
+        Series* s = (Series*)daGetMutable(&df->columns, c);
+        if (!s || (!columnArrays[c] && n > 0)) return false;
+        if (!seriesReserve(s, df->nrows + n)) {
+            fprintf(stderr, "Error: can't reserve %zu rows for column '%s'.\n",
+                    df->nrows + n, s->name);
+            return false;
+        }
+    }
+
+    for (size_t c = 0; c < nCols; c++) {
+        Series* s = (Series*)daGetMutable(&df->columns, c);
+        bool ok;
+        switch (s->type) {
+            case DF_STRING:
+            case DF_CATEGORY:
+                ok = seriesAppendStrings(s, (const char* const*)columnArrays[c], n);
+                break;
+            default:
+                ok = seriesAppendValues(s, columnArrays[c], n);
+                break;
+        }
+        if (!ok || seriesSize(s) != df->nrows + n) {
+            fprintf(stderr, "Error: appending %zu rows to column '%s' failed.\n",
+                    n, s->name);
+            return false;
+        }
+    }
+    df->nrows += n;
+    return true;
 }
 
 void dfFree_impl(DataFrame* df)
@@ -186,133 +258,298 @@ void dfFree_impl(DataFrame* df)
     }
     daFree(&df->columns);
     df->nrows = 0;
+    free(df->nameSlots);
+    df->nameSlots = NULL;
+    df->nameSlotCap = 0;
 }
 
 /* -------------------------------------------------------------
- * DataFrame_Create
+ * Column name index
  * ------------------------------------------------------------- */
-void DataFrame_Create(DataFrame* df)
+
+static size_t hashName(const char* name)
+{
+    // FNV-1a
+    uint64_t h = 1469598103934665603ULL;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        h ^= *p;
+        h *= 1099511628211ULL;
+    }
+    return (size_t)h;
+}
+
+static void nameIndexPut(size_t* slots, size_t cap, const char* name, size_t colIndex)
+{
+    size_t mask = cap - 1;
+    size_t i = hashName(name) & mask;
+    while (slots[i]) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = colIndex + 1;
+}
+
+void dfRebuildNameIndex(DataFrame* df)
 {
     if (!df) return;
-    memset(df, 0, sizeof(*df));
+    size_t nCols = daSize(&df->columns);
+    free(df->nameSlots);
+    df->nameSlots = NULL;
+    df->nameSlotCap = 0;
+    if (nCols == 0) return;
+
+    // keep the load factor at or below 1/2
+    size_t cap = 16;
+    while (cap < nCols * 2) cap *= 2;
+    size_t* slots = (size_t*)calloc(cap, sizeof(size_t));
+    if (!slots) return; // lookups fall back to a linear scan
+
+    for (size_t c = 0; c < nCols; c++) {
+        const Series* s = (const Series*)daGet(&df->columns, c);
+        nameIndexPut(slots, cap, s->name ? s->name : "", c);
+    }
+    df->nameSlots = slots;
+    df->nameSlotCap = cap;
+}
+
+// record the column just pushed at index nCols-1
+static void nameIndexAdd(DataFrame* df)
+{
+    size_t nCols = daSize(&df->columns);
+    if (!df->nameSlots || nCols * 2 > df->nameSlotCap) {
+        dfRebuildNameIndex(df);
+        return;
+    }
+    const Series* s = (const Series*)daGet(&df->columns, nCols - 1);
+    nameIndexPut(df->nameSlots, df->nameSlotCap, s->name ? s->name : "", nCols - 1);
+}
+
+size_t dfColumnIndexFrom(const DataFrame* df, const char* name, size_t from)
+{
+    if (!df || !name) return (size_t)-1;
+    size_t nCols = daSize(&df->columns);
+
+    if (!df->nameSlots) {
+        for (size_t c = from; c < nCols; c++) {
+            const Series* s = (const Series*)daGet(&df->columns, c);
+            if (s->name && strcmp(s->name, name) == 0) return c;
+        }
+        return (size_t)-1;
+    }
 
+    // Columns with equal names share one probe run; without deletions the
+    // run ends at the first empty slot, so scan it for the smallest match.
+    size_t mask = df->nameSlotCap - 1;
+    size_t best = (size_t)-1;
+    for (size_t i = hashName(name) & mask; df->nameSlots[i]; i = (i + 1) & mask) {
+        size_t c = df->nameSlots[i] - 1;
+        if (c < from || c >= best) continue;
+        const Series* s = (const Series*)daGet(&df->columns, c);
+        if (s->name && strcmp(s->name, name) == 0) best = c;
+    }
+    return best;
+}
+
+size_t dfColumnIndex_impl(const DataFrame* df, const char* name)
+{
+    return dfColumnIndexFrom(df, name, 0);
+}
+
+/*
+ * One row per column plus a "(frame)" row for the DataFrame header and its
+ * name index: column | data | strings | validity | overhead | total.
+ */
+DataFrame dfMemoryUsage_impl(const DataFrame* df, bool deep)
+{
+    DataFrame result;
+    DataFrame_Create(&result);
+    if (!df) return result;
+
+    Series nameS, dataS, stringsS, validityS, overheadS, totalS;
+    seriesInit(&nameS,     "column",   DF_STRING);
+    seriesInit(&dataS,     "data",     DF_INT64);
+    seriesInit(&stringsS,  "strings",  DF_INT64);
+    seriesInit(&validityS, "validity", DF_INT64);
+    seriesInit(&overheadS, "overhead", DF_INT64);
+    seriesInit(&totalS,    "total",    DF_INT64);
+
+    size_t nCols = df->ops->numColumns(df);
+    for (size_t c = 0; c < nCols; c++) {
+        const Series* s = df->ops->getSeries(df, c);
+        SeriesMemory m;
+        seriesMemoryUsage(s, deep, &m);
+        seriesAddString(&nameS, s->name ? s->name : "");
+        seriesAddInt64(&dataS,     (int64_t)m.data);
+        seriesAddInt64(&stringsS,  (int64_t)m.strings);
+        seriesAddInt64(&validityS, (int64_t)m.validity);
+        seriesAddInt64(&overheadS, (int64_t)m.overhead);
+        seriesAddInt64(&totalS,    (int64_t)(m.data + m.strings + m.validity + m.overhead));
+    }
+
+    size_t frame = sizeof(DataFrame) + df->nameSlotCap * sizeof(size_t);
+    seriesAddString(&nameS, "(frame)");
+    seriesAddInt64(&dataS,     0);
+    seriesAddInt64(&stringsS,  0);
+    seriesAddInt64(&validityS, 0);
+    seriesAddInt64(&overheadS, (int64_t)frame);
+    seriesAddInt64(&totalS,    (int64_t)frame);
+
+    result.ops->addSeriesMove(&result, &nameS);
+    result.ops->addSeriesMove(&result, &dataS);
+    result.ops->addSeriesMove(&result, &stringsS);
+    result.ops->addSeriesMove(&result, &validityS);
+    result.ops->addSeriesMove(&result, &overheadS);
+    result.ops->addSeriesMove(&result, &totalS);
+    return result;
+}
+
+/* -------------------------------------------------------------
+ * The shared method table
+ * ------------------------------------------------------------- */
+static const DataFrameOps g_dataFrameOps = {
     // Hook up the "core" pointers:
-    df->init         = dfInit_impl;
-    df->free         = dfFree_impl;
-    df->addSeries    = dfAddSeries_impl;
-    df->numColumns   = dfNumColumns_impl;
-    df->numRows      = dfNumRows_impl;
-    df->getSeries    = dfGetSeries_impl;
-    df->addRow       = dfAddRow_impl;
-    df->getRow       = dfGetRow_impl;
+    .init              = dfInit_impl,
+    .free              = dfFree_impl,
+    .addSeries         = dfAddSeries_impl,
+    .addSeriesMove     = dfAddSeriesMove_impl,
+    .numColumns        = dfNumColumns_impl,
+    .numRows           = dfNumRows_impl,
+    .getSeries         = dfGetSeries_impl,
+    .addRow            = dfAddRow_impl,
+    .appendColumns     = dfAppendColumns_impl,
+    .getRow            = dfGetRow_impl,
+    .columnIndex       = dfColumnIndex_impl,
+    .memoryUsage       = dfMemoryUsage_impl,
 
     // The "query" pointers that return DataFrame:
-    df->head         = dfHead_impl;
-    df->tail         = dfTail_impl;
-    df->describe     = dfDescribe_impl;
-    df->slice        = dfSlice_impl;
-    df->sample       = dfSample_impl;
-    df->selectColumns= dfSelectColumns_impl;
-    df->dropColumns  = dfDropColumns_impl;
-    df->renameColumns= dfRenameColumns_impl;
-    df->filter       = dfFilter_impl;
-    df->dropNA       = dfDropNA_impl;
-    df->sort         = dfSort_impl;
-    df->dropDuplicates= dfDropDuplicates_impl;
-    df->unique       = dfUnique_impl;
-    df->transpose    = dfTranspose_impl;
-    df->indexOf      = dfIndexOf_impl;
-    df->apply        = dfApply_impl;
-    df->where        = dfWhere_impl;
-    df->explode      = dfExplode_impl;
+    .head              = dfHead_impl,
+    .tail              = dfTail_impl,
+    .describe          = dfDescribe_impl,
+    .slice             = dfSlice_impl,
+    .materialize       = dfMaterialize_impl,
+    .sample            = dfSample_impl,
+    .selectColumns     = dfSelectColumns_impl,
+    .dropColumns       = dfDropColumns_impl,
+    .renameColumns     = dfRenameColumns_impl,
+    .filter            = dfFilter_impl,
+    .filterSelection   = dfFilterSelection_impl,
+    .filterMask        = dfFilterMask_impl,
+    .dropNA            = dfDropNA_impl,
+    .sort              = dfSort_impl,
+    .sortSelection     = dfSortSelection_impl,
+    .topSelection      = dfTopSelection_impl,
+    .dropDuplicates    = dfDropDuplicates_impl,
+    .unique            = dfUnique_impl,
+    .transpose         = dfTranspose_impl,
+    .indexOf           = dfIndexOf_impl,
+    .apply             = dfApply_impl,
+    .where             = dfWhere_impl,
+    .whereMask         = dfWhereMask_impl,
+    .explode           = dfExplode_impl,
 
     // Basic Aggregations returning double:
-    df->sum          = dfSum_impl;
-    df->mean         = dfMean_impl;
-    df->min          = dfMin_impl;
-    df->max          = dfMax_impl;
-    df->count        = dfCount_impl;
-    df->median       = dfMedian_impl;
-    df->mode         = dfMode_impl;
-    df->std          = dfStd_impl;
-    df->var          = dfVar_impl;
-    df->range        = dfRange_impl;
-    df->quantile     = dfQuantile_impl;
-    df->iqr          = dfIQR_impl;
-    df->nullCount    = dfNullCount_impl;
-    df->uniqueCount  = dfUniqueCount_impl;
-    df->product      = dfProduct_impl;
-    df->nthLargest   = dfNthLargest_impl;
-    df->nthSmallest  = dfNthSmallest_impl;
-    df->skewness     = dfSkewness_impl;
-    df->kurtosis     = dfKurtosis_impl;
-    df->covariance   = dfCovariance_impl;
-    df->correlation  = dfCorrelation_impl;
+    .sum               = dfSum_impl,
+    .mean              = dfMean_impl,
+    .sumSelection      = dfSumSelection_impl,
+    .meanSelection     = dfMeanSelection_impl,
+    .min               = dfMin_impl,
+    .max               = dfMax_impl,
+    .count             = dfCount_impl,
+    .median            = dfMedian_impl,
+    .mode              = dfMode_impl,
+    .std               = dfStd_impl,
+    .var               = dfVar_impl,
+    .range             = dfRange_impl,
+    .quantile          = dfQuantile_impl,
+    .quantiles         = dfQuantiles_impl,
+    .approxQuantile    = dfApproxQuantile_impl,
+    .iqr               = dfIQR_impl,
+    .nullCount         = dfNullCount_impl,
+    .uniqueCount       = dfUniqueCount_impl,
+    .approxUniqueCount = dfApproxUniqueCount_impl,
+    .product           = dfProduct_impl,
+    .nthLargest        = dfNthLargest_impl,
+    .nthSmallest       = dfNthSmallest_impl,
+    .skewness          = dfSkewness_impl,
+    .kurtosis          = dfKurtosis_impl,
+    .covariance        = dfCovariance_impl,
+    .correlation       = dfCorrelation_impl,
 
     // Additional DataFrame returning transforms
-    df->uniqueValues     = dfUniqueValues_impl;
-    df->valueCounts      = dfValueCounts_impl;
-    df->cumulativeSum    = dfCumulativeSum_impl;
-    df->cumulativeProduct= dfCumulativeProduct_impl;
-    df->cumulativeMax    = dfCumulativeMax_impl;
-    df->cumulativeMin    = dfCumulativeMin_impl;
+    .uniqueValues      = dfUniqueValues_impl,
+    .valueCounts       = dfValueCounts_impl,
+    .cumulativeSum     = dfCumulativeSum_impl,
+    .cumulativeProduct = dfCumulativeProduct_impl,
+    .cumulativeMax     = dfCumulativeMax_impl,
+    .cumulativeMin     = dfCumulativeMin_impl,
 
     // Others:
-    df->groupBy      = dfGroupBy_impl;
-    df->pivot        = dfPivot_impl;
-    df->melt         = dfMelt_impl;
+    .groupBy           = dfGroupBy_impl,
+    .groupBySelection  = dfGroupBySelection_impl,
+    .pivot             = dfPivot_impl,
+    .melt              = dfMelt_impl,
 
     // Indexing:
-    df->at           = dfAt_impl;
-    df->iat          = dfIat_impl;
-    df->loc          = dfLoc_impl;
-    df->iloc         = dfIloc_impl;
-    df->drop         = dfDrop_impl;
-    df->pop          = dfPop_impl;
-    df->insert       = dfInsert_impl;
-    df->index        = dfIndex_impl;
-    df->cols         = dfColumns_impl;
-    df->setValue     = dfSetValue_impl;
-    df->setRow       = dfSetRow_impl;
-    df->setColumn    = dfSetColumn_impl;
-    df->renameColumn = dfRenameColumn_impl;
-    df->reindex      = dfReindex_impl;
-    df->take         = dfTake_impl;
-    df->reorderColumns = dfReorderColumns_impl;
-
+    .at                = dfAt_impl,
+    .iat               = dfIat_impl,
+    .loc               = dfLoc_impl,
+    .iloc              = dfIloc_impl,
+    .drop              = dfDrop_impl,
+    .pop               = dfPop_impl,
+    .insert            = dfInsert_impl,
+    .index             = dfIndex_impl,
+    .cols              = dfColumns_impl,
+    .setValue          = dfSetValue_impl,
+    .setRow            = dfSetRow_impl,
+    .setColumn         = dfSetColumn_impl,
+    .renameColumn      = dfRenameColumn_impl,
+    .reindex           = dfReindex_impl,
+    .take              = dfTake_impl,
+    .takeSelection     = dfTakeSelection_impl,
+    .reorderColumns    = dfReorderColumns_impl,
 
     // Printing / IO:
-    df->print        = dfPrint_impl;
-    df->readCsv      = readCsv_impl;
-    df->plot         = dfPlot_impl;
+    .print             = dfPrint_impl,
+    .readCsv           = readCsv_impl,
+    .readCsvScan       = readCsvScan_impl,
+    .plot              = dfPlot_impl,
 
     //Date/Time:
-    df->convertToDatetime = dfConvertToDatetime_impl;
-    df->datetimeToString  = dfDatetimeToString_impl;
-    df->datetimeFilter    = dfDatetimeFilter_impl;
-    df->datetimeTruncate  = dfDatetimeTruncate_impl;
-    df->datetimeAdd       = dfDatetimeAdd_impl;
-    df->datetimeDiff      = dfDatetimeDiff_impl;
-    df->datetimeExtract   = dfDatetimeExtract_impl;
-    df->datetimeGroupBy   = dfDatetimeGroupBy_impl;
-    df->datetimeRound     = dfDatetimeRound_impl;
-    df->datetimeRebase    = dfDatetimeRebase_impl;
-    df->datetimeBetween   = dfDatetimeBetween_impl;
-    df->datetimeClamp     = dfDatetimeClamp_impl;
+    .convertToDatetime = dfConvertToDatetime_impl,
+    .datetimeToString  = dfDatetimeToString_impl,
+    .datetimeFilter    = dfDatetimeFilter_impl,
+    .datetimeTruncate  = dfDatetimeTruncate_impl,
+    .datetimeAdd       = dfDatetimeAdd_impl,
+    .datetimeDiff      = dfDatetimeDiff_impl,
+    .datetimeExtract   = dfDatetimeExtract_impl,
+    .datetimeGroupBy   = dfDatetimeGroupBy_impl,
+    .datetimeRound     = dfDatetimeRound_impl,
+    .datetimeRebase    = dfDatetimeRebase_impl,
+    .datetimeBetween   = dfDatetimeBetween_impl,
+    .datetimeClamp     = dfDatetimeClamp_impl,
 
     // Existing combining:
-    df->concat       = dfConcat_impl;
-    df->merge        = dfMerge_impl;
-    df->join         = dfJoin_impl;
-    df->unionDF      = dfUnion_impl;          // "union" might be a reserved word, so "unionDF"
-    df->intersectionDF = dfIntersection_impl; // intersection
-    df->differenceDF   = dfDifference_impl;   // difference
-    df->semiJoin     = dfSemiJoin_impl;       
-    df->antiJoin     = dfAntiJoin_impl;
-    df->crossJoin    = dfCrossJoin_impl;
-
-    // Finally, call init
-    df->init(df);
+    .concat            = dfConcat_impl,
+    .merge             = dfMerge_impl,
+    .join              = dfJoin_impl,
+    .unionDF           = dfUnion_impl, // "union" might be a reserved word, so "unionDF"
+    .intersectionDF    = dfIntersection_impl, // intersection
+    .differenceDF      = dfDifference_impl, // difference
+    .semiJoin          = dfSemiJoin_impl,
+    .antiJoin          = dfAntiJoin_impl,
+    .crossJoin         = dfCrossJoin_impl,
+};
+
+/* -------------------------------------------------------------
+ * DataFrame_Create
+ * ------------------------------------------------------------- */
+void DataFrame_Create(DataFrame* df)
+{
+    if (!df) return;
+    memset(df, 0, sizeof(*df));
+
+    // every frame shares the one read-only method table
+    df->ops = &g_dataFrameOps;
+    dfInit_impl(df);
 }
 
 /* -------------------------------------------------------------
@@ -321,7 +558,7 @@ void DataFrame_Create(DataFrame* df)
 void DataFrame_Destroy(DataFrame* df)
 {
     if (!df) return;
-    df->free(df);
+    dfFree_impl(df);
 }
 
 /* -------------------------------------------------------------
@@ -329,6 +566,7 @@ void DataFrame_Destroy(DataFrame* df)
  * ------------------------------------------------------------- */
 bool dfAddSeries_impl(DataFrame* df, const Series* s)
 {
+    DF_OP_SCOPE();
     if (!df || !s) return false;
 
     if (daSize(&df->columns) == 0) {
@@ -342,43 +580,44 @@ bool dfAddSeries_impl(DataFrame* df, const Series* s)
         }
     }
 
-    // Create a new Series in the DataFrame
+    // Create a new Series in the DataFrame (bulk copy of its buffers)
     Series newSeries;
-    seriesInit(&newSeries, s->name, s->type);
+    seriesCopy(s, &newSeries);
 
-    for (size_t i = 0; i < seriesSize(s); i++) {
-        switch (s->type) {
-            case DF_INT: {
-                int val;
-                seriesGetInt(s, i, &val);
-                seriesAddInt(&newSeries, val);
-            } break;
-
-            case DF_DOUBLE: {
-                double val;
-                seriesGetDouble(s, i, &val);
-                seriesAddDouble(&newSeries, val);
-            } break;
+    // Add the new Series to the DataFrame
+    daPushBack(&df->columns, &newSeries, sizeof(Series));
+    nameIndexAdd(df);
+    return true;
+}
 
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(s, i, &str)) {
-                    seriesAddString(&newSeries, str);
-                    free(str);
-                }
-            } break;
+/**
+ * @brief Like addSeries, but takes ownership of `s` instead of copying it:
+ *        its buffers, dictionary and name move into the DataFrame as-is.
+ *        `s` is always consumed (freed on failure) and left empty, so a
+ *        later seriesFree(s) is a harmless no-op.
+ */
+bool dfAddSeriesMove_impl(DataFrame* df, Series* s)
+{
+    DF_OP_SCOPE();
+    if (!s) return false;
+    if (!df) {
+        seriesFree(s);
+        return false;
+    }
 
-            case DF_DATETIME: {
-                long long dtVal;
-                if (seriesGetDateTime(s, i, &dtVal)) {
-                    seriesAddDateTime(&newSeries, dtVal);
-                }
-            } break;
-        }
+    if (daSize(&df->columns) == 0) {
+        df->nrows = seriesSize(s);
+    } else if (seriesSize(s) != df->nrows) {
+        fprintf(stderr,
+            "Error: new Series '%s' has %zu rows; DataFrame has %zu rows.\n",
+            s->name, seriesSize(s), df->nrows);
+        seriesFree(s);
+        return false;
     }
 
-    // Add the new Series to the DataFrame
-    daPushBack(&df->columns, &newSeries, sizeof(Series));
+    daPushBack(&df->columns, s, sizeof(Series));
+    memset(s, 0, sizeof(Series));
+    nameIndexAdd(df);
     return true;
 }
 
@@ -407,6 +646,7 @@ const Series* dfGetSeries_impl(const DataFrame* df, size_t colIndex)
  */
 bool dfAddRow_impl(DataFrame* df, const void** rowData)
 {
+    DF_OP_SCOPE();
     if (!df || !rowData) return false;
 
     size_t nCols = daSize(&df->columns);
@@ -432,7 +672,8 @@ bool dfAddRow_impl(DataFrame* df, const void** rowData)
                 seriesAddDouble(s, *valPtr);
             } break;
 
-            case DF_STRING: {
+            case DF_STRING:
+            case DF_CATEGORY: {
                 const char* strPtr = (const char*)rowData[c];
                 if (!strPtr) return false;
                 seriesAddString(s, strPtr);
@@ -446,6 +687,12 @@ bool dfAddRow_impl(DataFrame* df, const void** rowData)
                 if (!dtPtr) return false;
                 seriesAddDateTime(s, *dtPtr);
             } break;
+
+            /* fixed-width types: rowData[c] points to a value of the column's C type */
+            default: {
+                if (!rowData[c]) return false;
+                seriesAddValue(s, rowData[c]);
+            } break;
         }
     }
     df->nrows += 1;
@@ -454,12 +701,13 @@ bool dfAddRow_impl(DataFrame* df, const void** rowData)
 
 bool dfGetRow_impl(const DataFrame* df, size_t rowIndex, void*** outRow)
 {
+    DF_OP_SCOPE();
     // 1) Validate inputs
     if (!df || !outRow) {
         return false;
     }
     // If rowIndex is out of range, fail
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (rowIndex >= nRows) {
         fprintf(stderr, "dfGetRow_impl: rowIndex=%zu out of range (max %zu)\n",
                 rowIndex, (nRows == 0 ? 0 : nRows - 1));
@@ -467,7 +715,7 @@ bool dfGetRow_impl(const DataFrame* df, size_t rowIndex, void*** outRow)
     }
 
     // 2) Determine the number of columns
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     if (nCols == 0) {
         fprintf(stderr, "dfGetRow_impl: DataFrame has no columns.\n");
         return false;
@@ -483,7 +731,7 @@ bool dfGetRow_impl(const DataFrame* df, size_t rowIndex, void*** outRow)
 
     // 4) For each column, read the cell => allocate => store pointer in rowData[c]
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) {
             // Should not happen, but just in case
             rowData[c] = NULL;
@@ -523,7 +771,8 @@ bool dfGetRow_impl(const DataFrame* df, size_t rowIndex, void*** outRow)
                 rowData[c] = cellPtr;
             } break;
 
-            case DF_STRING: {
+            case DF_STRING:
+            case DF_CATEGORY: {
                 // For DF_STRING, we can read a fresh copy from seriesGetString
                 char* strVal = NULL;
                 bool got = seriesGetString(s, rowIndex, &strVal);
@@ -552,6 +801,17 @@ bool dfGetRow_impl(const DataFrame* df, size_t rowIndex, void*** outRow)
                 *cellPtr = dtVal;
                 rowData[c] = cellPtr;
             } break;
+
+            /* fixed-width types: one value of the column's C type */
+            default: {
+                void* cellPtr = malloc(sizeof(uint64_t));
+                if (!cellPtr || !seriesGetValue(s, rowIndex, cellPtr)) {
+                    free(cellPtr);
+                    rowData[c] = NULL;
+                    break;
+                }
+                rowData[c] = cellPtr;
+            } break;
         }
     }
 
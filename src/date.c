@@ -12,6 +12,8 @@
 #include <string.h>
 #include <stdbool.h>
 #include "dataframe.h"
+#include "dfalloc.h"
+#include "dfmask.h"
 //------------------------------------------------------------------------------------
 // 1) parseYYYYMMDD helper for "YYYYMMDD" -> timegm
 //    Produces UTC-based epoch (in seconds).
@@ -103,21 +105,6 @@ static long long parseEpochSec(const char* strVal, const char* formatType)
     return epochSec;
 }
 
-/**
- * A helper function to set the datetime (long long) in a DF_DATETIME Series.
- * This parallels seriesGetDateTime(...) but performs a 'set' operation.
- */
-bool seriesSetDateTime(Series* s, size_t index, long long value) {
-    if (!s || s->type != DF_DATETIME) return false;
-    if (index >= daSize(&s->data)) return false;
-
-    long long* valPtr = (long long*)daGetMutable(&s->data, index);
-    if (!valPtr) return false;
-
-    *valPtr = value;
-    return true;
-}
-
 /**
  * dfConvertToDatetime_impl:
  *   - For DF_INT / DF_DOUBLE => convert numeric -> string -> parse => store final as epoch MS.
@@ -132,6 +119,7 @@ bool dfConvertToDatetime_impl(
     const char* formatType
 )
 {
+    DF_OP_SCOPE();
     if (!df) return false;
     Series* s = (Series*)daGetMutable(&df->columns, dateColIndex);
     if (!s) return false;
@@ -156,7 +144,7 @@ bool dfConvertToDatetime_impl(
             seriesGetDouble(s, r, &dval);
             snprintf(buffer, sizeof(buffer), "%.f", dval);
         }
-        else if (s->type == DF_STRING) {
+        else if (s->type == DF_STRING || s->type == DF_CATEGORY) {
             char* tmp=NULL;
             bool got = seriesGetString(s, r, &tmp);
             if (!got || !tmp) {
@@ -203,6 +191,7 @@ bool dfDatetimeToString_impl(
     const char* outFormat
 )
 {
+    DF_OP_SCOPE();
     if (!df) {
         fprintf(stderr, "dfDatetimeToString_impl: df is NULL.\n");
         return false;
@@ -275,6 +264,7 @@ bool dfDatetimeAdd_impl(
     long long msToAdd
 )
 {
+    DF_OP_SCOPE();
     if (!df) return false;
 
     Series* s = (Series*)daGetMutable(&df->columns, dateColIndex);
@@ -301,7 +291,7 @@ bool dfDatetimeAdd_impl(
         }
 
         // Store updated value back into the column
-        *(long long*)daGetMutable(&s->data, r) = newMs;
+        seriesSetDateTime(s, r, newMs);
     }
 
     return true;
@@ -313,12 +303,13 @@ DataFrame dfDatetimeDiff_impl(const DataFrame* df,
                               size_t col2Index,
                               const char* newColName)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    const Series* s1 = df->getSeries(df, col1Index);
-    const Series* s2 = df->getSeries(df, col2Index);
+    const Series* s1 = df->ops->getSeries(df, col1Index);
+    const Series* s2 = df->ops->getSeries(df, col2Index);
     if (!s1 || !s2) return result;
 
     // Both columns must be DF_DATETIME storing ms
@@ -331,7 +322,7 @@ DataFrame dfDatetimeDiff_impl(const DataFrame* df,
     Series diffS;
     seriesInit(&diffS, newColName, DF_INT);
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
 
     for (size_t r = 0; r < nRows; r++)
     {
@@ -353,8 +344,7 @@ DataFrame dfDatetimeDiff_impl(const DataFrame* df,
         seriesAddInt(&diffS, (int)diffMs);
     }
 
-    bool ok = result.addSeries(&result, &diffS);
-    seriesFree(&diffS);
+    bool ok = result.ops->addSeriesMove(&result, &diffS);
 
     if (!ok)
     {
@@ -368,39 +358,32 @@ DataFrame dfDatetimeDiff_impl(const DataFrame* df,
 /**
  * dfDatetimeFilter_impl:
  *   - We keep rows if DF_DATETIME (ms) is in [startMs, endMs].
+ *   - The range test runs as a column kernel over the raw ms buffer.
  */
-typedef struct {
-    long long start;
-    long long end;
-    size_t colIndex;
-} DTFilterCtx;
-
-static DTFilterCtx g_filterCtx;
-
-static bool dtRangePredicate(const DataFrame* d, size_t row)
-{
-    const Series* s = d->getSeries(d, g_filterCtx.colIndex);
-    if (!s) return false;
-    long long msVal=0;
-    bool got= seriesGetDateTime(s, row, &msVal);
-    if (!got) return false;
-    return (msVal>=g_filterCtx.start && msVal<=g_filterCtx.end);
-}
-
 DataFrame dfDatetimeFilter_impl(const DataFrame* df,
                                 size_t dateColIndex,
                                 long long startMs,
                                 long long endMs)
 {
-    DataFrame empty;
-    DataFrame_Create(&empty);
-    if (!df) return empty;
-
-    g_filterCtx.colIndex = dateColIndex;
-    g_filterCtx.start    = startMs;
-    g_filterCtx.end      = endMs;
+    DF_OP_SCOPE();
+    const Series* s = df ? df->ops->getSeries(df, dateColIndex) : NULL;
+    DfMask keep;
+    bool ok = false;
+    if (s && s->type == DF_DATETIME) {
+        ok = dfMaskBetween(s, (double)startMs, (double)endMs, &keep);
+    } else if (df) {
+        // not a datetime column => no row matches
+        ok = dfMaskInit(&keep, df->ops->numRows(df));
+    }
+    if (!ok) {
+        DataFrame empty;
+        DataFrame_Create(&empty);
+        return empty;
+    }
 
-    return df->filter(df, dtRangePredicate);
+    DataFrame result = df->ops->filterMask(df, &keep);
+    dfMaskFree(&keep);
+    return result;
 }
 
 /**
@@ -412,6 +395,7 @@ bool dfDatetimeTruncate_impl(DataFrame* df,
                              size_t colIndex,
                              const char* unit)
 {
+    DF_OP_SCOPE();
     if (!df) return false;
 
     // Fetch the Series; must be DF_DATETIME (storing ms).
@@ -481,7 +465,7 @@ bool dfDatetimeTruncate_impl(DataFrame* df,
         long long newMs = (long long)newSec * 1000LL;
 
         // Store truncated ms back into DF_DATETIME
-        *(long long*)daGetMutable(&s->data, r) = newMs;
+        seriesSetDateTime(s, r, newMs);
     }
 
     return true;
@@ -498,14 +482,15 @@ DataFrame dfDatetimeExtract_impl(const DataFrame* df,
                                  const char* const* fields,
                                  size_t numFields)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if(!df) return result;
 
-    const Series* s= df->getSeries(df, dateColIndex);
+    const Series* s= df->ops->getSeries(df, dateColIndex);
     if(!s || s->type!=DF_DATETIME) return result;
 
-    size_t nRows= df->numRows(df);
+    size_t nRows= df->ops->numRows(df);
 
     for(size_t f=0;f<numFields;f++){
         Series newS;
@@ -542,8 +527,7 @@ DataFrame dfDatetimeExtract_impl(const DataFrame* df,
             }
             seriesAddInt(&newS, outVal);
         }
-        bool ok= result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        bool ok= result.ops->addSeriesMove(&result, &newS);
         if(!ok){
             DataFrame_Destroy(&result);
             DataFrame_Create(&result);
@@ -562,13 +546,14 @@ DataFrame dfDatetimeGroupBy_impl(const DataFrame* df,
                                  size_t dateColIndex,
                                  const char* truncateUnit)
 {
+    DF_OP_SCOPE();
     DataFrame empty;
     DataFrame_Create(&empty);
     if(!df) return empty;
 
     // copy all rows
-    DataFrame copyAll= df->slice(df,0, df->numRows(df));
-    if(copyAll.numRows(&copyAll)==0){
+    DataFrame copyAll= df->ops->slice(df,0, df->ops->numRows(df));
+    if(copyAll.ops->numRows(&copyAll)==0){
         return copyAll;
     }
 
@@ -576,7 +561,7 @@ DataFrame dfDatetimeGroupBy_impl(const DataFrame* df,
     dfDatetimeTruncate_impl(&copyAll, dateColIndex, truncateUnit);
 
     // groupBy
-    DataFrame grouped= copyAll.groupBy(&copyAll, dateColIndex);
+    DataFrame grouped= copyAll.ops->groupBy(&copyAll, dateColIndex);
     DataFrame_Destroy(&copyAll);
     return grouped;
 }
@@ -585,6 +570,7 @@ DataFrame dfDatetimeGroupBy_impl(const DataFrame* df,
 
 bool dfDatetimeRound_impl(DataFrame* df, size_t colIndex, const char* unit)
 {
+    DF_OP_SCOPE();
     if (!df) return false;
 
     // Get the Series to round. Must be DF_DATETIME.
@@ -727,6 +713,7 @@ DataFrame dfDatetimeBetween_impl(const DataFrame* df,
                                  const char* endStr,
                                  const char* formatType)
 {
+    DF_OP_SCOPE();
     // Create an empty DataFrame to return if anything fails
     DataFrame empty;
     DataFrame_Create(&empty);
@@ -751,8 +738,8 @@ DataFrame dfDatetimeBetween_impl(const DataFrame* df,
         endMs   = tmp;
     }
 
-    // 3) Call df->datetimeFilter(...) to keep rows in [startMs..endMs]
-    return df->datetimeFilter(df, dateColIndex, startMs, endMs);
+    // 3) Call df->ops->datetimeFilter(...) to keep rows in [startMs..endMs]
+    return df->ops->datetimeFilter(df, dateColIndex, startMs, endMs);
 }
 
 /**
@@ -761,6 +748,7 @@ DataFrame dfDatetimeBetween_impl(const DataFrame* df,
  */
 bool dfDatetimeRebase_impl(DataFrame* df, size_t colIndex, long long anchorMs)
 {
+    DF_OP_SCOPE();
     if (!df) {
         fprintf(stderr, "dfDatetimeRebase_impl: invalid df.\n");
         return false;
@@ -812,6 +800,7 @@ bool dfDatetimeClamp_impl(DataFrame* df,
                           long long minMs,
                           long long maxMs)
 {
+    DF_OP_SCOPE();
     if (!df) {
         fprintf(stderr, "dfDatetimeClamp_impl: invalid df pointer.\n");
         return false;
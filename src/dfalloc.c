@@ -0,0 +1,302 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "dfalloc.h"
+
+/* ---------------------------------------------------------------------------
+ * Pluggable allocator
+ * --------------------------------------------------------------------------- */
+
+static void* defaultAllocate(void* ctx, size_t size, size_t alignment)
+{
+    (void)ctx;
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size = (size + alignment - 1) / alignment * alignment;
+    return aligned_alloc(alignment, size ? size : alignment);
+}
+
+static void defaultRelease(void* ctx, void* ptr, size_t size)
+{
+    (void)ctx;
+    (void)size;
+    free(ptr);
+}
+
+static const DfAllocator g_defaultAllocator = { defaultAllocate, defaultRelease, NULL };
+static DfAllocator g_allocator = { defaultAllocate, defaultRelease, NULL };
+
+void dfSetAllocator(const DfAllocator* allocator)
+{
+    if (allocator && allocator->allocate && allocator->release) {
+        g_allocator = *allocator;
+    } else {
+        g_allocator = g_defaultAllocator;
+    }
+}
+
+const DfAllocator* dfGetAllocator(void)
+{
+    return &g_allocator;
+}
+
+/* ---------------------------------------------------------------------------
+ * Allocation statistics
+ * --------------------------------------------------------------------------- */
+
+#define DF_MAX_OP_STATS 256
+
+static bool       g_statsOn = false;
+static DfOpStats  g_opStats[DF_MAX_OP_STATS];
+static size_t     g_opCount = 0;
+static DfOpStats* g_currentOp = NULL;   // innermost running operator
+static size_t     g_allocs = 0;
+static size_t     g_bytes = 0;
+static size_t     g_live = 0;
+static size_t     g_peak = 0;
+static size_t     g_scopePeak = 0;      // live-bytes high-water mark of the current scope
+
+static void statsAlloc(size_t size)
+{
+    g_allocs++;
+    g_bytes += size;
+    g_live += size;
+    if (g_live > g_peak) g_peak = g_live;
+    if (g_live > g_scopePeak) g_scopePeak = g_live;
+    if (g_currentOp) {
+        g_currentOp->allocs++;
+        g_currentOp->bytes += size;
+    }
+}
+
+static void statsRelease(size_t size)
+{
+    // blocks allocated before stats were enabled may be released after
+    g_live = (size < g_live) ? g_live - size : 0;
+}
+
+void dfStatsEnable(bool enable)
+{
+    g_statsOn = enable;
+}
+
+bool dfStatsEnabled(void)
+{
+    return g_statsOn;
+}
+
+void dfStatsReset(void)
+{
+    memset(g_opStats, 0, sizeof(g_opStats));
+    g_opCount = 0;
+    g_currentOp = NULL;
+    g_allocs = g_bytes = g_live = g_peak = g_scopePeak = 0;
+}
+
+size_t dfStatsCount(void)                 { return g_opCount; }
+const DfOpStats* dfStatsAt(size_t i)      { return (i < g_opCount) ? &g_opStats[i] : NULL; }
+size_t dfStatsAllocs(void)                { return g_allocs; }
+size_t dfStatsBytes(void)                 { return g_bytes; }
+size_t dfStatsLiveBytes(void)             { return g_live; }
+size_t dfStatsPeakBytes(void)             { return g_peak; }
+
+DfOpScope dfOpEnter(const char* op)
+{
+    DfOpScope scope = { NULL, NULL, 0, 0 };
+    if (!g_statsOn || !op) return scope;
+
+    // __func__ strings are unique per function, so compare pointers first
+    DfOpStats* stats = NULL;
+    for (size_t i = 0; i < g_opCount && !stats; i++) {
+        if (g_opStats[i].op == op || strcmp(g_opStats[i].op, op) == 0) {
+            stats = &g_opStats[i];
+        }
+    }
+    if (!stats) {
+        if (g_opCount == DF_MAX_OP_STATS) return scope;
+        stats = &g_opStats[g_opCount++];
+        stats->op = op;
+    }
+    stats->calls++;
+
+    scope.stats = stats;
+    scope.outer = g_currentOp;
+    scope.liveAtEntry = g_live;
+    scope.outerPeak = g_scopePeak;
+    g_currentOp = stats;
+    g_scopePeak = g_live;
+    return scope;
+}
+
+void dfOpLeave(DfOpScope* scope)
+{
+    if (!scope || !scope->stats) return;
+    size_t grown = (g_scopePeak > scope->liveAtEntry) ? g_scopePeak - scope->liveAtEntry : 0;
+    if (grown > scope->stats->peakBytes) scope->stats->peakBytes = grown;
+
+    g_currentOp = scope->outer;
+    if (scope->outerPeak > g_scopePeak) g_scopePeak = scope->outerPeak;
+}
+
+void* dfMemAlloc(size_t size, size_t alignment)
+{
+    void* p = g_allocator.allocate(g_allocator.ctx, size, alignment);
+    if (p && g_statsOn) statsAlloc(size);
+    return p;
+}
+
+void dfMemFree(void* ptr, size_t size)
+{
+    if (!ptr) return;
+    if (g_statsOn) statsRelease(size);
+    g_allocator.release(g_allocator.ctx, ptr, size);
+}
+
+/* ---------------------------------------------------------------------------
+ * Sized malloc-style wrappers: the request size sits in a header in front
+ * of the block, so dfFree can hand it back to the hook
+ * --------------------------------------------------------------------------- */
+
+#define SIZED_HEADER (sizeof(max_align_t))
+
+void* dfMalloc(size_t size)
+{
+    char* block = (char*)dfMemAlloc(SIZED_HEADER + size, SIZED_HEADER);
+    if (!block) return NULL;
+    memcpy(block, &size, sizeof(size));
+    return block + SIZED_HEADER;
+}
+
+void* dfCalloc(size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* p = dfMalloc(count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+static size_t sizedLength(const void* ptr)
+{
+    size_t size;
+    memcpy(&size, (const char*)ptr - SIZED_HEADER, sizeof(size));
+    return size;
+}
+
+void* dfRealloc(void* ptr, size_t size)
+{
+    if (!ptr) return dfMalloc(size);
+    void* grown = dfMalloc(size);
+    if (!grown) return NULL;
+    size_t old = sizedLength(ptr);
+    memcpy(grown, ptr, old < size ? old : size);
+    dfFree(ptr);
+    return grown;
+}
+
+char* dfStrdup(const char* str)
+{
+    if (!str) return NULL;
+    size_t len = strlen(str) + 1;
+    char* copy = (char*)dfMalloc(len);
+    if (copy) memcpy(copy, str, len);
+    return copy;
+}
+
+void dfFree(void* ptr)
+{
+    if (!ptr) return;
+    dfMemFree((char*)ptr - SIZED_HEADER, SIZED_HEADER + sizedLength(ptr));
+}
+
+/* ---------------------------------------------------------------------------
+ * Arena
+ * --------------------------------------------------------------------------- */
+
+#define ARENA_ALIGN (sizeof(max_align_t))
+
+struct DfArenaBlock {
+    DfArenaBlock* next;   // older block
+    size_t        size;   // usable bytes in data[]
+    size_t        used;
+    max_align_t   data[]; // keeps the payload maximally aligned
+};
+
+void dfArenaInit(DfArena* arena, size_t blockSize)
+{
+    if (!arena) return;
+    arena->head = NULL;
+    arena->blockSize = blockSize ? blockSize : DF_ARENA_DEFAULT_BLOCK;
+    arena->used = 0;
+}
+
+void* dfArenaAlloc(DfArena* arena, size_t size)
+{
+    if (!arena) return NULL;
+    size = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+    if (size == 0) size = ARENA_ALIGN;
+
+    DfArenaBlock* b = arena->head;
+    if (!b || b->size - b->used < size) {
+        // oversized requests get a block of their own
+        size_t dataSize = (size > arena->blockSize) ? size : arena->blockSize;
+        b = (DfArenaBlock*)dfMemAlloc(sizeof(DfArenaBlock) + dataSize, ARENA_ALIGN);
+        if (!b) return NULL;
+        b->size = dataSize;
+        b->used = 0;
+        b->next = arena->head;
+        arena->head = b;
+    }
+    void* p = (char*)b->data + b->used;
+    b->used += size;
+    arena->used += size;
+    return p;
+}
+
+void* dfArenaCalloc(DfArena* arena, size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* p = dfArenaAlloc(arena, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+char* dfArenaStrdup(DfArena* arena, const char* str)
+{
+    if (!str) return NULL;
+    size_t len = strlen(str) + 1;
+    char* copy = (char*)dfArenaAlloc(arena, len);
+    if (copy) memcpy(copy, str, len);
+    return copy;
+}
+
+void dfArenaReset(DfArena* arena)
+{
+    if (!arena || !arena->head) return;
+    DfArenaBlock* keep = arena->head;
+    DfArenaBlock* b = keep->next;
+    while (b) {
+        DfArenaBlock* next = b->next;
+        dfMemFree(b, sizeof(DfArenaBlock) + b->size);
+        b = next;
+    }
+    keep->next = NULL;
+    keep->used = 0;
+    arena->used = 0;
+}
+
+void dfArenaFree(DfArena* arena)
+{
+    if (!arena) return;
+    DfArenaBlock* b = arena->head;
+    while (b) {
+        DfArenaBlock* next = b->next;
+        dfMemFree(b, sizeof(DfArenaBlock) + b->size);
+        b = next;
+    }
+    arena->head = NULL;
+    arena->used = 0;
+}
@@ -0,0 +1,386 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "dfmask.h"
+#include "series.h"
+#include "dfalloc.h"
+
+#define MASK_WORDS(n) (((n) + 63) / 64)
+
+/* ---------------------------------------------------------------------------
+ * Mask basics
+ * --------------------------------------------------------------------------- */
+
+bool dfMaskInit(DfMask* m, size_t length)
+{
+    if (!m) return false;
+    m->length = length;
+    m->words = (uint64_t*)dfCalloc(MASK_WORDS(length) ? MASK_WORDS(length) : 1, sizeof(uint64_t));
+    if (!m->words) {
+        m->length = 0;
+        return false;
+    }
+    return true;
+}
+
+void dfMaskFree(DfMask* m)
+{
+    if (!m) return;
+    dfFree(m->words);
+    m->words = NULL;
+    m->length = 0;
+}
+
+bool dfMaskGet(const DfMask* m, size_t row)
+{
+    if (!m || row >= m->length) return false;
+    return (m->words[row >> 6] >> (row & 63)) & 1ULL;
+}
+
+void dfMaskSet(DfMask* m, size_t row, bool on)
+{
+    if (!m || row >= m->length) return;
+    if (on) m->words[row >> 6] |= 1ULL << (row & 63);
+    else    m->words[row >> 6] &= ~(1ULL << (row & 63));
+}
+
+static size_t popcount64(uint64_t w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(w);
+#else
+    size_t n = 0;
+    for (; w; w &= w - 1) n++;
+    return n;
+#endif
+}
+
+static unsigned lowestBit(uint64_t w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(w);
+#else
+    unsigned i = 0;
+    while (!((w >> i) & 1ULL)) i++;
+    return i;
+#endif
+}
+
+size_t dfMaskCount(const DfMask* m)
+{
+    if (!m) return 0;
+    size_t n = 0;
+    for (size_t w = 0; w < MASK_WORDS(m->length); w++) {
+        n += popcount64(m->words[w]);
+    }
+    return n;
+}
+
+bool dfMaskAnd(DfMask* dst, const DfMask* src)
+{
+    if (!dst || !src || dst->length != src->length) return false;
+    for (size_t w = 0; w < MASK_WORDS(dst->length); w++) {
+        dst->words[w] &= src->words[w];
+    }
+    return true;
+}
+
+bool dfMaskOr(DfMask* dst, const DfMask* src)
+{
+    if (!dst || !src || dst->length != src->length) return false;
+    for (size_t w = 0; w < MASK_WORDS(dst->length); w++) {
+        dst->words[w] |= src->words[w];
+    }
+    return true;
+}
+
+void dfMaskNot(DfMask* m)
+{
+    if (!m) return;
+    size_t nWords = MASK_WORDS(m->length);
+    for (size_t w = 0; w < nWords; w++) {
+        m->words[w] = ~m->words[w];
+    }
+    // bits past the last row stay clear so counts remain exact
+    if (m->length & 63) {
+        m->words[nWords - 1] &= (1ULL << (m->length & 63)) - 1;
+    }
+}
+
+DfSelection dfMaskToSelection(const DfMask* m)
+{
+    DfSelection sel = { NULL, 0 };
+    size_t n = dfMaskCount(m);
+    if (n == 0) return sel;
+
+    sel.rows = (size_t*)dfMalloc(n * sizeof(size_t));
+    if (!sel.rows) return sel;
+    for (size_t w = 0; w < MASK_WORDS(m->length); w++) {
+        for (uint64_t bits = m->words[w]; bits; bits &= bits - 1) {
+            sel.rows[sel.count++] = w * 64 + lowestBit(bits);
+        }
+    }
+    return sel;
+}
+
+/* OR the low bits of `bits` into the mask starting at `row` (any alignment). */
+static void maskPut(DfMask* m, size_t row, uint64_t bits)
+{
+    if (!bits) return;
+    size_t w = row >> 6;
+    size_t shift = row & 63;
+    m->words[w] |= bits << shift;
+    if (shift && w + 1 < MASK_WORDS(m->length)) {
+        m->words[w + 1] |= bits >> (64 - shift);
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Kernels
+ *
+ * Each chunk of a column is one contiguous buffer. The kernels build one
+ * 64-bit word per 64 rows from a branch-free condition (which compilers can
+ * vectorize), then clear null rows with the chunk's validity word.
+ * --------------------------------------------------------------------------- */
+
+#define MASK_KERNEL(T, data, COND)                                           \
+    do {                                                                     \
+        const T* v_ = (const T*)(data);                                      \
+        for (size_t base_ = 0; base_ < n; base_ += 64) {                     \
+            size_t end_ = (base_ + 64 < n) ? base_ + 64 : n;                 \
+            uint64_t bits_ = 0;                                              \
+            for (size_t r_ = base_; r_ < end_; r_++) {                       \
+                T x = v_[r_];                                                \
+                bits_ |= (uint64_t)(COND) << (r_ - base_);                   \
+            }                                                                \
+            if (hasNulls) bits_ &= seriesValidityWord(chunk, base_ >> 6);    \
+            maskPut(out, at + base_, bits_);                                 \
+        }                                                                    \
+    } while (0)
+
+// internal op for lo <= x <= hi, next to the DfCompareOp values
+#define CMP_BETWEEN (DF_CMP_GE + 1)
+
+#define COMPARE_TYPED(T, data)                                               \
+    switch (op) {                                                            \
+        case DF_CMP_EQ: MASK_KERNEL(T, data, (double)x == lo); break;        \
+        case DF_CMP_NE: MASK_KERNEL(T, data, (double)x != lo); break;        \
+        case DF_CMP_LT: MASK_KERNEL(T, data, (double)x <  lo); break;        \
+        case DF_CMP_LE: MASK_KERNEL(T, data, (double)x <= lo); break;        \
+        case DF_CMP_GT: MASK_KERNEL(T, data, (double)x >  lo); break;        \
+        case DF_CMP_GE: MASK_KERNEL(T, data, (double)x >= lo); break;        \
+        default:                                                             \
+            MASK_KERNEL(T, data, ((double)x >= lo) & ((double)x <= hi));     \
+            break;                                                           \
+    }
+
+static void compareChunk(const Series* chunk, size_t at, int op,
+                         double lo, double hi, DfMask* out)
+{
+    size_t n = seriesSize(chunk);
+    bool hasNulls = seriesNullCount(chunk) > 0;
+
+    switch (chunk->type) {
+        case DF_INT:      COMPARE_TYPED(int,       seriesIntData(chunk));      break;
+        case DF_DOUBLE:   COMPARE_TYPED(double,    seriesDoubleData(chunk));   break;
+        case DF_DATETIME: COMPARE_TYPED(long long, seriesDateTimeData(chunk)); break;
+        case DF_INT8:     COMPARE_TYPED(int8_t,    seriesInt8Data(chunk));     break;
+        case DF_INT16:    COMPARE_TYPED(int16_t,   seriesInt16Data(chunk));    break;
+        case DF_INT64:    COMPARE_TYPED(int64_t,   seriesInt64Data(chunk));    break;
+        case DF_UINT8:    COMPARE_TYPED(uint8_t,   seriesUInt8Data(chunk));    break;
+        case DF_UINT16:   COMPARE_TYPED(uint16_t,  seriesUInt16Data(chunk));   break;
+        case DF_UINT32:   COMPARE_TYPED(uint32_t,  seriesUInt32Data(chunk));   break;
+        case DF_UINT64:   COMPARE_TYPED(uint64_t,  seriesUInt64Data(chunk));   break;
+        case DF_FLOAT:    COMPARE_TYPED(float,     seriesFloatData(chunk));    break;
+        default:
+            break;
+    }
+}
+
+static bool compareColumn(const Series* s, int op, double lo, double hi, DfMask* out)
+{
+    if (!s || !out) return false;
+    if (!seriesTypeIsNumeric(s->type) && s->type != DF_DATETIME) return false;
+    if (!dfMaskInit(out, seriesSize(s))) return false;
+
+    size_t at = 0;
+    for (size_t k = 0; k < seriesChunkCount(s); k++) {
+        const Series* chunk = seriesChunk(s, k);
+        compareChunk(chunk, at, op, lo, hi, out);
+        at += seriesSize(chunk);
+    }
+    return true;
+}
+
+bool dfMaskCompare(const Series* s, DfCompareOp op, double value, DfMask* out)
+{
+    if ((unsigned)op > DF_CMP_GE) return false;
+    return compareColumn(s, (int)op, value, value, out);
+}
+
+bool dfMaskBetween(const Series* s, double lo, double hi, DfMask* out)
+{
+    return compareColumn(s, CMP_BETWEEN, lo, hi, out);
+}
+
+bool dfMaskValid(const Series* s, DfMask* out)
+{
+    if (!s || !out || !dfMaskInit(out, seriesSize(s))) return false;
+    for (size_t w = 0; w < MASK_WORDS(out->length); w++) {
+        out->words[w] = seriesValidityWord(s, w);
+    }
+    if (out->length & 63) {
+        out->words[MASK_WORDS(out->length) - 1] &= (1ULL << (out->length & 63)) - 1;
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Set membership
+ * --------------------------------------------------------------------------- */
+
+static int compareDoubles(const void* a, const void* b)
+{
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static bool inSorted(const double* set, size_t n, double x)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set[mid] < x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < n && set[lo] == x;
+}
+
+#define ISIN_TYPED(T, data) MASK_KERNEL(T, data, inSorted(set, nSet, (double)x))
+
+bool dfMaskIsIn(const Series* s, const double* values, size_t nValues, DfMask* out)
+{
+    if (!s || !out || (nValues && !values)) return false;
+    if (!seriesTypeIsNumeric(s->type) && s->type != DF_DATETIME) return false;
+
+    double* set = (double*)dfMalloc((nValues ? nValues : 1) * sizeof(double));
+    if (!set) return false;
+    if (nValues) memcpy(set, values, nValues * sizeof(double));
+    qsort(set, nValues, sizeof(double), compareDoubles);
+    size_t nSet = nValues;
+
+    if (!dfMaskInit(out, seriesSize(s))) {
+        dfFree(set);
+        return false;
+    }
+    size_t at = 0;
+    for (size_t k = 0; k < seriesChunkCount(s); k++) {
+        const Series* chunk = seriesChunk(s, k);
+        size_t n = seriesSize(chunk);
+        bool hasNulls = seriesNullCount(chunk) > 0;
+        switch (chunk->type) {
+            case DF_INT:      ISIN_TYPED(int,       seriesIntData(chunk));      break;
+            case DF_DOUBLE:   ISIN_TYPED(double,    seriesDoubleData(chunk));   break;
+            case DF_DATETIME: ISIN_TYPED(long long, seriesDateTimeData(chunk)); break;
+            case DF_INT8:     ISIN_TYPED(int8_t,    seriesInt8Data(chunk));     break;
+            case DF_INT16:    ISIN_TYPED(int16_t,   seriesInt16Data(chunk));    break;
+            case DF_INT64:    ISIN_TYPED(int64_t,   seriesInt64Data(chunk));    break;
+            case DF_UINT8:    ISIN_TYPED(uint8_t,   seriesUInt8Data(chunk));    break;
+            case DF_UINT16:   ISIN_TYPED(uint16_t,  seriesUInt16Data(chunk));   break;
+            case DF_UINT32:   ISIN_TYPED(uint32_t,  seriesUInt32Data(chunk));   break;
+            case DF_UINT64:   ISIN_TYPED(uint64_t,  seriesUInt64Data(chunk));   break;
+            case DF_FLOAT:    ISIN_TYPED(float,     seriesFloatData(chunk));    break;
+            default:
+                break;
+        }
+        at += n;
+    }
+    dfFree(set);
+    return true;
+}
+
+/*
+ * DF_CATEGORY: mark the wanted dictionary codes once, then the kernel only
+ * looks codes up in that table.
+ */
+static void categoryMatch(const Series* chunk, size_t at, const unsigned char* wanted, DfMask* out)
+{
+    size_t n = seriesSize(chunk);
+    bool hasNulls = seriesNullCount(chunk) > 0;
+    switch (chunk->codeWidth) {
+        case 1:  MASK_KERNEL(uint8_t,  chunk->values, wanted[x]); break;
+        case 2:  MASK_KERNEL(uint16_t, chunk->values, wanted[x]); break;
+        default: MASK_KERNEL(uint32_t, chunk->values, wanted[x]); break;
+    }
+}
+
+static bool stringInSet(const char* str, const char* const* strs, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (strs[i] && strcmp(str, strs[i]) == 0) return true;
+    }
+    return false;
+}
+
+bool dfMaskIsInStrings(const Series* s, const char* const* strs, size_t nStrs, DfMask* out)
+{
+    if (!s || !out || (nStrs && !strs)) return false;
+    if (s->type != DF_STRING && s->type != DF_CATEGORY) return false;
+    if (!dfMaskInit(out, seriesSize(s))) return false;
+
+    size_t at = 0;
+    for (size_t k = 0; k < seriesChunkCount(s); k++) {
+        const Series* chunk = seriesChunk(s, k);
+        size_t n = seriesSize(chunk);
+
+        if (chunk->type == DF_CATEGORY) {
+            // chunks may have their own dictionaries
+            size_t nCodes = seriesCategoryCount(chunk);
+            unsigned char* wanted = (unsigned char*)dfCalloc(nCodes ? nCodes : 1, 1);
+            if (!wanted) {
+                dfMaskFree(out);
+                return false;
+            }
+            for (size_t i = 0; i < nStrs; i++) {
+                uint32_t code;
+                if (strs[i] && seriesCategoryFind(chunk, strs[i], &code)) wanted[code] = 1;
+            }
+            categoryMatch(chunk, at, wanted, out);
+            dfFree(wanted);
+        } else {
+            for (size_t r = 0; r < n; r++) {
+                const char* str = NULL;
+                if (seriesGetStringView(chunk, r, &str, NULL) && stringInSet(str, strs, nStrs)) {
+                    out->words[(at + r) >> 6] |= 1ULL << ((at + r) & 63);
+                }
+            }
+        }
+        at += n;
+    }
+    return true;
+}
+
+bool dfMaskEqString(const Series* s, const char* str, DfMask* out)
+{
+    if (!str) return false;
+    return dfMaskIsInStrings(s, &str, 1, out);
+}
+
+bool dfMaskFromPredicate(const DataFrame* df, RowPredicate predicate, DfMask* out)
+{
+    if (!df || !predicate || !out) return false;
+    size_t nRows = df->ops->numRows(df);
+    if (!dfMaskInit(out, nRows)) return false;
+
+    for (size_t base = 0; base < nRows; base += 64) {
+        size_t end = (base + 64 < nRows) ? base + 64 : nRows;
+        uint64_t bits = 0;
+        for (size_t r = base; r < end; r++) {
+            if (predicate(df, r)) bits |= 1ULL << (r - base);
+        }
+        out->words[base >> 6] = bits;
+    }
+    return true;
+}
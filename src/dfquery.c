@@ -0,0 +1,1122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfquery.h"
+#include "dfalloc.h"
+
+static char* copyName(const char* name)
+{
+    size_t len = strlen(name) + 1;
+    char* copy = (char*)dfMalloc(len);
+    if (copy) memcpy(copy, name, len);
+    return copy;
+}
+
+static void freeNames(char** names, size_t count)
+{
+    if (!names) return;
+    for (size_t i = 0; i < count; i++) {
+        dfFree(names[i]);
+    }
+    dfFree(names);
+}
+
+static void freeFilters(DfCsvFilter* filters, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dfFree((char*)filters[i].column);
+    }
+    dfFree(filters);
+}
+
+static void freeStep(DFQueryStep* step)
+{
+    freeNames(step->aliases, step->nameCount);
+    freeNames(step->names, step->nameCount);
+    dfFree(step->column);
+    dfFree(step->newName);
+    dfFree(step->rightKey);
+    freeFilters(step->filters, step->filterCount);
+    memset(step, 0, sizeof(*step));
+}
+
+/* ---------------------------------------------------------------------------
+ * Building the plan
+ * --------------------------------------------------------------------------- */
+
+void dfQueryInit(DFQuery* q, const DataFrame* source)
+{
+    if (!q) return;
+    memset(q, 0, sizeof(*q));
+    q->source = source;
+}
+
+bool dfQueryInitCsv(DFQuery* q, const char* filename)
+{
+    if (!q || !filename) return false;
+    dfQueryInit(q, NULL);
+    q->csvPath = copyName(filename);
+    return q->csvPath != NULL;
+}
+
+void dfQueryFree(DFQuery* q)
+{
+    if (!q) return;
+    for (size_t i = 0; i < q->count; i++) {
+        freeStep(&q->steps[i]);
+    }
+    dfFree(q->steps);
+    dfFree(q->csvPath);
+    freeNames(q->scanColumns, q->scanColumnCount);
+    freeFilters(q->scanFilters, q->scanFilterCount);
+    memset(q, 0, sizeof(*q));
+}
+
+/* A zeroed step appended to the plan, or NULL if out of memory. */
+static DFQueryStep* pushStep(DFQuery* q, DFQueryOp op)
+{
+    if (q->count == q->capacity) {
+        size_t cap = q->capacity ? q->capacity * 2 : 8;
+        DFQueryStep* steps = (DFQueryStep*)dfRealloc(q->steps, cap * sizeof(DFQueryStep));
+        if (!steps) return NULL;
+        q->steps = steps;
+        q->capacity = cap;
+    }
+    DFQueryStep* step = &q->steps[q->count++];
+    memset(step, 0, sizeof(*step));
+    step->op = op;
+    return step;
+}
+
+/* Drop the step pushStep just added (its allocations failed). */
+static DFQuery* popStep(DFQuery* q)
+{
+    freeStep(&q->steps[--q->count]);
+    return NULL;
+}
+
+DFQuery* dfQuerySelect(DFQuery* q, const char* const* names, size_t count)
+{
+    if (!q || (count && !names)) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (!names[i]) return NULL;
+    }
+    DFQueryStep* step = pushStep(q, DFQ_SELECT);
+    if (!step) return NULL;
+
+    step->names = (char**)dfCalloc(count ? count : 1, sizeof(char*));
+    if (!step->names) return popStep(q);
+    for (size_t i = 0; i < count; i++) {
+        step->names[i] = copyName(names[i]);
+        step->nameCount++;
+        if (!step->names[i]) return popStep(q);
+    }
+    return q;
+}
+
+DFQuery* dfQueryRename(DFQuery* q, const char* oldName, const char* newName)
+{
+    if (!q || !oldName || !newName) return NULL;
+    DFQueryStep* step = pushStep(q, DFQ_RENAME);
+    if (!step) return NULL;
+    step->column = copyName(oldName);
+    step->newName = copyName(newName);
+    if (!step->column || !step->newName) return popStep(q);
+    return q;
+}
+
+DFQuery* dfQueryFilter(DFQuery* q, RowPredicate predicate)
+{
+    if (!q || !predicate) return NULL;
+    DFQueryStep* step = pushStep(q, DFQ_FILTER);
+    if (!step) return NULL;
+    step->predicate = predicate;
+    return q;
+}
+
+DFQuery* dfQueryWhere(DFQuery* q, const char* column, DfCompareOp cmp, double value)
+{
+    if (!q || !column) return NULL;
+    DFQueryStep* step = pushStep(q, DFQ_WHERE);
+    if (!step) return NULL;
+    step->column = copyName(column);
+    step->cmp = cmp;
+    step->value = value;
+    if (!step->column) return popStep(q);
+    return q;
+}
+
+DFQuery* dfQuerySort(DFQuery* q, const char* column, bool ascending)
+{
+    if (!q || !column) return NULL;
+    DFQueryStep* step = pushStep(q, DFQ_SORT);
+    if (!step) return NULL;
+    step->column = copyName(column);
+    step->ascending = ascending;
+    if (!step->column) return popStep(q);
+    return q;
+}
+
+DFQuery* dfQueryHead(DFQuery* q, size_t n)
+{
+    if (!q) return NULL;
+    DFQueryStep* step = pushStep(q, DFQ_HEAD);
+    if (!step) return NULL;
+    step->n = n;
+    return q;
+}
+
+DFQuery* dfQueryJoin(DFQuery* q, const DataFrame* right, const char* leftKey,
+                     const char* rightKey, JoinType how)
+{
+    if (!q || !right || !leftKey || !rightKey) return NULL;
+    DFQueryStep* step = pushStep(q, DFQ_JOIN);
+    if (!step) return NULL;
+    step->right = right;
+    step->column = copyName(leftKey);
+    step->rightKey = copyName(rightKey);
+    step->how = how;
+    if (!step->column || !step->rightKey) return popStep(q);
+    return q;
+}
+
+/* ---------------------------------------------------------------------------
+ * Optimizer
+ *
+ * Rules run on a deep copy of the plan, in order: move where() steps as far
+ * forward as they can go, prune the columns each join and a CSV scan
+ * receive (walking backwards from the output), then merge adjacent
+ * selections and renames. Column names are tracked by simulating each
+ * step's output schema; the rewrite never changes the result, so a rule
+ * that cannot prove a move safe (unknown column, a later head(), a
+ * RowPredicate that may look at any column) leaves the step alone.
+ * --------------------------------------------------------------------------- */
+
+/* Borrowed column names, in column order. */
+typedef struct {
+    const char** items;
+    size_t       count;
+    size_t       capacity;
+} NameList;
+
+static bool nameListPush(NameList* list, const char* name)
+{
+    if (list->count == list->capacity) {
+        size_t cap = list->capacity ? list->capacity * 2 : 16;
+        const char** items = (const char**)dfRealloc(list->items, cap * sizeof(const char*));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = cap;
+    }
+    list->items[list->count++] = name;
+    return true;
+}
+
+/* Index of the first `name` in the list, or (size_t)-1. */
+static size_t nameListFind(const NameList* list, const char* name)
+{
+    for (size_t i = 0; i < list->count; i++) {
+        if (strcmp(list->items[i], name) == 0) return i;
+    }
+    return (size_t)-1;
+}
+
+static void nameListFree(NameList* list)
+{
+    dfFree(list->items);
+    memset(list, 0, sizeof(*list));
+}
+
+static bool frameNames(const DataFrame* df, NameList* out)
+{
+    size_t nCols = df->ops->numColumns(df);
+    for (size_t c = 0; c < nCols; c++) {
+        if (!nameListPush(out, df->ops->getSeries(df, c)->name)) return false;
+    }
+    return true;
+}
+
+/* Output name of column j of a DFQ_SELECT / DFQ_RENAME. */
+static const char* outputName(const DFQueryStep* step, size_t j)
+{
+    return (step->aliases && step->aliases[j]) ? step->aliases[j] : step->names[j];
+}
+
+static char** copyNames(char* const* names, size_t count)
+{
+    char** copy = (char**)dfCalloc(count ? count : 1, sizeof(char*));
+    if (!copy) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (names[i] && !(copy[i] = copyName(names[i]))) {
+            freeNames(copy, count);
+            return NULL;
+        }
+    }
+    return copy;
+}
+
+static bool copyStep(DFQueryStep* dst, const DFQueryStep* src)
+{
+    *dst = *src;
+    dst->names = NULL;
+    dst->aliases = NULL;
+    dst->column = dst->newName = dst->rightKey = NULL;
+    dst->filters = NULL;
+    dst->filterCount = 0;
+
+    bool ok = true;
+    if (src->names && !(dst->names = copyNames(src->names, src->nameCount))) ok = false;
+    if (src->aliases && !(dst->aliases = copyNames(src->aliases, src->nameCount))) ok = false;
+    if (src->column && !(dst->column = copyName(src->column))) ok = false;
+    if (src->newName && !(dst->newName = copyName(src->newName))) ok = false;
+    if (src->rightKey && !(dst->rightKey = copyName(src->rightKey))) ok = false;
+    if (src->filterCount) {
+        dst->filters = (DfCsvFilter*)dfCalloc(src->filterCount, sizeof(DfCsvFilter));
+        if (dst->filters) {
+            for (size_t i = 0; i < src->filterCount; i++) {
+                dst->filters[i] = src->filters[i];
+                dst->filters[i].column = copyName(src->filters[i].column);
+                dst->filterCount++;
+                if (!dst->filters[i].column) ok = false;
+            }
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok) freeStep(dst);
+    return ok;
+}
+
+/* A rename as built (column -> newName) in the optimized one-pair form. */
+static bool normalizeRename(DFQueryStep* step)
+{
+    step->names = (char**)dfCalloc(1, sizeof(char*));
+    step->aliases = (char**)dfCalloc(1, sizeof(char*));
+    if (!step->names || !step->aliases) return false;
+    step->names[0] = step->column;
+    step->aliases[0] = step->newName;
+    step->nameCount = 1;
+    step->column = step->newName = NULL;
+    return true;
+}
+
+/* Names of the columns a step's input has: the source run through steps[0..i). */
+static bool schemaBefore(const DFQuery* plan, const NameList* source, size_t i, NameList* out)
+{
+    out->count = 0;
+    for (size_t k = 0; k < source->count; k++) {
+        if (!nameListPush(out, source->items[k])) return false;
+    }
+    for (size_t s = 0; s < i; s++) {
+        const DFQueryStep* step = &plan->steps[s];
+        if (step->op == DFQ_SELECT) {
+            out->count = 0;
+            for (size_t j = 0; j < step->nameCount; j++) {
+                if (!nameListPush(out, outputName(step, j))) return false;
+            }
+        } else if (step->op == DFQ_RENAME) {
+            // every column with an old name (renameColumns semantics)
+            for (size_t k = 0; k < out->count; k++) {
+                for (size_t j = 0; j < step->nameCount; j++) {
+                    if (strcmp(out->items[k], step->names[j]) == 0) {
+                        out->items[k] = outputName(step, j);
+                        break;
+                    }
+                }
+            }
+        } else if (step->op == DFQ_JOIN) {
+            NameList right = { NULL, 0, 0 };
+            if (step->nameCount) {
+                for (size_t j = 0; j < step->nameCount; j++) {
+                    if (!nameListPush(&right, step->names[j])) { nameListFree(&right); return false; }
+                }
+            } else if (!frameNames(step->right, &right)) {
+                nameListFree(&right);
+                return false;
+            }
+            size_t key = nameListFind(&right, step->rightKey);
+            bool ok = true;
+            for (size_t j = 0; ok && j < right.count; j++) {
+                if (j != key) ok = nameListPush(out, right.items[j]);
+            }
+            nameListFree(&right);
+            if (!ok) return false;
+        }
+    }
+    return true;
+}
+
+static bool renameWhereColumn(DFQueryStep* where, const char* name)
+{
+    if (strcmp(where->column, name) == 0) return true;
+    char* copy = copyName(name);
+    if (!copy) return false;
+    dfFree(where->column);
+    where->column = copy;
+    return true;
+}
+
+static void removeStep(DFQuery* plan, size_t i)
+{
+    freeStep(&plan->steps[i]);
+    memmove(&plan->steps[i], &plan->steps[i + 1], (plan->count - i - 1) * sizeof(DFQueryStep));
+    plan->count--;
+}
+
+static bool addJoinFilter(DFQueryStep* join, const DFQueryStep* where)
+{
+    DfCsvFilter* filters = (DfCsvFilter*)dfRealloc(join->filters,
+                                                 (join->filterCount + 1) * sizeof(DfCsvFilter));
+    if (!filters) return false;
+    join->filters = filters;
+    DfCsvFilter* f = &filters[join->filterCount];
+    f->column = copyName(where->column);
+    f->cmp = where->cmp;
+    f->value = where->value;
+    if (!f->column) return false;
+    join->filterCount++;
+    return true;
+}
+
+/*
+ * Try to move the where() at steps[i] one step forward. Sets *moved if the
+ * plan changed (the where swapped places or went into a join).
+ */
+static bool pushWhereOnce(DFQuery* plan, const NameList* source, size_t i, bool* moved)
+{
+    DFQueryStep* where = &plan->steps[i];
+    DFQueryStep* prev = &plan->steps[i - 1];
+    bool swap = false;
+
+    switch (prev->op) {
+        case DFQ_SORT:
+        case DFQ_FILTER:
+            // row filters commute with each other and with a stable sort
+            swap = true;
+            break;
+        case DFQ_SELECT:
+            for (size_t j = 0; j < prev->nameCount && !swap; j++) {
+                if (strcmp(outputName(prev, j), where->column) == 0) {
+                    if (!renameWhereColumn(where, prev->names[j])) return false;
+                    swap = true;
+                }
+            }
+            break;
+        case DFQ_RENAME: {
+            swap = true;
+            for (size_t j = 0; j < prev->nameCount; j++) {
+                if (strcmp(prev->aliases[j], where->column) == 0) {
+                    if (!renameWhereColumn(where, prev->names[j])) return false;
+                    break;
+                }
+                if (strcmp(prev->names[j], where->column) == 0) {
+                    swap = false;   // names a column the rename just replaced
+                    break;
+                }
+            }
+        } break;
+        case DFQ_JOIN: {
+            NameList left = { NULL, 0, 0 };
+            if (!schemaBefore(plan, source, i - 1, &left)) {
+                nameListFree(&left);
+                return false;
+            }
+            bool inLeft = nameListFind(&left, where->column) != (size_t)-1;
+            nameListFree(&left);
+
+            // rows the join pads with nulls for the other side must still be
+            // dropped by the where, so only filter the side that is never padded
+            if (inLeft) {
+                swap = (prev->how == JOIN_INNER || prev->how == JOIN_LEFT);
+            } else if (prev->how != JOIN_LEFT && strcmp(where->column, prev->rightKey) != 0 &&
+                       prev->right->ops->columnIndex(prev->right, where->column) != (size_t)-1) {
+                if (!addJoinFilter(prev, where)) return false;
+                removeStep(plan, i);
+                *moved = true;
+            }
+        } break;
+        default:
+            break;   // never across a head() or another where()
+    }
+
+    if (swap) {
+        DFQueryStep tmp = *where;
+        *where = *prev;
+        *prev = tmp;
+        *moved = true;
+    }
+    return true;
+}
+
+static bool pushWheres(DFQuery* plan, const NameList* source)
+{
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        for (size_t i = 1; i < plan->count; i++) {
+            if (plan->steps[i].op != DFQ_WHERE) continue;
+            if (!pushWhereOnce(plan, source, i, &moved)) return false;
+        }
+    }
+    return true;
+}
+
+static bool insertSelect(DFQuery* plan, size_t i, const NameList* names)
+{
+    if (!pushStep(plan, DFQ_SELECT)) return false;
+    DFQueryStep step = plan->steps[plan->count - 1];
+    memmove(&plan->steps[i + 1], &plan->steps[i], (plan->count - 1 - i) * sizeof(DFQueryStep));
+    plan->steps[i] = step;
+
+    DFQueryStep* sel = &plan->steps[i];
+    sel->names = (char**)dfCalloc(names->count ? names->count : 1, sizeof(char*));
+    if (!sel->names) return false;
+    for (size_t j = 0; j < names->count; j++) {
+        if (!(sel->names[j] = copyName(names->items[j]))) return false;
+        sel->nameCount++;
+    }
+    return true;
+}
+
+/*
+ * Trim a join to the columns `needed` after it: the right frame keeps its
+ * key and the needed columns the left side does not already answer for
+ * (columnIndex finds left columns first), the left side gets a selection of
+ * its needed columns plus its key. `needed` becomes the left side's needs.
+ */
+static bool pruneJoin(DFQuery* plan, const NameList* source, size_t i, NameList* needed)
+{
+    NameList left = { NULL, 0, 0 }, right = { NULL, 0, 0 }, leftNeeded = { NULL, 0, 0 };
+    bool ok = schemaBefore(plan, source, i, &left) && frameNames(plan->steps[i].right, &right);
+
+    DFQueryStep* join = &plan->steps[i];
+    size_t key = ok ? nameListFind(&right, join->rightKey) : (size_t)-1;
+    if (ok && key != (size_t)-1) {
+        size_t keep = 0;
+        bool* kept = (bool*)dfCalloc(right.count ? right.count : 1, sizeof(bool));
+        ok = kept != NULL;
+        for (size_t j = 0; ok && j < right.count; j++) {
+            kept[j] = j == key || (nameListFind(needed, right.items[j]) != (size_t)-1 &&
+                                   nameListFind(&left, right.items[j]) == (size_t)-1);
+            if (kept[j]) keep++;
+        }
+        if (ok && keep < right.count) {
+            join->names = (char**)dfCalloc(keep, sizeof(char*));
+            ok = join->names != NULL;
+            for (size_t j = 0; ok && j < right.count; j++) {
+                if (!kept[j]) continue;
+                ok = (join->names[join->nameCount] = copyName(right.items[j])) != NULL;
+                if (ok) join->nameCount++;
+            }
+        }
+        dfFree(kept);
+    }
+
+    for (size_t j = 0; ok && j < left.count; j++) {
+        const char* name = left.items[j];
+        bool use = strcmp(name, join->column) == 0 || nameListFind(needed, name) != (size_t)-1;
+        if (use && nameListFind(&leftNeeded, name) == (size_t)-1) ok = nameListPush(&leftNeeded, name);
+    }
+    if (ok && leftNeeded.count < left.count) {
+        ok = insertSelect(plan, i, &leftNeeded);
+    }
+
+    needed->count = 0;
+    for (size_t j = 0; ok && j < leftNeeded.count; j++) ok = nameListPush(needed, leftNeeded.items[j]);
+    nameListFree(&left);
+    nameListFree(&right);
+    nameListFree(&leftNeeded);
+    return ok;
+}
+
+/*
+ * Walk the plan backwards tracking which input columns each step needs;
+ * `all` stands for "every column" (the output, or a RowPredicate).
+ */
+static bool pruneColumns(DFQuery* plan, const NameList* source)
+{
+    NameList needed = { NULL, 0, 0 };
+    bool all = true;
+    bool ok = true;
+
+    for (size_t i = plan->count; ok && i-- > 0; ) {
+        DFQueryStep* step = &plan->steps[i];
+        switch (step->op) {
+            case DFQ_SELECT:
+                needed.count = 0;
+                all = false;
+                for (size_t j = 0; ok && j < step->nameCount; j++) ok = nameListPush(&needed, step->names[j]);
+                break;
+            case DFQ_RENAME:
+                for (size_t k = 0; !all && k < needed.count; k++) {
+                    for (size_t j = 0; j < step->nameCount; j++) {
+                        if (strcmp(needed.items[k], step->aliases[j]) == 0) {
+                            needed.items[k] = step->names[j];
+                            break;
+                        }
+                    }
+                }
+                break;
+            case DFQ_FILTER:
+                all = true;
+                break;
+            case DFQ_WHERE:
+            case DFQ_SORT:
+                if (!all && nameListFind(&needed, step->column) == (size_t)-1) {
+                    ok = nameListPush(&needed, step->column);
+                }
+                break;
+            case DFQ_HEAD:
+                break;
+            case DFQ_JOIN:
+                if (!all) ok = pruneJoin(plan, source, i, &needed);
+                break;
+        }
+    }
+
+    // a CSV source only parses the columns the first step needs
+    if (ok && plan->csvPath && !all) {
+        plan->scanColumns = (char**)dfCalloc(needed.count ? needed.count : 1, sizeof(char*));
+        ok = plan->scanColumns != NULL;
+        for (size_t k = 0; ok && k < needed.count; k++) {
+            if (nameListFind(source, needed.items[k]) == (size_t)-1) continue; // reported at collect
+            ok = (plan->scanColumns[plan->scanColumnCount] = copyName(needed.items[k])) != NULL;
+            if (ok) plan->scanColumnCount++;
+        }
+    }
+    nameListFree(&needed);
+    return ok;
+}
+
+/*
+ * The where() steps at the start of a CSV plan also run while parsing, so
+ * failing rows are never copied. They stay in the plan: the scan compares
+ * the text of a cell, the step the loaded (and type-checked) column.
+ * Column types come from every row either way (see readCsvScan).
+ */
+static bool scanFilters(DFQuery* plan)
+{
+    size_t n = 0;
+    while (n < plan->count && plan->steps[n].op == DFQ_WHERE) n++;
+    if (!plan->csvPath || n == 0) return true;
+
+    plan->scanFilters = (DfCsvFilter*)dfCalloc(n, sizeof(DfCsvFilter));
+    if (!plan->scanFilters) return false;
+    for (size_t i = 0; i < n; i++) {
+        DfCsvFilter* f = &plan->scanFilters[i];
+        f->column = copyName(plan->steps[i].column);
+        f->cmp = plan->steps[i].cmp;
+        f->value = plan->steps[i].value;
+        if (!f->column) return false;
+        plan->scanFilterCount++;
+    }
+    return true;
+}
+
+static bool setAlias(DFQueryStep* step, size_t j, const char* name)
+{
+    if (!step->aliases) {
+        step->aliases = (char**)dfCalloc(step->nameCount ? step->nameCount : 1, sizeof(char*));
+        if (!step->aliases) return false;
+    }
+    char* copy = copyName(name);
+    if (!copy) return false;
+    dfFree(step->aliases[j]);
+    step->aliases[j] = copy;
+    return true;
+}
+
+/* select + rename => one select with output names. False if a rename misses. */
+static bool foldRename(DFQueryStep* sel, const DFQueryStep* ren, bool* folded)
+{
+    *folded = false;
+    for (size_t r = 0; r < ren->nameCount; r++) {
+        bool hit = false;
+        for (size_t j = 0; j < sel->nameCount && !hit; j++) {
+            hit = strcmp(outputName(sel, j), ren->names[r]) == 0;
+        }
+        if (!hit) return true;
+    }
+    // match every column against the original output names first, as
+    // renameColumns does, then rewrite them
+    size_t* pair = (size_t*)dfMalloc((sel->nameCount ? sel->nameCount : 1) * sizeof(size_t));
+    if (!pair) return false;
+    for (size_t j = 0; j < sel->nameCount; j++) {
+        pair[j] = (size_t)-1;
+        for (size_t r = 0; r < ren->nameCount && pair[j] == (size_t)-1; r++) {
+            if (strcmp(outputName(sel, j), ren->names[r]) == 0) pair[j] = r;
+        }
+    }
+    bool ok = true;
+    for (size_t j = 0; ok && j < sel->nameCount; j++) {
+        if (pair[j] != (size_t)-1) ok = setAlias(sel, j, ren->aliases[pair[j]]);
+    }
+    dfFree(pair);
+    *folded = ok;
+    return ok;
+}
+
+/* rename + rename => one rename. */
+static bool mergeRenames(DFQueryStep* first, const DFQueryStep* second)
+{
+    bool* composed = (bool*)dfCalloc(second->nameCount ? second->nameCount : 1, sizeof(bool));
+    if (!composed) return false;
+    bool ok = true;
+    size_t oldCount = first->nameCount;
+    for (size_t j = 0; ok && j < oldCount; j++) {
+        for (size_t r = 0; r < second->nameCount; r++) {
+            if (strcmp(first->aliases[j], second->names[r]) == 0) {
+                ok = setAlias(first, j, second->aliases[r]);
+                composed[r] = true;
+                break;
+            }
+        }
+    }
+    size_t extra = 0;
+    for (size_t r = 0; r < second->nameCount; r++) extra += !composed[r];
+    if (ok && extra) {
+        char** names = (char**)dfRealloc(first->names, (oldCount + extra) * sizeof(char*));
+        if (names) first->names = names;
+        char** aliases = (char**)dfRealloc(first->aliases, (oldCount + extra) * sizeof(char*));
+        if (aliases) first->aliases = aliases;
+        ok = names && aliases;
+        for (size_t r = 0; ok && r < second->nameCount; r++) {
+            if (composed[r]) continue;
+            size_t j = first->nameCount;
+            first->names[j] = copyName(second->names[r]);
+            first->aliases[j] = copyName(second->aliases[r]);
+            first->nameCount++;
+            ok = first->names[j] && first->aliases[j];
+        }
+    }
+    dfFree(composed);
+    return ok;
+}
+
+/* select + select => the second, reading the first's inputs directly. */
+static bool composeSelects(const DFQueryStep* first, DFQueryStep* second, bool* composed)
+{
+    *composed = false;
+    size_t* from = (size_t*)dfMalloc((second->nameCount ? second->nameCount : 1) * sizeof(size_t));
+    if (!from) return false;
+    for (size_t j = 0; j < second->nameCount; j++) {
+        from[j] = (size_t)-1;
+        for (size_t k = 0; k < first->nameCount && from[j] == (size_t)-1; k++) {
+            if (strcmp(second->names[j], outputName(first, k)) == 0) from[j] = k;
+        }
+        if (from[j] == (size_t)-1) {
+            dfFree(from);
+            return true;   // unknown name: leave it to collect to report
+        }
+    }
+    bool ok = true;
+    for (size_t j = 0; ok && j < second->nameCount; j++) {
+        const DFQueryStep* src = first;
+        size_t k = from[j];
+        if (strcmp(outputName(second, j), src->names[k]) != 0) {
+            ok = setAlias(second, j, outputName(second, j));
+        }
+        char* name = ok ? copyName(src->names[k]) : NULL;
+        ok = name != NULL;
+        if (ok) {
+            dfFree(second->names[j]);
+            second->names[j] = name;
+        }
+    }
+    dfFree(from);
+    *composed = ok;
+    return ok;
+}
+
+static bool collapseSteps(DFQuery* plan)
+{
+    size_t i = 1;
+    while (i < plan->count) {
+        DFQueryStep* prev = &plan->steps[i - 1];
+        DFQueryStep* step = &plan->steps[i];
+        bool merged = false;
+        bool ok = true;
+        if (prev->op == DFQ_SELECT && step->op == DFQ_RENAME) {
+            ok = foldRename(prev, step, &merged);
+            if (merged) removeStep(plan, i);
+        } else if (prev->op == DFQ_RENAME && step->op == DFQ_RENAME) {
+            ok = merged = mergeRenames(prev, step);
+            if (merged) removeStep(plan, i);
+        } else if (prev->op == DFQ_SELECT && step->op == DFQ_SELECT) {
+            ok = composeSelects(prev, step, &merged);
+            if (merged) removeStep(plan, i - 1);
+        }
+        if (!ok) return false;
+        if (!merged) i++;
+    }
+    return true;
+}
+
+bool dfQueryOptimize(const DFQuery* q, DFQuery* out)
+{
+    if (!q || !out || (!q->source && !q->csvPath)) return false;
+    dfQueryInit(out, q->source);
+    if (q->csvPath && !(out->csvPath = copyName(q->csvPath))) return false;
+
+    for (size_t i = 0; i < q->count; i++) {
+        DFQueryStep* step = pushStep(out, q->steps[i].op);
+        if (!step || !copyStep(step, &q->steps[i])) {
+            if (step) out->count--;
+            dfQueryFree(out);
+            return false;
+        }
+        if (step->op == DFQ_RENAME && step->column && !normalizeRename(step)) {
+            dfQueryFree(out);
+            return false;
+        }
+    }
+
+    // the source columns: a CSV plan reads just the header
+    DataFrame header;
+    DataFrame_Create(&header);
+    NameList source = { NULL, 0, 0 };
+    bool ok;
+    if (q->csvPath) {
+        DfCsvScan headerOnly = { NULL, 0, NULL, 0, true };
+        ok = header.ops->readCsvScan(&header, q->csvPath, &headerOnly) && frameNames(&header, &source);
+    } else {
+        ok = frameNames(q->source, &source);
+    }
+
+    ok = ok && pushWheres(out, &source) && pruneColumns(out, &source) &&
+         scanFilters(out) && collapseSteps(out);
+
+    nameListFree(&source);
+    DataFrame_Destroy(&header);
+    if (!ok) dfQueryFree(out);
+    return ok;
+}
+
+/* ---------------------------------------------------------------------------
+ * Execution
+ *
+ * The running state is a view frame whose columns share the source's
+ * storage, plus the rows still selected: either the leading `prefix` rows
+ * of the view in order (no index vector yet) or an explicit DfSelection.
+ * --------------------------------------------------------------------------- */
+
+typedef struct {
+    DataFrame   view;
+    bool        explicitRows;  // false => rows are 0 .. prefix-1
+    size_t      prefix;
+    DfSelection sel;
+} QueryState;
+
+static void replaceView(QueryState* st, DataFrame next)
+{
+    DataFrame_Destroy(&st->view);
+    st->view = next;
+}
+
+static void replaceSelection(QueryState* st, DfSelection next)
+{
+    dfSelectionFree(&st->sel);
+    st->sel = next;
+    st->explicitRows = true;
+}
+
+/*
+ * The current rows as an input selection for the selection methods: NULL
+ * when they are still every row of the view.
+ */
+static const DfSelection* inputRows(QueryState* st)
+{
+    if (st->explicitRows) return &st->sel;
+    if (st->prefix == st->view.ops->numRows(&st->view)) return NULL;
+
+    // a head() ran before any filter or sort: spell out the prefix
+    DfSelection range = { NULL, 0 };
+    if (st->prefix > 0) {
+        range.rows = (size_t*)dfMalloc(st->prefix * sizeof(size_t));
+        if (range.rows) {
+            for (size_t i = 0; i < st->prefix; i++) range.rows[i] = i;
+            range.count = st->prefix;
+        }
+    }
+    replaceSelection(st, range);
+    return &st->sel;
+}
+
+static bool resolveColumn(const DataFrame* view, const char* name, size_t* out)
+{
+    *out = view->ops->columnIndex(view, name);
+    if (*out == (size_t)-1) {
+        fprintf(stderr, "dfQueryCollect: no column named '%s'.\n", name);
+        return false;
+    }
+    return true;
+}
+
+/* Rename the view's columns names[j] -> aliases[j] (where they differ). */
+static bool renameView(QueryState* st, const DFQueryStep* step)
+{
+    const char** oldNames = (const char**)dfMalloc((step->nameCount ? step->nameCount : 1) * sizeof(char*));
+    const char** newNames = (const char**)dfMalloc((step->nameCount ? step->nameCount : 1) * sizeof(char*));
+    size_t n = 0;
+    if (oldNames && newNames) {
+        for (size_t j = 0; j < step->nameCount; j++) {
+            if (strcmp(step->names[j], outputName(step, j)) == 0) continue;
+            oldNames[n] = step->names[j];
+            newNames[n] = outputName(step, j);
+            n++;
+        }
+        if (n) replaceView(st, st->view.ops->renameColumns(&st->view, oldNames, newNames, n));
+    }
+    bool ok = oldNames && newNames;
+    dfFree(oldNames);
+    dfFree(newNames);
+    return ok;
+}
+
+static bool runSelect(QueryState* st, const DFQueryStep* step)
+{
+    size_t* cols = (size_t*)dfMalloc((step->nameCount ? step->nameCount : 1) * sizeof(size_t));
+    if (!cols) return false;
+    for (size_t i = 0; i < step->nameCount; i++) {
+        if (!resolveColumn(&st->view, step->names[i], &cols[i])) {
+            dfFree(cols);
+            return false;
+        }
+    }
+    replaceView(st, st->view.ops->selectColumns(&st->view, cols, step->nameCount));
+    dfFree(cols);
+    return !step->aliases || renameView(st, step);
+}
+
+static bool runRename(QueryState* st, const DFQueryStep* step)
+{
+    for (size_t j = 0; j < step->nameCount; j++) {
+        size_t c;
+        if (!resolveColumn(&st->view, step->names[j], &c)) return false;
+    }
+    return renameView(st, step);
+}
+
+static bool runWhere(QueryState* st, const DFQueryStep* step)
+{
+    size_t c;
+    if (!resolveColumn(&st->view, step->column, &c)) return false;
+
+    DfMask hit;
+    if (!dfMaskCompare(st->view.ops->getSeries(&st->view, c), step->cmp, step->value, &hit)) {
+        fprintf(stderr, "dfQueryCollect: column '%s' is not numeric.\n", step->column);
+        return false;
+    }
+
+    const DfSelection* in = inputRows(st);
+    if (!in) {
+        replaceSelection(st, dfMaskToSelection(&hit));
+    } else {
+        // keep the selected rows whose bit is set, in place
+        size_t kept = 0;
+        for (size_t i = 0; i < st->sel.count; i++) {
+            if (dfMaskGet(&hit, st->sel.rows[i])) st->sel.rows[kept++] = st->sel.rows[i];
+        }
+        st->sel.count = kept;
+    }
+    dfMaskFree(&hit);
+    return true;
+}
+
+/* The selected rows of the view as a frame of their own. */
+static DataFrame currentRows(QueryState* st)
+{
+    if (!st->explicitRows) {
+        // still a prefix of the view: a row view, nothing is copied
+        return st->view.ops->head(&st->view, st->prefix);
+    }
+    DataFrame rows = st->view.ops->takeSelection(&st->view, &st->sel);
+    if (rows.ops->numColumns(&rows) == 0) {
+        // take() of no rows has no columns; keep the schema
+        DataFrame_Destroy(&rows);
+        rows = st->view.ops->head(&st->view, 0);
+    }
+    return rows;
+}
+
+/*
+ * The join's right frame after its pushed-down filters and column pruning.
+ * `filtered` and `out` are created frames, replaced here.
+ */
+static bool joinRight(const DFQueryStep* step, DataFrame* filtered, DataFrame* out)
+{
+    const DataFrame* right = step->right;
+    DfMask keep = { NULL, 0 };
+    for (size_t f = 0; f < step->filterCount; f++) {
+        size_t c;
+        if (!resolveColumn(right, step->filters[f].column, &c)) {
+            dfMaskFree(&keep);
+            return false;
+        }
+        DfMask hit;
+        if (!dfMaskCompare(right->ops->getSeries(right, c), step->filters[f].cmp,
+                           step->filters[f].value, &hit)) {
+            fprintf(stderr, "dfQueryCollect: column '%s' is not numeric.\n", step->filters[f].column);
+            dfMaskFree(&keep);
+            return false;
+        }
+        if (f == 0) {
+            keep = hit;
+        } else {
+            dfMaskAnd(&keep, &hit);
+            dfMaskFree(&hit);
+        }
+    }
+    if (step->filterCount) {
+        DfSelection sel = dfMaskToSelection(&keep);
+        dfMaskFree(&keep);
+        DataFrame_Destroy(filtered);
+        *filtered = right->ops->takeSelection(right, &sel);
+        if (filtered->ops->numColumns(filtered) == 0) {
+            DataFrame_Destroy(filtered);
+            *filtered = right->ops->head(right, 0);
+        }
+        dfSelectionFree(&sel);
+        right = filtered;
+    }
+
+    size_t nCols = step->nameCount ? step->nameCount : right->ops->numColumns(right);
+    size_t* cols = (size_t*)dfMalloc((nCols ? nCols : 1) * sizeof(size_t));
+    if (!cols) return false;
+    for (size_t j = 0; j < nCols; j++) {
+        if (!step->nameCount) {
+            cols[j] = j;
+        } else if (!resolveColumn(right, step->names[j], &cols[j])) {
+            dfFree(cols);
+            return false;
+        }
+    }
+    DataFrame_Destroy(out);
+    *out = right->ops->selectColumns(right, cols, nCols);
+    dfFree(cols);
+    return true;
+}
+
+static bool runJoin(QueryState* st, const DFQueryStep* step)
+{
+    DataFrame filtered, right;
+    DataFrame_Create(&filtered);
+    DataFrame_Create(&right);
+    bool ok = joinRight(step, &filtered, &right);
+    if (ok) {
+        DataFrame left = currentRows(st);
+        DataFrame joined = left.ops->join(&left, &right, step->column, step->rightKey, step->how);
+        DataFrame_Destroy(&left);
+
+        // the joined rows are the new view, every row selected
+        replaceView(st, joined);
+        dfSelectionFree(&st->sel);
+        st->explicitRows = false;
+        st->prefix = st->view.ops->numRows(&st->view);
+        ok = st->view.ops->numColumns(&st->view) > 0;
+    }
+    DataFrame_Destroy(&right);
+    DataFrame_Destroy(&filtered);
+    return ok;
+}
+
+static DataFrame execute(const DataFrame* source, const DFQueryStep* steps, size_t count)
+{
+    QueryState st;
+    DataFrame_Create(&st.view);
+    st.explicitRows = false;
+    st.sel.rows = NULL;
+    st.sel.count = 0;
+
+    // start from a view sharing every source column
+    size_t nCols = source->ops->numColumns(source);
+    size_t* all = (size_t*)dfMalloc((nCols ? nCols : 1) * sizeof(size_t));
+    if (!all) return st.view;
+    for (size_t c = 0; c < nCols; c++) all[c] = c;
+    replaceView(&st, source->ops->selectColumns(source, all, nCols));
+    dfFree(all);
+    st.prefix = st.view.ops->numRows(&st.view);
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < count; i++) {
+        const DFQueryStep* step = &steps[i];
+        switch (step->op) {
+            case DFQ_SELECT:
+                ok = runSelect(&st, step);
+                break;
+            case DFQ_RENAME:
+                ok = runRename(&st, step);
+                break;
+            case DFQ_FILTER: {
+                const DfSelection* in = inputRows(&st);
+                replaceSelection(&st, st.view.ops->filterSelection(&st.view, step->predicate, in));
+            } break;
+            case DFQ_WHERE:
+                ok = runWhere(&st, step);
+                break;
+            case DFQ_SORT: {
+                size_t c;
+                ok = resolveColumn(&st.view, step->column, &c);
+                if (!ok) break;
+                const DfSelection* in = inputRows(&st);
+                if (i + 1 < count && steps[i + 1].op == DFQ_HEAD) {
+                    // sort + head => keep only the best n rows
+                    replaceSelection(&st, st.view.ops->topSelection(&st.view, c, step->ascending,
+                                                                    steps[i + 1].n, in));
+                    i++;
+                } else {
+                    replaceSelection(&st, st.view.ops->sortSelection(&st.view, c, step->ascending, in));
+                }
+            } break;
+            case DFQ_HEAD:
+                if (st.explicitRows) {
+                    if (step->n < st.sel.count) st.sel.count = step->n;
+                } else if (step->n < st.prefix) {
+                    st.prefix = step->n;
+                }
+                break;
+            case DFQ_JOIN:
+                ok = runJoin(&st, step);
+                break;
+        }
+    }
+
+    DataFrame result;
+    if (ok) {
+        result = currentRows(&st);
+    } else {
+        DataFrame_Create(&result);
+    }
+    dfSelectionFree(&st.sel);
+    DataFrame_Destroy(&st.view);
+    return result;
+}
+
+DataFrame dfQueryCollect(const DFQuery* q)
+{
+    DF_OP_SCOPE();
+    DataFrame result;
+    DFQuery plan;
+    if (!dfQueryOptimize(q, &plan)) {
+        DataFrame_Create(&result);
+        return result;
+    }
+
+    if (!plan.csvPath) {
+        result = execute(plan.source, plan.steps, plan.count);
+    } else {
+        DataFrame loaded;
+        DataFrame_Create(&loaded);
+        DfCsvScan scan = { (const char* const*)plan.scanColumns, plan.scanColumnCount,
+                           plan.scanFilters, plan.scanFilterCount, false };
+        if (loaded.ops->readCsvScan(&loaded, plan.csvPath, &scan)) {
+            result = execute(&loaded, plan.steps, plan.count);
+        } else {
+            DataFrame_Create(&result);
+        }
+        DataFrame_Destroy(&loaded);
+    }
+    dfQueryFree(&plan);
+    return result;
+}
@@ -0,0 +1,517 @@
+#include <limits.h>
+#include <math.h>
+
+#include "dfreduce.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DF_REDUCE_X86 1
+#include <immintrin.h>
+#define DF_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Dispatch table
+ * --------------------------------------------------------------------------- */
+
+typedef struct {
+    int64_t   (*sumInt32)(const int*, size_t);
+    double    (*sumDouble)(const double*, size_t);
+    double    (*sumInt64)(const long long*, size_t);
+    int       (*minInt32)(const int*, size_t);
+    int       (*maxInt32)(const int*, size_t);
+    double    (*minDouble)(const double*, size_t);
+    double    (*maxDouble)(const double*, size_t);
+    long long (*minInt64)(const long long*, size_t);
+    long long (*maxInt64)(const long long*, size_t);
+    double    (*productInt32)(const int*, size_t);
+    double    (*productDouble)(const double*, size_t);
+    double    (*productInt64)(const long long*, size_t);
+} ReduceKernels;
+
+/* ---------------------------------------------------------------------------
+ * Scalar kernels: four accumulators, so the loop is not one long
+ * dependency chain, plus a tail loop.
+ * --------------------------------------------------------------------------- */
+
+#define SCALAR_FOLD(T, Acc, init, STEP)                                      \
+    Acc a0 = (init), a1 = (init), a2 = (init), a3 = (init);                  \
+    size_t i = 0;                                                            \
+    for (; i + 4 <= n; i += 4) {                                             \
+        STEP(a0, v[i]);                                                      \
+        STEP(a1, v[i + 1]);                                                  \
+        STEP(a2, v[i + 2]);                                                  \
+        STEP(a3, v[i + 3]);                                                  \
+    }                                                                        \
+    for (; i < n; i++) STEP(a0, v[i]);
+
+#define ADD_STEP(acc, x)  (acc) += (x)
+#define MUL_STEP(acc, x)  (acc) *= (double)(x)
+#define MIN_STEP(acc, x)  if ((x) < (acc)) (acc) = (x)
+#define MAX_STEP(acc, x)  if ((x) > (acc)) (acc) = (x)
+#define ADD_D_STEP(acc, x) (acc) += (double)(x)
+
+static int64_t sumInt32Scalar(const int* v, size_t n)
+{
+    SCALAR_FOLD(int, int64_t, 0, ADD_STEP)
+    return (a0 + a1) + (a2 + a3);
+}
+
+static double sumDoubleScalar(const double* v, size_t n)
+{
+    SCALAR_FOLD(double, double, 0.0, ADD_STEP)
+    return (a0 + a1) + (a2 + a3);
+}
+
+static double sumInt64Scalar(const long long* v, size_t n)
+{
+    SCALAR_FOLD(long long, double, 0.0, ADD_D_STEP)
+    return (a0 + a1) + (a2 + a3);
+}
+
+#define SCALAR_EXTREME(Name, T, init, STEP)                                  \
+    static T Name(const T* v, size_t n)                                      \
+    {                                                                        \
+        SCALAR_FOLD(T, T, init, STEP)                                        \
+        STEP(a0, a1);                                                        \
+        STEP(a2, a3);                                                        \
+        STEP(a0, a2);                                                        \
+        return a0;                                                           \
+    }
+
+SCALAR_EXTREME(minInt32Scalar,  int,       INT_MAX,   MIN_STEP)
+SCALAR_EXTREME(maxInt32Scalar,  int,       INT_MIN,   MAX_STEP)
+SCALAR_EXTREME(minDoubleScalar, double,    INFINITY,  MIN_STEP)
+SCALAR_EXTREME(maxDoubleScalar, double,    -INFINITY, MAX_STEP)
+SCALAR_EXTREME(minInt64Scalar,  long long, LLONG_MAX, MIN_STEP)
+SCALAR_EXTREME(maxInt64Scalar,  long long, LLONG_MIN, MAX_STEP)
+
+#define SCALAR_PRODUCT(Name, T)                                              \
+    static double Name(const T* v, size_t n)                                 \
+    {                                                                        \
+        SCALAR_FOLD(T, double, 1.0, MUL_STEP)                                \
+        return (a0 * a1) * (a2 * a3);                                        \
+    }
+
+SCALAR_PRODUCT(productInt32Scalar,  int)
+SCALAR_PRODUCT(productDoubleScalar, double)
+SCALAR_PRODUCT(productInt64Scalar,  long long)
+
+static const ReduceKernels g_scalarKernels = {
+    .sumInt32      = sumInt32Scalar,
+    .sumDouble     = sumDoubleScalar,
+    .sumInt64      = sumInt64Scalar,
+    .minInt32      = minInt32Scalar,
+    .maxInt32      = maxInt32Scalar,
+    .minDouble     = minDoubleScalar,
+    .maxDouble     = maxDoubleScalar,
+    .minInt64      = minInt64Scalar,
+    .maxInt64      = maxInt64Scalar,
+    .productInt32  = productInt32Scalar,
+    .productDouble = productDoubleScalar,
+    .productInt64  = productInt64Scalar,
+};
+
+#ifdef DF_REDUCE_X86
+
+/* ---------------------------------------------------------------------------
+ * SSE2 kernels (2 doubles / 4 ints per register). SSE2 has no 64-bit
+ * compare, so 64-bit min/max stay scalar.
+ * --------------------------------------------------------------------------- */
+
+DF_TARGET("sse2")
+static int64_t sumInt32Sse2(const int* v, size_t n)
+{
+    // sign-extend each int to 64 bits by interleaving it with its sign mask
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128(), acc3 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(v + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(v + i + 4));
+        __m128i sx = _mm_srai_epi32(x, 31), sy = _mm_srai_epi32(y, 31);
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(x, sx));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(x, sx));
+        acc2 = _mm_add_epi64(acc2, _mm_unpacklo_epi32(y, sy));
+        acc3 = _mm_add_epi64(acc3, _mm_unpackhi_epi32(y, sy));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes,
+                     _mm_add_epi64(_mm_add_epi64(acc0, acc1), _mm_add_epi64(acc2, acc3)));
+    return lanes[0] + lanes[1] + sumInt32Scalar(v + i, n - i);
+}
+
+DF_TARGET("sse2")
+static double sumDoubleSse2(const double* v, size_t n)
+{
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(v + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(v + i + 2));
+        acc2 = _mm_add_pd(acc2, _mm_loadu_pd(v + i + 4));
+        acc3 = _mm_add_pd(acc3, _mm_loadu_pd(v + i + 6));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+    return (lanes[0] + lanes[1]) + sumDoubleScalar(v + i, n - i);
+}
+
+/* take ? a : b per lane; SSE2 has neither pminsd nor a blend */
+DF_TARGET("sse2")
+static __m128i selectInt32Sse2(__m128i take, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(take, a), _mm_andnot_si128(take, b));
+}
+
+DF_TARGET("sse2")
+static int minInt32Sse2(const int* v, size_t n)
+{
+    __m128i acc0 = _mm_set1_epi32(INT_MAX), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(v + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(v + i + 4));
+        acc0 = selectInt32Sse2(_mm_cmplt_epi32(x, acc0), x, acc0);
+        acc1 = selectInt32Sse2(_mm_cmplt_epi32(y, acc1), y, acc1);
+    }
+    acc0 = selectInt32Sse2(_mm_cmplt_epi32(acc1, acc0), acc1, acc0);
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, acc0);
+    int m = minInt32Scalar(v + i, n - i);
+    for (int k = 0; k < 4; k++) if (lanes[k] < m) m = lanes[k];
+    return m;
+}
+
+DF_TARGET("sse2")
+static int maxInt32Sse2(const int* v, size_t n)
+{
+    __m128i acc0 = _mm_set1_epi32(INT_MIN), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(v + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(v + i + 4));
+        acc0 = selectInt32Sse2(_mm_cmpgt_epi32(x, acc0), x, acc0);
+        acc1 = selectInt32Sse2(_mm_cmpgt_epi32(y, acc1), y, acc1);
+    }
+    acc0 = selectInt32Sse2(_mm_cmpgt_epi32(acc1, acc0), acc1, acc0);
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, acc0);
+    int m = maxInt32Scalar(v + i, n - i);
+    for (int k = 0; k < 4; k++) if (lanes[k] > m) m = lanes[k];
+    return m;
+}
+
+/*
+ * minpd/maxpd return the second operand when either is NaN: keeping the
+ * accumulator second means a NaN input is simply passed over.
+ */
+DF_TARGET("sse2")
+static double minDoubleSse2(const double* v, size_t n)
+{
+    __m128d acc0 = _mm_set1_pd(INFINITY), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_min_pd(_mm_loadu_pd(v + i), acc0);
+        acc1 = _mm_min_pd(_mm_loadu_pd(v + i + 2), acc1);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_min_pd(acc0, acc1));
+    double m = minDoubleScalar(v + i, n - i);
+    if (lanes[0] < m) m = lanes[0];
+    if (lanes[1] < m) m = lanes[1];
+    return m;
+}
+
+DF_TARGET("sse2")
+static double maxDoubleSse2(const double* v, size_t n)
+{
+    __m128d acc0 = _mm_set1_pd(-INFINITY), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_max_pd(_mm_loadu_pd(v + i), acc0);
+        acc1 = _mm_max_pd(_mm_loadu_pd(v + i + 2), acc1);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_max_pd(acc0, acc1));
+    double m = maxDoubleScalar(v + i, n - i);
+    if (lanes[0] > m) m = lanes[0];
+    if (lanes[1] > m) m = lanes[1];
+    return m;
+}
+
+DF_TARGET("sse2")
+static double productDoubleSse2(const double* v, size_t n)
+{
+    __m128d acc0 = _mm_set1_pd(1.0), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_mul_pd(acc0, _mm_loadu_pd(v + i));
+        acc1 = _mm_mul_pd(acc1, _mm_loadu_pd(v + i + 2));
+        acc2 = _mm_mul_pd(acc2, _mm_loadu_pd(v + i + 4));
+        acc3 = _mm_mul_pd(acc3, _mm_loadu_pd(v + i + 6));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_mul_pd(_mm_mul_pd(acc0, acc1), _mm_mul_pd(acc2, acc3)));
+    return (lanes[0] * lanes[1]) * productDoubleScalar(v + i, n - i);
+}
+
+DF_TARGET("sse2")
+static double productInt32Sse2(const int* v, size_t n)
+{
+    __m128d acc0 = _mm_set1_pd(1.0), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(v + i));
+        acc0 = _mm_mul_pd(acc0, _mm_cvtepi32_pd(x));
+        acc1 = _mm_mul_pd(acc1, _mm_cvtepi32_pd(_mm_srli_si128(x, 8)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_mul_pd(acc0, acc1));
+    return (lanes[0] * lanes[1]) * productInt32Scalar(v + i, n - i);
+}
+
+static const ReduceKernels g_sse2Kernels = {
+    .sumInt32      = sumInt32Sse2,
+    .sumDouble     = sumDoubleSse2,
+    .sumInt64      = sumInt64Scalar,
+    .minInt32      = minInt32Sse2,
+    .maxInt32      = maxInt32Sse2,
+    .minDouble     = minDoubleSse2,
+    .maxDouble     = maxDoubleSse2,
+    .minInt64      = minInt64Scalar,
+    .maxInt64      = maxInt64Scalar,
+    .productInt32  = productInt32Sse2,
+    .productDouble = productDoubleSse2,
+    .productInt64  = productInt64Scalar,
+};
+
+/* ---------------------------------------------------------------------------
+ * AVX2 kernels (4 doubles / 8 ints per register). There is no 64-bit
+ * integer to double conversion before AVX-512, so the DF_DATETIME sum and
+ * product stay scalar.
+ * --------------------------------------------------------------------------- */
+
+DF_TARGET("avx2")
+static int64_t sumInt32Avx2(const int* v, size_t n)
+{
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(v + i))));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(v + i + 4))));
+        acc2 = _mm256_add_epi64(acc2, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(v + i + 8))));
+        acc3 = _mm256_add_epi64(acc3, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(v + i + 12))));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes,
+                        _mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3)));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumInt32Scalar(v + i, n - i);
+}
+
+DF_TARGET("avx2")
+static double sumDoubleAvx2(const double* v, size_t n)
+{
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(v + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(v + i + 4));
+        acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(v + i + 8));
+        acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(v + i + 12));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + sumDoubleScalar(v + i, n - i);
+}
+
+#define AVX2_EXTREME_INT32(Name, init, OP, Scalar, CMP)                      \
+    DF_TARGET("avx2")                                                        \
+    static int Name(const int* v, size_t n)                                  \
+    {                                                                        \
+        __m256i acc0 = _mm256_set1_epi32(init), acc1 = acc0;                 \
+        size_t i = 0;                                                        \
+        for (; i + 16 <= n; i += 16) {                                       \
+            acc0 = OP(acc0, _mm256_loadu_si256((const __m256i*)(v + i)));    \
+            acc1 = OP(acc1, _mm256_loadu_si256((const __m256i*)(v + i + 8))); \
+        }                                                                    \
+        int lanes[8];                                                        \
+        _mm256_storeu_si256((__m256i*)lanes, OP(acc0, acc1));                \
+        int m = Scalar(v + i, n - i);                                        \
+        for (int k = 0; k < 8; k++) if (lanes[k] CMP m) m = lanes[k];        \
+        return m;                                                            \
+    }
+
+AVX2_EXTREME_INT32(minInt32Avx2, INT_MAX, _mm256_min_epi32, minInt32Scalar, <)
+AVX2_EXTREME_INT32(maxInt32Avx2, INT_MIN, _mm256_max_epi32, maxInt32Scalar, >)
+
+/* the accumulator goes second so a NaN input is passed over (see SSE2) */
+#define AVX2_EXTREME_DOUBLE(Name, init, OP, Scalar, CMP)                     \
+    DF_TARGET("avx2")                                                        \
+    static double Name(const double* v, size_t n)                            \
+    {                                                                        \
+        __m256d acc0 = _mm256_set1_pd(init), acc1 = acc0;                    \
+        size_t i = 0;                                                        \
+        for (; i + 8 <= n; i += 8) {                                         \
+            acc0 = OP(_mm256_loadu_pd(v + i), acc0);                         \
+            acc1 = OP(_mm256_loadu_pd(v + i + 4), acc1);                     \
+        }                                                                    \
+        double lanes[4];                                                     \
+        _mm256_storeu_pd(lanes, OP(acc0, acc1));                             \
+        double m = Scalar(v + i, n - i);                                     \
+        for (int k = 0; k < 4; k++) if (lanes[k] CMP m) m = lanes[k];        \
+        return m;                                                            \
+    }
+
+AVX2_EXTREME_DOUBLE(minDoubleAvx2, INFINITY,  _mm256_min_pd, minDoubleScalar, <)
+AVX2_EXTREME_DOUBLE(maxDoubleAvx2, -INFINITY, _mm256_max_pd, maxDoubleScalar, >)
+
+/* 64-bit min/max: compare, then blend the winner in */
+#define AVX2_EXTREME_INT64(Name, init, Scalar, CMP, TAKE)                    \
+    DF_TARGET("avx2")                                                        \
+    static long long Name(const long long* v, size_t n)                      \
+    {                                                                        \
+        __m256i acc0 = _mm256_set1_epi64x(init), acc1 = acc0;                \
+        size_t i = 0;                                                        \
+        for (; i + 8 <= n; i += 8) {                                         \
+            __m256i x = _mm256_loadu_si256((const __m256i*)(v + i));         \
+            __m256i y = _mm256_loadu_si256((const __m256i*)(v + i + 4));     \
+            acc0 = _mm256_blendv_epi8(acc0, x, TAKE(x, acc0));               \
+            acc1 = _mm256_blendv_epi8(acc1, y, TAKE(y, acc1));               \
+        }                                                                    \
+        long long lanes[8];                                                  \
+        _mm256_storeu_si256((__m256i*)lanes, acc0);                          \
+        _mm256_storeu_si256((__m256i*)(lanes + 4), acc1);                    \
+        long long m = Scalar(v + i, n - i);                                  \
+        for (int k = 0; k < 8; k++) if (lanes[k] CMP m) m = lanes[k];        \
+        return m;                                                            \
+    }
+
+#define AVX2_LESS64(x, acc)    _mm256_cmpgt_epi64(acc, x)
+#define AVX2_GREATER64(x, acc) _mm256_cmpgt_epi64(x, acc)
+
+AVX2_EXTREME_INT64(minInt64Avx2, LLONG_MAX, minInt64Scalar, <, AVX2_LESS64)
+AVX2_EXTREME_INT64(maxInt64Avx2, LLONG_MIN, maxInt64Scalar, >, AVX2_GREATER64)
+
+DF_TARGET("avx2")
+static double productDoubleAvx2(const double* v, size_t n)
+{
+    __m256d acc0 = _mm256_set1_pd(1.0), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_mul_pd(acc0, _mm256_loadu_pd(v + i));
+        acc1 = _mm256_mul_pd(acc1, _mm256_loadu_pd(v + i + 4));
+        acc2 = _mm256_mul_pd(acc2, _mm256_loadu_pd(v + i + 8));
+        acc3 = _mm256_mul_pd(acc3, _mm256_loadu_pd(v + i + 12));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_mul_pd(_mm256_mul_pd(acc0, acc1), _mm256_mul_pd(acc2, acc3)));
+    return ((lanes[0] * lanes[1]) * (lanes[2] * lanes[3])) * productDoubleScalar(v + i, n - i);
+}
+
+DF_TARGET("avx2")
+static double productInt32Avx2(const int* v, size_t n)
+{
+    __m256d acc0 = _mm256_set1_pd(1.0), acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_mul_pd(acc0, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(v + i))));
+        acc1 = _mm256_mul_pd(acc1, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(v + i + 4))));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_mul_pd(acc0, acc1));
+    return ((lanes[0] * lanes[1]) * (lanes[2] * lanes[3])) * productInt32Scalar(v + i, n - i);
+}
+
+static const ReduceKernels g_avx2Kernels = {
+    .sumInt32      = sumInt32Avx2,
+    .sumDouble     = sumDoubleAvx2,
+    .sumInt64      = sumInt64Scalar,
+    .minInt32      = minInt32Avx2,
+    .maxInt32      = maxInt32Avx2,
+    .minDouble     = minDoubleAvx2,
+    .maxDouble     = maxDoubleAvx2,
+    .minInt64      = minInt64Avx2,
+    .maxInt64      = maxInt64Avx2,
+    .productInt32  = productInt32Avx2,
+    .productDouble = productDoubleAvx2,
+    .productInt64  = productInt64Scalar,
+};
+
+#endif /* DF_REDUCE_X86 */
+
+/* ---------------------------------------------------------------------------
+ * Runtime selection
+ * --------------------------------------------------------------------------- */
+
+static bool isaSupported(DfIsa isa)
+{
+    switch (isa) {
+        case DF_ISA_SCALAR: return true;
+#ifdef DF_REDUCE_X86
+        case DF_ISA_SSE2:   __builtin_cpu_init(); return __builtin_cpu_supports("sse2");
+        case DF_ISA_AVX2:   __builtin_cpu_init(); return __builtin_cpu_supports("avx2");
+#endif
+        default:            return false;
+    }
+}
+
+static const ReduceKernels* kernelsFor(DfIsa isa)
+{
+    switch (isa) {
+#ifdef DF_REDUCE_X86
+        case DF_ISA_AVX2: return &g_avx2Kernels;
+        case DF_ISA_SSE2: return &g_sse2Kernels;
+#endif
+        default:          return &g_scalarKernels;
+    }
+}
+
+// chosen on first use; a racing first call only stores the same answer twice
+static const ReduceKernels* g_kernels = NULL;
+static DfIsa g_isa = DF_ISA_SCALAR;
+
+static const ReduceKernels* activeKernels(void)
+{
+    if (!g_kernels) {
+        DfIsa isa = DF_ISA_SCALAR;
+        if (isaSupported(DF_ISA_AVX2))      isa = DF_ISA_AVX2;
+        else if (isaSupported(DF_ISA_SSE2)) isa = DF_ISA_SSE2;
+        g_isa = isa;
+        g_kernels = kernelsFor(isa);
+    }
+    return g_kernels;
+}
+
+DfIsa dfReduceIsa(void)
+{
+    activeKernels();
+    return g_isa;
+}
+
+bool dfReduceSetIsa(DfIsa isa)
+{
+    if (!isaSupported(isa)) return false;
+    g_isa = isa;
+    g_kernels = kernelsFor(isa);
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Public entry points
+ * --------------------------------------------------------------------------- */
+
+int64_t dfReduceSumInt32(const int* v, size_t n)           { return activeKernels()->sumInt32(v, n); }
+double  dfReduceSumDouble(const double* v, size_t n)       { return activeKernels()->sumDouble(v, n); }
+double  dfReduceSumInt64(const long long* v, size_t n)     { return activeKernels()->sumInt64(v, n); }
+
+int       dfReduceMinInt32(const int* v, size_t n)         { return activeKernels()->minInt32(v, n); }
+int       dfReduceMaxInt32(const int* v, size_t n)         { return activeKernels()->maxInt32(v, n); }
+double    dfReduceMinDouble(const double* v, size_t n)     { return activeKernels()->minDouble(v, n); }
+double    dfReduceMaxDouble(const double* v, size_t n)     { return activeKernels()->maxDouble(v, n); }
+long long dfReduceMinInt64(const long long* v, size_t n)   { return activeKernels()->minInt64(v, n); }
+long long dfReduceMaxInt64(const long long* v, size_t n)   { return activeKernels()->maxInt64(v, n); }
+
+double dfReduceProductInt32(const int* v, size_t n)        { return activeKernels()->productInt32(v, n); }
+double dfReduceProductDouble(const double* v, size_t n)    { return activeKernels()->productDouble(v, n); }
+double dfReduceProductInt64(const long long* v, size_t n)  { return activeKernels()->productInt64(v, n); }
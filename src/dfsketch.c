@@ -0,0 +1,653 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "dfsketch.h"
+#include "dfstats.h"
+
+#define SKETCH_MAGIC   0x53514644u   // "DFQS"
+#define SKETCH_VERSION 1u
+#define SKETCH_HEADER  (4 + 4 + 8 + 8 + 8 + 8)
+#define SKETCH_BLOCK   ((size_t)1 << 16)   // rows per dfSketchAddSeries batch
+
+#define HLL_MAGIC      0x4C484644u   // "DFHL"
+#define HLL_VERSION    1u
+#define HLL_HEADER     (4 + 4 + 1)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Scale function (k1): centroid q-ranges shrink like sqrt(q(1-q))
+ * --------------------------------------------------------------------------- */
+
+static double scaleK(double q, double compression)
+{
+    return compression / (2.0 * M_PI) * asin(2.0 * q - 1.0);
+}
+
+static double scaleKInverse(double k, double compression)
+{
+    double q = (sin(k * 2.0 * M_PI / compression) + 1.0) / 2.0;
+    return q > 1.0 ? 1.0 : q;
+}
+
+/* ---------------------------------------------------------------------------
+ * Lifecycle
+ * --------------------------------------------------------------------------- */
+
+static bool sketchAllocate(DfQuantileSketch* sk, double compression)
+{
+    memset(sk, 0, sizeof(*sk));
+    sk->compression = compression;
+    // the merged list never exceeds ~compression; the buffer amortizes the sort
+    size_t maxCentroids = (size_t)ceil(compression) + 8;
+    sk->bufferCapacity = 5 * maxCentroids;
+    sk->centroids = (DfCentroid*)malloc((maxCentroids + sk->bufferCapacity) * sizeof(DfCentroid));
+    sk->buffer = (DfCentroid*)malloc(sk->bufferCapacity * sizeof(DfCentroid));
+    if (!sk->centroids || !sk->buffer) {
+        dfSketchFree(sk);
+        return false;
+    }
+    sk->min = INFINITY;
+    sk->max = -INFINITY;
+    return true;
+}
+
+bool dfSketchInit(DfQuantileSketch* sk, double errorBound)
+{
+    if (!sk) return false;
+    if (!(errorBound >= 1e-5)) errorBound = 1e-5;
+    if (errorBound > 0.1) errorBound = 0.1;
+    // the median centroid spans about pi / (2 * compression) of the ranks
+    return sketchAllocate(sk, ceil(M_PI / (2.0 * errorBound)));
+}
+
+void dfSketchFree(DfQuantileSketch* sk)
+{
+    if (!sk) return;
+    free(sk->centroids);
+    free(sk->buffer);
+    memset(sk, 0, sizeof(*sk));
+}
+
+double dfSketchCount(const DfQuantileSketch* sk)
+{
+    return sk ? sk->totalWeight : 0.0;
+}
+
+/* ---------------------------------------------------------------------------
+ * Merging
+ * --------------------------------------------------------------------------- */
+
+static int compareCentroids(const void* a, const void* b)
+{
+    double x = ((const DfCentroid*)a)->mean, y = ((const DfCentroid*)b)->mean;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Fold the buffer into the centroid list: sort everything by mean, then
+ * sweep once, growing each centroid until it would span more than one unit
+ * of the scale function.
+ */
+static void sketchCompress(DfQuantileSketch* sk)
+{
+    if (sk->buffered == 0) return;
+
+    // centroids has room for count + bufferCapacity entries
+    DfCentroid* all = sk->centroids;
+    memcpy(all + sk->count, sk->buffer, sk->buffered * sizeof(DfCentroid));
+    size_t n = sk->count + sk->buffered;
+    sk->buffered = 0;
+    qsort(all, n, sizeof(DfCentroid), compareCentroids);
+
+    double total = sk->totalWeight;
+    double before = 0.0;    // weight left of the current centroid
+    double limit = total * scaleKInverse(scaleK(0.0, sk->compression) + 1.0, sk->compression);
+    size_t out = 0;
+    DfCentroid cur = all[0];
+    for (size_t i = 1; i < n; i++) {
+        double proposed = cur.weight + all[i].weight;
+        if (before + proposed <= limit) {
+            cur.mean += (all[i].mean - cur.mean) * all[i].weight / proposed;
+            cur.weight = proposed;
+        } else {
+            all[out++] = cur;
+            before += cur.weight;
+            limit = total * scaleKInverse(scaleK(before / total, sk->compression) + 1.0,
+                                          sk->compression);
+            cur = all[i];
+        }
+    }
+    all[out++] = cur;
+    sk->count = out;
+}
+
+static bool sketchPush(DfQuantileSketch* sk, double mean, double weight)
+{
+    if (sk->buffered == sk->bufferCapacity) sketchCompress(sk);
+    sk->buffer[sk->buffered].mean = mean;
+    sk->buffer[sk->buffered].weight = weight;
+    sk->buffered++;
+    sk->totalWeight += weight;
+    return true;
+}
+
+bool dfSketchAdd(DfQuantileSketch* sk, double x)
+{
+    if (!sk || !sk->centroids) return false;
+    if (isnan(x)) return true;
+    if (x < sk->min) sk->min = x;
+    if (x > sk->max) sk->max = x;
+    return sketchPush(sk, x, 1.0);
+}
+
+bool dfSketchAddSeries(DfQuantileSketch* sk, const Series* s, size_t fromRow)
+{
+    if (!sk || !sk->centroids || !s) return false;
+    if (s->type == DF_STRING || s->type == DF_CATEGORY) return false;
+
+    // a block at a time through a row view, so no full copy of the column
+    size_t length = seriesSize(s);
+    for (size_t start = fromRow; start < length; start += SKETCH_BLOCK) {
+        size_t rows = length - start < SKETCH_BLOCK ? length - start : SKETCH_BLOCK;
+        Series view;
+        seriesSlice(s, start, rows, &view);
+        size_t expected = rows - seriesNullCount(&view);
+        size_t count = 0;
+        double* values = dfSeriesValues(&view, &count);
+        seriesFree(&view);
+        if (!values && expected > 0) return false;
+
+        for (size_t i = 0; i < count; i++) dfSketchAdd(sk, values[i]);
+        free(values);
+    }
+    return true;
+}
+
+bool dfSketchMerge(DfQuantileSketch* dst, const DfQuantileSketch* src)
+{
+    if (!dst || !src || !dst->centroids) return false;
+    for (size_t i = 0; i < src->count; i++) {
+        sketchPush(dst, src->centroids[i].mean, src->centroids[i].weight);
+    }
+    for (size_t i = 0; i < src->buffered; i++) {
+        sketchPush(dst, src->buffer[i].mean, src->buffer[i].weight);
+    }
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Queries
+ * --------------------------------------------------------------------------- */
+
+static double weightedAverage(double x1, double w1, double x2, double w2)
+{
+    double lo = x1 < x2 ? x1 : x2, hi = x1 < x2 ? x2 : x1;
+    double v = (x1 * w1 + x2 * w2) / (w1 + w2);
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/*
+ * Treat each centroid as its mass spread around its mean: interpolate
+ * between neighbouring means, with the exact min / max as the outer ends
+ * and single-value centroids kept as points.
+ */
+double dfSketchQuantile(DfQuantileSketch* sk, double q)
+{
+    if (!sk || !sk->centroids) return 0.0;
+    sketchCompress(sk);
+    if (sk->count == 0) return 0.0;
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+
+    const DfCentroid* c = sk->centroids;
+    size_t n = sk->count;
+    double total = sk->totalWeight;
+    double index = q * total;
+
+    if (index < 1.0) return sk->min;
+    if (n == 1) return c[0].mean;
+    if (c[0].weight > 1.0 && index < c[0].weight / 2.0) {
+        return sk->min + (index - 1.0) / (c[0].weight / 2.0 - 1.0) * (c[0].mean - sk->min);
+    }
+    if (index > total - 1.0) return sk->max;
+    if (c[n - 1].weight > 1.0 && total - index <= c[n - 1].weight / 2.0) {
+        return sk->max - (total - index - 1.0) / (c[n - 1].weight / 2.0 - 1.0) *
+                         (sk->max - c[n - 1].mean);
+    }
+
+    double soFar = c[0].weight / 2.0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        double step = (c[i].weight + c[i + 1].weight) / 2.0;
+        if (soFar + step > index) {
+            double leftUnit = 0.0, rightUnit = 0.0;
+            if (c[i].weight == 1.0) {
+                if (index - soFar < 0.5) return c[i].mean;
+                leftUnit = 0.5;
+            }
+            if (c[i + 1].weight == 1.0) {
+                if (soFar + step - index <= 0.5) return c[i + 1].mean;
+                rightUnit = 0.5;
+            }
+            double z1 = index - soFar - leftUnit;
+            double z2 = soFar + step - index - rightUnit;
+            return weightedAverage(c[i].mean, z2, c[i + 1].mean, z1);
+        }
+        soFar += step;
+    }
+    // between the last mean and max
+    return weightedAverage(c[n - 1].mean, total - index, sk->max, index - soFar);
+}
+
+/* ---------------------------------------------------------------------------
+ * Serialization: fixed little-endian layout
+ *   u32 magic, u32 version, f64 compression, f64 min, f64 max, u64 count,
+ *   then count x (f64 mean, f64 weight)
+ * --------------------------------------------------------------------------- */
+
+static void putU64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t getU64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static void putU32(uint8_t* p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t getU32(const uint8_t* p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static void putF64(uint8_t* p, double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    putU64(p, bits);
+}
+
+static double getF64(const uint8_t* p)
+{
+    uint64_t bits = getU64(p);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+size_t dfSketchSerialize(DfQuantileSketch* sk, uint8_t* buf, size_t cap)
+{
+    if (!sk || !sk->centroids) return 0;
+    sketchCompress(sk);
+    size_t need = SKETCH_HEADER + sk->count * 16;
+    if (!buf || cap < need) return need;
+
+    putU32(buf, SKETCH_MAGIC);
+    putU32(buf + 4, SKETCH_VERSION);
+    putF64(buf + 8, sk->compression);
+    putF64(buf + 16, sk->min);
+    putF64(buf + 24, sk->max);
+    putU64(buf + 32, (uint64_t)sk->count);
+    uint8_t* p = buf + SKETCH_HEADER;
+    for (size_t i = 0; i < sk->count; i++, p += 16) {
+        putF64(p, sk->centroids[i].mean);
+        putF64(p + 8, sk->centroids[i].weight);
+    }
+    return need;
+}
+
+bool dfSketchDeserialize(DfQuantileSketch* sk, const uint8_t* buf, size_t len)
+{
+    if (!sk) return false;
+    memset(sk, 0, sizeof(*sk));
+    if (!buf || len < SKETCH_HEADER) return false;
+    if (getU32(buf) != SKETCH_MAGIC || getU32(buf + 4) != SKETCH_VERSION) return false;
+
+    double compression = getF64(buf + 8);
+    uint64_t count = getU64(buf + 32);
+    if (!(compression >= 1.0 && compression <= 1e6)) return false;
+    if (count > (uint64_t)ceil(compression) + 8 || len < SKETCH_HEADER + count * 16) return false;
+
+    if (!sketchAllocate(sk, compression)) return false;
+    sk->min = getF64(buf + 16);
+    sk->max = getF64(buf + 24);
+    const uint8_t* p = buf + SKETCH_HEADER;
+    for (size_t i = 0; i < (size_t)count; i++, p += 16) {
+        sk->centroids[i].mean = getF64(p);
+        sk->centroids[i].weight = getF64(p + 8);
+        sk->totalWeight += sk->centroids[i].weight;
+    }
+    sk->count = (size_t)count;
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * HyperLogLog: hashing
+ * --------------------------------------------------------------------------- */
+
+// splitmix64 finalizer: a bijection with full avalanche
+static uint64_t hllMix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t hllHashBytes(const char* str, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)str;
+    uint64_t h = hllMix((uint64_t)len);
+    for (; len >= 8; len -= 8, p += 8) h = hllMix(h ^ getU64(p));
+    if (len) {
+        uint64_t tail = 0;
+        for (size_t i = 0; i < len; i++) tail |= (uint64_t)p[i] << (8 * i);
+        h = hllMix(h ^ tail);
+    }
+    return h;
+}
+
+// false for NaN; integral doubles hash like the integer they hold
+static bool hllHashDouble(double v, uint64_t* out)
+{
+    if (isnan(v)) return false;
+    if (v == floor(v) && v >= -9223372036854775808.0 && v < 18446744073709551616.0) {
+        *out = hllMix(v < 9223372036854775808.0 ? (uint64_t)(int64_t)v : (uint64_t)v);
+        return true;
+    }
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    *out = hllMix(bits);
+    return true;
+}
+
+static void hllAddHash(DfHyperLogLog* h, uint64_t hash)
+{
+    int p = h->precision;
+    size_t index = (size_t)(hash >> (64 - p));
+    uint64_t rest = hash << p;
+    uint8_t rank = rest ? (uint8_t)(__builtin_clzll(rest) + 1) : (uint8_t)(65 - p);
+    if (rank > h->registers[index]) h->registers[index] = rank;
+}
+
+/* ---------------------------------------------------------------------------
+ * HyperLogLog: lifecycle and updates
+ * --------------------------------------------------------------------------- */
+
+bool dfHllInit(DfHyperLogLog* h, int precision)
+{
+    if (!h) return false;
+    if (precision == 0) precision = DF_HLL_DEFAULT_PRECISION;
+    if (precision < DF_HLL_MIN_PRECISION) precision = DF_HLL_MIN_PRECISION;
+    if (precision > DF_HLL_MAX_PRECISION) precision = DF_HLL_MAX_PRECISION;
+    h->precision = precision;
+    h->registers = (uint8_t*)calloc((size_t)1 << precision, 1);
+    return h->registers != NULL;
+}
+
+void dfHllFree(DfHyperLogLog* h)
+{
+    if (!h) return;
+    free(h->registers);
+    h->registers = NULL;
+    h->precision = 0;
+}
+
+void dfHllAddInt64(DfHyperLogLog* h, int64_t v)
+{
+    if (h && h->registers) hllAddHash(h, hllMix((uint64_t)v));
+}
+
+void dfHllAddDouble(DfHyperLogLog* h, double v)
+{
+    uint64_t hash;
+    if (h && h->registers && hllHashDouble(v, &hash)) hllAddHash(h, hash);
+}
+
+void dfHllAddString(DfHyperLogLog* h, const char* str, size_t len)
+{
+    if (h && h->registers && str) hllAddHash(h, hllHashBytes(str, len));
+}
+
+/*
+ * Run STMT for every non-null row `r` in [0, n) of the contiguous chunk
+ * `c`, skipping all-null validity words whole.
+ */
+#define HLL_FOR_EACH_VALID_ROW(c, n, r, STMT)                                \
+    do {                                                                     \
+        bool hasNulls_ = seriesNullCount(c) > 0;                             \
+        for (size_t base_ = 0; base_ < (n); base_ += 64) {                   \
+            size_t end_ = (base_ + 64 < (n)) ? base_ + 64 : (n);             \
+            uint64_t word_ = hasNulls_ ? seriesValidityWord(c, base_ >> 6)   \
+                                       : ~0ULL;                              \
+            if (word_ == 0) continue;                                        \
+            for (size_t r = base_; r < end_; r++) {                          \
+                if ((word_ >> (r - base_)) & 1ULL) { STMT; }                 \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+#define HLL_ADD_INTEGERS(h, c, n, CType, data)                               \
+    do {                                                                     \
+        const CType* v_ = (data);                                            \
+        HLL_FOR_EACH_VALID_ROW(c, n, r_, hllAddHash(h, hllMix((uint64_t)(int64_t)v_[r_]))); \
+    } while (0)
+
+/* Label hashes of one category dictionary, computed on first use. */
+typedef struct {
+    const SeriesDictionary* dict;
+    size_t    count;
+    uint64_t* hashes;
+    uint64_t* known;    // bit per code: hashes[code] is filled
+} HllLabelCache;
+
+static bool hllLabelCacheReset(HllLabelCache* cache, const Series* c)
+{
+    free(cache->hashes);
+    cache->dict = c->dict;
+    cache->count = seriesCategoryCount(c);
+    size_t words = SERIES_VALIDITY_WORDS(cache->count);
+    cache->hashes = (uint64_t*)calloc(cache->count + words + 1, sizeof(uint64_t));
+    cache->known = cache->hashes ? cache->hashes + cache->count : NULL;
+    return cache->hashes != NULL;
+}
+
+static bool hllAddChunk(DfHyperLogLog* h, const Series* c, HllLabelCache* cache)
+{
+    size_t n = seriesSize(c);
+    switch (c->type) {
+        case DF_INT:      HLL_ADD_INTEGERS(h, c, n, int,       seriesIntData(c));      break;
+        case DF_DATETIME: HLL_ADD_INTEGERS(h, c, n, long long, seriesDateTimeData(c)); break;
+        case DF_INT8:     HLL_ADD_INTEGERS(h, c, n, int8_t,    seriesInt8Data(c));     break;
+        case DF_INT16:    HLL_ADD_INTEGERS(h, c, n, int16_t,   seriesInt16Data(c));    break;
+        case DF_INT64:    HLL_ADD_INTEGERS(h, c, n, int64_t,   seriesInt64Data(c));    break;
+        case DF_UINT8:    HLL_ADD_INTEGERS(h, c, n, uint8_t,   seriesUInt8Data(c));    break;
+        case DF_UINT16:   HLL_ADD_INTEGERS(h, c, n, uint16_t,  seriesUInt16Data(c));   break;
+        case DF_UINT32:   HLL_ADD_INTEGERS(h, c, n, uint32_t,  seriesUInt32Data(c));   break;
+        case DF_UINT64: {
+            const uint64_t* v = seriesUInt64Data(c);
+            HLL_FOR_EACH_VALID_ROW(c, n, r, hllAddHash(h, hllMix(v[r])));
+        } break;
+        case DF_DOUBLE: {
+            const double* v = seriesDoubleData(c);
+            uint64_t hash;
+            HLL_FOR_EACH_VALID_ROW(c, n, r, if (hllHashDouble(v[r], &hash)) hllAddHash(h, hash));
+        } break;
+        case DF_FLOAT: {
+            const float* v = seriesFloatData(c);
+            uint64_t hash;
+            HLL_FOR_EACH_VALID_ROW(c, n, r, if (hllHashDouble((double)v[r], &hash)) hllAddHash(h, hash));
+        } break;
+        case DF_STRING: {
+            const char* str;
+            size_t len;
+            HLL_FOR_EACH_VALID_ROW(c, n, r,
+                if (seriesGetStringView(c, r, &str, &len)) hllAddHash(h, hllHashBytes(str, len)));
+        } break;
+        case DF_CATEGORY: {
+            // hash each label once, not once per row
+            if ((cache->dict != c->dict || cache->count != seriesCategoryCount(c)) &&
+                !hllLabelCacheReset(cache, c)) {
+                return false;
+            }
+            uint32_t code;
+            const char* str;
+            size_t len;
+            HLL_FOR_EACH_VALID_ROW(c, n, r,
+                if (seriesGetCode(c, r, &code) && code < cache->count) {
+                    uint64_t bit = 1ULL << (code & 63);
+                    if (!(cache->known[code >> 6] & bit)) {
+                        if (!seriesCategoryLabel(c, code, &str, &len)) continue;
+                        cache->hashes[code] = hllHashBytes(str, len);
+                        cache->known[code >> 6] |= bit;
+                    }
+                    hllAddHash(h, cache->hashes[code]);
+                });
+        } break;
+        default:
+            break;
+    }
+    return true;
+}
+
+#undef HLL_ADD_INTEGERS
+
+bool dfHllAddSeries(DfHyperLogLog* h, const Series* s, size_t fromRow)
+{
+    if (!h || !h->registers || !s) return false;
+    size_t length = seriesSize(s);
+    if (fromRow >= length) return true;
+
+    Series view;
+    seriesSlice(s, fromRow, length - fromRow, &view);
+    HllLabelCache cache = { NULL, 0, NULL, NULL };
+    bool ok = true;
+    for (size_t k = 0; ok && k < seriesChunkCount(&view); k++) {
+        ok = hllAddChunk(h, seriesChunk(&view, k), &cache);
+    }
+    free(cache.hashes);
+    seriesFree(&view);
+    return ok;
+}
+
+bool dfHllMerge(DfHyperLogLog* dst, const DfHyperLogLog* src)
+{
+    if (!dst || !src || !dst->registers || !src->registers) return false;
+    if (src->precision < dst->precision) return false;
+
+    // the index bits src has beyond dst's lead the rest of the hash
+    int extra = src->precision - dst->precision;
+    size_t m = (size_t)1 << src->precision;
+    uint64_t lowMask = ((uint64_t)1 << extra) - 1;
+    for (size_t j = 0; j < m; j++) {
+        uint8_t rank = src->registers[j];
+        if (rank == 0) continue;
+        uint64_t low = (uint64_t)j & lowMask;
+        if (low) rank = (uint8_t)(extra - (63 - __builtin_clzll(low)));
+        else     rank = (uint8_t)(rank + extra);
+        size_t index = j >> extra;
+        if (rank > dst->registers[index]) dst->registers[index] = rank;
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * HyperLogLog: estimate (Ertl, "New cardinality estimation algorithms for
+ * HyperLogLog sketches", 2017)
+ * --------------------------------------------------------------------------- */
+
+static double hllSigma(double x)
+{
+    if (x == 1.0) return INFINITY;
+    double y = 1.0, z = x, prev;
+    do {
+        x *= x;
+        prev = z;
+        z += x * y;
+        y += y;
+    } while (z != prev);
+    return z;
+}
+
+static double hllTau(double x)
+{
+    if (x == 0.0 || x == 1.0) return 0.0;
+    double y = 1.0, z = 1.0 - x, prev;
+    do {
+        x = sqrt(x);
+        prev = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != prev);
+    return z / 3.0;
+}
+
+double dfHllEstimate(const DfHyperLogLog* h)
+{
+    if (!h || !h->registers) return 0.0;
+    int q = 64 - h->precision;
+    size_t m = (size_t)1 << h->precision;
+    size_t hist[66] = { 0 };
+    for (size_t i = 0; i < m; i++) hist[h->registers[i]]++;
+
+    double md = (double)m;
+    double z = md * hllTau(1.0 - (double)hist[q + 1] / md);
+    for (int k = q; k >= 1; k--) z = 0.5 * (z + (double)hist[k]);
+    z += md * hllSigma((double)hist[0] / md);
+    // alpha_inf = 1 / (2 ln 2)
+    return md * md / (2.0 * log(2.0) * z);
+}
+
+/* ---------------------------------------------------------------------------
+ * HyperLogLog: serialization
+ *   u32 magic, u32 version, u8 precision, then 2^precision register bytes
+ * --------------------------------------------------------------------------- */
+
+size_t dfHllSerialize(const DfHyperLogLog* h, uint8_t* buf, size_t cap)
+{
+    if (!h || !h->registers) return 0;
+    size_t m = (size_t)1 << h->precision;
+    size_t need = HLL_HEADER + m;
+    if (!buf || cap < need) return need;
+
+    putU32(buf, HLL_MAGIC);
+    putU32(buf + 4, HLL_VERSION);
+    buf[8] = (uint8_t)h->precision;
+    memcpy(buf + HLL_HEADER, h->registers, m);
+    return need;
+}
+
+bool dfHllDeserialize(DfHyperLogLog* h, const uint8_t* buf, size_t len)
+{
+    if (!h) return false;
+    h->precision = 0;
+    h->registers = NULL;
+    if (!buf || len < HLL_HEADER) return false;
+    if (getU32(buf) != HLL_MAGIC || getU32(buf + 4) != HLL_VERSION) return false;
+
+    int precision = buf[8];
+    if (precision < DF_HLL_MIN_PRECISION || precision > DF_HLL_MAX_PRECISION) return false;
+    size_t m = (size_t)1 << precision;
+    if (len < HLL_HEADER + m) return false;
+    for (size_t i = 0; i < m; i++) {
+        if (buf[HLL_HEADER + i] > 65 - precision) return false;
+    }
+
+    if (!dfHllInit(h, precision)) return false;
+    memcpy(h->registers, buf + HLL_HEADER, m);
+    return true;
+}
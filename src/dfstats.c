@@ -0,0 +1,465 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <stddef.h>
+
+#include "dfstats.h"
+#include "series.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#define DF_STATS_THREADS 1
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Multi-rank selection
+ * --------------------------------------------------------------------------- */
+
+static void swapDoubles(double* a, size_t i, size_t j)
+{
+    double t = a[i];
+    a[i] = a[j];
+    a[j] = t;
+}
+
+static void insertionSort(double* a, size_t lo, size_t hi)
+{
+    for (size_t i = lo + 1; i <= hi; i++) {
+        double x = a[i];
+        size_t j = i;
+        while (j > lo && a[j - 1] > x) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = x;
+    }
+}
+
+/* Heapsort a[lo..hi]: the worst-case fallback once a selection stops shrinking. */
+static void siftDown(double* a, size_t lo, size_t root, size_t count)
+{
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= count) return;
+        if (child + 1 < count && a[lo + child] < a[lo + child + 1]) child++;
+        if (!(a[lo + root] < a[lo + child])) return;
+        swapDoubles(a, lo + root, lo + child);
+        root = child;
+    }
+}
+
+static void heapSortRange(double* a, size_t lo, size_t hi)
+{
+    size_t count = hi - lo + 1;
+    for (size_t i = count / 2; i-- > 0;) siftDown(a, lo, i, count);
+    for (size_t end = count - 1; end > 0; end--) {
+        swapDoubles(a, lo, lo + end);
+        siftDown(a, lo, 0, end);
+    }
+}
+
+/* Partition budget before falling back to heapsort (introselect). */
+static size_t depthBudget(size_t n)
+{
+    size_t depth = 0;
+    while (n > 1) {
+        n >>= 1;
+        depth++;
+    }
+    return 2 * depth + 4;
+}
+
+/*
+ * Floyd-Rivest selection: put the k-th smallest of a[left..right] at a[k],
+ * with smaller values before it and larger after. On big ranges it first
+ * selects inside a small sample around k, so the pivot lands next to the
+ * target and each pass discards almost everything (about n + min(k, n-k)
+ * comparisons on average).
+ */
+static void floydRivest(double* a, ptrdiff_t left, ptrdiff_t right, ptrdiff_t k, size_t budget)
+{
+    while (right > left) {
+        if (budget-- == 0) {
+            heapSortRange(a, (size_t)left, (size_t)right);
+            return;
+        }
+        if (right - left > 600) {
+            double n = (double)(right - left + 1);
+            double i = (double)(k - left + 1);
+            double z = log(n);
+            double s = 0.5 * exp(2.0 * z / 3.0);
+            double sd = 0.5 * sqrt(z * s * (n - s) / n) * (i - n / 2.0 < 0 ? -1.0 : 1.0);
+            ptrdiff_t newLeft = (ptrdiff_t)((double)k - i * s / n + sd);
+            ptrdiff_t newRight = (ptrdiff_t)((double)k + (n - i) * s / n + sd);
+            floydRivest(a, newLeft > left ? newLeft : left, newRight < right ? newRight : right, k, budget);
+        }
+
+        // partition a[left..right] around t = a[k]; a[left] and a[right] act as sentinels
+        double t = a[k];
+        ptrdiff_t i = left, j = right;
+        swapDoubles(a, (size_t)left, (size_t)k);
+        if (a[right] > t) swapDoubles(a, (size_t)right, (size_t)left);
+        while (i < j) {
+            swapDoubles(a, (size_t)i, (size_t)j);
+            i++;
+            j--;
+            while (a[i] < t) i++;
+            while (a[j] > t) j--;
+        }
+        if (a[left] == t) {
+            swapDoubles(a, (size_t)left, (size_t)j);
+        } else {
+            j++;
+            swapDoubles(a, (size_t)j, (size_t)right);
+        }
+        if (j <= k) left = j + 1;
+        if (k <= j) right = j - 1;
+    }
+}
+
+/*
+ * Place a[k] = the k-th smallest for every k in ranks[0..nr) (ascending),
+ * for a[lo..hi] inclusive. While several ranks share a range it partitions
+ * once and follows every side that still holds one, so they cost about one
+ * selection, not one each; a lone rank finishes with Floyd-Rivest. Ranges
+ * that stop shrinking within the budget are heapsorted (introselect).
+ */
+static void selectRanks(double* a, size_t lo, size_t hi, const size_t* ranks, size_t nr, size_t budget)
+{
+    while (nr > 1 && hi - lo > 16) {
+        if (budget-- == 0) {
+            heapSortRange(a, lo, hi);
+            return;
+        }
+        // median of three, ordered in place so a[lo] <= pivot <= a[hi]
+        size_t mid = lo + (hi - lo) / 2;
+        if (a[mid] < a[lo]) swapDoubles(a, mid, lo);
+        if (a[hi] < a[lo])  swapDoubles(a, hi, lo);
+        if (a[hi] < a[mid]) swapDoubles(a, hi, mid);
+        double pivot = a[mid];
+
+        // Hoare partition: a[lo..j] <= pivot <= a[j+1..hi], lo <= j < hi
+        size_t i = lo - 1, j = hi + 1;
+        for (;;) {
+            do { i++; } while (a[i] < pivot);
+            do { j--; } while (a[j] > pivot);
+            if (i >= j) break;
+            swapDoubles(a, i, j);
+        }
+
+        size_t split = 0;
+        while (split < nr && ranks[split] <= j) split++;
+        if (split > 0) selectRanks(a, lo, j, ranks, split, budget);
+        ranks += split;
+        nr -= split;
+        lo = j + 1;
+    }
+    if (nr == 1) {
+        floydRivest(a, (ptrdiff_t)lo, (ptrdiff_t)hi, (ptrdiff_t)ranks[0], budget);
+    } else if (nr > 1) {
+        insertionSort(a, lo, hi);
+    }
+}
+
+void dfSelectRanksInPlace(double* values, size_t n, const size_t* ranks, size_t nRanks)
+{
+    if (!values || n == 0 || !ranks || nRanks == 0) return;
+    selectRanks(values, 0, n - 1, ranks, nRanks, depthBudget(n));
+}
+
+double dfSelectInPlace(double* values, size_t n, size_t k)
+{
+    if (!values || k >= n) return 0.0;
+    dfSelectRanksInPlace(values, n, &k, 1);
+    return values[k];
+}
+
+static int compareSizes(const void* a, const void* b)
+{
+    size_t x = *(const size_t*)a, y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+
+bool dfQuantilesInPlace(double* values, size_t n, const double* qs, size_t nq, double* out)
+{
+    if (!values || n == 0 || (nq && (!qs || !out))) return false;
+
+    // each quantile needs the two ranks around q * (n - 1)
+    size_t* ranks = (size_t*)malloc((nq ? 2 * nq : 1) * sizeof(size_t));
+    if (!ranks) return false;
+    size_t nr = 0;
+    for (size_t k = 0; k < nq; k++) {
+        double q = qs[k] < 0.0 ? 0.0 : (qs[k] > 1.0 ? 1.0 : qs[k]);
+        double pos = q * (double)(n - 1);
+        ranks[nr++] = (size_t)floor(pos);
+        ranks[nr++] = (size_t)ceil(pos);
+    }
+    qsort(ranks, nr, sizeof(size_t), compareSizes);
+    size_t unique = 0;
+    for (size_t k = 0; k < nr; k++) {
+        if (unique == 0 || ranks[unique - 1] != ranks[k]) ranks[unique++] = ranks[k];
+    }
+    dfSelectRanksInPlace(values, n, ranks, unique);
+    free(ranks);
+
+    for (size_t k = 0; k < nq; k++) {
+        double q = qs[k] < 0.0 ? 0.0 : (qs[k] > 1.0 ? 1.0 : qs[k]);
+        double pos = q * (double)(n - 1);
+        size_t below = (size_t)floor(pos), above = (size_t)ceil(pos);
+        out[k] = values[below];
+        if (above != below) {
+            out[k] += (pos - (double)below) * (values[above] - values[below]);
+        }
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Streaming pass
+ * --------------------------------------------------------------------------- */
+
+typedef struct {
+    size_t n;
+    double min, max;
+    double mean, m2, m3, m4;    // running central moments
+    double* values;             // copy for the quantile selection
+} Moments;
+
+/* One-pass update of mean and the 2nd..4th central moment sums. */
+static inline void pushValue(Moments* m, double x)
+{
+    if (m->n == 0 || x < m->min) m->min = x;
+    if (m->n == 0 || x > m->max) m->max = x;
+    m->values[m->n] = x;
+
+    double n1 = (double)m->n;
+    double n = n1 + 1.0;
+    double delta = x - m->mean;
+    double deltaN = delta / n;
+    double deltaN2 = deltaN * deltaN;
+    double term = delta * deltaN * n1;
+    m->mean += deltaN;
+    m->m4 += term * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m->m2 - 4.0 * deltaN * m->m3;
+    m->m3 += term * deltaN * (n - 2.0) - 3.0 * deltaN * m->m2;
+    m->m2 += term;
+    m->n++;
+}
+
+/* Feed the non-null values of one contiguous chunk, read in type T. */
+#define PUSH_TYPED(T, data)                                                  \
+    do {                                                                     \
+        const T* v_ = (const T*)(data);                                      \
+        bool hasNulls_ = seriesNullCount(chunk) > 0;                         \
+        for (size_t base_ = 0; base_ < len; base_ += 64) {                   \
+            size_t end_ = (base_ + 64 < len) ? base_ + 64 : len;             \
+            uint64_t word_ = hasNulls_ ? seriesValidityWord(chunk, base_ >> 6) \
+                                       : ~0ULL;                              \
+            for (size_t r_ = base_; r_ < end_; r_++) {                       \
+                if ((word_ >> (r_ - base_)) & 1ULL) pushValue(m, (double)v_[r_]); \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+static void pushChunk(Moments* m, const Series* chunk)
+{
+    size_t len = seriesSize(chunk);
+    switch (chunk->type) {
+        case DF_INT:      PUSH_TYPED(int,       seriesIntData(chunk));      break;
+        case DF_DOUBLE:   PUSH_TYPED(double,    seriesDoubleData(chunk));   break;
+        case DF_DATETIME: PUSH_TYPED(long long, seriesDateTimeData(chunk)); break;
+        case DF_INT8:     PUSH_TYPED(int8_t,    seriesInt8Data(chunk));     break;
+        case DF_INT16:    PUSH_TYPED(int16_t,   seriesInt16Data(chunk));    break;
+        case DF_INT64:    PUSH_TYPED(int64_t,   seriesInt64Data(chunk));    break;
+        case DF_UINT8:    PUSH_TYPED(uint8_t,   seriesUInt8Data(chunk));    break;
+        case DF_UINT16:   PUSH_TYPED(uint16_t,  seriesUInt16Data(chunk));   break;
+        case DF_UINT32:   PUSH_TYPED(uint32_t,  seriesUInt32Data(chunk));   break;
+        case DF_UINT64:   PUSH_TYPED(uint64_t,  seriesUInt64Data(chunk));   break;
+        case DF_FLOAT:    PUSH_TYPED(float,     seriesFloatData(chunk));    break;
+        default:
+            break;
+    }
+}
+
+#define COPY_TYPED(T, data)                                                  \
+    do {                                                                     \
+        const T* v_ = (const T*)(data);                                      \
+        bool hasNulls_ = seriesNullCount(chunk) > 0;                         \
+        for (size_t base_ = 0; base_ < len; base_ += 64) {                   \
+            size_t end_ = (base_ + 64 < len) ? base_ + 64 : len;             \
+            uint64_t word_ = hasNulls_ ? seriesValidityWord(chunk, base_ >> 6) \
+                                       : ~0ULL;                              \
+            for (size_t r_ = base_; r_ < end_; r_++) {                       \
+                if ((word_ >> (r_ - base_)) & 1ULL) out[n++] = (double)v_[r_]; \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+/* Append the non-null values of one contiguous chunk to out; returns how many. */
+static size_t copyChunk(const Series* chunk, double* out)
+{
+    size_t len = seriesSize(chunk), n = 0;
+    switch (chunk->type) {
+        case DF_INT:      COPY_TYPED(int,       seriesIntData(chunk));      break;
+        case DF_DOUBLE:   COPY_TYPED(double,    seriesDoubleData(chunk));   break;
+        case DF_DATETIME: COPY_TYPED(long long, seriesDateTimeData(chunk)); break;
+        case DF_INT8:     COPY_TYPED(int8_t,    seriesInt8Data(chunk));     break;
+        case DF_INT16:    COPY_TYPED(int16_t,   seriesInt16Data(chunk));    break;
+        case DF_INT64:    COPY_TYPED(int64_t,   seriesInt64Data(chunk));    break;
+        case DF_UINT8:    COPY_TYPED(uint8_t,   seriesUInt8Data(chunk));    break;
+        case DF_UINT16:   COPY_TYPED(uint16_t,  seriesUInt16Data(chunk));   break;
+        case DF_UINT32:   COPY_TYPED(uint32_t,  seriesUInt32Data(chunk));   break;
+        case DF_UINT64:   COPY_TYPED(uint64_t,  seriesUInt64Data(chunk));   break;
+        case DF_FLOAT:    COPY_TYPED(float,     seriesFloatData(chunk));    break;
+        default:
+            break;
+    }
+    return n;
+}
+
+double* dfSeriesValues(const Series* s, size_t* outCount)
+{
+    if (outCount) *outCount = 0;
+    if (!s || !outCount || s->type == DF_STRING || s->type == DF_CATEGORY) return NULL;
+    size_t count = seriesSize(s) - seriesNullCount(s);
+    if (count == 0) return NULL;
+
+    double* values = (double*)malloc(count * sizeof(double));
+    if (!values) return NULL;
+    size_t n = 0;
+    for (size_t k = 0; k < seriesChunkCount(s); k++) {
+        n += copyChunk(seriesChunk(s, k), values + n);
+    }
+    *outCount = n;
+    return values;
+}
+
+bool dfSummarizeSeries(const Series* s, DfColumnStats* out)
+{
+    if (!s || !out) return false;
+    memset(out, 0, sizeof(*out));
+    out->nulls = seriesNullCount(s);
+    out->count = seriesSize(s) - out->nulls;
+    out->numeric = s->type != DF_STRING && s->type != DF_CATEGORY;
+    if (!out->numeric || out->count == 0) return true;
+
+    // values are copied as they stream past, for the quantile pass
+    Moments m;
+    memset(&m, 0, sizeof(m));
+    m.values = (double*)malloc(out->count * sizeof(double));
+    if (!m.values) return false;
+    for (size_t k = 0; k < seriesChunkCount(s); k++) {
+        pushChunk(&m, seriesChunk(s, k));
+    }
+
+    double n = (double)m.n;
+    out->min = m.min;
+    out->max = m.max;
+    out->mean = m.mean;
+    if (m.n >= 2) {
+        double var = m.m2 / (n - 1.0);
+        out->std = sqrt(var);
+        if (var > 0.0 && m.n >= 3) {
+            // skewness(): n / ((n-1)(n-2)) * sum((x-mean)^3) / s^3
+            out->skew = n / ((n - 1.0) * (n - 2.0)) * m.m3 / (var * out->std);
+        }
+        if (var > 0.0 && m.n >= 4) {
+            // kurtosis(): c1 * sum(((x-mean)/s)^4) - c2
+            double c1 = (n * (n + 1.0)) / ((n - 1.0) * (n - 2.0) * (n - 3.0));
+            double c2 = 3.0 * (n - 1.0) * (n - 1.0) / ((n - 2.0) * (n - 3.0));
+            out->kurtosis = c1 * (m.m4 / (var * var)) - c2;
+        }
+    }
+
+    static const double quartiles[3] = { 0.25, 0.5, 0.75 };
+    double q[3];
+    dfQuantilesInPlace(m.values, m.n, quartiles, 3, q);
+    out->q25 = q[0];
+    out->q50 = q[1];
+    out->q75 = q[2];
+
+    free(m.values);
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Parallel driver
+ * --------------------------------------------------------------------------- */
+
+// below this many cells a thread costs more than it saves
+#define STATS_PARALLEL_MIN_CELLS ((size_t)1 << 16)
+#define STATS_MAX_THREADS 16
+
+typedef struct {
+    const Series* const* cols;
+    DfColumnStats* out;
+    size_t nCols;
+    size_t first;
+    size_t step;
+    bool ok;
+} StatsJob;
+
+static void* statsWorker(void* arg)
+{
+    StatsJob* job = (StatsJob*)arg;
+    for (size_t c = job->first; c < job->nCols; c += job->step) {
+        if (!dfSummarizeSeries(job->cols[c], &job->out[c])) job->ok = false;
+    }
+    return NULL;
+}
+
+static size_t statsThreadCount(size_t nCols, size_t nRows)
+{
+#ifdef DF_STATS_THREADS
+    if (nCols < 2 || nCols * nRows < STATS_PARALLEL_MIN_CELLS) return 1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t n = cpus > 1 ? (size_t)cpus : 1;
+    if (n > STATS_MAX_THREADS) n = STATS_MAX_THREADS;
+    return n < nCols ? n : nCols;
+#else
+    (void)nCols;
+    (void)nRows;
+    return 1;
+#endif
+}
+
+bool dfSummarizeColumns(const DataFrame* df, DfColumnStats* out)
+{
+    if (!df || !out) return false;
+    size_t nCols = df->ops->numColumns(df);
+    if (nCols == 0) return true;
+
+    // look the columns up here: the workers only read Series
+    const Series** cols = (const Series**)malloc(nCols * sizeof(const Series*));
+    if (!cols) return false;
+    for (size_t c = 0; c < nCols; c++) {
+        cols[c] = df->ops->getSeries(df, c);
+    }
+
+    size_t nThreads = statsThreadCount(nCols, df->ops->numRows(df));
+    StatsJob jobs[STATS_MAX_THREADS];
+    for (size_t t = 0; t < nThreads; t++) {
+        jobs[t] = (StatsJob){ cols, out, nCols, t, nThreads, true };
+    }
+
+#ifdef DF_STATS_THREADS
+    pthread_t threads[STATS_MAX_THREADS];
+    bool started[STATS_MAX_THREADS] = { false };
+    for (size_t t = 1; t < nThreads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, statsWorker, &jobs[t]) == 0;
+    }
+    statsWorker(&jobs[0]);
+    for (size_t t = 1; t < nThreads; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+        else statsWorker(&jobs[t]);     // could not start: do its share here
+    }
+#else
+    statsWorker(&jobs[0]);
+#endif
+
+    bool ok = true;
+    for (size_t t = 0; t < nThreads; t++) ok = ok && jobs[t].ok;
+    free(cols);
+    return ok;
+}
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 /* -------------------------------------------------------------------------
  * Existing: at, iat, loc, iloc
  * ------------------------------------------------------------------------- */
@@ -13,65 +14,28 @@
  */
 DataFrame dfAt_impl(const DataFrame* df, size_t rowIndex, const char* colName)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !colName) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t foundCol = (size_t)-1;
-    for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
-        if (s && strcmp(s->name, colName) == 0) {
-            foundCol = c;
-            break;
-        }
-    }
+    size_t foundCol = df->ops->columnIndex(df, colName);
     if (foundCol == (size_t)-1) {
         return result; // not found
     }
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (rowIndex >= nRows) {
         return result; // out-of-range
     }
-    const Series* origCol = df->getSeries(df, foundCol);
+    const Series* origCol = df->ops->getSeries(df, foundCol);
     if (!origCol) return result;
 
     Series newSeries;
     seriesInit(&newSeries, origCol->name, origCol->type);
 
-    switch (origCol->type) {
-        case DF_INT: {
-            int val;
-            if (seriesGetInt(origCol, rowIndex, &val)) {
-                seriesAddInt(&newSeries, val);
-            }
-        } break;
-        case DF_DOUBLE: {
-            double dval;
-            if (seriesGetDouble(origCol, rowIndex, &dval)) {
-                seriesAddDouble(&newSeries, dval);
-            }
-        } break;
-        case DF_STRING: {
-            char* str = NULL;
-            if (seriesGetString(origCol, rowIndex, &str)) {
-                seriesAddString(&newSeries, str);
-                free(str);
-            }
-        } break;
-        /* --------------------------------------------------------
-         *  DF_DATETIME
-         * -------------------------------------------------------- */
-        case DF_DATETIME: {
-            long long dtVal;
-            if (seriesGetDateTime(origCol, rowIndex, &dtVal)) {
-                seriesAddDateTime(&newSeries, dtVal);
-            }
-        } break;
-    }
+    seriesAppendFrom(&newSeries, origCol, rowIndex);
 
-    result.addSeries(&result, &newSeries);
-    seriesFree(&newSeries);
+    result.ops->addSeriesMove(&result, &newSeries);
 
     return result;
 }
@@ -81,54 +45,25 @@ DataFrame dfAt_impl(const DataFrame* df, size_t rowIndex, const char* colName)
  */
 DataFrame dfIat_impl(const DataFrame* df, size_t rowIndex, size_t colIndex)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
     if (colIndex >= nCols || rowIndex >= nRows) {
         return result;
     }
-    const Series* origCol = df->getSeries(df, colIndex);
+    const Series* origCol = df->ops->getSeries(df, colIndex);
     if (!origCol) return result;
 
     Series newSeries;
     seriesInit(&newSeries, origCol->name, origCol->type);
 
-    switch (origCol->type) {
-        case DF_INT: {
-            int val;
-            if (seriesGetInt(origCol, rowIndex, &val)) {
-                seriesAddInt(&newSeries, val);
-            }
-        } break;
-        case DF_DOUBLE: {
-            double dval;
-            if (seriesGetDouble(origCol, rowIndex, &dval)) {
-                seriesAddDouble(&newSeries, dval);
-            }
-        } break;
-        case DF_STRING: {
-            char* str = NULL;
-            if (seriesGetString(origCol, rowIndex, &str)) {
-                seriesAddString(&newSeries, str);
-                free(str);
-            }
-        } break;
-        /* --------------------------------------------------------
-         *  DF_DATETIME
-         * -------------------------------------------------------- */
-        case DF_DATETIME: {
-            long long dtVal;
-            if (seriesGetDateTime(origCol, rowIndex, &dtVal)) {
-                seriesAddDateTime(&newSeries, dtVal);
-            }
-        } break;
-    }
+    seriesAppendFrom(&newSeries, origCol, rowIndex);
 
-    result.addSeries(&result, &newSeries);
-    seriesFree(&newSeries);
+    result.ops->addSeriesMove(&result, &newSeries);
     return result;
 }
 
@@ -141,74 +76,44 @@ DataFrame dfLoc_impl(const DataFrame* df,
                      const char* const* colNames,
                      size_t colCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+
+    // out-of-range rows are skipped: compact the index once, not per column
+    const size_t* rows = rowIndices;
+    size_t* kept = NULL;
+    size_t keptCount = rowCount;
+    for (size_t r = 0; r < rowCount; r++) {
+        if (rowIndices[r] < nRows) continue;
+        kept = (size_t*)malloc((rowCount ? rowCount : 1) * sizeof(size_t));
+        if (!kept) return result;
+        keptCount = 0;
+        for (size_t k = 0; k < rowCount; k++) {
+            if (rowIndices[k] < nRows) kept[keptCount++] = rowIndices[k];
+        }
+        rows = kept;
+        break;
+    }
 
     for (size_t cn = 0; cn < colCount; cn++) {
-        size_t foundCol = (size_t)-1;
-        for (size_t c = 0; c < nCols; c++) {
-            const Series* s = df->getSeries(df, c);
-            if (s && strcmp(s->name, colNames[cn]) == 0) {
-                foundCol = c;
-                break;
-            }
-        }
+        size_t foundCol = df->ops->columnIndex(df, colNames[cn]);
         if (foundCol == (size_t)-1) {
             // skip unknown column name
             continue;
         }
-        const Series* orig = df->getSeries(df, foundCol);
+        const Series* orig = df->ops->getSeries(df, foundCol);
         if (!orig) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, orig->name, orig->type);
-
-        for (size_t r = 0; r < rowCount; r++) {
-            size_t realRow = rowIndices[r];
-            if (realRow >= nRows) {
-                // skip
-                continue;
-            }
-            switch (orig->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(orig, realRow, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(orig, realRow, &dv)) {
-                        seriesAddDouble(&newSeries, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(orig, realRow, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* --------------------------------------------
-                 *  DF_DATETIME
-                 * -------------------------------------------- */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(orig, realRow, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        seriesGather(orig, rows, keptCount, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
+    free(kept);
     return result;
 }
 
@@ -221,12 +126,13 @@ DataFrame dfIloc_impl(const DataFrame* df,
                       const size_t* colIndices,
                       size_t colCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
     if (rowStart >= nRows) {
         return result;
     }
@@ -240,46 +146,13 @@ DataFrame dfIloc_impl(const DataFrame* df,
             // skip
             continue;
         }
-        const Series* orig = df->getSeries(df, cIndex);
+        const Series* orig = df->ops->getSeries(df, cIndex);
         if (!orig) continue;
 
+        // a row view of [rowStart, rowEnd) sharing the column's storage
         Series newSeries;
-        seriesInit(&newSeries, orig->name, orig->type);
-
-        for (size_t r = rowStart; r < rowEnd; r++) {
-            switch (orig->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(orig, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(orig, r, &dv)) {
-                        seriesAddDouble(&newSeries, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(orig, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* --------------------------------------------
-                 *  DF_DATETIME
-                 * -------------------------------------------- */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(orig, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        seriesSlice(orig, rowStart, (rowEnd > rowStart) ? rowEnd - rowStart : 0, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
     return result;
 }
@@ -293,11 +166,12 @@ DataFrame dfIloc_impl(const DataFrame* df,
  */
 DataFrame dfDrop_impl(const DataFrame* df, const char* const* colNames, size_t nameCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !colNames) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
 
     // We'll build a "toDrop" boolean array for each column
     bool* dropMask = (bool*)calloc(nCols, sizeof(bool));
@@ -306,13 +180,10 @@ DataFrame dfDrop_impl(const DataFrame* df, const char* const* colNames, size_t n
     for (size_t i = 0; i < nameCount; i++) {
         const char* dropName = colNames[i];
         if (!dropName) continue;
-        // find a column with that name
-        for (size_t c = 0; c < nCols; c++) {
-            const Series* s = df->getSeries(df, c);
-            if (!s) continue;
-            if (strcmp(s->name, dropName) == 0) {
-                dropMask[c] = true;
-            }
+        // every column with that name
+        for (size_t c = dfColumnIndexFrom(df, dropName, 0); c != (size_t)-1;
+             c = dfColumnIndexFrom(df, dropName, c + 1)) {
+            dropMask[c] = true;
         }
     }
 
@@ -321,48 +192,12 @@ DataFrame dfDrop_impl(const DataFrame* df, const char* const* colNames, size_t n
         if (dropMask[c]) {
             continue; // skip
         }
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
-        // copy entire column
         Series newS;
-        seriesInit(&newS, s->name, s->type);
-
-        size_t nRows = seriesSize(s);
-        for (size_t r = 0; r < nRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newS, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(s, r, &dv)) {
-                        seriesAddDouble(&newS, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newS, str);
-                        free(str);
-                    }
-                } break;
-                /* --------------------------------------------
-                 *  DF_DATETIME
-                 * -------------------------------------------- */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newS, dtVal);
-                    }
-                } break;
-            }
-        }
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        seriesShare(s, &newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
     free(dropMask);
@@ -374,6 +209,7 @@ DataFrame dfDrop_impl(const DataFrame* df, const char* const* colNames, size_t n
  */
 DataFrame dfPop_impl(const DataFrame* df, const char* colName, DataFrame* poppedColDF)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
@@ -383,105 +219,27 @@ DataFrame dfPop_impl(const DataFrame* df, const char* colName, DataFrame* popped
         DataFrame_Create(poppedColDF);
     }
 
-    size_t nCols = df->numColumns(df);
-    size_t foundIdx = (size_t)-1;
+    size_t nCols = df->ops->numColumns(df);
 
     // 1) Find the column
-    for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
-        if (s && strcmp(s->name, colName)==0) {
-            foundIdx = c;
-            break;
-        }
-    }
+    size_t foundIdx = df->ops->columnIndex(df, colName);
 
     // 2) Build the new DF w/o that column, also build popped DF
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         if (c == foundIdx) {
             // Move this column to poppedColDF
             if (poppedColDF) {
                 Series poppedS;
-                seriesInit(&poppedS, s->name, s->type);
-
-                size_t nRows = seriesSize(s);
-                for (size_t r = 0; r < nRows; r++) {
-                    switch (s->type) {
-                        case DF_INT: {
-                            int val;
-                            if (seriesGetInt(s, r, &val)) {
-                                seriesAddInt(&poppedS, val);
-                            }
-                        } break;
-                        case DF_DOUBLE: {
-                            double dv;
-                            if (seriesGetDouble(s, r, &dv)) {
-                                seriesAddDouble(&poppedS, dv);
-                            }
-                        } break;
-                        case DF_STRING: {
-                            char* str = NULL;
-                            if (seriesGetString(s, r, &str)) {
-                                seriesAddString(&poppedS, str);
-                                free(str);
-                            }
-                        } break;
-                        /* --------------------------------
-                         *  DF_DATETIME
-                         * -------------------------------- */
-                        case DF_DATETIME: {
-                            long long dtVal;
-                            if (seriesGetDateTime(s, r, &dtVal)) {
-                                seriesAddDateTime(&poppedS, dtVal);
-                            }
-                        } break;
-                    }
-                }
-                poppedColDF->addSeries(poppedColDF, &poppedS);
-                seriesFree(&poppedS);
+                seriesShare(s, &poppedS);
+                poppedColDF->ops->addSeriesMove(poppedColDF, &poppedS);
             }
         } else {
-            // Copy to the result
             Series newS;
-            seriesInit(&newS, s->name, s->type);
-
-            size_t nRows = seriesSize(s);
-            for (size_t r = 0; r < nRows; r++) {
-                switch (s->type) {
-                    case DF_INT: {
-                        int val;
-                        if (seriesGetInt(s, r, &val)) {
-                            seriesAddInt(&newS, val);
-                        }
-                    } break;
-                    case DF_DOUBLE: {
-                        double dv;
-                        if (seriesGetDouble(s, r, &dv)) {
-                            seriesAddDouble(&newS, dv);
-                        }
-                    } break;
-                    case DF_STRING: {
-                        char* str = NULL;
-                        if (seriesGetString(s, r, &str)) {
-                            seriesAddString(&newS, str);
-                            free(str);
-                        }
-                    } break;
-                    /* --------------------------------
-                     *  DF_DATETIME
-                     * -------------------------------- */
-                    case DF_DATETIME: {
-                        long long dtVal;
-                        if (seriesGetDateTime(s, r, &dtVal)) {
-                            seriesAddDateTime(&newS, dtVal);
-                        }
-                    } break;
-                }
-            }
-            result.addSeries(&result, &newS);
-            seriesFree(&newS);
+            seriesShare(s, &newS);
+            result.ops->addSeriesMove(&result, &newS);
         }
     }
 
@@ -493,59 +251,30 @@ DataFrame dfPop_impl(const DataFrame* df, const char* colName, DataFrame* popped
  */
 DataFrame dfInsert_impl(const DataFrame* df, size_t insertPos, const Series* newCol)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !newCol) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
 
     // If DF has existing columns, ensure row count matches
-    if (df->numColumns(df) > 0) {
+    if (df->ops->numColumns(df) > 0) {
         if (seriesSize(newCol) != nRows) {
             fprintf(stderr, "dfInsert_impl: newCol row mismatch, ignoring.\n");
             // Return copy of original DF
             for (size_t c = 0; c < nCols; c++) {
-                const Series* s = df->getSeries(df, c);
+                const Series* s = df->ops->getSeries(df, c);
                 if (!s) continue;
 
                 Series copyS;
                 seriesInit(&copyS, s->name, s->type);
                 size_t cRows = seriesSize(s);
                 for (size_t r = 0; r < cRows; r++) {
-                    switch (s->type) {
-                        case DF_INT: {
-                            int val;
-                            if (seriesGetInt(s, r, &val)) {
-                                seriesAddInt(&copyS, val);
-                            }
-                        } break;
-                        case DF_DOUBLE: {
-                            double dv;
-                            if (seriesGetDouble(s, r, &dv)) {
-                                seriesAddDouble(&copyS, dv);
-                            }
-                        } break;
-                        case DF_STRING: {
-                            char* str = NULL;
-                            if (seriesGetString(s, r, &str)) {
-                                seriesAddString(&copyS, str);
-                                free(str);
-                            }
-                        } break;
-                        /* -------------------------
-                         *  DF_DATETIME
-                         * ------------------------- */
-                        case DF_DATETIME: {
-                            long long dtVal;
-                            if (seriesGetDateTime(s, r, &dtVal)) {
-                                seriesAddDateTime(&copyS, dtVal);
-                            }
-                        } break;
-                    }
+                    seriesAppendFrom(&copyS, s, r);
                 }
-                result.addSeries(&result, &copyS);
-                seriesFree(&copyS);
+                result.ops->addSeriesMove(&result, &copyS);
             }
             return result;
         }
@@ -565,39 +294,9 @@ DataFrame dfInsert_impl(const DataFrame* df, size_t insertPos, const Series* new
 
             size_t cRows = seriesSize(newCol);
             for (size_t r = 0; r < cRows; r++) {
-                switch (newCol->type) {
-                    case DF_INT: {
-                        int val;
-                        if (seriesGetInt(newCol, r, &val)) {
-                            seriesAddInt(&newCopy, val);
-                        }
-                    } break;
-                    case DF_DOUBLE: {
-                        double dv;
-                        if (seriesGetDouble(newCol, r, &dv)) {
-                            seriesAddDouble(&newCopy, dv);
-                        }
-                    } break;
-                    case DF_STRING: {
-                        char* str = NULL;
-                        if (seriesGetString(newCol, r, &str)) {
-                            seriesAddString(&newCopy, str);
-                            free(str);
-                        }
-                    } break;
-                    /* ----------------------------
-                     *  DF_DATETIME
-                     * ---------------------------- */
-                    case DF_DATETIME: {
-                        long long dtVal;
-                        if (seriesGetDateTime(newCol, r, &dtVal)) {
-                            seriesAddDateTime(&newCopy, dtVal);
-                        }
-                    } break;
-                }
+                seriesAppendFrom(&newCopy, newCol, r);
             }
-            result.addSeries(&result, &newCopy);
-            seriesFree(&newCopy);
+            result.ops->addSeriesMove(&result, &newCopy);
         }
         else {
             // For the original columns
@@ -606,46 +305,16 @@ DataFrame dfInsert_impl(const DataFrame* df, size_t insertPos, const Series* new
                 // out of range => skip
                 continue;
             }
-            const Series* s = df->getSeries(df, origIndex);
+            const Series* s = df->ops->getSeries(df, origIndex);
             if (!s) continue;
 
             Series copyS;
             seriesInit(&copyS, s->name, s->type);
             size_t cRows = seriesSize(s);
             for (size_t r = 0; r < cRows; r++) {
-                switch (s->type) {
-                    case DF_INT: {
-                        int val;
-                        if (seriesGetInt(s, r, &val)) {
-                            seriesAddInt(&copyS, val);
-                        }
-                    } break;
-                    case DF_DOUBLE: {
-                        double dv;
-                        if (seriesGetDouble(s, r, &dv)) {
-                            seriesAddDouble(&copyS, dv);
-                        }
-                    } break;
-                    case DF_STRING: {
-                        char* str = NULL;
-                        if (seriesGetString(s, r, &str)) {
-                            seriesAddString(&copyS, str);
-                            free(str);
-                        }
-                    } break;
-                    /* ----------------------------
-                     *  DF_DATETIME
-                     * ---------------------------- */
-                    case DF_DATETIME: {
-                        long long dtVal;
-                        if (seriesGetDateTime(s, r, &dtVal)) {
-                            seriesAddDateTime(&copyS, dtVal);
-                        }
-                    } break;
-                }
+                seriesAppendFrom(&copyS, s, r);
             }
-            result.addSeries(&result, &copyS);
-            seriesFree(&copyS);
+            result.ops->addSeriesMove(&result, &copyS);
         }
     }
 
@@ -659,10 +328,11 @@ DataFrame dfInsert_impl(const DataFrame* df, size_t insertPos, const Series* new
  */
 DataFrame dfIndex_impl(const DataFrame* df)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
 
     Series idxSeries;
     seriesInit(&idxSeries, "index", DF_INT);
@@ -671,8 +341,7 @@ DataFrame dfIndex_impl(const DataFrame* df)
         seriesAddInt(&idxSeries, (int)i);
     }
 
-    result.addSeries(&result, &idxSeries);
-    seriesFree(&idxSeries);
+    result.ops->addSeriesMove(&result, &idxSeries);
 
     return result;
 }
@@ -684,16 +353,17 @@ DataFrame dfIndex_impl(const DataFrame* df)
  */
 DataFrame dfColumns_impl(const DataFrame* df)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
 
     Series colSeries;
     seriesInit(&colSeries, "columns", DF_STRING);
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) {
             seriesAddString(&colSeries, "");
             continue;
@@ -701,8 +371,7 @@ DataFrame dfColumns_impl(const DataFrame* df)
         seriesAddString(&colSeries, s->name);
     }
 
-    result.addSeries(&result, &colSeries);
-    seriesFree(&colSeries);
+    result.ops->addSeriesMove(&result, &colSeries);
 
     return result;
 }
@@ -713,46 +382,14 @@ static void copyDataFrame(const DataFrame* src, DataFrame* dst)
     // Initialize dst
     DataFrame_Create(dst);
 
-    size_t nCols = src->numColumns(src);
+    size_t nCols = src->ops->numColumns(src);
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = src->getSeries(src, c);
+        const Series* s = src->ops->getSeries(src, c);
         if (!s) continue;
-        // create a copy
+        // share the column's storage (copy-on-write)
         Series newS;
-        seriesInit(&newS, s->name, s->type);
-
-        size_t nRows = seriesSize(s);
-        for (size_t r = 0; r < nRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newS, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(s, r, &dv)) {
-                        seriesAddDouble(&newS, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* strVal=NULL;
-                    if (seriesGetString(s, r, &strVal)) {
-                        seriesAddString(&newS, strVal);
-                        free(strVal);
-                    }
-                } break;
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newS, dtVal);
-                    }
-                } break;
-            }
-        }
-        dst->addSeries(dst, &newS);
-        seriesFree(&newS);
+        seriesShare(s, &newS);
+        dst->ops->addSeriesMove(dst, &newS);
     }
 }
 
@@ -762,14 +399,15 @@ DataFrame dfSetValue_impl(const DataFrame* df,
                           size_t colIndex,
                           const void* newValue)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !newValue) {
         return result; // empty
     }
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
 
     // out-of-range checks
     if (colIndex >= nCols || rowIndex >= nRows) {
@@ -779,7 +417,7 @@ DataFrame dfSetValue_impl(const DataFrame* df,
     }
 
     // fetch the Series we want to set
-    const Series* origCol = df->getSeries(df, colIndex);
+    const Series* origCol = df->ops->getSeries(df, colIndex);
     if (!origCol) {
         // copy original
         copyDataFrame(df, &result);
@@ -801,44 +439,36 @@ DataFrame dfSetValue_impl(const DataFrame* df,
         case DF_INT: {
             // interpret newValue as (int*)
             const int* valPtr = (const int*) newValue;
-            // Overwrite rowIndex in modCol->data
-            int* cellPtr = (int*)daGetMutable(&modCol->data, rowIndex);
-            if (cellPtr && valPtr) {
-                *cellPtr = *valPtr;
+            // Overwrite rowIndex in the column's value buffer
+            if (valPtr) {
+                seriesSetInt(modCol, rowIndex, *valPtr);
             }
         } break;
         case DF_DOUBLE: {
             const double* dPtr = (const double*) newValue;
-            double* cellPtr = (double*)daGetMutable(&modCol->data, rowIndex);
-            if (cellPtr && dPtr) {
-                *cellPtr = *dPtr;
+            if (dPtr) {
+                seriesSetDouble(modCol, rowIndex, *dPtr);
             }
         } break;
-        case DF_STRING: {
-            // For DF_STRING, we stored each row as a char*. 
-            // We can free the old string (if you store it separately), then store a copy.
-            char** cellPtr = (char**)daGetMutable(&modCol->data, rowIndex);
-            if (cellPtr) {
-                // free old
-                // (depending on how your library does string storage—some do copy on add)
-                // We'll assume we can free(*cellPtr):
-                free(*cellPtr);
-                // now store a fresh copy of newValue
-                const char* newStr = (const char*) newValue;
-                if (newStr) {
-                    char* copyStr = strdup(newStr);
-                    *cellPtr = copyStr;
-                } else {
-                    *cellPtr = NULL;
-                }
+        case DF_STRING:
+        case DF_CATEGORY: {
+            // splice the new string into the column's byte arena
+            const char* newStr = (const char*) newValue;
+            if (newStr) {
+                seriesSetString(modCol, rowIndex, newStr);
             }
         } break;
         case DF_DATETIME: {
             // interpret newValue as (long long*) if using ms as epoch
             const long long* dtPtr = (const long long*) newValue;
-            long long* cellPtr = (long long*)daGetMutable(&modCol->data, rowIndex);
-            if (cellPtr && dtPtr) {
-                *cellPtr = *dtPtr;
+            if (dtPtr) {
+                seriesSetDateTime(modCol, rowIndex, *dtPtr);
+            }
+        } break;
+        default: {
+            // fixed-width types: newValue points to the column's C type
+            if (newValue) {
+                seriesSetValue(modCol, rowIndex, newValue);
             }
         } break;
     }
@@ -854,14 +484,15 @@ DataFrame dfSetRow_impl(const DataFrame* df,
                         const void** rowValues, 
                         size_t valueCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !rowValues) {
         return result;
     }
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
 
     if (rowIndex >= nRows || valueCount != nCols) {
         // mismatch => return copy
@@ -886,31 +517,20 @@ DataFrame dfSetRow_impl(const DataFrame* df,
 
         switch (modCol->type) {
             case DF_INT: {
-                int* cellPtr = (int*)daGetMutable(&modCol->data, rowIndex);
-                if (cellPtr) {
-                    *cellPtr = *(const int*)valPtr;
-                }
+                seriesSetInt(modCol, rowIndex, *(const int*)valPtr);
             } break;
             case DF_DOUBLE: {
-                double* cellPtr = (double*)daGetMutable(&modCol->data, rowIndex);
-                if (cellPtr) {
-                    *cellPtr = *(const double*)valPtr;
-                }
+                seriesSetDouble(modCol, rowIndex, *(const double*)valPtr);
             } break;
-            case DF_STRING: {
-                char** cellPtr = (char**)daGetMutable(&modCol->data, rowIndex);
-                if (cellPtr) {
-                    // free old
-                    free(*cellPtr);
-                    // store new
-                    *cellPtr = strdup((const char*)valPtr);
-                }
+            case DF_STRING:
+            case DF_CATEGORY: {
+                seriesSetString(modCol, rowIndex, (const char*)valPtr);
             } break;
             case DF_DATETIME: {
-                long long* cellPtr = (long long*)daGetMutable(&modCol->data, rowIndex);
-                if (cellPtr) {
-                    *cellPtr = *(const long long*)valPtr;
-                }
+                seriesSetDateTime(modCol, rowIndex, *(const long long*)valPtr);
+            } break;
+            default: {
+                seriesSetValue(modCol, rowIndex, valPtr);
             } break;
         }
     }
@@ -922,14 +542,14 @@ DataFrame dfSetColumn_impl(const DataFrame* df,
                            const char* colName,
                            const Series* newCol)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !colName || !newCol) {
         return result;
     }
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
 
     // must match row count
     if (seriesSize(newCol) != nRows) {
@@ -939,14 +559,7 @@ DataFrame dfSetColumn_impl(const DataFrame* df,
     }
 
     // find colName
-    size_t found = (size_t)-1;
-    for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
-        if (s && strcmp(s->name, colName)==0) {
-            found = c;
-            break;
-        }
-    }
+    size_t found = df->ops->columnIndex(df, colName);
     if (found == (size_t)-1) {
         // not found => copy
         copyDataFrame(df, &result);
@@ -966,7 +579,7 @@ DataFrame dfSetColumn_impl(const DataFrame* df,
         return result;
     }
 
-    // free the old data in modCol->data
+    // free the old data in modCol
     // but careful if DF_STRING => free each pointer
     // We'll just re-init for simplicity
     seriesFree(modCol);
@@ -975,34 +588,10 @@ DataFrame dfSetColumn_impl(const DataFrame* df,
     // copy newCol's rows into modCol
     size_t cRows = seriesSize(newCol);
     for (size_t r = 0; r < cRows; r++) {
-        switch (newCol->type) {
-            case DF_INT: {
-                int v; 
-                if (seriesGetInt(newCol, r, &v)) {
-                    seriesAddInt(modCol, v);
-                }
-            } break;
-            case DF_DOUBLE: {
-                double d;
-                if (seriesGetDouble(newCol, r, &d)) {
-                    seriesAddDouble(modCol, d);
-                }
-            } break;
-            case DF_STRING: {
-                char* st=NULL;
-                if (seriesGetString(newCol, r, &st)) {
-                    seriesAddString(modCol, st);
-                    free(st);
-                }
-            } break;
-            case DF_DATETIME: {
-                long long dt;
-                if (seriesGetDateTime(newCol, r, &dt)) {
-                    seriesAddDateTime(modCol, dt);
-                }
-            } break;
-        }
+        seriesAppendFrom(modCol, newCol, r);
     }
+    // the column now carries newCol's name
+    dfRebuildNameIndex(&result);
     return result;
 }
 
@@ -1011,6 +600,7 @@ DataFrame dfRenameColumn_impl(const DataFrame* df,
                               const char* oldName,
                               const char* newName)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !oldName || !newName) {
@@ -1021,142 +611,113 @@ DataFrame dfRenameColumn_impl(const DataFrame* df,
     copyDataFrame(df, &result);
 
     // find col with oldName
-    size_t nCols = result.numColumns(&result);
-    for (size_t c = 0; c < nCols; c++) {
-        Series* s = (Series*)daGetMutable(&result.columns, c);
-        if (!s) continue;
-        if (strcmp(s->name, oldName)==0) {
-            // rename
-            free(s->name);  // old name
-            s->name = strdup(newName);
-            break; 
-        }
+    size_t c = result.ops->columnIndex(&result, oldName);
+    Series* s = (c == (size_t)-1) ? NULL : (Series*)daGetMutable(&result.columns, c);
+    if (s) {
+        // rename
+        free(s->name);  // old name
+        s->name = strdup(newName);
+        dfRebuildNameIndex(&result);
     }
     return result;
 }
 
-// helper: addNAValue => just adds "0" or "NA" depending on type
+// helper: addNAValue => a null row (counted by nullCount, dropped by dropNA)
 static void addNAValue(Series* s)
 {
-    switch (s->type) {
-        case DF_INT:      seriesAddInt(s, 0);  break;
-        case DF_DOUBLE:   seriesAddDouble(s, 0.0); break;
-        case DF_STRING:   seriesAddString(s, "NA"); break;
-        case DF_DATETIME: seriesAddDateTime(s, 0LL); break;
-    }
+    seriesAddNull(s);
 }
 
-// helper: copyCell => read row=oldIdx from 'orig' and add to 'dest'
+// helper: copyCell => read row=oldIdx from 'orig' and add to 'dest' (nulls stay null)
 static void copyCell(const Series* orig, Series* dest, size_t oldIdx)
 {
-    switch (orig->type) {
-        case DF_INT: {
-            int v;
-            if (seriesGetInt(orig, oldIdx, &v)) {
-                seriesAddInt(dest, v);
-            } else {
-                addNAValue(dest);
-            }
-        } break;
-        case DF_DOUBLE: {
-            double d;
-            if (seriesGetDouble(orig, oldIdx, &d)) {
-                seriesAddDouble(dest, d);
-            } else {
-                addNAValue(dest);
-            }
-        } break;
-        case DF_STRING: {
-            char* st=NULL;
-            if (seriesGetString(orig, oldIdx, &st)) {
-                seriesAddString(dest, st);
-                free(st);
-            } else {
-                addNAValue(dest);
-            }
-        } break;
-        case DF_DATETIME: {
-            long long dt;
-            if (seriesGetDateTime(orig, oldIdx, &dt)) {
-                seriesAddDateTime(dest, dt);
-            } else {
-                addNAValue(dest);
-            }
-        } break;
+    if (!seriesAppendFrom(dest, orig, oldIdx)) {
+        addNAValue(dest);
     }
 }
 
 
-DataFrame dfReindex_impl(const DataFrame* df,
-                         const size_t* newIndices,
-                         size_t newN)
+// helper: gatherRows => every column at rowIndices[0..count), in that order.
+// Out-of-range indices get a null row.
+static DataFrame gatherRows(const DataFrame* df, const size_t* rowIndices, size_t count)
 {
     DataFrame result;
     DataFrame_Create(&result);
-    if (!df || !newIndices || newN==0) {
-        return result; 
-    }
 
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
 
-    // We'll build each column from scratch
+    bool inRange = true;
+    for (size_t i = 0; i < count && inRange; i++) {
+        inRange = rowIndices[i] < nRows;
+    }
+
+    // We'll create each column from scratch
     for (size_t c = 0; c < nCols; c++) {
-        const Series* orig = df->getSeries(df, c);
+        const Series* orig = df->ops->getSeries(df, c);
         if (!orig) continue;
 
         Series newS;
-        seriesInit(&newS, orig->name, orig->type);
-
-        for (size_t i = 0; i < newN; i++) {
-            size_t oldIdx = newIndices[i];
-            if (oldIdx >= nRows) {
-                // out-of-range => "NA"
-                addNAValue(&newS); 
-            } else {
-                copyCell(orig, &newS, oldIdx);
+        if (inRange) {
+            seriesGather(orig, rowIndices, count, &newS);
+        } else {
+            seriesInit(&newS, orig->name, orig->type);
+            for (size_t i = 0; i < count; i++) {
+                size_t r = rowIndices[i];
+                if (r >= nRows) {
+                    // out-of-range => null
+                    addNAValue(&newS);
+                } else {
+                    copyCell(orig, &newS, r);
+                }
             }
         }
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
     return result;
 }
 
 
+DataFrame dfReindex_impl(const DataFrame* df,
+                         const size_t* newIndices,
+                         size_t newN)
+{
+    DF_OP_SCOPE();
+    if (!df || !newIndices || newN==0) {
+        DataFrame result;
+        DataFrame_Create(&result);
+        return result; 
+    }
+    return gatherRows(df, newIndices, newN);
+}
+
+
 DataFrame dfTake_impl(const DataFrame* df,
                       const size_t* rowIndices,
                       size_t count)
 {
-    DataFrame result;
-    DataFrame_Create(&result);
+    DF_OP_SCOPE();
     if (!df || !rowIndices || count==0) {
+        DataFrame result;
+        DataFrame_Create(&result);
         return result;
     }
+    return gatherRows(df, rowIndices, count);
+}
 
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
-
-    // We'll create each column from scratch
-    for (size_t c = 0; c < nCols; c++) {
-        const Series* orig = df->getSeries(df, c);
-        if (!orig) continue;
 
-        Series newS;
-        seriesInit(&newS, orig->name, orig->type);
-
-        for (size_t i = 0; i < count; i++) {
-            size_t r = rowIndices[i];
-            if (r >= nRows) {
-                addNAValue(&newS);
-            } else {
-                copyCell(orig, &newS, r);
-            }
-        }
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+/**
+ * @brief Materialize a selection: copy the rows of `sel`, in its order.
+ */
+DataFrame dfTakeSelection_impl(const DataFrame* df, const DfSelection* sel)
+{
+    DF_OP_SCOPE();
+    if (!sel) {
+        DataFrame result;
+        DataFrame_Create(&result);
+        return result;
     }
-    return result;
+    return dfTake_impl(df, sel->rows, sel->count);
 }
 
 
@@ -1164,13 +725,14 @@ DataFrame dfReorderColumns_impl(const DataFrame* df,
                                 const size_t* newOrder,
                                 size_t colCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !newOrder || colCount==0) {
         return result;
     }
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
 
     // for each newOrder[i], copy that column from df => result
     for (size_t i = 0; i < colCount; i++) {
@@ -1179,19 +741,12 @@ DataFrame dfReorderColumns_impl(const DataFrame* df,
             // skip or add blank
             continue;
         }
-        const Series* s = df->getSeries(df, oldPos);
+        const Series* s = df->ops->getSeries(df, oldPos);
         if (!s) continue;
 
-        // copy entire column
         Series copyS;
-        seriesInit(&copyS, s->name, s->type);
-
-        size_t nRows = seriesSize(s);
-        for (size_t r = 0; r < nRows; r++) {
-            copyCell(s, &copyS, r); // re-uses the helper from above
-        }
-        result.addSeries(&result, &copyS);
-        seriesFree(&copyS);
+        seriesShare(s, &copyS);
+        result.ops->addSeriesMove(&result, &copyS);
     }
     return result;
 }
@@ -4,7 +4,11 @@
 #include <ctype.h>
 #include <stdbool.h>
 #include <time.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 /* -------------------------------------------------------------------------
  *  Forward-declared static helpers
  * ------------------------------------------------------------------------- */
@@ -23,13 +27,20 @@ static long long parseDateTimeToEpoch(const char* dateStr);
  *  2) Stores the column headers in 'outHeaders'.
  *  3) Stores row cells in 'outCells' (2D).
  *  4) Returns true/false on success/fail.
+ * With a scan, only the scan's columns are kept (in file order) and rows
+ * failing a scan filter are dropped before any of their cells are copied.
+ * Column types must still come from every row, so a filtered scan infers
+ * them while reading and returns them in 'outTypes' (NULL otherwise, in
+ * which case the caller infers them from the cells).
  */
 static bool loadCsvIntoBuffer(
     const char* filename,
+    const DfCsvScan* scan,
     size_t* outNCols,
     size_t* outNRows,
     char*** outHeaders,
-    char**** outCells
+    char**** outCells,
+    ColumnType** outTypes
 );
 
 /**
@@ -42,9 +53,27 @@ static void freeCsvBuffer(
     char*** cells
 );
 
+/*
+ * Running type inference for one column, fed a cell at a time so a
+ * filtered scan can look at rows it does not keep.
+ */
+typedef struct {
+    bool allDatetime;
+    int stage;                  // 0 => int, 1 => double, 2 => string
+    bool allFloat;              // every value fits a float
+    long long minVal;           // integer range seen so far
+    unsigned long long maxVal;  // (max kept unsigned for uint64)
+    bool sawInt;
+} CsvTypeProbe;
+
+static void typeProbeInit(CsvTypeProbe* p);
+static void typeProbeAdd(CsvTypeProbe* p, const char* val);
+static ColumnType typeProbeResult(const CsvTypeProbe* p);
+
 /**
- * Decide whether a column is DF_INT, DF_DOUBLE, DF_STRING, or DF_DATETIME
- * by scanning all rows in that column.
+ * Decide whether a column is DF_DATETIME, numeric (the narrowest integer
+ * type, DF_FLOAT or DF_DOUBLE), or DF_STRING by scanning all rows in that
+ * column.
  */
 static ColumnType inferColumnType(
     size_t nRows,
@@ -53,45 +82,74 @@ static ColumnType inferColumnType(
     size_t colIndex
 );
 
-bool readCsv_impl(DataFrame* df, const char* filename)
+/*
+ * String columns with at least CSV_CATEGORY_MIN_ROWS rows whose distinct
+ * values make up at most half of the rows are loaded as DF_CATEGORY.
+ */
+#define CSV_CATEGORY_MIN_ROWS 32
+
+/* NEW: Decide whether a string column is low-cardinality enough for DF_CATEGORY. */
+static bool isLowCardinality(size_t nRows, char*** cells, size_t colIndex);
+
+/* Running DF_CATEGORY check for one column of a known total row count. */
+typedef struct {
+    Series labels;
+    bool low;
+} CsvCategoryProbe;
+
+static void categoryProbeInit(CsvCategoryProbe* p, size_t nRows);
+static void categoryProbeAdd(CsvCategoryProbe* p, const char* val, size_t nRows);
+static bool categoryProbeDone(CsvCategoryProbe* p);
+
+bool readCsvScan_impl(DataFrame* df, const char* filename, const DfCsvScan* scan)
 {
+    DF_OP_SCOPE();
     if (!df || !filename) {
-        fprintf(stderr, "readCsv_impl: invalid arguments.\n");
+        fprintf(stderr, "readCsvScan_impl: invalid arguments.\n");
         return false;
     }
 
     size_t nCols = 0, nRows = 0;
     char** headers = NULL;
     char*** cells = NULL;
+    ColumnType* finalTypes = NULL;
 
-    if (!loadCsvIntoBuffer(filename, &nCols, &nRows, &headers, &cells)) {
+    if (!loadCsvIntoBuffer(filename, scan, &nCols, &nRows, &headers, &cells, &finalTypes)) {
         return false; // already logged error
     }
 
-    // If df was used before, you might want to df->free(df) here
-    df->init(df); // ensure it's in a clean state
+    // release whatever df held (DataFrame_Create already allocated its
+    // column array) before starting it over empty
+    df->ops->free(df);
+    df->ops->init(df);
 
-    // If no data rows, create empty columns (DF_STRING by default)
+    // If no data rows, create empty columns (DF_STRING unless a filtered
+    // scan dropped every row and already knows the types)
     if (nRows == 0) {
         for (size_t c = 0; c < nCols; c++) {
             Series s;
-            seriesInit(&s, headers[c], DF_STRING);
-            df->addSeries(df, &s);
-            seriesFree(&s);
+            seriesInit(&s, headers[c], finalTypes ? finalTypes[c] : DF_STRING);
+            df->ops->addSeriesMove(df, &s);
         }
+        dfFree(finalTypes);
         freeCsvBuffer(nCols, nRows, headers, cells);
         return true;
     }
 
-    // Infer column types
-    ColumnType* finalTypes = (ColumnType*)malloc(sizeof(ColumnType) * nCols);
+    // Infer column types (a filtered scan inferred them over every row)
     if (!finalTypes) {
-        fprintf(stderr, "readCsv_impl: out of memory for finalTypes.\n");
-        freeCsvBuffer(nCols, nRows, headers, cells);
-        return false;
-    }
-    for (size_t c = 0; c < nCols; c++) {
-        finalTypes[c] = inferColumnType(nRows, cells, nCols, c);
+        finalTypes = (ColumnType*)dfMalloc(sizeof(ColumnType) * nCols);
+        if (!finalTypes) {
+            fprintf(stderr, "readCsv_impl: out of memory for finalTypes.\n");
+            freeCsvBuffer(nCols, nRows, headers, cells);
+            return false;
+        }
+        for (size_t c = 0; c < nCols; c++) {
+            finalTypes[c] = inferColumnType(nRows, cells, nCols, c);
+            if (finalTypes[c] == DF_STRING && isLowCardinality(nRows, cells, c)) {
+                finalTypes[c] = DF_CATEGORY;
+            }
+        }
     }
 
     // Build the DataFrame
@@ -109,7 +167,9 @@ bool readCsv_impl(DataFrame* df, const char* filename)
                     double d = strtod(valStr, NULL);
                     seriesAddDouble(&s, d);
                 } break;
-                case DF_STRING: {
+                case DF_STRING:
+                case DF_CATEGORY: {
+                    // a category only stores each distinct label once
                     seriesAddString(&s, valStr);
                 } break;
                 /* ------------------------------------------------------
@@ -119,17 +179,34 @@ bool readCsv_impl(DataFrame* df, const char* filename)
                     long long dtEpoch = parseDateTimeToEpoch(valStr);
                     seriesAddDateTime(&s, dtEpoch);
                 } break;
+                /* narrow / wide numeric types picked by inferColumnType */
+                case DF_INT8:   seriesAddInt8(&s, (int8_t)strtoll(valStr, NULL, 10));      break;
+                case DF_INT16:  seriesAddInt16(&s, (int16_t)strtoll(valStr, NULL, 10));    break;
+                case DF_INT64:  seriesAddInt64(&s, (int64_t)strtoll(valStr, NULL, 10));    break;
+                case DF_UINT8:  seriesAddUInt8(&s, (uint8_t)strtoull(valStr, NULL, 10));   break;
+                case DF_UINT16: seriesAddUInt16(&s, (uint16_t)strtoull(valStr, NULL, 10)); break;
+                case DF_UINT32: seriesAddUInt32(&s, (uint32_t)strtoull(valStr, NULL, 10)); break;
+                case DF_UINT64: seriesAddUInt64(&s, (uint64_t)strtoull(valStr, NULL, 10)); break;
+                case DF_FLOAT:  seriesAddFloat(&s, strtof(valStr, NULL));                  break;
             }
         }
-        df->addSeries(df, &s);
-        seriesFree(&s);
+        df->ops->addSeriesMove(df, &s);
     }
 
-    free(finalTypes);
+    dfFree(finalTypes);
     freeCsvBuffer(nCols, nRows, headers, cells);
     return true;
 }
 
+bool readCsv_impl(DataFrame* df, const char* filename)
+{
+    if (!df || !filename) {
+        fprintf(stderr, "readCsv_impl: invalid arguments.\n");
+        return false;
+    }
+    return readCsvScan_impl(df, filename, NULL);
+}
+
 /* -------------------------------------------------------------------------
  * Implementation of static helpers
  * ------------------------------------------------------------------------- */
@@ -223,12 +300,74 @@ static long long parseDateTimeToEpoch(const char* dateStr)
     return (long long)seconds;
 }
 
+/*
+ * A CSV cell against a scan filter, compared the way the loaded column
+ * would be: as a number, or as epoch seconds for a date.
+ */
+static bool csvCellMatches(const char* cell, const DfCsvFilter* f)
+{
+    double x;
+    if (checkNumericType(cell) >= 0) {
+        x = strtod(cell, NULL);
+    } else if (isLikelyDateTime(cell)) {
+        x = (double)parseDateTimeToEpoch(cell);
+    } else {
+        return false;
+    }
+    switch (f->cmp) {
+        case DF_CMP_EQ: return x == f->value;
+        case DF_CMP_NE: return x != f->value;
+        case DF_CMP_LT: return x <  f->value;
+        case DF_CMP_LE: return x <= f->value;
+        case DF_CMP_GT: return x >  f->value;
+        case DF_CMP_GE: return x >= f->value;
+    }
+    return false;
+}
+
+/* File column of a scan name, or colCount (with a message) if missing. */
+static size_t csvColumnIndex(char** headerTokens, size_t colCount, const char* name)
+{
+    for (size_t c = 0; c < colCount; c++) {
+        if (strcmp(headerTokens[c], name) == 0) return c;
+    }
+    fprintf(stderr, "readCsvScan_impl: no column named '%s'.\n", name);
+    return colCount;
+}
+
+/*
+ * Reads the next non-blank line into lineBuf and splits it into tokens,
+ * padding short rows with "" up to colCount. False at end of file.
+ */
+static bool readCsvRow(FILE* fp, char* lineBuf, int lineLen, char** tokens, size_t colCount)
+{
+    while (fgets(lineBuf, lineLen, fp)) {
+        // Strip newline
+        lineBuf[strcspn(lineBuf, "\r\n")] = '\0';
+        // Check if blank
+        char* checkp = lineBuf;
+        while (*checkp && isspace((unsigned char)*checkp)) checkp++;
+        if (*checkp == '\0') {
+            continue; // skip empty lines
+        }
+
+        size_t nTokens = splitCsvLine(lineBuf, tokens, colCount);
+        for (size_t cc = nTokens; cc < colCount; cc++) {
+            tokens[cc] = ""; // pad with ""
+        }
+        return true;
+    }
+    return false;
+}
+
 static bool loadCsvIntoBuffer(
     const char* filename,
+    const DfCsvScan* scan,
     size_t* outNCols,
     size_t* outNRows,
     char*** outHeaders,
-    char**** outCells
+    char**** outCells,
+    ColumnType** outTypes
 )
 {
     #define MAX_LINE_LEN 4096
@@ -258,73 +397,162 @@ static bool loadCsvIntoBuffer(
         return false;
     }
 
-    char** headers = (char**)calloc(colCount, sizeof(char*));
+    // Resolve the scan: which file columns to keep, which to test
+    size_t keep[MAX_COLS];
+    size_t keepCount = 0;
+    size_t filterCount = scan ? scan->filterCount : 0;
+    size_t* filterCols = (size_t*)dfMalloc((filterCount ? filterCount : 1) * sizeof(size_t));
+    if (!filterCols) {
+        fclose(fp);
+        fprintf(stderr, "out of memory for scan filters.\n");
+        return false;
+    }
+    bool scanOk = true;
+    for (size_t f = 0; f < filterCount && scanOk; f++) {
+        filterCols[f] = csvColumnIndex(headerTokens, colCount, scan->filters[f].column);
+        scanOk = filterCols[f] < colCount;
+    }
+    if (scan && scan->columns) {
+        bool wanted[MAX_COLS] = { false };
+        for (size_t i = 0; i < scan->columnCount && scanOk; i++) {
+            size_t c = csvColumnIndex(headerTokens, colCount, scan->columns[i]);
+            scanOk = c < colCount;
+            if (scanOk) wanted[c] = true;
+        }
+        for (size_t c = 0; c < colCount; c++) {
+            if (wanted[c]) keep[keepCount++] = c;
+        }
+    } else {
+        for (size_t c = 0; c < colCount; c++) keep[keepCount++] = c;
+    }
+    if (!scanOk) {
+        dfFree(filterCols);
+        fclose(fp);
+        return false;
+    }
+
+    char** headers = (char**)dfCalloc(keepCount ? keepCount : 1, sizeof(char*));
     if (!headers) {
+        dfFree(filterCols);
         fclose(fp);
         fprintf(stderr, "out of memory for headers.\n");
         return false;
     }
-    for (size_t c = 0; c < colCount; c++) {
-        headers[c] = strdup(headerTokens[c]);
+    for (size_t k = 0; k < keepCount; k++) {
+        headers[k] = dfStrdup(headerTokens[keep[k]]);
+    }
+
+    /*
+     * 2) A filtered scan first reads every row once to infer the kept
+     * columns' types, so dropping rows cannot change them; nothing is
+     * copied. String columns are then checked for DF_CATEGORY over every
+     * row while the matching rows are read below.
+     */
+    char* tokens[MAX_COLS];
+    ColumnType* types = NULL;
+    CsvCategoryProbe* categories = NULL;
+    size_t totalRows = 0;
+    if (filterCount > 0 && !scan->headerOnly) {
+        CsvTypeProbe* probes = (CsvTypeProbe*)dfMalloc(sizeof(CsvTypeProbe) * (keepCount ? keepCount : 1));
+        if (!probes) {
+            dfFree(filterCols);
+            fclose(fp);
+            fprintf(stderr, "out of memory for scan types.\n");
+            return false;
+        }
+        for (size_t k = 0; k < keepCount; k++) typeProbeInit(&probes[k]);
+        while (readCsvRow(fp, lineBuf, sizeof(lineBuf), tokens, colCount)) {
+            for (size_t k = 0; k < keepCount; k++) {
+                typeProbeAdd(&probes[k], tokens[keep[k]]);
+            }
+            totalRows++;
+        }
+        if (totalRows > 0) {
+            types = (ColumnType*)dfMalloc(sizeof(ColumnType) * (keepCount ? keepCount : 1));
+            categories = (CsvCategoryProbe*)dfMalloc(sizeof(CsvCategoryProbe) * (keepCount ? keepCount : 1));
+            if (!types || !categories) {
+                dfFree(probes);
+                dfFree(types);
+                dfFree(categories);
+                dfFree(filterCols);
+                fclose(fp);
+                fprintf(stderr, "out of memory for scan types.\n");
+                return false;
+            }
+            for (size_t k = 0; k < keepCount; k++) {
+                types[k] = typeProbeResult(&probes[k]);
+                categoryProbeInit(&categories[k], types[k] == DF_STRING ? totalRows : 0);
+            }
+        }
+        dfFree(probes);
+        // back to the first data row
+        rewind(fp);
+        if (!fgets(lineBuf, sizeof(lineBuf), fp)) {
+            totalRows = 0;
+        }
     }
 
-    // 2) Read rows
+    // 3) Read rows
     size_t capacityRows = 1000;
     size_t rowCount = 0;
-    char*** rowData = (char***)malloc(sizeof(char**) * capacityRows);
+    char*** rowData = (char***)dfMalloc(sizeof(char**) * capacityRows);
     if (!rowData) {
+        dfFree(filterCols);
         fclose(fp);
         fprintf(stderr, "out of memory for row pointers.\n");
         return false;
     }
 
-    while (fgets(lineBuf, sizeof(lineBuf), fp)) {
-        // Strip newline
-        lineBuf[strcspn(lineBuf, "\r\n")] = '\0';
-        // Check if blank
-        char* checkp = lineBuf;
-        while (*checkp && isspace((unsigned char)*checkp)) checkp++;
-        if (*checkp == '\0') {
-            continue; // skip empty lines
+    while (!(scan && scan->headerOnly) && readCsvRow(fp, lineBuf, sizeof(lineBuf), tokens, colCount)) {
+        if (categories) {
+            for (size_t k = 0; k < keepCount; k++) {
+                categoryProbeAdd(&categories[k], tokens[keep[k]], totalRows);
+            }
         }
 
-        char* tokens[MAX_COLS];
-        size_t nTokens = splitCsvLine(lineBuf, tokens, MAX_COLS);
-        if (nTokens < colCount) {
-            // pad with ""
-            for (size_t cc = nTokens; cc < colCount; cc++) {
-                tokens[cc] = "";
-            }
-            nTokens = colCount;
+        bool match = true;
+        for (size_t f = 0; f < filterCount && match; f++) {
+            match = csvCellMatches(tokens[filterCols[f]], &scan->filters[f]);
+        }
+        if (!match) {
+            continue; // filtered out before any cell is copied
         }
 
         if (rowCount >= capacityRows) {
             capacityRows *= 2;
-            rowData = (char***)realloc(rowData, sizeof(char**) * capacityRows);
+            rowData = (char***)dfRealloc(rowData, sizeof(char**) * capacityRows);
             if (!rowData) {
                 fclose(fp);
                 fprintf(stderr, "out of memory expanding rowData.\n");
                 return false;
             }
         }
-        rowData[rowCount] = (char**)malloc(sizeof(char*) * colCount);
+        rowData[rowCount] = (char**)dfMalloc(sizeof(char*) * (keepCount ? keepCount : 1));
         if (!rowData[rowCount]) {
             fclose(fp);
             fprintf(stderr, "out of memory for row.\n");
             return false;
         }
-        for (size_t cc = 0; cc < colCount; cc++) {
-            rowData[rowCount][cc] = strdup(tokens[cc]);
+        for (size_t k = 0; k < keepCount; k++) {
+            rowData[rowCount][k] = dfStrdup(tokens[keep[k]]);
         }
         rowCount++;
     }
     fclose(fp);
+    dfFree(filterCols);
+    if (categories) {
+        for (size_t k = 0; k < keepCount; k++) {
+            if (categoryProbeDone(&categories[k])) types[k] = DF_CATEGORY;
+        }
+        dfFree(categories);
+    }
 
     // Assign out-params
-    *outNCols = colCount;
+    *outNCols = keepCount;
     *outNRows = rowCount;
     *outHeaders = headers;
     *outCells = rowData;
+    *outTypes = types;
     return true;
 }
 
@@ -337,28 +565,133 @@ static void freeCsvBuffer(
 {
     if (headers) {
         for (size_t c = 0; c < nCols; c++) {
-            free(headers[c]);
+            dfFree(headers[c]);
         }
-        free(headers);
+        dfFree(headers);
     }
 
     if (cells) {
         for (size_t r = 0; r < nRows; r++) {
             for (size_t c = 0; c < nCols; c++) {
-                free(cells[r][c]);
+                dfFree(cells[r][c]);
             }
-            free(cells[r]);
+            dfFree(cells[r]);
         }
-        free(cells);
+        dfFree(cells);
     }
 }
 
 /*
- * inferColumnType: 
+ * True if the token's value survives a round trip through float exactly
+ * (1.25, 99.5, 30), so storing it as DF_FLOAT changes nothing. 0.1 does
+ * not: as a float it reads back as 0.100000001..., which would break sums
+ * and comparisons against the literal.
+ */
+static bool fitsFloat(const char* str)
+{
+    return (double)strtof(str, NULL) == strtod(str, NULL);
+}
+
+/*
+ * Narrowest integer type for values in [minVal, maxVal]. Signed types are
+ * preferred; an unsigned one is used when it is narrower (e.g. 200 => uint8).
+ */
+static ColumnType narrowestIntType(long long minVal, unsigned long long maxVal)
+{
+    if (minVal >= 0) {
+        if (maxVal <= INT8_MAX)   return DF_INT8;
+        if (maxVal <= UINT8_MAX)  return DF_UINT8;
+        if (maxVal <= INT16_MAX)  return DF_INT16;
+        if (maxVal <= UINT16_MAX) return DF_UINT16;
+        if (maxVal <= INT32_MAX)  return DF_INT;
+        if (maxVal <= UINT32_MAX) return DF_UINT32;
+        if (maxVal <= INT64_MAX)  return DF_INT64;
+        return DF_UINT64;
+    }
+    if (maxVal > INT64_MAX)                                 return DF_DOUBLE;
+    long long maxS = (long long)maxVal;
+    if (minVal >= INT8_MIN  && maxS <= INT8_MAX)  return DF_INT8;
+    if (minVal >= INT16_MIN && maxS <= INT16_MAX) return DF_INT16;
+    if (minVal >= INT32_MIN && maxS <= INT32_MAX) return DF_INT;
+    return DF_INT64;
+}
+
+static void typeProbeInit(CsvTypeProbe* p)
+{
+    p->allDatetime = true;
+    p->stage = 0;
+    p->allFloat = true;
+    p->minVal = 0;
+    p->maxVal = 0;
+    p->sawInt = false;
+}
+
+static void typeProbeAdd(CsvTypeProbe* p, const char* val)
+{
+    if (p->allDatetime && !isLikelyDateTime(val)) {
+        p->allDatetime = false;
+    }
+    if (p->stage == 2) return;
+
+    int t = checkNumericType(val);
+    if (t < 0) {
+        p->stage = 2; // string
+        return;
+    }
+    if (p->allFloat && !fitsFloat(val)) {
+        p->allFloat = false;
+    }
+    if (t == 1) {
+        // once we see a double, entire column is double
+        p->stage = 1;
+        return;
+    }
+    if (p->stage != 0) return;
+
+    // integer token: widen the observed range
+    errno = 0;
+    long long v = strtoll(val, NULL, 10);
+    unsigned long long u = 0;
+    if (errno == ERANGE) {
+        errno = 0;
+        u = strtoull(val, NULL, 10);
+        if (v < 0 || errno == ERANGE) {
+            p->stage = 1;   // beyond 64 bits => double
+            return;
+        }
+        v = 0;              // above INT64_MAX: only raises the max
+    } else if (v >= 0) {
+        u = (unsigned long long)v;
+    }
+    if (!p->sawInt || v < p->minVal) p->minVal = v;
+    if (v >= 0 && (!p->sawInt || u > p->maxVal)) p->maxVal = u;
+    p->sawInt = true;
+}
+
+/*
+ * typeProbeResult:
  *   1) If all rows in col parse as date/time => DF_DATETIME
- *   2) else if all rows numeric => DF_INT or DF_DOUBLE
- *   3) else => DF_STRING
+ *   2) else if all rows are integers => the narrowest integer type
+ *      (DF_INT8 ... DF_UINT64, DF_INT for 32-bit)
+ *   3) else if all rows are numeric => DF_FLOAT if every value fits a
+ *      float exactly as written, otherwise DF_DOUBLE
+ *   4) else => DF_STRING
  */
+static ColumnType typeProbeResult(const CsvTypeProbe* p)
+{
+    if (p->allDatetime) {
+        return DF_DATETIME;
+    }
+    int stage = p->stage;
+    if (stage == 0) {
+        ColumnType t = narrowestIntType(p->minVal, p->maxVal);
+        if (t != DF_DOUBLE) return t;
+        stage = 1;
+    }
+    if (stage == 1) return p->allFloat ? DF_FLOAT : DF_DOUBLE;
+    return DF_STRING;
+}
+
 static ColumnType inferColumnType(
     size_t nRows,
     char*** cells,
@@ -366,32 +699,51 @@ static ColumnType inferColumnType(
     size_t colIndex
 )
 {
-    bool allDatetime = true;
+    CsvTypeProbe probe;
+    typeProbeInit(&probe);
     for (size_t r = 0; r < nRows; r++) {
-        if (!isLikelyDateTime(cells[r][colIndex])) {
-            allDatetime = false;
-            break;
-        }
+        typeProbeAdd(&probe, cells[r][colIndex]);
     }
-    if (allDatetime) {
-        return DF_DATETIME;
+    return typeProbeResult(&probe);
+}
+
+/*
+ * Category probe: feed the column into a scratch DF_CATEGORY dictionary
+ * and give up as soon as the distinct count exceeds half of nRows.
+ */
+static void categoryProbeInit(CsvCategoryProbe* p, size_t nRows)
+{
+    p->low = nRows >= CSV_CATEGORY_MIN_ROWS;
+    if (p->low) {
+        seriesInit(&p->labels, "probe", DF_CATEGORY);
     }
+}
 
-    // Next fallback: numeric or string
-    // 0 => can be int, 1 => can be double, 2 => must be string
-    int colStage = 0;
-    for (size_t r = 0; r < nRows; r++) {
-        const char* val = cells[r][colIndex];
-        int t = checkNumericType(val);
-        if (t < 0) {
-            colStage = 2; // string
-            break;
-        } else if (t == 1) {
-            // once we see a double, entire column is double
-            colStage = 1;
-        }
+static void categoryProbeAdd(CsvCategoryProbe* p, const char* val, size_t nRows)
+{
+    if (!p->low) return;
+    seriesAddString(&p->labels, val);
+    if (seriesCategoryCount(&p->labels) * 2 > nRows) {
+        p->low = false;
+        seriesFree(&p->labels);
     }
-    if (colStage == 0) return DF_INT;
-    if (colStage == 1) return DF_DOUBLE;
-    return DF_STRING;
+}
+
+/* Releases the probe; true if the column stayed low-cardinality. */
+static bool categoryProbeDone(CsvCategoryProbe* p)
+{
+    if (p->low) {
+        seriesFree(&p->labels);
+    }
+    return p->low;
+}
+
+static bool isLowCardinality(size_t nRows, char*** cells, size_t colIndex)
+{
+    CsvCategoryProbe probe;
+    categoryProbeInit(&probe, nRows);
+    for (size_t r = 0; r < nRows && probe.low; r++) {
+        categoryProbeAdd(&probe, cells[r][colIndex], nRows);
+    }
+    return categoryProbeDone(&probe);
 }
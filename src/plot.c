@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 
 /* -------------------------------------------------------------------------
  * Forward-declared static helper
@@ -20,12 +21,13 @@ void dfPlot_impl(
     const char* outputFile
 )
 {
+    DF_OP_SCOPE();
     if (!df) {
         fprintf(stderr, "dfPlot_impl Error: DataFrame is NULL.\n");
         return;
     }
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
     if (nRows == 0 || nCols == 0) {
         fprintf(stderr, "dfPlot_impl Error: DataFrame is empty.\n");
         return;
@@ -43,7 +45,7 @@ void dfPlot_impl(
 
     // Validate Y columns => must be numeric
     for (size_t i = 0; i < yCount; i++) {
-        const Series* sy = df->getSeries(df, yColIndices[i]);
+        const Series* sy = df->ops->getSeries(df, yColIndices[i]);
         if (!sy) {
             fprintf(stderr, "dfPlot_impl Error: Invalid yCol index %zu.\n", yColIndices[i]);
             return;
@@ -59,7 +61,7 @@ void dfPlot_impl(
     // If using a real column as X, check numeric
     const Series* sx = NULL;
     if (!useIndexAsX) {
-        sx = df->getSeries(df, xColIndex);
+        sx = df->ops->getSeries(df, xColIndex);
         if (!sx) {
             fprintf(stderr, "dfPlot_impl Error: Invalid xCol index %zu.\n", xColIndex);
             return;
@@ -104,7 +106,7 @@ void dfPlot_impl(
 
     // Build each Y array
     for (size_t i = 0; i < yCount; i++) {
-        const Series* s = df->getSeries(df, yColIndices[i]);
+        const Series* s = df->ops->getSeries(df, yColIndices[i]);
         fprintf(pyFile, "y%zu = [", i);
         for (size_t r = 0; r < nRows; r++) {
             double val = 0.0;
@@ -119,7 +121,7 @@ void dfPlot_impl(
     if (strcmp(plotType, "scatter") == 0) {
         // scatter
         for (size_t i = 0; i < yCount; i++) {
-            const Series* s = df->getSeries(df, yColIndices[i]);
+            const Series* s = df->ops->getSeries(df, yColIndices[i]);
             fprintf(pyFile, 
                 "plt.scatter(x, y%zu, label=\"%s\")\n",
                 i, s->name);
@@ -161,7 +163,7 @@ void dfPlot_impl(
     else {
         // line plot
         for (size_t i = 0; i < yCount; i++) {
-            const Series* s = df->getSeries(df, yColIndices[i]);
+            const Series* s = df->ops->getSeries(df, yColIndices[i]);
             fprintf(pyFile, 
                 "plt.plot(x, y%zu, label=\"%s\")\n",
                 i, s->name);
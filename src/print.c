@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 // Helper to convert an integer to string safely
 static size_t intToStrLen(int value, char* buffer, size_t bufSize)
 {
@@ -56,7 +57,7 @@ static void printRow(
 
     // Print each column value in rowIndex
     for (int c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) {
             printf("???  ");
             continue;
@@ -89,12 +90,12 @@ static void printRow(
                 }
             } break;
 
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(s, rowIndex, &str)) {
+            case DF_STRING:
+            case DF_CATEGORY: {
+                const char* str = NULL;
+                if (seriesGetStringView(s, rowIndex, &str, NULL)) {
                     // Print string left-aligned
                     printf("%-*s  ", (int)colWidths[c], str);
-                    free(str);
                 } else {
                     printf("%-*s  ", (int)colWidths[c], "?");
                 }
@@ -111,6 +112,14 @@ static void printRow(
                     printf("%*s  ", (int)colWidths[c], "?");
                 }
             } break;
+            default: {
+                // other numeric types
+                if (seriesFormatNumber(s, rowIndex, tempBuf, sizeof(tempBuf))) {
+                    printf("%*s  ", (int)colWidths[c], tempBuf);
+                } else {
+                    printf("%*s  ", (int)colWidths[c], "?");
+                }
+            } break;
         }
     }
     printf("\n");
@@ -121,13 +130,14 @@ static void printRow(
  * ------------------------------------------------------------------------- */
 void dfPrint_impl(const DataFrame* df)
 {
+    DF_OP_SCOPE();
     if (!df) {
         printf("NULL DataFrame pointer.\n");
         return;
     }
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
 
     if (nCols == 0 || nRows == 0) {
         printf("Empty DataFrame\n");
@@ -146,7 +156,7 @@ void dfPrint_impl(const DataFrame* df)
     // Figure out max width needed for each column
     char tempBuf[256];
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) {
             colWidths[c] = 3; // fallback
             continue;
@@ -178,14 +188,14 @@ void dfPrint_impl(const DataFrame* df)
                         }
                     }
                 } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        size_t length = strlen(str);
+                case DF_STRING:
+                case DF_CATEGORY: {
+                    const char* str = NULL;
+                    size_t length = 0;
+                    if (seriesGetStringView(s, r, &str, &length)) {
                         if (length > colWidths[c]) {
                             colWidths[c] = length;
                         }
-                        free(str);
                     }
                 } break;
 
@@ -200,6 +210,14 @@ void dfPrint_impl(const DataFrame* df)
                         }
                     }
                 } break;
+                default: {
+                    if (seriesFormatNumber(s, r, tempBuf, sizeof(tempBuf))) {
+                        size_t length = strlen(tempBuf);
+                        if (length > colWidths[c]) {
+                            colWidths[c] = length;
+                        }
+                    }
+                } break;
             }
         }
     }
@@ -210,7 +228,7 @@ void dfPrint_impl(const DataFrame* df)
     // Print header row
     printf("%*s  ", (int)idxWidth, "");
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (s) {
             // column name left-aligned
             printf("%-*s  ", (int)colWidths[c], s->name);
@@ -3,7 +3,11 @@
 #include <time.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "dataframe.h"
+#include "dfalloc.h"
+#include "dfmask.h"
+#include "dfstats.h"
 
 /* 
    -------------
@@ -14,9 +18,12 @@
 /**
  * @brief Return a new DataFrame containing the first `n` rows of `df`.
  *        If `df` has fewer than `n` rows, it returns all of them.
+ *        The result is a row view: its columns share `df`'s storage
+ *        (copy-on-write) and keep it alive; see dfMaterialize_impl.
  */
 DataFrame dfHead_impl(const DataFrame* df, size_t n)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);  // initialize a blank DataFrame
 
@@ -25,51 +32,20 @@ DataFrame dfHead_impl(const DataFrame* df, size_t n)
         return result;
     }
 
-    size_t numRows = df->numRows(df);
+    size_t numRows = df->ops->numRows(df);
     size_t limit = (n < numRows) ? n : numRows;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
+        // a view of the first `limit` rows (shares the column's storage)
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
+        seriesSlice(s, 0, limit, &newSeries);
 
-        for (size_t r = 0; r < limit; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str); 
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
     return result;
@@ -78,9 +54,11 @@ DataFrame dfHead_impl(const DataFrame* df, size_t n)
 /**
  * @brief Return a new DataFrame containing the last `n` rows of `df`.
  *        If `df` has fewer than `n` rows, it returns all of them.
+ *        Like head, the result is a row view of `df`.
  */
 DataFrame dfTail_impl(const DataFrame* df, size_t n)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
 
@@ -88,164 +66,116 @@ DataFrame dfTail_impl(const DataFrame* df, size_t n)
         return result;
     }
 
-    size_t numRows = df->numRows(df);
+    size_t numRows = df->ops->numRows(df);
     if (n > numRows) {
         n = numRows;
     }
     size_t start = (numRows > n) ? (numRows - n) : 0;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
-
-        for (size_t r = start; r < numRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        seriesSlice(s, start, numRows - start, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
     return result;
 }
 
+/**
+ * @brief Return a compact, independent copy of `df`. Row views (head, tail,
+ *        slice, iloc) keep their parent's whole buffers alive; materialize
+ *        copies just the visible rows so the parent's memory can go.
+ */
+DataFrame dfMaterialize_impl(const DataFrame* df)
+{
+    DF_OP_SCOPE();
+    DataFrame result;
+    DataFrame_Create(&result);
+    if (!df) return result;
+
+    size_t nCols = df->ops->numColumns(df);
+    for (size_t c = 0; c < nCols; c++) {
+        const Series* s = df->ops->getSeries(df, c);
+        if (!s) continue;
+
+        Series newSeries;
+        seriesCopy(s, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
+    }
+    return result;
+}
+
 /* 
    -------------
    DESCRIBE
    -------------
 */
 
+/**
+ * @brief One row per column: colName, count, min, max, mean, then nulls,
+ *        std, skew, kurtosis, 25%, 50%, 75%. All statistics come from one
+ *        fused pass per column (see dfstats.h); columns are summarized in
+ *        parallel. count excludes nulls; text columns get 0 for the rest.
+ */
 DataFrame dfDescribe_impl(const DataFrame* df)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
 
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    DfColumnStats* stats = (DfColumnStats*)calloc(nCols ? nCols : 1, sizeof(DfColumnStats));
+    if (!stats) return result;
+    if (!dfSummarizeColumns(df, stats)) {
+        fprintf(stderr, "dfDescribe_impl: out of memory.\n");
+        free(stats);
+        return result;
+    }
 
-    Series colNameS, countS, minS, maxS, meanS;
+    enum { N_STATS = 10 };
+    static const char* const statNames[N_STATS] = {
+        "min", "max", "mean", "nulls", "std", "skew", "kurtosis", "25%", "50%", "75%"
+    };
+    Series colNameS, countS, statS[N_STATS];
     seriesInit(&colNameS, "colName", DF_STRING);
     seriesInit(&countS,   "count",   DF_INT);
-    seriesInit(&minS,     "min",     DF_DOUBLE);
-    seriesInit(&maxS,     "max",     DF_DOUBLE);
-    seriesInit(&meanS,    "mean",    DF_DOUBLE);
+    for (size_t k = 0; k < N_STATS; k++) {
+        seriesInit(&statS[k], statNames[k], k == 3 ? DF_INT : DF_DOUBLE);
+    }
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
-
-        seriesAddString(&colNameS, s->name);  // add col name
-
-        // For numeric columns, compute stats
-        if ((s->type == DF_INT || s->type == DF_DOUBLE) && nRows > 0) {
-            double minVal, maxVal, sumVal = 0.0;
-
-            // initialize from row 0
-            if (s->type == DF_INT) {
-                int temp;
-                seriesGetInt(s, 0, &temp);
-                minVal = maxVal = (double)temp;
-                sumVal = (double)temp;
-            }
-            else {
-                double temp;
-                seriesGetDouble(s, 0, &temp);
-                minVal = maxVal = temp;
-                sumVal = temp;
-            }
-            // gather stats
-            for (size_t r = 1; r < nRows; r++) {
-                double d = 0.0;
-                if (s->type == DF_INT) {
-                    int ti;
-                    seriesGetInt(s, r, &ti);
-                    d = (double)ti;
-                } else {
-                    double td;
-                    seriesGetDouble(s, r, &td);
-                    d = td;
-                }
-                if (d < minVal) minVal = d;
-                if (d > maxVal) maxVal = d;
-                sumVal += d;
-            }
-
-            double meanVal = sumVal / (double)nRows;
-
-            seriesAddInt(&countS,  (int)nRows);
-            seriesAddDouble(&minS,  minVal);
-            seriesAddDouble(&maxS,  maxVal);
-            seriesAddDouble(&meanS, meanVal);
-        }
-        else if (s->type == DF_STRING) {
-            // For string columns, store count + 0 for min/max/mean
-            seriesAddInt(&countS, (int)nRows);
-            seriesAddDouble(&minS,  0.0);
-            seriesAddDouble(&maxS,  0.0);
-            seriesAddDouble(&meanS, 0.0);
-        }
-        /* NEW: DF_DATETIME => treat like a "non-numeric" for now */
-        else if (s->type == DF_DATETIME) {
-            seriesAddInt(&countS, (int)nRows);
-            // Could compute actual min, max from epoch. For now, set 0
-            seriesAddDouble(&minS,  0.0);
-            seriesAddDouble(&maxS,  0.0);
-            seriesAddDouble(&meanS, 0.0);
-        }
-        else {
-            // no rows => everything is 0 or empty
-            seriesAddInt(&countS, 0);
-            seriesAddDouble(&minS,  0.0);
-            seriesAddDouble(&maxS,  0.0);
-            seriesAddDouble(&meanS, 0.0);
-        }
+        const DfColumnStats* st = &stats[c];
+
+        seriesAddString(&colNameS, s->name);
+        seriesAddInt(&countS, (int)st->count);
+        seriesAddDouble(&statS[0], st->min);
+        seriesAddDouble(&statS[1], st->max);
+        seriesAddDouble(&statS[2], st->mean);
+        seriesAddInt(&statS[3], (int)st->nulls);
+        seriesAddDouble(&statS[4], st->std);
+        seriesAddDouble(&statS[5], st->skew);
+        seriesAddDouble(&statS[6], st->kurtosis);
+        seriesAddDouble(&statS[7], st->q25);
+        seriesAddDouble(&statS[8], st->q50);
+        seriesAddDouble(&statS[9], st->q75);
     }
+    free(stats);
 
     // Add columns to the result
-    result.addSeries(&result, &colNameS);
-    result.addSeries(&result, &countS);
-    result.addSeries(&result, &minS);
-    result.addSeries(&result, &maxS);
-    result.addSeries(&result, &meanS);
-
-    seriesFree(&colNameS);
-    seriesFree(&countS);
-    seriesFree(&minS);
-    seriesFree(&maxS);
-    seriesFree(&meanS);
+    result.ops->addSeriesMove(&result, &colNameS);
+    result.ops->addSeriesMove(&result, &countS);
+    for (size_t k = 0; k < N_STATS; k++) {
+        result.ops->addSeriesMove(&result, &statS[k]);
+    }
 
     return result;
 }
@@ -256,11 +186,12 @@ DataFrame dfDescribe_impl(const DataFrame* df)
 
 DataFrame dfSlice_impl(const DataFrame* df, size_t start, size_t end)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (start >= nRows) {
         return result; // empty
     }
@@ -268,58 +199,27 @@ DataFrame dfSlice_impl(const DataFrame* df, size_t start, size_t end)
         end = nRows;
     }
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
+        seriesSlice(s, start, (end > start) ? end - start : 0, &newSeries);
 
-        for (size_t r = start; r < end; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
     return result;
 }
 
 DataFrame dfSample_impl(const DataFrame* df, size_t count)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     if (count >= nRows) {
         return dfSlice_impl(df, 0, nRows);
     }
@@ -337,47 +237,14 @@ DataFrame dfSample_impl(const DataFrame* df, size_t count)
         indices[i] = tmp;
     }
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
-
-        for (size_t i = 0; i < count; i++) {
-            size_t rowIdx = indices[i];
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, rowIdx, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, rowIdx, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, rowIdx, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, rowIdx, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        seriesGather(s, indices, count, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
     free(indices);
@@ -390,53 +257,22 @@ DataFrame dfSample_impl(const DataFrame* df, size_t count)
 
 DataFrame dfSelectColumns_impl(const DataFrame* df, const size_t* colIndices, size_t count)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !colIndices) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     for (size_t i = 0; i < count; i++) {
         size_t cIndex = colIndices[i];
         if (cIndex >= nCols) continue;
-        const Series* s = df->getSeries(df, cIndex);
+        const Series* s = df->ops->getSeries(df, cIndex);
         if (!s) continue;
 
+        // share the column's storage (copy-on-write)
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
-
-        size_t nRows = seriesSize(s);
-        for (size_t r = 0; r < nRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        seriesShare(s, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
     return result;
@@ -444,11 +280,12 @@ DataFrame dfSelectColumns_impl(const DataFrame* df, const size_t* colIndices, si
 
 DataFrame dfDropColumns_impl(const DataFrame* df, const size_t* dropIndices, size_t dropCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !dropIndices) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     bool* toDrop = (bool*)calloc(nCols, sizeof(bool));
     for (size_t i = 0; i < dropCount; i++) {
         if (dropIndices[i] < nCols) {
@@ -460,45 +297,12 @@ DataFrame dfDropColumns_impl(const DataFrame* df, const size_t* dropIndices, siz
         if (toDrop[c]) {
             continue;
         }
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
-
-        size_t nRows = seriesSize(s);
-        for (size_t r = 0; r < nRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
-        }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        seriesShare(s, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
     free(toDrop);
@@ -510,65 +314,40 @@ DataFrame dfRenameColumns_impl(const DataFrame* df,
                                const char** newNames,
                                size_t count)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
+
+    // newName[c] = the first matching entry of newNames for column c
+    const char** newName = (const char**)calloc(nCols ? nCols : 1, sizeof(const char*));
+    if (!newName) return result;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t c = dfColumnIndexFrom(df, oldNames[i], 0); c != (size_t)-1;
+             c = dfColumnIndexFrom(df, oldNames[i], c + 1)) {
+            if (!newName[c]) newName[c] = newNames[i];
+        }
+    }
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
+        seriesShare(s, &newSeries);
 
-        size_t nRows = seriesSize(s);
-        for (size_t r = 0; r < nRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
+        if (newName[c]) {
+            free(newSeries.name); 
+            newSeries.name = (char*)malloc(strlen(newName[c]) + 1);
+            strcpy(newSeries.name, newName[c]);
         }
 
-        // check if s->name is in oldNames => rename
-        for (size_t i = 0; i < count; i++) {
-            if (strcmp(s->name, oldNames[i]) == 0) {
-                free(newSeries.name); 
-                newSeries.name = (char*)malloc(strlen(newNames[i]) + 1);
-                strcpy(newSeries.name, newNames[i]);
-                break;
-            }
-        }
-
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
+    free(newName);
     return result;
 }
 
@@ -576,138 +355,163 @@ DataFrame dfRenameColumns_impl(const DataFrame* df,
  * 3) Filtering Rows
  * ------------------------------------------------------------------------- */
 
-static bool isRowNA(const DataFrame* df, size_t rowIndex);
-
-DataFrame dfFilter_impl(const DataFrame* df, RowPredicate predicate)
+/* Copy the rows whose bit is set in `keep` (one bit per row of df). */
+static DataFrame filterRows(const DataFrame* df, const DfMask* keep)
 {
     DataFrame result;
     DataFrame_Create(&result);
-    if (!df || !predicate) return result;
-
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
 
-    bool* keepRow = (bool*)calloc(nRows, sizeof(bool));
+    DfSelection rows = dfMaskToSelection(keep);
+    size_t nCols = df->ops->numColumns(df);
 
-    for (size_t r = 0; r < nRows; r++) {
-        if (predicate(df, r)) {
-            keepRow[r] = true;
-        }
-    }
-
-    // Copy those rows
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
         seriesInit(&newSeries, s->name, s->type);
+        seriesReserve(&newSeries, rows.count);
 
-        for (size_t r = 0; r < nRows; r++) {
-            if (!keepRow[r]) continue;
-
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double val;
-                    if (seriesGetDouble(s, r, &val)) {
-                        seriesAddDouble(&newSeries, val);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, r, &str)) {
-                        seriesAddString(&newSeries, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
-            }
+        for (size_t i = 0; i < rows.count; i++) {
+            seriesAppendFrom(&newSeries, s, rows.rows[i]);
         }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
+    }
+
+    dfSelectionFree(&rows);
+    return result;
+}
+
+DataFrame dfFilter_impl(const DataFrame* df, RowPredicate predicate)
+{
+    DF_OP_SCOPE();
+    DfMask keep;
+    if (!df || !predicate || !dfMaskFromPredicate(df, predicate, &keep)) {
+        DataFrame result;
+        DataFrame_Create(&result);
+        return result;
     }
 
-    free(keepRow);
+    DataFrame result = filterRows(df, &keep);
+    dfMaskFree(&keep);
     return result;
 }
 
-static bool dropNA_predicate(const DataFrame* d, size_t rowIdx)
+/**
+ * @brief Like filter, with the rows to keep given as a mask built by the
+ *        column kernels in dfmask.h (its length must be numRows(df)).
+ */
+DataFrame dfFilterMask_impl(const DataFrame* df, const DfMask* keep)
 {
-    return !isRowNA(d, rowIdx);
+    DF_OP_SCOPE();
+    if (!df || !keep || keep->length != df->ops->numRows(df)) {
+        if (df && keep) {
+            fprintf(stderr, "dfFilterMask_impl: mask has %zu rows, frame has %zu.\n",
+                    keep->length, df->ops->numRows(df));
+        }
+        DataFrame result;
+        DataFrame_Create(&result);
+        return result;
+    }
+    return filterRows(df, keep);
 }
 
-DataFrame dfDropNA_impl(const DataFrame* df)
+/**
+ * @brief Like filter, but return the surviving row indices instead of
+ *        copying the rows. Only the rows of `within` (all rows if NULL) are
+ *        tested, so chained filters narrow one selection without copying.
+ */
+DfSelection dfFilterSelection_impl(const DataFrame* df, RowPredicate predicate, const DfSelection* within)
 {
-    if (!df) {
-        DataFrame empty;
-        DataFrame_Create(&empty);
-        return empty;
+    DF_OP_SCOPE();
+    DfSelection sel = { NULL, 0 };
+    if (!df || !predicate) return sel;
+
+    size_t n = within ? within->count : df->ops->numRows(df);
+    if (n == 0) return sel;
+
+    sel.rows = (size_t*)dfMalloc(n * sizeof(size_t));
+    if (!sel.rows) return sel;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t r = within ? within->rows[i] : i;
+        if (predicate(df, r)) {
+            sel.rows[sel.count++] = r;
+        }
     }
-    // Filter out rows that are "NA"
-    return dfFilter_impl(df, dropNA_predicate);
+
+    // give back the unused tail
+    if (sel.count == 0) {
+        dfFree(sel.rows);
+        sel.rows = NULL;
+    } else if (sel.count < n) {
+        size_t* shrunk = (size_t*)dfRealloc(sel.rows, sel.count * sizeof(size_t));
+        if (shrunk) sel.rows = shrunk;
+    }
+    return sel;
 }
 
-/* 
-   helper to detect if row has "NA" in numeric=0 or string="" 
-   (You can adapt for DF_DATETIME as needed.)
-*/
-static bool isRowNA(const DataFrame* df, size_t rowIndex)
+void dfSelectionFree(DfSelection* sel)
+{
+    if (!sel) return;
+    dfFree(sel->rows);
+    sel->rows = NULL;
+    sel->count = 0;
+}
+
+/**
+ * @brief Drop every row that is null in any column.
+ *
+ * The rows to keep are the AND of all columns' validity bitmaps, built one
+ * 64-row word at a time; columns without nulls are skipped, and so are
+ * words in which every row is dropped.
+ */
+DataFrame dfDropNA_impl(const DataFrame* df)
 {
-    size_t nCols = df->numColumns(df);
+    DF_OP_SCOPE();
+    DataFrame result;
+    DataFrame_Create(&result);
+    if (!df) return result;
+
+    size_t nRows = df->ops->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nWords = SERIES_VALIDITY_WORDS(nRows);
+
+    uint64_t* keep = (uint64_t*)malloc((nWords ? nWords : 1) * sizeof(uint64_t));
+    if (!keep) return result;
+    memset(keep, 0xFF, nWords * sizeof(uint64_t));
+
+    for (size_t c = 0; c < nCols; c++) {
+        const Series* s = df->ops->getSeries(df, c);
+        if (!s || seriesNullCount(s) == 0) continue;
+        for (size_t w = 0; w < nWords; w++) {
+            keep[w] &= seriesValidityWord(s, w);
+        }
+    }
+
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
-        switch (s->type) {
-            case DF_INT: {
-                int val;
-                if (seriesGetInt(s, rowIndex, &val)) {
-                    if (val == 0) {
-                        return true;
-                    }
-                }
-            } break;
-            case DF_DOUBLE: {
-                double val;
-                if (seriesGetDouble(s, rowIndex, &val)) {
-                    if (val == 0.0) {
-                        return true;
-                    }
-                }
-            } break;
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(s, rowIndex, &str)) {
-                    bool empty = (str[0] == '\0');
-                    free(str);
-                    if (empty) {
-                        return true;
-                    }
-                }
-            } break;
-            /* If you want DF_DATETIME = 0 to be "NA", do so here, e.g. */
-            case DF_DATETIME: {
-                long long dtVal;
-                if (seriesGetDateTime(s, rowIndex, &dtVal)) {
-                    if (dtVal == 0) {
-                        return true;
-                    }
+
+        Series newSeries;
+        seriesInit(&newSeries, s->name, s->type);
+
+        for (size_t w = 0; w < nWords; w++) {
+            uint64_t word = keep[w];
+            if (word == 0) continue;
+            size_t base = w * 64;
+            size_t end = (base + 64 < nRows) ? base + 64 : nRows;
+            for (size_t r = base; r < end; r++) {
+                if ((word >> (r - base)) & 1ULL) {
+                    seriesAppendFrom(&newSeries, s, r);
                 }
-            } break;
+            }
         }
+        result.ops->addSeriesMove(&result, &newSeries);
     }
-    return false;
+
+    free(keep);
+    return result;
 }
 
 /* -------------------------------------------------------------------------
@@ -718,12 +522,34 @@ typedef struct {
     const DataFrame* df;
     size_t columnIndex;
     bool ascending;
+    const Series* key;           // contiguous fixed-width key, else NULL
+    const SeriesKernels* kernels;
 } SortContext;
 
+static void initSortContext(SortContext* ctx, const DataFrame* df, size_t columnIndex, bool ascending)
+{
+    ctx->df = df;
+    ctx->columnIndex = columnIndex;
+    ctx->ascending = ascending;
+    ctx->key = df->ops->getSeries(df, columnIndex);
+    ctx->kernels = ctx->key ? seriesKernels(ctx->key->type) : NULL;
+    if (!ctx->kernels || seriesIsChunked(ctx->key)) {
+        ctx->key = NULL;
+        ctx->kernels = NULL;
+    }
+}
+
 static int compareRowIndices(size_t ra, size_t rb, const SortContext* ctx)
 {
     if (!ctx || !ctx->df) return 0;
-    const Series* s = ctx->df->getSeries(ctx->df, ctx->columnIndex);
+    if (ctx->kernels) {
+        // type resolved once: compare straight out of the value buffer
+        const Series* key = ctx->key;
+        if (key->nullCount && (seriesIsNull(key, ra) || seriesIsNull(key, rb))) return 0;
+        int cmp = ctx->kernels->compare(key->values, ra, key->values, rb);
+        return ctx->ascending ? cmp : -cmp;
+    }
+    const Series* s = ctx->df->ops->getSeries(ctx->df, ctx->columnIndex);
     if (!s) return 0;
 
     if (s->type == DF_INT) {
@@ -744,19 +570,15 @@ static int compareRowIndices(size_t ra, size_t rb, const SortContext* ctx)
         if (va > vb) return ctx->ascending ? 1 : -1;
         return 0;
     }
-    else if (s->type == DF_STRING) {
-        char* strA = NULL;
-        char* strB = NULL;
-        bool gotA = seriesGetString(s, ra, &strA);
-        bool gotB = seriesGetString(s, rb, &strB);
+    else if (s->type == DF_STRING || s->type == DF_CATEGORY) {
+        const char* strA = NULL;
+        const char* strB = NULL;
+        bool gotA = seriesGetStringView(s, ra, &strA, NULL);
+        bool gotB = seriesGetStringView(s, rb, &strB, NULL);
         if (!gotA || !gotB) {
-            if (strA) free(strA);
-            if (strB) free(strB);
             return 0;
         }
         int cmp = strcmp(strA, strB);
-        free(strA);
-        free(strB);
         return ctx->ascending ? cmp : -cmp;
     }
     /* NEW: DF_DATETIME => compare as long long */
@@ -769,6 +591,11 @@ static int compareRowIndices(size_t ra, size_t rb, const SortContext* ctx)
         if (va > vb) return ctx->ascending ? 1 : -1;
         return 0;
     }
+    /* fixed-width types (DF_INT8 ... DF_FLOAT) compare in their own type */
+    else if (seriesTypeIsNumeric(s->type)) {
+        int cmp = seriesCompareRows(s, ra, rb);
+        return ctx->ascending ? cmp : -cmp;
+    }
 
     return 0;
 }
@@ -792,13 +619,14 @@ static void insertionSortRows(size_t* rowIdx, size_t count, const SortContext* c
 
 DataFrame dfSort_impl(const DataFrame* df, size_t columnIndex, bool ascending)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
 
     if (!df) return result;
 
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
     if (columnIndex >= nCols) {
         return result;
     }
@@ -812,57 +640,137 @@ DataFrame dfSort_impl(const DataFrame* df, size_t columnIndex, bool ascending)
     }
 
     SortContext ctx;
-    ctx.df = df;
-    ctx.columnIndex = columnIndex;
-    ctx.ascending = ascending;
+    initSortContext(&ctx, df, columnIndex, ascending);
 
     insertionSortRows(rowIdx, nRows, &ctx);
 
     // Now build sorted DF
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
-        seriesInit(&newSeries, s->name, s->type);
+        seriesGather(s, rowIdx, nRows, &newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
+    }
 
-        for (size_t i = 0; i < nRows; i++) {
-            size_t oldRow = rowIdx[i];
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, oldRow, &val)) {
-                        seriesAddInt(&newSeries, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dval;
-                    if (seriesGetDouble(s, oldRow, &dval)) {
-                        seriesAddDouble(&newSeries, dval);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* strVal = NULL;
-                    if (seriesGetString(s, oldRow, &strVal)) {
-                        seriesAddString(&newSeries, strVal);
-                        free(strVal);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, oldRow, &dtVal)) {
-                        seriesAddDateTime(&newSeries, dtVal);
-                    }
-                } break;
+    free(rowIdx);
+    return result;
+}
+
+/**
+ * @brief Order the rows of `sel` (all rows if NULL) by a column without
+ *        copying anything: the result holds the same row indices, sorted.
+ *        Ties keep their order in `sel`. Materialize it with takeSelection.
+ */
+DfSelection dfSortSelection_impl(const DataFrame* df, size_t columnIndex, bool ascending, const DfSelection* sel)
+{
+    DF_OP_SCOPE();
+    DfSelection sorted = { NULL, 0 };
+    if (!df || columnIndex >= df->ops->numColumns(df)) return sorted;
+
+    size_t n = sel ? sel->count : df->ops->numRows(df);
+    if (n == 0) return sorted;
+
+    sorted.rows = (size_t*)dfMalloc(n * sizeof(size_t));
+    if (!sorted.rows) return sorted;
+    for (size_t i = 0; i < n; i++) {
+        sorted.rows[i] = sel ? sel->rows[i] : i;
+    }
+    sorted.count = n;
+
+    SortContext ctx;
+    initSortContext(&ctx, df, columnIndex, ascending);
+    insertionSortRows(sorted.rows, n, &ctx);
+    return sorted;
+}
+
+/* Heap entry for top-k: a row and its position in the input order. */
+typedef struct {
+    size_t row;
+    size_t pos;
+} TopEntry;
+
+/* Sort order of two entries; ties go to the earlier position (stable). */
+static int compareTop(const TopEntry* a, const TopEntry* b, const SortContext* ctx)
+{
+    int cmp = compareRowIndices(a->row, b->row, ctx);
+    if (cmp != 0) return cmp;
+    return (a->pos < b->pos) ? -1 : (a->pos > b->pos);
+}
+
+/* Restore the max-heap (worst entry on top) below index i. */
+static void siftDownTop(TopEntry* heap, size_t n, size_t i, const SortContext* ctx)
+{
+    for (;;) {
+        size_t worst = i;
+        size_t l = 2 * i + 1, r = l + 1;
+        if (l < n && compareTop(&heap[l], &heap[worst], ctx) > 0) worst = l;
+        if (r < n && compareTop(&heap[r], &heap[worst], ctx) > 0) worst = r;
+        if (worst == i) return;
+        TopEntry tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+/**
+ * @brief The first `k` rows of sortSelection(df, col, asc, sel), found with
+ *        a k-entry heap in O(n log k) instead of ordering every row.
+ */
+DfSelection dfTopSelection_impl(const DataFrame* df, size_t columnIndex, bool ascending,
+                                size_t k, const DfSelection* sel)
+{
+    DF_OP_SCOPE();
+    DfSelection top = { NULL, 0 };
+    if (!df || columnIndex >= df->ops->numColumns(df)) return top;
+
+    size_t n = sel ? sel->count : df->ops->numRows(df);
+    if (k > n) k = n;
+    if (k == 0) return top;
+
+    TopEntry* heap = (TopEntry*)malloc(k * sizeof(TopEntry));
+    top.rows = (size_t*)dfMalloc(k * sizeof(size_t));
+    if (!heap || !top.rows) {
+        free(heap);
+        dfFree(top.rows);
+        top.rows = NULL;
+        return top;
+    }
+
+    SortContext ctx;
+    initSortContext(&ctx, df, columnIndex, ascending);
+
+    size_t size = 0;
+    for (size_t i = 0; i < n; i++) {
+        TopEntry e = { sel ? sel->rows[i] : i, i };
+        if (size < k) {
+            // sift the new entry up
+            size_t j = size++;
+            heap[j] = e;
+            while (j > 0 && compareTop(&heap[(j - 1) / 2], &heap[j], &ctx) < 0) {
+                TopEntry tmp = heap[j];
+                heap[j] = heap[(j - 1) / 2];
+                heap[(j - 1) / 2] = tmp;
+                j = (j - 1) / 2;
             }
+        } else if (compareTop(&e, &heap[0], &ctx) < 0) {
+            heap[0] = e;
+            siftDownTop(heap, size, 0, &ctx);
         }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
     }
 
-    free(rowIdx);
-    return result;
+    // pop the worst entry into the last slot until the heap is empty
+    for (size_t end = size; end > 0; end--) {
+        top.rows[end - 1] = heap[0].row;
+        heap[0] = heap[end - 1];
+        siftDownTop(heap, end - 1, 0, &ctx);
+    }
+    top.count = size;
+
+    free(heap);
+    return top;
 }
 
 /* -------------------------------------------------------------------------
@@ -885,7 +793,7 @@ static void buildRowKey(const DataFrame* df,
 
     for (size_t i = 0; i < subsetCount; i++) {
         size_t colIdx = subsetCols[i];
-        const Series* s = df->getSeries(df, colIdx);
+        const Series* s = df->ops->getSeries(df, colIdx);
         if (!s) continue;
 
         char valBuf[128] = "";
@@ -902,12 +810,12 @@ static void buildRowKey(const DataFrame* df,
                     snprintf(valBuf, sizeof(valBuf), "%g", dval);
                 }
             } break;
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(s, row, &str)) {
+            case DF_STRING:
+            case DF_CATEGORY: {
+                const char* str = NULL;
+                if (seriesGetStringView(s, row, &str, NULL)) {
                     strncpy(valBuf, str, sizeof(valBuf) - 1);
                     valBuf[sizeof(valBuf) - 1] = '\0';
-                    free(str);
                 }
             } break;
             /* NEW: DF_DATETIME => convert epoch to string */
@@ -917,6 +825,9 @@ static void buildRowKey(const DataFrame* df,
                     snprintf(valBuf, sizeof(valBuf), "%lld", dtVal);
                 }
             } break;
+            default:
+                seriesFormatNumber(s, row, valBuf, sizeof(valBuf));
+                break;
         }
 
         if (i > 0) {
@@ -931,19 +842,25 @@ static void buildRowKey(const DataFrame* df,
  */
 DataFrame dfDropDuplicates_impl(const DataFrame* df, const size_t* subsetCols, size_t subsetCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+
+    // all scratch data lives in one arena, released in one shot at the end
+    DfArena arena;
+    dfArenaInit(&arena, 0);
 
     // If subsetCount == 0 => use all columns
-    int usedAll = 0;
-    size_t* allCols = NULL;
     if (subsetCount == 0) {
-        usedAll = 1;
-        allCols = (size_t*)malloc(nCols * sizeof(size_t));
+        size_t* allCols = (size_t*)dfArenaAlloc(&arena, nCols * sizeof(size_t));
+        if (!allCols) {
+            dfArenaFree(&arena);
+            return result;
+        }
         for (size_t i = 0; i < nCols; i++) {
             allCols[i] = i;
         }
@@ -951,15 +868,16 @@ DataFrame dfDropDuplicates_impl(const DataFrame* df, const size_t* subsetCols, s
         subsetCount = nCols;
     }
 
-    typedef struct {
-        char* key;
-    } DeduKey;
-
-    DeduKey* usedKeys = NULL;
-    size_t usedSize = 0, usedCap = 0;
+    // at most one distinct key per row, so both arrays are sized up front
+    char** usedKeys = (char**)dfArenaAlloc(&arena, nRows * sizeof(char*));
+    size_t usedSize = 0;
 
-    size_t* keepRows = (size_t*)malloc(nRows * sizeof(size_t));
+    size_t* keepRows = (size_t*)dfArenaAlloc(&arena, nRows * sizeof(size_t));
     size_t keepCount = 0;
+    if (!usedKeys || !keepRows) {
+        dfArenaFree(&arena);
+        return result;
+    }
 
     char rowBuf[1024];
     for (size_t r = 0; r < nRows; r++) {
@@ -969,26 +887,21 @@ DataFrame dfDropDuplicates_impl(const DataFrame* df, const size_t* subsetCols, s
         // hasKey check
         bool found = false;
         for (size_t i = 0; i < usedSize; i++) {
-            if (strcmp(usedKeys[i].key, rowBuf) == 0) {
+            if (strcmp(usedKeys[i], rowBuf) == 0) {
                 found = true;
                 break;
             }
         }
         if (!found) {
             // add key
-            if (usedSize >= usedCap) {
-                usedCap = (usedCap == 0) ? 64 : usedCap * 2;
-                usedKeys = (DeduKey*)realloc(usedKeys, usedCap * sizeof(DeduKey));
-            }
-            usedKeys[usedSize].key = strdup(rowBuf);
-            usedSize++;
+            usedKeys[usedSize++] = dfArenaStrdup(&arena, rowBuf);
 
             keepRows[keepCount++] = r;
         }
     }
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newS;
@@ -996,49 +909,12 @@ DataFrame dfDropDuplicates_impl(const DataFrame* df, const size_t* subsetCols, s
 
         for (size_t i = 0; i < keepCount; i++) {
             size_t oldRow = keepRows[i];
-            switch (s->type) {
-                case DF_INT: {
-                    int ival;
-                    if (seriesGetInt(s, oldRow, &ival)) {
-                        seriesAddInt(&newS, ival);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dval;
-                    if (seriesGetDouble(s, oldRow, &dval)) {
-                        seriesAddDouble(&newS, dval);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(s, oldRow, &str)) {
-                        seriesAddString(&newS, str);
-                        free(str);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, oldRow, &dtVal)) {
-                        seriesAddDateTime(&newS, dtVal);
-                    }
-                } break;
-            }
+            seriesAppendFrom(&newS, s, oldRow);
         }
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
-    }
-
-    for (size_t i = 0; i < usedSize; i++) {
-        free(usedKeys[i].key);
-    }
-    free(usedKeys);
-    free(keepRows);
-
-    if (usedAll) {
-        free((void*)subsetCols);
+        result.ops->addSeriesMove(&result, &newS);
     }
 
+    dfArenaFree(&arena);
     return result;
 }
 
@@ -1050,16 +926,17 @@ DataFrame dfDropDuplicates_impl(const DataFrame* df, const size_t* subsetCols, s
 
 DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     if (colIndex >= nCols) {
         return result;
     }
 
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) {
         return result;
     }
@@ -1070,7 +947,7 @@ DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex)
     DistItem* arr = NULL;
     size_t used = 0, cap = 0;
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
 
     for (size_t r = 0; r < nRows; r++) {
         char buf[128] = "";
@@ -1087,12 +964,12 @@ DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex)
                     snprintf(buf, sizeof(buf), "%g", dval);
                 }
             } break;
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(s, r, &str)) {
+            case DF_STRING:
+            case DF_CATEGORY: {
+                const char* str = NULL;
+                if (seriesGetStringView(s, r, &str, NULL)) {
                     strncpy(buf, str, sizeof(buf) - 1);
                     buf[sizeof(buf) - 1] = '\0';
-                    free(str);
                 }
             } break;
             /* NEW: DF_DATETIME => convert epoch to string */
@@ -1102,6 +979,9 @@ DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex)
                     snprintf(buf, sizeof(buf), "%lld", dtVal);
                 }
             } break;
+            default:
+                seriesFormatNumber(s, r, buf, sizeof(buf));
+                break;
         }
 
         if (buf[0] == '\0') {
@@ -1134,8 +1014,7 @@ DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex)
     for (size_t i = 0; i < used; i++) {
         seriesAddString(&newSeries, arr[i].val);
     }
-    result.addSeries(&result, &newSeries);
-    seriesFree(&newSeries);
+    result.ops->addSeriesMove(&result, &newSeries);
 
     // Cleanup
     for (size_t i = 0; i < used; i++) {
@@ -1152,12 +1031,13 @@ DataFrame dfUnique_impl(const DataFrame* df, size_t colIndex)
 
 DataFrame dfTranspose_impl(const DataFrame* df)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
 
     // We'll produce nRows columns in result
     for (size_t r = 0; r < nRows; r++) {
@@ -1171,7 +1051,7 @@ DataFrame dfTranspose_impl(const DataFrame* df)
 
         // fill col with nCols entries (all strings)
         for (size_t c = 0; c < nCols; c++) {
-            const Series* orig = df->getSeries(df, c);
+            const Series* orig = df->ops->getSeries(df, c);
             if (!orig) {
                 seriesAddString(&col, "???");
                 continue;
@@ -1184,7 +1064,7 @@ DataFrame dfTranspose_impl(const DataFrame* df)
                         snprintf(buf, sizeof(buf), "%d", v);
                         seriesAddString(&col, buf);
                     } else {
-                        seriesAddString(&col, "NA");
+                        seriesAddNull(&col);
                     }
                 } break;
                 case DF_DOUBLE: {
@@ -1194,16 +1074,16 @@ DataFrame dfTranspose_impl(const DataFrame* df)
                         snprintf(buf, sizeof(buf), "%g", d);
                         seriesAddString(&col, buf);
                     } else {
-                        seriesAddString(&col, "NA");
+                        seriesAddNull(&col);
                     }
                 } break;
-                case DF_STRING: {
-                    char* str = NULL;
-                    if (seriesGetString(orig, r, &str)) {
+                case DF_STRING:
+                case DF_CATEGORY: {
+                    const char* str = NULL;
+                    if (seriesGetStringView(orig, r, &str, NULL)) {
                         seriesAddString(&col, str);
-                        free(str);
                     } else {
-                        seriesAddString(&col, "NA");
+                        seriesAddNull(&col);
                     }
                 } break;
                 /* NEW: DF_DATETIME => convert to string, e.g. epoch */
@@ -1215,13 +1095,20 @@ DataFrame dfTranspose_impl(const DataFrame* df)
                         // or convert to human-readable date/time
                         seriesAddString(&col, buf);
                     } else {
-                        seriesAddString(&col, "NA");
+                        seriesAddNull(&col);
+                    }
+                } break;
+                default: {
+                    char buf[64];
+                    if (seriesFormatNumber(orig, r, buf, sizeof(buf))) {
+                        seriesAddString(&col, buf);
+                    } else {
+                        seriesAddNull(&col);
                     }
                 } break;
             }
         }
-        result.addSeries(&result, &col);
-        seriesFree(&col);
+        result.ops->addSeriesMove(&result, &col);
     }
     return result;
 }
@@ -1232,8 +1119,9 @@ DataFrame dfTranspose_impl(const DataFrame* df)
 
 size_t dfIndexOf_impl(const DataFrame* df, size_t colIndex, double value)
 {
+    DF_OP_SCOPE();
     if (!df) return (size_t)-1;
-    const Series* s = df->getSeries(df, colIndex);
+    const Series* s = df->ops->getSeries(df, colIndex);
     if (!s) return (size_t)-1;
 
     size_t n = seriesSize(s);
@@ -1282,35 +1170,36 @@ size_t dfIndexOf_impl(const DataFrame* df, size_t colIndex, double value)
 
 DataFrame dfApply_impl(const DataFrame* df, RowFunction func)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df || !func) return result;
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     for (size_t r = 0; r < nRows; r++) {
         func(&result, df, r);
     }
     return result;
 }
 
-DataFrame dfWhere_impl(const DataFrame* df, RowPredicate predicate, double defaultVal)
+/* Keep the cells of rows set in `keep`, put `defaultVal` in the others. */
+static DataFrame whereRows(const DataFrame* df, const DfMask* keep, double defaultVal)
 {
     DataFrame result;
     DataFrame_Create(&result);
-    if (!df || !predicate) return result;
 
-    size_t nRows = df->numRows(df);
-    size_t nCols = df->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newSeries;
         seriesInit(&newSeries, s->name, s->type);
 
         for (size_t r = 0; r < nRows; r++) {
-            bool cond = predicate(df, r);
+            bool cond = dfMaskGet(keep, r);
             if (cond) {
                 switch (s->type) {
                     case DF_INT: {
@@ -1329,11 +1218,11 @@ DataFrame dfWhere_impl(const DataFrame* df, RowPredicate predicate, double defau
                             seriesAddDouble(&newSeries, 0.0);
                         }
                     } break;
-                    case DF_STRING: {
-                        char* str = NULL;
-                        if (seriesGetString(s, r, &str)) {
+                    case DF_STRING:
+                    case DF_CATEGORY: {
+                        const char* str = NULL;
+                        if (seriesGetStringView(s, r, &str, NULL)) {
                             seriesAddString(&newSeries, str);
-                            free(str);
                         } else {
                             seriesAddString(&newSeries, "");
                         }
@@ -1348,6 +1237,14 @@ DataFrame dfWhere_impl(const DataFrame* df, RowPredicate predicate, double defau
                             seriesAddDateTime(&newSeries, 0LL);
                         }
                     } break;
+                    default:
+                        // other numeric types keep their own width
+                        if (!seriesIsNull(s, r)) {
+                            seriesAppendFrom(&newSeries, s, r);
+                        } else {
+                            seriesAddNumber(&newSeries, 0.0);
+                        }
+                        break;
                 }
             } else {
                 // set default
@@ -1359,22 +1256,56 @@ DataFrame dfWhere_impl(const DataFrame* df, RowPredicate predicate, double defau
                         seriesAddDouble(&newSeries, defaultVal);
                         break;
                     case DF_STRING:
+                    case DF_CATEGORY:
                         seriesAddString(&newSeries, "NA");
                         break;
                     /* NEW: DF_DATETIME => default to 0? or some sentinel? */
                     case DF_DATETIME:
                         seriesAddDateTime(&newSeries, (long long)defaultVal); 
                         break;
+                    default:
+                        seriesAddNumber(&newSeries, defaultVal);
+                        break;
                 }
             }
         }
-        result.addSeries(&result, &newSeries);
-        seriesFree(&newSeries);
+        result.ops->addSeriesMove(&result, &newSeries);
     }
 
     return result;
 }
 
+DataFrame dfWhere_impl(const DataFrame* df, RowPredicate predicate, double defaultVal)
+{
+    DF_OP_SCOPE();
+    // evaluate the predicate once per row, not once per cell
+    DfMask keep;
+    if (!df || !predicate || !dfMaskFromPredicate(df, predicate, &keep)) {
+        DataFrame result;
+        DataFrame_Create(&result);
+        return result;
+    }
+
+    DataFrame result = whereRows(df, &keep, defaultVal);
+    dfMaskFree(&keep);
+    return result;
+}
+
+DataFrame dfWhereMask_impl(const DataFrame* df, const DfMask* keep, double defaultVal)
+{
+    DF_OP_SCOPE();
+    if (!df || !keep || keep->length != df->ops->numRows(df)) {
+        if (df && keep) {
+            fprintf(stderr, "dfWhereMask_impl: mask has %zu rows, frame has %zu.\n",
+                    keep->length, df->ops->numRows(df));
+        }
+        DataFrame result;
+        DataFrame_Create(&result);
+        return result;
+    }
+    return whereRows(df, keep, defaultVal);
+}
+
 /**
  * dfExplode_impl:
  *   If colIndex is DF_STRING, we treat each cell as a comma-separated list => multiple rows.
@@ -1409,12 +1340,12 @@ static char* _cellToString(const Series* s, size_t rowIndex)
                 snprintf(buffer, sizeof(buffer), "%g", dv);
             }
         } break;
-        case DF_STRING: {
-            char* st = NULL;
-            if (seriesGetString(s, rowIndex, &st)) {
+        case DF_STRING:
+        case DF_CATEGORY: {
+            const char* st = NULL;
+            if (seriesGetStringView(s, rowIndex, &st, NULL)) {
                 strncpy(buffer, st, sizeof(buffer) - 1);
                 buffer[sizeof(buffer) - 1] = '\0';
-                free(st);
             }
         } break;
         /* NEW: DF_DATETIME => convert to string as epoch */
@@ -1424,6 +1355,9 @@ static char* _cellToString(const Series* s, size_t rowIndex)
                 snprintf(buffer, sizeof(buffer), "%lld", dtVal);
             }
         } break;
+        default:
+            seriesFormatNumber(s, rowIndex, buffer, sizeof(buffer));
+            break;
     }
     return strdup(buffer);
 }
@@ -1434,48 +1368,20 @@ static DataFrame copyEntireDF(const DataFrame* df)
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
 
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = df->getSeries(df, c);
+        const Series* s = df->ops->getSeries(df, c);
         if (!s) continue;
 
         Series newS;
         seriesInit(&newS, s->name, s->type);
 
         for (size_t r = 0; r < nRows; r++) {
-            switch (s->type) {
-                case DF_INT: {
-                    int val;
-                    if (seriesGetInt(s, r, &val)) {
-                        seriesAddInt(&newS, val);
-                    }
-                } break;
-                case DF_DOUBLE: {
-                    double dv;
-                    if (seriesGetDouble(s, r, &dv)) {
-                        seriesAddDouble(&newS, dv);
-                    }
-                } break;
-                case DF_STRING: {
-                    char* st = NULL;
-                    if (seriesGetString(s, r, &st)) {
-                        seriesAddString(&newS, st);
-                        free(st);
-                    }
-                } break;
-                /* NEW: DF_DATETIME */
-                case DF_DATETIME: {
-                    long long dtVal;
-                    if (seriesGetDateTime(s, r, &dtVal)) {
-                        seriesAddDateTime(&newS, dtVal);
-                    }
-                } break;
-            }
+            seriesAppendFrom(&newS, s, r);
         }
-        result.addSeries(&result, &newS);
-        seriesFree(&newS);
+        result.ops->addSeriesMove(&result, &newS);
     }
     return result;
 }
@@ -1490,28 +1396,29 @@ static DataFrame copyEntireDF(const DataFrame* df)
  */
 DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
+    size_t nCols = df->ops->numColumns(df);
     if (colIndex >= nCols) {
         // invalid => just copy entire DF
         return copyEntireDF(df);
     }
 
-    const Series* explodeSer = df->getSeries(df, colIndex);
+    const Series* explodeSer = df->ops->getSeries(df, colIndex);
     if (!explodeSer) {
         // no data => copy
         return copyEntireDF(df);
     }
     // If explode column isn't string, no explosion
-    if (explodeSer->type != DF_STRING) {
+    if (explodeSer->type != DF_STRING && explodeSer->type != DF_CATEGORY) {
         return copyEntireDF(df);
     }
 
     // We'll store an array of ExplodeRow for each row in df.
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
     ExplodeRow* rows = (ExplodeRow*)calloc(nRows, sizeof(ExplodeRow));
 
     // First pass: read each original row => gather "otherCols" and parse the explode col
@@ -1524,7 +1431,7 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
                 continue;
             }
             // Convert cell to string
-            const Series* s = df->getSeries(df, c);
+            const Series* s = df->ops->getSeries(df, c);
             rows[r].otherCols[c] = _cellToString(s, r);
         }
 
@@ -1568,7 +1475,7 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
     // The exploded column => DF_STRING, others => same as original
     Series* outCols = (Series*)calloc(nCols, sizeof(Series));
     for (size_t c = 0; c < nCols; c++) {
-        const Series* orig = df->getSeries(df, c);
+        const Series* orig = df->ops->getSeries(df, c);
         if (!orig) {
             seriesInit(&outCols[c], "unknown", DF_STRING);
             continue;
@@ -1593,7 +1500,7 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
                     seriesAddString(&outCols[c], rows[r].subItems[s]);
                 } else {
                     // parse rows[r].otherCols[c] back to the original type
-                    const Series* orig = df->getSeries(df, c);
+                    const Series* orig = df->ops->getSeries(df, c);
                     if (!orig) {
                         // fallback
                         if (outCols[c].type == DF_STRING) {
@@ -1603,7 +1510,7 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
                         } else if (outCols[c].type == DF_DATETIME) {
                             seriesAddDateTime(&outCols[c], 0LL);
                         } else {
-                            seriesAddDouble(&outCols[c], 0.0);
+                            seriesAddNumber(&outCols[c], 0.0);
                         }
                         continue;
                     }
@@ -1620,7 +1527,8 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
                             double vd = atof(cellStr);
                             seriesAddDouble(&outCols[c], vd);
                         } break;
-                        case DF_STRING: {
+                        case DF_STRING:
+                        case DF_CATEGORY: {
                             seriesAddString(&outCols[c], cellStr);
                         } break;
                         /* NEW: DF_DATETIME => parse the string as a 64-bit epoch */
@@ -1628,6 +1536,9 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
                             long long dtVal = atoll(cellStr);
                             seriesAddDateTime(&outCols[c], dtVal);
                         } break;
+                        default:
+                            seriesAddNumber(&outCols[c], strtod(cellStr, NULL));
+                            break;
                     }
                 }
             }
@@ -1636,8 +1547,7 @@ DataFrame dfExplode_impl(const DataFrame* df, size_t colIndex)
 
     // Attach outCols to result
     for (size_t c = 0; c < nCols; c++) {
-        result.addSeries(&result, &outCols[c]);
-        seriesFree(&outCols[c]);
+        result.ops->addSeriesMove(&result, &outCols[c]);
     }
     free(outCols);
 
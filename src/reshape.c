@@ -4,50 +4,28 @@
 #include <string.h>
 #include <stdbool.h>
 #include "dataframe.h"
+#include "dfalloc.h"
 
 /* -------------------------------------------------------------------------
  * Pivot / Melt
  * ------------------------------------------------------------------------- */
 
 /**
- * @brief pivotAddIndexKey
- *  Manages a dynamic array of indexKeys. If 'key' not present, add it.
+ * @brief pivotAddKey
+ *  Adds 'key' to a distinct-keys array (index or column keys) if not present.
+ *  The array has room for one key per row; the strings live in the arena.
  */
-static void pivotAddIndexKey(char*** indexKeys, size_t* iCount, size_t* iCap, const char* key)
+static void pivotAddKey(DfArena* arena, char** keys, size_t* count, const char* key)
 {
     // linear search
-    for (size_t i = 0; i < *iCount; i++) {
-        if (strcmp((*indexKeys)[i], key) == 0) {
+    for (size_t i = 0; i < *count; i++) {
+        if (strcmp(keys[i], key) == 0) {
             return; // already present
         }
     }
     // not found -> append
-    if (*iCount >= *iCap) {
-        *iCap = (*iCap == 0) ? 8 : (*iCap * 2);
-        *indexKeys = (char**)realloc(*indexKeys, (*iCap) * sizeof(char*));
-    }
-    (*indexKeys)[*iCount] = strdup(key);
-    (*iCount)++;
-}
-
-/**
- * @brief pivotAddColKey
- *  Similar for the "columns" keys array.
- */
-static void pivotAddColKey(char*** colKeys, size_t* cCount, size_t* cCap, const char* key)
-{
-    // linear search
-    for (size_t i = 0; i < *cCount; i++) {
-        if (strcmp((*colKeys)[i], key) == 0) {
-            return;
-        }
-    }
-    if (*cCount >= *cCap) {
-        *cCap = (*cCap == 0) ? 8 : (*cCap * 2);
-        *colKeys = (char**)realloc(*colKeys, (*cCap) * sizeof(char*));
-    }
-    (*colKeys)[*cCount] = strdup(key);
-    (*cCount)++;
+    keys[*count] = dfArenaStrdup(arena, key);
+    (*count)++;
 }
 
 /**
@@ -61,18 +39,14 @@ typedef struct {
 
 /**
  * @brief pivotPush
- *  Append a new (idx,col,val) triple to pivotData array
+ *  Append a new (idx,col,val) triple to pivotData array (one slot per row)
  */
-static void pivotPush(PivotItem** pivotData, size_t* pUsed, size_t* pCap, 
+static void pivotPush(DfArena* arena, PivotItem* pivotData, size_t* pUsed,
                       const char* iK, const char* cK, const char* vK)
 {
-    if (*pUsed >= *pCap) {
-        *pCap = (*pCap == 0) ? 64 : (*pCap * 2);
-        *pivotData = (PivotItem*)realloc(*pivotData, (*pCap) * sizeof(PivotItem));
-    }
-    (*pivotData)[*pUsed].idx = strdup(iK);
-    (*pivotData)[*pUsed].col = strdup(cK);
-    (*pivotData)[*pUsed].val = strdup(vK);
+    pivotData[*pUsed].idx = dfArenaStrdup(arena, iK);
+    pivotData[*pUsed].col = dfArenaStrdup(arena, cK);
+    pivotData[*pUsed].val = dfArenaStrdup(arena, vK);
     (*pUsed)++;
 }
 
@@ -98,7 +72,8 @@ static void pivotCellToString(const Series* s, size_t rowIndex, char* buf, size_
                 snprintf(buf, bufSize, "%g", dval);
             }
         } break;
-        case DF_STRING: {
+        case DF_STRING:
+        case DF_CATEGORY: {
             char* str = NULL;
             if (seriesGetString(s, rowIndex, &str)) {
                 strncpy(buf, str, bufSize - 1);
@@ -114,6 +89,9 @@ static void pivotCellToString(const Series* s, size_t rowIndex, char* buf, size_
                 // Or convert to something like YYYY-MM-DD
             }
         } break;
+        default:
+            seriesFormatNumber(s, rowIndex, buf, bufSize);
+            break;
     }
 }
 
@@ -124,46 +102,56 @@ static void pivotCellToString(const Series* s, size_t rowIndex, char* buf, size_
 */
 DataFrame dfPivot_impl(const DataFrame* df, size_t indexCol, size_t columnsCol, size_t valuesCol)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nC = df->numColumns(df);
+    size_t nC = df->ops->numColumns(df);
     if (indexCol >= nC || columnsCol >= nC || valuesCol >= nC) {
         // invalid indexes => return empty
         return result;
     }
 
-    const Series* idxS = df->getSeries(df, indexCol);
-    const Series* colS = df->getSeries(df, columnsCol);
-    const Series* valS = df->getSeries(df, valuesCol);
+    const Series* idxS = df->ops->getSeries(df, indexCol);
+    const Series* colS = df->ops->getSeries(df, columnsCol);
+    const Series* valS = df->ops->getSeries(df, valuesCol);
     if (!idxS || !colS || !valS) {
         // any missing => return empty
         return result;
     }
 
-    size_t nRows = df->numRows(df);
+    size_t nRows = df->ops->numRows(df);
+
+    // scratch keys and triples come from one arena, freed together at the end
+    DfArena arena;
+    dfArenaInit(&arena, 0);
 
     // 1) gather distinct index keys, distinct column keys
-    char** indexKeys = NULL;
-    size_t iCount = 0, iCap = 0;
+    char** indexKeys = (char**)dfArenaAlloc(&arena, nRows * sizeof(char*));
+    size_t iCount = 0;
 
-    char** colKeys = NULL;
-    size_t cCount = 0, cCap = 0;
+    char** colKeys = (char**)dfArenaAlloc(&arena, nRows * sizeof(char*));
+    size_t cCount = 0;
 
     // 2) pivotData = array of (idx,col,val)
-    PivotItem* pData = NULL;
-    size_t pUsed = 0, pCap2 = 0;
+    PivotItem* pData = (PivotItem*)dfArenaAlloc(&arena, nRows * sizeof(PivotItem));
+    size_t pUsed = 0;
+
+    if (!indexKeys || !colKeys || !pData) {
+        dfArenaFree(&arena);
+        return result;
+    }
 
     char bufIdx[128], bufCol[128], bufVal[128];
 
     // read each row once for index & col keys
     for (size_t r = 0; r < nRows; r++) {
         pivotCellToString(idxS, r, bufIdx, sizeof(bufIdx));
-        pivotAddIndexKey(&indexKeys, &iCount, &iCap, bufIdx);
+        pivotAddKey(&arena, indexKeys, &iCount, bufIdx);
 
         pivotCellToString(colS, r, bufCol, sizeof(bufCol));
-        pivotAddColKey(&colKeys, &cCount, &cCap, bufCol);
+        pivotAddKey(&arena, colKeys, &cCount, bufCol);
     }
 
     // read again, building pivotData
@@ -171,7 +159,7 @@ DataFrame dfPivot_impl(const DataFrame* df, size_t indexCol, size_t columnsCol,
         pivotCellToString(idxS, r, bufIdx, sizeof(bufIdx));
         pivotCellToString(colS, r, bufCol, sizeof(bufCol));
         pivotCellToString(valS, r, bufVal, sizeof(bufVal));
-        pivotPush(&pData, &pUsed, &pCap2, bufIdx, bufCol, bufVal);
+        pivotPush(&arena, pData, &pUsed, bufIdx, bufCol, bufVal);
     }
 
     // 3) Build the result with 1 + cCount columns => "index", then each colKey as DF_STRING
@@ -211,33 +199,15 @@ DataFrame dfPivot_impl(const DataFrame* df, size_t indexCol, size_t columnsCol,
     }
 
     // attach them to result
-    result.addSeries(&result, &indexSeries);
-    seriesFree(&indexSeries);
+    result.ops->addSeriesMove(&result, &indexSeries);
 
     for (size_t j = 0; j < cCount; j++) {
-        result.addSeries(&result, &pivotCols[j]);
-        seriesFree(&pivotCols[j]);
+        result.ops->addSeriesMove(&result, &pivotCols[j]);
     }
     free(pivotCols);
 
-    // free arrays
-    for (size_t i = 0; i < iCount; i++) {
-        free(indexKeys[i]);
-    }
-    free(indexKeys);
-
-    for (size_t j = 0; j < cCount; j++) {
-        free(colKeys[j]);
-    }
-    free(colKeys);
-
-    // free pData
-    for (size_t p = 0; p < pUsed; p++) {
-        free(pData[p].idx);
-        free(pData[p].col);
-        free(pData[p].val);
-    }
-    free(pData);
+    // keys and pData go away with the arena
+    dfArenaFree(&arena);
 
     return result;
 }
@@ -285,7 +255,8 @@ static void cellToString(const Series* s, size_t rowIndex, char* buf, size_t buf
                 snprintf(buf, bufSize, "%g", d);
             }
         } break;
-        case DF_STRING: {
+        case DF_STRING:
+        case DF_CATEGORY: {
             char* st = NULL;
             if (seriesGetString(s, rowIndex, &st)) {
                 strncpy(buf, st, bufSize - 1);
@@ -300,6 +271,9 @@ static void cellToString(const Series* s, size_t rowIndex, char* buf, size_t buf
                 snprintf(buf, bufSize, "%lld", dtVal);
             }
         } break;
+        default:
+            seriesFormatNumber(s, rowIndex, buf, bufSize);
+            break;
     }
 }
 
@@ -312,12 +286,13 @@ static void cellToString(const Series* s, size_t rowIndex, char* buf, size_t buf
  */
 DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount)
 {
+    DF_OP_SCOPE();
     DataFrame result;
     DataFrame_Create(&result);
     if (!df) return result;
 
-    size_t nCols = df->numColumns(df);
-    size_t nRows = df->numRows(df);
+    size_t nCols = df->ops->numColumns(df);
+    size_t nRows = df->ops->numRows(df);
     if (nCols == 0 || nRows == 0) {
         return result;  // empty or no data => result also empty
     }
@@ -334,7 +309,7 @@ DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount)
     // Create an array of Series for the ID columns (same type as original)
     Series* outIdSeries = (Series*)calloc(idCount, sizeof(Series));
     for (size_t i = 0; i < idCount; i++) {
-        const Series* s = df->getSeries(df, idCols[i]);
+        const Series* s = df->ops->getSeries(df, idCols[i]);
         if (s) {
             seriesInit(&outIdSeries[i], s->name, s->type);
         } else {
@@ -352,19 +327,21 @@ DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount)
     for (size_t r = 0; r < nRows; r++) {
         for (size_t vc = 0; vc < valCount; vc++) {
             size_t realCol = valCols[vc];
-            const Series* meltS = df->getSeries(df, realCol);
+            const Series* meltS = df->ops->getSeries(df, realCol);
             if (!meltS) continue;
 
             // A) For each ID column, copy the row's data to outIdSeries[i]
             for (size_t i = 0; i < idCount; i++) {
-                const Series* idSer = df->getSeries(df, idCols[i]);
+                const Series* idSer = df->ops->getSeries(df, idCols[i]);
                 if (!idSer) {
                     // fallback
                     switch (outIdSeries[i].type) {
                         case DF_INT:    seriesAddInt(&outIdSeries[i], 0);    break;
                         case DF_DOUBLE: seriesAddDouble(&outIdSeries[i], 0); break;
-                        case DF_STRING: seriesAddString(&outIdSeries[i], ""); break;
+                        case DF_STRING:
+                        case DF_CATEGORY: seriesAddString(&outIdSeries[i], ""); break;
                         case DF_DATETIME: seriesAddDateTime(&outIdSeries[i], 0LL); break;
+                        default: seriesAddNumber(&outIdSeries[i], 0.0); break;
                     }
                     continue;
                 }
@@ -387,7 +364,8 @@ DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount)
                             seriesAddDouble(&outIdSeries[i], 0.0);
                         }
                     } break;
-                    case DF_STRING: {
+                    case DF_STRING:
+                    case DF_CATEGORY: {
                         char* st = NULL;
                         if (seriesGetString(idSer, r, &st)) {
                             seriesAddString(&outIdSeries[i], st);
@@ -405,6 +383,14 @@ DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount)
                             seriesAddDateTime(&outIdSeries[i], 0LL);
                         }
                     } break;
+                    default:
+                        // other numeric types keep their own width
+                        if (!seriesIsNull(idSer, r)) {
+                            seriesAppendFrom(&outIdSeries[i], idSer, r);
+                        } else {
+                            seriesAddNumber(&outIdSeries[i], 0.0);
+                        }
+                        break;
                 }
             }
 
@@ -420,16 +406,13 @@ DataFrame dfMelt_impl(const DataFrame* df, const size_t* idCols, size_t idCount)
 
     // Attach ID columns to result
     for (size_t i = 0; i < idCount; i++) {
-        result.addSeries(&result, &outIdSeries[i]);
-        seriesFree(&outIdSeries[i]);
+        result.ops->addSeriesMove(&result, &outIdSeries[i]);
     }
     free(outIdSeries);
 
     // Attach variable/value
-    result.addSeries(&result, &varSeries);
-    result.addSeries(&result, &valSeries);
-    seriesFree(&varSeries);
-    seriesFree(&valSeries);
+    result.ops->addSeriesMove(&result, &varSeries);
+    result.ops->addSeriesMove(&result, &valSeries);
 
     free(valCols);
     return result;
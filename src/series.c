@@ -2,9 +2,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <inttypes.h>  // for PRId64 or similar if you want printing macros
 
 #include "series.h"  // The new series header
+#include "dfalloc.h"
+
+/*
+ * Random-access gathers stall on cache misses, not arithmetic: touch the
+ * value SERIES_PREFETCH_DISTANCE rows ahead so its line is on the way by
+ * the time the loop gets there.
+ */
+#define SERIES_PREFETCH_DISTANCE 16
+#if defined(__GNUC__) || defined(__clang__)
+#define SERIES_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define SERIES_PREFETCH(addr) ((void)0)
+#endif
 
 static char* safeStrdup(const char* src) {
     if (!src) return NULL;
@@ -15,20 +29,708 @@ static char* safeStrdup(const char* src) {
     return copy;
 }
 
+/* ---------------------------------------------------------------------------
+ * Typed value buffer helpers
+ * --------------------------------------------------------------------------- */
+
+/* Size in bytes of one element in the typed buffer. */
+static size_t seriesElementSize(const Series* s)
+{
+    switch (s->type) {
+        case DF_INT:      return sizeof(int);
+        case DF_DOUBLE:   return sizeof(double);
+        case DF_DATETIME: return sizeof(long long);
+        case DF_STRING:   return sizeof(uint64_t);   // offsets
+        case DF_CATEGORY: return s->codeWidth;       // codes
+        case DF_INT8:     return sizeof(int8_t);
+        case DF_INT16:    return sizeof(int16_t);
+        case DF_INT64:    return sizeof(int64_t);
+        case DF_UINT8:    return sizeof(uint8_t);
+        case DF_UINT16:   return sizeof(uint16_t);
+        case DF_UINT32:   return sizeof(uint32_t);
+        case DF_UINT64:   return sizeof(uint64_t);
+        case DF_FLOAT:    return sizeof(float);
+    }
+    return 0;
+}
+
+/*
+ * Sizes of the owned buffers as requested from the allocator hook (which
+ * gets them back on release).
+ */
+static size_t valuesAllocSize(size_t capacity, size_t elemSize)
+{
+    size_t bytes = capacity * elemSize;
+    return (bytes + SERIES_ALIGNMENT - 1) / SERIES_ALIGNMENT * SERIES_ALIGNMENT;
+}
+
+static size_t validityAllocSize(size_t capacity)
+{
+    return SERIES_VALIDITY_WORDS(capacity ? capacity : 1) * sizeof(uint64_t);
+}
+
+static void storageSync(Series* s);
+
+/*
+ * Make sure the value buffer can hold at least `minCapacity` elements.
+ * Capacity grows geometrically; the buffer is always SERIES_ALIGNMENT-aligned
+ * (aligned_alloc wants a size that is a multiple of the alignment).
+ */
+static bool seriesGrow(Series* s, size_t minCapacity)
+{
+    if (minCapacity <= s->capacity) return true;
+
+    size_t elemSize = seriesElementSize(s);
+    size_t newCap = s->capacity ? s->capacity : 8;
+    while (newCap < minCapacity) {
+        newCap *= 2;
+    }
+
+    void* buf = dfMemAlloc(valuesAllocSize(newCap, elemSize), SERIES_ALIGNMENT);
+    if (!buf) return false;
+
+    // a validity bitmap grows with the values; new rows start out valid
+    uint64_t* bits = NULL;
+    if (s->validity) {
+        size_t oldSize = validityAllocSize(s->capacity);
+        size_t newSize = validityAllocSize(newCap);
+        bits = (uint64_t*)dfMemAlloc(newSize, sizeof(uint64_t));
+        if (!bits) {
+            dfMemFree(buf, valuesAllocSize(newCap, elemSize));
+            return false;
+        }
+        memcpy(bits, s->validity, oldSize);
+        memset((char*)bits + oldSize, 0xFF, newSize - oldSize);
+        dfMemFree(s->validity, oldSize);
+        s->validity = bits;
+    }
+
+    if (s->values) {
+        // DF_STRING keeps one extra slot: the end offset of the last string
+        size_t used = s->length + (s->type == DF_STRING ? 1 : 0);
+        memcpy(buf, s->values, used * elemSize);
+        dfMemFree(s->values, valuesAllocSize(s->capacity, elemSize));
+    }
+    s->values = buf;
+    s->capacity = newCap;
+    storageSync(s);
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Chunked storage
+ * --------------------------------------------------------------------------- */
+
+struct SeriesChunks {
+    Series* items;      // the chunks, each an ordinary contiguous Series
+    size_t* starts;     // starts[k] = first row of chunk k, starts[count] = length
+    size_t  count;
+    size_t  cap;
+    size_t  chunkRows;  // capacity of a newly started tail chunk
+};
+
+/*
+ * Chunk holding row `*index` of a chunked Series (index < length); *index
+ * becomes the row within that chunk. Appends and scans mostly hit the tail,
+ * so it is checked before the binary search.
+ */
+static Series* chunkAt(const Series* s, size_t* index)
+{
+    const SeriesChunks* c = s->chunks;
+    size_t lo = 0, hi = c->count - 1;
+    if (*index >= c->starts[hi]) {
+        lo = hi;
+    } else {
+        // last chunk whose first row is <= index (skips empty chunks)
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo + 1) / 2;
+            if (c->starts[mid] <= *index) lo = mid;
+            else hi = mid - 1;
+        }
+    }
+    *index -= c->starts[lo];
+    return &c->items[lo];
+}
+
+/* A chunked Series reads row `index` from the chunk that holds it. */
+#define CHUNK_READ(s, index)                                                  \
+    do {                                                                      \
+        if ((s)->chunks) (s) = chunkAt((s), &(index));                        \
+    } while (0)
+
+/*
+ * A chunked Series writes through the chunk that holds row `index`: CALL
+ * runs on `chunk_` / `row_` and its change in nulls is folded into `s`.
+ */
+#define CHUNK_WRITE(s, index, CALL)                                           \
+    do {                                                                      \
+        if ((s)->chunks) {                                                    \
+            size_t row_ = (index);                                            \
+            Series* chunk_ = chunkAt((s), &row_);                             \
+            size_t nulls_ = chunk_->nullCount;                                \
+            bool ok_ = (CALL);                                                \
+            (s)->nullCount = (s)->nullCount - nulls_ + chunk_->nullCount;     \
+            return ok_;                                                       \
+        }                                                                     \
+    } while (0)
+
+static Series* chunkTail(Series* s);
+static void chunkGrew(Series* s, const Series* chunk, size_t oldLength, size_t oldNulls);
+static void chunkedCopy(const Series* src, Series* dst);
+static void chunkedShare(const Series* src, Series* dst);
+static void chunkedSlice(const Series* src, size_t start, size_t count, Series* dst);
+static void chunkedFree(Series* s);
+
+/* A chunked Series appends to its tail chunk only: CALL runs on `chunk_`. */
+#define CHUNK_APPEND(s, CALL)                                                 \
+    do {                                                                      \
+        if ((s)->chunks) {                                                    \
+            Series* chunk_ = chunkTail(s);                                    \
+            if (chunk_) {                                                     \
+                size_t len_ = chunk_->length, nulls_ = chunk_->nullCount;     \
+                CALL;                                                         \
+                chunkGrew((s), chunk_, len_, nulls_);                         \
+            }                                                                 \
+            return;                                                           \
+        }                                                                     \
+    } while (0)
+
+/* ---------------------------------------------------------------------------
+ * Validity bitmap helpers
+ * --------------------------------------------------------------------------- */
+
+/* Row `index` of a row view is bit `offset + index` of the shared bitmap. */
+static inline bool isNullAt(const Series* s, size_t index)
+{
+    if (s->chunks) {
+        const Series* chunk = chunkAt(s, &index);
+        return isNullAt(chunk, index);
+    }
+    size_t bit = s->offset + index;
+    return s->validity && !((s->validity[bit >> 6] >> (bit & 63)) & 1ULL);
+}
+
+/*
+ * Validity of rows [64 * w, 64 * w + 64) as one word, bit 0 = first row,
+ * realigned for row views. Bits past the last row read as valid.
+ */
+static uint64_t validityWord(const Series* s, size_t w)
+{
+    size_t first = w * 64;
+    if (!s->validity || first >= s->length) return ~0ULL;
+
+    size_t bit = s->offset + first;
+    size_t shift = bit & 63;
+    uint64_t word = s->validity[bit >> 6] >> shift;
+    size_t lastBit = s->offset + s->length - 1;
+    if (shift && (bit >> 6) < (lastBit >> 6)) {
+        word |= s->validity[(bit >> 6) + 1] << (64 - shift);
+    }
+    size_t rows = s->length - first;
+    if (rows < 64) {
+        word |= ~0ULL << rows;
+    }
+    return word;
+}
+
+/* Number of null rows in the validity bitmap of `s` (rows 0 .. length-1). */
+static size_t countNulls(const Series* s)
+{
+    if (!s->validity) return 0;
+    size_t nulls = 0;
+    for (size_t w = 0; w < SERIES_VALIDITY_WORDS(s->length); w++) {
+        uint64_t missing = ~validityWord(s, w);
+        while (missing) {
+            missing &= missing - 1;
+            nulls++;
+        }
+    }
+    return nulls;
+}
+
+/* Allocate the (all-valid) bitmap the first time a null shows up. */
+static bool seriesEnsureValidity(Series* s)
+{
+    if (s->validity) return true;
+    size_t size = validityAllocSize(s->capacity);
+    s->validity = (uint64_t*)dfMemAlloc(size, sizeof(uint64_t));
+    if (!s->validity) return false;
+    memset(s->validity, 0xFF, size);
+    storageSync(s);
+    return true;
+}
+
+/* A write at `index` makes the row valid again. */
+static inline void markValid(Series* s, size_t index)
+{
+    if (isNullAt(s, index)) {
+        size_t bit = s->offset + index;
+        s->validity[bit >> 6] |= (1ULL << (bit & 63));
+        s->nullCount--;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Copy-on-write sharing
+ * --------------------------------------------------------------------------- */
+
+/*
+ * Created with the first buffer of a Series and kept in step whenever its
+ * owner reallocates (which only happens while it is the sole user), so
+ * seriesShare never writes anything but the atomic reference count: read-
+ * only calls on a const Series may run on several threads at once.
+ */
+struct SeriesShared {
+    atomic_size_t refCount;   // number of Series using the buffers
+    size_t capacity;          // element capacity of the shared value buffer
+    size_t valuesSize;        // allocation sizes, for the allocator hook
+    size_t bytesSize;
+    size_t validitySize;
+};
+
+/* Start of the value allocation (a row view's `values` points `offset` rows in). */
+static inline void* valuesBase(const Series* s)
+{
+    return s->values ? (char*)s->values - s->offset * seriesElementSize(s) : NULL;
+}
+
+/*
+ * Record the current buffers of a sole owner in its storage block, creating
+ * the block with the first buffer. Without a block (out of memory) the
+ * Series is still valid; seriesShare then falls back to a copy.
+ */
+static void storageSync(Series* s)
+{
+    if (!s->shared) {
+        s->shared = (SeriesShared*)dfMalloc(sizeof(SeriesShared));
+        if (!s->shared) return;
+        atomic_init(&s->shared->refCount, 1);
+    }
+    s->shared->capacity = s->capacity;
+    s->shared->valuesSize = s->values ? valuesAllocSize(s->capacity, seriesElementSize(s)) : 0;
+    s->shared->bytesSize = s->bytes ? s->bytesCapacity : 0;
+    s->shared->validitySize = s->validity ? validityAllocSize(s->capacity) : 0;
+}
+
+/* Drop one reference to shared storage; the last user frees it. */
+static void releaseShared(Series* s)
+{
+    if (atomic_fetch_sub_explicit(&s->shared->refCount, 1, memory_order_acq_rel) == 1) {
+        dfMemFree(valuesBase(s), s->shared->valuesSize);
+        dfMemFree(s->bytes, s->shared->bytesSize);
+        dfMemFree(s->validity, s->shared->validitySize);
+        dfFree(s->shared);
+    }
+    s->shared = NULL;
+}
+
+/*
+ * Give `s` its own buffers before a write: a no-op for an unshared Series,
+ * otherwise values / bytes / validity are copied (a row view keeps just its
+ * rows, re-based to offset 0) and the shared reference is dropped.
+ */
+static bool seriesDetach(Series* s)
+{
+    if (!s->shared) return true;
+    if (atomic_load_explicit(&s->shared->refCount, memory_order_acquire) == 1 &&
+        s->offset == 0 && s->capacity == s->shared->capacity) {
+        return true;   // sole owner of the whole buffer
+    }
+
+    void* values = NULL;
+    char* bytes = NULL;
+    uint64_t* validity = NULL;
+    // DF_STRING needs length + 1 offset slots
+    size_t used = s->length + (s->type == DF_STRING ? 1 : 0);
+    size_t capacity = s->capacity > used ? s->capacity : used;
+    size_t elemSize = seriesElementSize(s);
+
+    if (s->values) {
+        values = dfMemAlloc(valuesAllocSize(capacity, elemSize), SERIES_ALIGNMENT);
+        if (!values) return false;
+        memcpy(values, s->values, used * elemSize);
+    }
+    if (s->bytes) {
+        // string offsets stay absolute, so the arena is copied whole
+        bytes = (char*)dfMemAlloc(s->bytesCapacity, 1);
+        if (!bytes) {
+            dfMemFree(values, valuesAllocSize(capacity, elemSize));
+            return false;
+        }
+        memcpy(bytes, s->bytes, s->bytesUsed);
+    }
+    if (s->validity) {
+        size_t words = validityAllocSize(capacity) / sizeof(uint64_t);
+        validity = (uint64_t*)dfMemAlloc(words * sizeof(uint64_t), sizeof(uint64_t));
+        if (!validity) {
+            dfMemFree(values, valuesAllocSize(capacity, elemSize));
+            dfMemFree(bytes, s->bytesCapacity);
+            return false;
+        }
+        for (size_t w = 0; w < words; w++) {
+            validity[w] = validityWord(s, w);
+        }
+    }
+
+    releaseShared(s);
+    s->values = values;
+    s->bytes = bytes;
+    s->validity = validity;
+    s->offset = 0;
+    s->capacity = capacity;
+    storageSync(s);
+    return true;
+}
+
+/* Append one element (elemSize bytes at `src`) to the typed buffer. */
+static void seriesPushValue(Series* s, const void* src)
+{
+    CHUNK_APPEND(s, seriesPushValue(chunk_, src));
+    size_t elemSize = seriesElementSize(s);
+    if (!seriesDetach(s) || !seriesGrow(s, s->length + 1)) return;
+    memcpy((char*)s->values + s->length * elemSize, src, elemSize);
+    s->length++;
+}
+
+/* Append `n` elements (n * elemSize bytes at `src`) with one copy per chunk. */
+static bool seriesPushValues(Series* s, const void* src, size_t n)
+{
+    size_t elemSize = seriesElementSize(s);
+    const char* p = (const char*)src;
+    if (s->chunks) {
+        while (n > 0) {
+            Series* tail = chunkTail(s);
+            if (!tail) return false;
+            size_t room = s->chunks->chunkRows - tail->length;
+            size_t take = (n < room) ? n : room;
+            size_t len = tail->length, nulls = tail->nullCount;
+            bool ok = seriesPushValues(tail, p, take);
+            chunkGrew(s, tail, len, nulls);
+            if (!ok) return false;
+            p += take * elemSize;
+            n -= take;
+        }
+        return true;
+    }
+    if (n == 0) return true;
+    if (!seriesDetach(s) || !seriesGrow(s, s->length + n)) return false;
+    // rows past `length` are always marked valid, so the bitmap needs no update
+    memcpy((char*)s->values + s->length * elemSize, p, n * elemSize);
+    s->length += n;
+    return true;
+}
+
+/* Make sure the string arena can hold at least `minBytes` bytes. */
+static bool seriesGrowBytes(Series* s, size_t minBytes)
+{
+    if (minBytes <= s->bytesCapacity) return true;
+
+    size_t newCap = s->bytesCapacity ? s->bytesCapacity : 64;
+    while (newCap < minBytes) {
+        newCap *= 2;
+    }
+    char* buf = (char*)dfMemAlloc(newCap, 1);
+    if (!buf) return false;
+    if (s->bytes) {
+        memcpy(buf, s->bytes, s->bytesUsed);
+        dfMemFree(s->bytes, s->bytesCapacity);
+    }
+    s->bytes = buf;
+    s->bytesCapacity = newCap;
+    storageSync(s);
+    return true;
+}
+
+/* Offsets array of a DF_STRING Series (length + 1 entries once non-empty). */
+static inline uint64_t* stringOffsets(const Series* s)
+{
+    return (uint64_t*)s->values;
+}
+
+/* ---------------------------------------------------------------------------
+ * DF_CATEGORY: shared dictionary + packed codes
+ * --------------------------------------------------------------------------- */
+
+struct SeriesDictionary {
+    Series    labels;     // DF_STRING; label i has code i
+    uint32_t* slots;      // open addressing index: code + 1, 0 = empty
+    size_t    slotCount;  // power of two
+    atomic_size_t refCount;
+};
+
+static uint64_t hashBytes(const char* str, size_t len)
+{
+    // FNV-1a
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)str[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static SeriesDictionary* dictCreate(void)
+{
+    SeriesDictionary* d = (SeriesDictionary*)dfCalloc(1, sizeof(SeriesDictionary));
+    if (!d) return NULL;
+    seriesInit(&d->labels, "labels", DF_STRING);
+    d->slotCount = 16;
+    d->slots = (uint32_t*)dfCalloc(d->slotCount, sizeof(uint32_t));
+    atomic_init(&d->refCount, 1);
+    return d;
+}
+
+/* Another Series uses `d`; may run concurrently with other retains. */
+static SeriesDictionary* dictRetain(SeriesDictionary* d)
+{
+    atomic_fetch_add_explicit(&d->refCount, 1, memory_order_relaxed);
+    return d;
+}
+
+static void dictRelease(SeriesDictionary* d)
+{
+    if (!d || atomic_fetch_sub_explicit(&d->refCount, 1, memory_order_acq_rel) > 1) return;
+    seriesFree(&d->labels);
+    dfFree(d->slots);
+    dfFree(d);
+}
+
+/* Slot index where `str` lives, or the empty slot where it would go. */
+static size_t dictProbe(const SeriesDictionary* d, const char* str, size_t len)
+{
+    size_t mask = d->slotCount - 1;
+    size_t i = (size_t)hashBytes(str, len) & mask;
+    while (d->slots[i] != 0) {
+        const char* label = NULL;
+        size_t labelLen = 0;
+        seriesGetStringView(&d->labels, d->slots[i] - 1, &label, &labelLen);
+        if (labelLen == len && memcmp(label, str, len) == 0) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static bool dictRehash(SeriesDictionary* d, size_t newSlotCount)
+{
+    uint32_t* slots = (uint32_t*)dfCalloc(newSlotCount, sizeof(uint32_t));
+    if (!slots) return false;
+    dfFree(d->slots);
+    d->slots = slots;
+    d->slotCount = newSlotCount;
+
+    for (size_t code = 0; code < seriesSize(&d->labels); code++) {
+        const char* label = NULL;
+        size_t len = 0;
+        seriesGetStringView(&d->labels, code, &label, &len);
+        d->slots[dictProbe(d, label, len)] = (uint32_t)code + 1;
+    }
+    return true;
+}
+
+/* Code for `str`, adding it as a new label if needed. */
+static bool dictIntern(SeriesDictionary* d, const char* str, uint32_t* outCode)
+{
+    size_t len = strlen(str);
+    size_t slot = dictProbe(d, str, len);
+    if (d->slots[slot] != 0) {
+        *outCode = d->slots[slot] - 1;
+        return true;
+    }
+
+    size_t code = seriesSize(&d->labels);
+    if (code >= UINT32_MAX) return false;
+    seriesAddString(&d->labels, str);
+    d->slots[slot] = (uint32_t)code + 1;
+
+    // keep the load factor at or below 1/2
+    if (seriesSize(&d->labels) * 2 > d->slotCount) {
+        dictRehash(d, d->slotCount * 2);
+    }
+    *outCode = (uint32_t)code;
+    return true;
+}
+
+static inline uint32_t readCode(const void* codes, unsigned int width, size_t i)
+{
+    switch (width) {
+        case 1:  return ((const uint8_t*)codes)[i];
+        case 2:  return ((const uint16_t*)codes)[i];
+        default: return ((const uint32_t*)codes)[i];
+    }
+}
+
+static inline void writeCode(void* codes, unsigned int width, size_t i, uint32_t code)
+{
+    switch (width) {
+        case 1:  ((uint8_t*)codes)[i]  = (uint8_t)code;  break;
+        case 2:  ((uint16_t*)codes)[i] = (uint16_t)code; break;
+        default: ((uint32_t*)codes)[i] = code;           break;
+    }
+}
+
+/* Re-pack the codes so that `code` fits (uint8 -> uint16 -> uint32). */
+static bool seriesFitCode(Series* s, uint32_t code)
+{
+    unsigned int width = (code <= UINT8_MAX) ? 1 : (code <= UINT16_MAX) ? 2 : 4;
+    if (width <= s->codeWidth) return true;
+
+    if (s->values) {
+        void* buf = dfMemAlloc(valuesAllocSize(s->capacity, width), SERIES_ALIGNMENT);
+        if (!buf) return false;
+        for (size_t i = 0; i < s->length; i++) {
+            writeCode(buf, width, i, readCode(s->values, s->codeWidth, i));
+        }
+        dfMemFree(s->values, valuesAllocSize(s->capacity, s->codeWidth));
+        s->values = buf;
+    }
+    s->codeWidth = width;
+    if (s->values) storageSync(s);
+    return true;
+}
+
 void seriesInit(Series* s, const char* name, ColumnType type) {
     if (!s) return;
 
     s->name = safeStrdup(name);
     s->type = type;
-    daInit(&s->data, 8); // some default capacity
+    s->values = NULL;
+    s->length = 0;
+    s->capacity = 0;
+    s->bytes = NULL;
+    s->bytesUsed = 0;
+    s->bytesCapacity = 0;
+    s->codeWidth = 1;
+    s->dict = (type == DF_CATEGORY) ? dictCreate() : NULL;
+    s->validity = NULL;
+    s->nullCount = 0;
+    s->shared = NULL;
+    s->offset = 0;
+    s->chunks = NULL;
+}
+
+void seriesCopy(const Series* src, Series* dst) {
+    if (!src || !dst) return;
+    if (src->chunks) {
+        chunkedCopy(src, dst);
+        return;
+    }
+
+    seriesInit(dst, src->name, src->type);
+    if (src->type == DF_CATEGORY) {
+        // share the dictionary instead of re-encoding every label
+        dictRelease(dst->dict);
+        dst->dict = src->dict;
+        dictRetain(dst->dict);
+        dst->codeWidth = src->codeWidth;
+    }
+    if (src->length == 0) return;
+
+    // DF_STRING copies its length + 1 offsets
+    size_t slots = src->length + (src->type == DF_STRING ? 1 : 0);
+    if (!seriesGrow(dst, slots)) return;
+    memcpy(dst->values, src->values, slots * seriesElementSize(src));
+    dst->length = src->length;
+
+    if (src->type == DF_STRING) {
+        // only this Series' strings, with the offsets re-based to 0
+        // (a row view covers just part of its parent's arena)
+        const uint64_t* offsets = stringOffsets(src);
+        uint64_t first = offsets[0];
+        size_t used = (size_t)(offsets[src->length] - first);
+        if (seriesGrowBytes(dst, used ? used : 1)) {
+            memcpy(dst->bytes, src->bytes + first, used);
+            dst->bytesUsed = used;
+        }
+        uint64_t* out = stringOffsets(dst);
+        for (size_t i = 0; i <= src->length; i++) {
+            out[i] -= first;
+        }
+    }
+
+    if (src->nullCount > 0 && seriesEnsureValidity(dst)) {
+        for (size_t w = 0; w < SERIES_VALIDITY_WORDS(src->length); w++) {
+            dst->validity[w] = validityWord(src, w);
+        }
+        dst->nullCount = src->nullCount;
+    }
+}
+
+void seriesShare(const Series* src, Series* dst) {
+    if (!src || !dst) return;
+    if (src->chunks) {
+        chunkedShare(src, dst);
+        return;
+    }
+
+    // buffers without a storage block (it failed to allocate) are copied
+    if (!src->shared && (src->values || src->bytes || src->validity)) {
+        seriesCopy(src, dst);
+        return;
+    }
+    // only the atomic counts change, so concurrent shares of src are safe
+    if (src->shared) {
+        atomic_fetch_add_explicit(&src->shared->refCount, 1, memory_order_relaxed);
+    }
+
+    *dst = *src;
+    dst->name = safeStrdup(src->name);
+    if (dst->dict) {
+        dictRetain(dst->dict);
+    }
+}
+
+void seriesSlice(const Series* src, size_t start, size_t count, Series* dst) {
+    if (!src || !dst) return;
+    if (start > src->length) start = src->length;
+    if (count > src->length - start) count = src->length - start;
+    if (src->chunks) {
+        chunkedSlice(src, start, count, dst);
+        return;
+    }
+
+    seriesShare(src, dst);
+    if (dst->values) {
+        dst->values = (char*)dst->values + start * seriesElementSize(dst);
+    }
+    dst->offset += start;
+    dst->length = count;
+    dst->capacity = count;
+    dst->nullCount = (src->nullCount == 0) ? 0 : countNulls(dst);
 }
 
 void seriesFree(Series* s) {
     if (!s) return;
+    if (s->chunks) {
+        chunkedFree(s);
+    }
+
+    if (s->shared) {
+        // the last user of shared storage frees it
+        releaseShared(s);
+        s->values = NULL;
+        s->bytes = NULL;
+        s->validity = NULL;
+        s->offset = 0;
+    }
+
+    dfMemFree(s->values, valuesAllocSize(s->capacity, seriesElementSize(s)));
+    s->values = NULL;
 
-    // For DF_STRING, we do NOT individually free each string because 
-    // DynamicArray code already free()s every pointer if it allocated them.
-    daFree(&s->data);
+    dfMemFree(s->validity, validityAllocSize(s->capacity));
+    s->validity = NULL;
+    s->nullCount = 0;
+    s->length = 0;
+    s->capacity = 0;
+
+    dfMemFree(s->bytes, s->bytesCapacity);
+    s->bytes = NULL;
+    s->bytesUsed = 0;
+    s->bytesCapacity = 0;
+
+    dictRelease(s->dict);
+    s->dict = NULL;
 
     // Free the series name
     free(s->name);
@@ -37,23 +739,46 @@ void seriesFree(Series* s) {
 
 size_t seriesSize(const Series* s) {
     if (!s) return 0;
-    return daSize(&s->data);
+    return s->length;
 }
 
 void seriesAddInt(Series* s, int value) {
     if (!s || s->type != DF_INT) return;
-    daPushBack(&s->data, &value, sizeof(int));
+    seriesPushValue(s, &value);
 }
 
 void seriesAddDouble(Series* s, double value) {
     if (!s || s->type != DF_DOUBLE) return;
-    daPushBack(&s->data, &value, sizeof(double));
+    seriesPushValue(s, &value);
 }
 
 void seriesAddString(Series* s, const char* str) {
-    if (!s || s->type != DF_STRING || !str) return;
-    size_t len = strlen(str) + 1;
-    daPushBack(&s->data, str, len); // store a copy in the dynamic array
+    if (!s || !str) return;
+    CHUNK_APPEND(s, seriesAddString(chunk_, str));
+    if (!seriesDetach(s)) return;
+    if (s->type == DF_CATEGORY) {
+        uint32_t code;
+        if (!s->dict || !dictIntern(s->dict, str, &code)) return;
+        if (!seriesFitCode(s, code) || !seriesGrow(s, s->length + 1)) return;
+        writeCode(s->values, s->codeWidth, s->length, code);
+        s->length++;
+        return;
+    }
+    if (s->type != DF_STRING) return;
+    size_t len = strlen(str) + 1;   // keep the NUL in the arena
+
+    // offsets needs length + 2 slots: [0] plus one end offset per string
+    if (!seriesGrow(s, s->length + 2)) return;
+    if (!seriesGrowBytes(s, s->bytesUsed + len)) return;
+
+    uint64_t* offsets = stringOffsets(s);
+    if (s->length == 0) {
+        offsets[0] = 0;
+    }
+    memcpy(s->bytes + s->bytesUsed, str, len);
+    s->bytesUsed += len;
+    offsets[s->length + 1] = (uint64_t)s->bytesUsed;
+    s->length++;
 }
 
 /* ---------------------------------------------------------------------------
@@ -61,7 +786,219 @@ void seriesAddString(Series* s, const char* str) {
  * --------------------------------------------------------------------------- */
 void seriesAddDateTime(Series* s, long long datetimeMillis) {
     if (!s || s->type != DF_DATETIME) return;
-    daPushBack(&s->data, &datetimeMillis, sizeof(long long));
+    seriesPushValue(s, &datetimeMillis);
+}
+
+/* ---------------------------------------------------------------------------
+ * Nulls
+ * --------------------------------------------------------------------------- */
+void seriesAddNull(Series* s) {
+    if (!s) return;
+    CHUNK_APPEND(s, seriesAddNull(chunk_));
+
+    // placeholder value of the column's type, then clear its validity bit
+    size_t row = s->length;
+    switch (s->type) {
+        case DF_INT:      seriesAddInt(s, 0);          break;
+        case DF_DOUBLE:   seriesAddDouble(s, 0.0);     break;
+        case DF_DATETIME: seriesAddDateTime(s, 0LL);   break;
+        case DF_STRING:   seriesAddString(s, "");      break;
+        case DF_CATEGORY: {
+            // code 0 is never read back for a null row
+            if (!seriesDetach(s) || !seriesGrow(s, s->length + 1)) return;
+            writeCode(s->values, s->codeWidth, s->length, 0);
+            s->length++;
+        } break;
+        case DF_INT8:  case DF_INT16:  case DF_INT64:
+        case DF_UINT8: case DF_UINT16: case DF_UINT32: case DF_UINT64:
+        case DF_FLOAT: {
+            // all-zero bytes are a 0 of any of these types
+            uint64_t zero = 0;
+            seriesPushValue(s, &zero);
+        } break;
+    }
+    if (s->length != row + 1 || !seriesEnsureValidity(s)) return;
+
+    size_t bit = s->offset + row;
+    s->validity[bit >> 6] &= ~(1ULL << (bit & 63));
+    s->nullCount++;
+}
+
+bool seriesIsNull(const Series* s, size_t index) {
+    if (!s || index >= s->length) return false;
+    return isNullAt(s, index);
+}
+
+bool seriesSetNull(Series* s, size_t index) {
+    if (!s || index >= s->length) return false;
+    if (isNullAt(s, index)) return true;
+    CHUNK_WRITE(s, index, seriesSetNull(chunk_, row_));
+    if (!seriesDetach(s) || !seriesEnsureValidity(s)) return false;
+    size_t bit = s->offset + index;
+    s->validity[bit >> 6] &= ~(1ULL << (bit & 63));
+    s->nullCount++;
+    return true;
+}
+
+size_t seriesNullCount(const Series* s) {
+    return s ? s->nullCount : 0;
+}
+
+uint64_t seriesValidityWord(const Series* s, size_t w) {
+    if (!s) return ~0ULL;
+    if (s->chunks) {
+        // a 64-row block may straddle chunks: assemble it row by row
+        uint64_t word = ~0ULL;
+        for (size_t i = 0; s->nullCount > 0 && i < 64 && w * 64 + i < s->length; i++) {
+            if (isNullAt(s, w * 64 + i)) word &= ~(1ULL << i);
+        }
+        return word;
+    }
+    return validityWord(s, w);
+}
+
+bool seriesAppendFrom(Series* dst, const Series* src, size_t row) {
+    if (!dst || !src || row >= src->length) return false;
+    CHUNK_READ(src, row);
+
+    if (isNullAt(src, row)) {
+        seriesAddNull(dst);
+        return true;
+    }
+    switch (src->type) {
+        case DF_INT: {
+            if (dst->type != DF_INT) return false;
+            seriesAddInt(dst, ((const int*)src->values)[row]);
+        } break;
+        case DF_DOUBLE: {
+            if (dst->type != DF_DOUBLE) return false;
+            seriesAddDouble(dst, ((const double*)src->values)[row]);
+        } break;
+        case DF_DATETIME: {
+            if (dst->type != DF_DATETIME) return false;
+            seriesAddDateTime(dst, ((const long long*)src->values)[row]);
+        } break;
+        case DF_STRING:
+        case DF_CATEGORY: {
+            if (dst->type != DF_STRING && dst->type != DF_CATEGORY) return false;
+            const char* str = NULL;
+            seriesGetStringView(src, row, &str, NULL);
+            seriesAddString(dst, str);
+        } break;
+        case DF_INT8:  case DF_INT16:  case DF_INT64:
+        case DF_UINT8: case DF_UINT16: case DF_UINT32: case DF_UINT64:
+        case DF_FLOAT: {
+            if (dst->type != src->type) return false;
+            seriesPushValue(dst, (const char*)src->values + row * seriesElementSize(src));
+        } break;
+    }
+    return true;
+}
+
+bool seriesAppendRows(Series* dst, const Series* src, const size_t* rows, size_t n) {
+    if (!dst || !src || (n && !rows)) return false;
+    bool contiguous = true;
+    for (size_t i = 0; i < n; i++) {
+        if (rows[i] >= src->length) return false;
+        contiguous = contiguous && rows[i] == rows[0] + i;
+    }
+
+    const SeriesKernels* k = seriesKernels(src->type);
+    if (!k || dst->type != src->type || src->chunks || dst->chunks) {
+        // strings, categories and chunked columns go row by row
+        for (size_t i = 0; i < n; i++) {
+            if (!seriesAppendFrom(dst, src, rows[i])) return false;
+        }
+        return true;
+    }
+    if (n == 0) return true;
+
+    if (!seriesDetach(dst) || !seriesGrow(dst, dst->length + n)) return false;
+    size_t base = dst->length;
+    char* out = (char*)dst->values + base * k->width;
+    if (contiguous) {
+        k->copy((const char*)src->values + rows[0] * k->width, n, out);
+    } else {
+        k->gather(src->values, rows, n, out);
+    }
+    // rows past `length` are always marked valid; only nulls need a write
+    dst->length += n;
+    for (size_t i = 0; src->nullCount && i < n; i++) {
+        if (isNullAt(src, rows[i]) && !seriesSetNull(dst, base + i)) return false;
+    }
+    return true;
+}
+
+/* Gather the strings at idx[0..n) of a contiguous DF_STRING `src` into `dst`. */
+static bool gatherStrings(const Series* src, const size_t* idx, size_t n, Series* dst)
+{
+    // pass 1: exact arena size, so the bytes are copied into one allocation
+    const uint64_t* in = stringOffsets(src);
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i + SERIES_PREFETCH_DISTANCE < n) SERIES_PREFETCH(&in[idx[i + SERIES_PREFETCH_DISTANCE]]);
+        total += (size_t)(in[idx[i] + 1] - in[idx[i]]);
+    }
+    if (!seriesGrow(dst, n + 1) || !seriesGrowBytes(dst, total ? total : 1)) return false;
+
+    // pass 2: one memcpy per string, straight into the arena
+    uint64_t* out = stringOffsets(dst);
+    size_t used = 0;
+    out[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i + SERIES_PREFETCH_DISTANCE < n) {
+            SERIES_PREFETCH(src->bytes + in[idx[i + SERIES_PREFETCH_DISTANCE]]);
+        }
+        size_t len = (size_t)(in[idx[i] + 1] - in[idx[i]]);
+        memcpy(dst->bytes + used, src->bytes + in[idx[i]], len);
+        used += len;
+        out[i + 1] = (uint64_t)used;
+    }
+    dst->bytesUsed = used;
+    return true;
+}
+
+bool seriesGather(const Series* src, const size_t* idx, size_t n, Series* dst) {
+    if (!src || !dst) return false;
+    seriesInit(dst, src->name, src->type);
+    if (n && !idx) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (idx[i] >= src->length) return false;
+    }
+    if (src->chunks) {
+        // rows may sit in any chunk: go through the row-at-a-time path
+        return seriesAppendRows(dst, src, idx, n);
+    }
+    if (n == 0) return true;
+
+    bool ok;
+    if (src->type == DF_STRING) {
+        ok = gatherStrings(src, idx, n, dst);
+    } else {
+        const SeriesKernels* k = seriesKernels(src->type);
+        if (src->type == DF_CATEGORY) {
+            // codes are 1, 2 or 4 byte unsigned values; share the labels
+            dictRelease(dst->dict);
+            dst->dict = src->dict;
+            dictRetain(dst->dict);
+            dst->codeWidth = src->codeWidth;
+            k = seriesKernels(src->codeWidth == 1 ? DF_UINT8 : src->codeWidth == 2 ? DF_UINT16 : DF_UINT32);
+        }
+        ok = seriesGrow(dst, n);
+        if (ok) k->gather(src->values, idx, n, dst->values);
+    }
+    if (!ok) return false;
+    dst->length = n;
+
+    if (src->nullCount > 0) {
+        if (!seriesEnsureValidity(dst)) return false;
+        for (size_t i = 0; i < n; i++) {
+            if (!isNullAt(src, idx[i])) continue;
+            dst->validity[i >> 6] &= ~(1ULL << (i & 63));
+            dst->nullCount++;
+        }
+    }
+    return true;
 }
 
 /* ---------------------------------------------------------------------------
@@ -69,42 +1006,461 @@ void seriesAddDateTime(Series* s, long long datetimeMillis) {
  * --------------------------------------------------------------------------- */
 bool seriesGetDateTime(const Series* s, size_t index, long long* outValue) {
     if (!s || s->type != DF_DATETIME || !outValue) return false;
-    if (index >= daSize(&s->data)) return false;
-
-    const long long* valPtr = (const long long*)daGet(&s->data, index);
-    if (!valPtr) return false;
+    if (index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
 
-    *outValue = *valPtr;
+    *outValue = ((const long long*)s->values)[index];
     return true;
 }
 /* --------------------------------------------------------------------------- */
 
 bool seriesGetInt(const Series* s, size_t index, int* outValue) {
-    if (!s || s->type != DF_INT || !outValue) return false;
-    if (index >= daSize(&s->data)) return false;
-    const int* valPtr = (const int*)daGet(&s->data, index);
-    if (!valPtr) return false;
-    *outValue = *valPtr;
+    if (!s || !outValue) return false;
+    if (index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    // the narrower integer types widen losslessly
+    switch (s->type) {
+        case DF_INT:    *outValue = ((const int*)s->values)[index];      break;
+        case DF_INT8:   *outValue = ((const int8_t*)s->values)[index];   break;
+        case DF_INT16:  *outValue = ((const int16_t*)s->values)[index];  break;
+        case DF_UINT8:  *outValue = ((const uint8_t*)s->values)[index];  break;
+        case DF_UINT16: *outValue = ((const uint16_t*)s->values)[index]; break;
+        default: return false;
+    }
     return true;
 }
 
 bool seriesGetDouble(const Series* s, size_t index, double* outValue) {
-    if (!s || s->type != DF_DOUBLE || !outValue) return false;
-    if (index >= daSize(&s->data)) return false;
-    const double* valPtr = (const double*)daGet(&s->data, index);
-    if (!valPtr) return false;
-    *outValue = *valPtr;
+    if (!s || !outValue) return false;
+    if (index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    switch (s->type) {
+        case DF_DOUBLE: *outValue = ((const double*)s->values)[index]; break;
+        case DF_FLOAT:  *outValue = ((const float*)s->values)[index];  break;
+        default: return false;
+    }
     return true;
 }
 
 bool seriesGetString(const Series* s, size_t index, char** outStr) {
-    if (!s || s->type != DF_STRING || !outStr) return false;
-    if (index >= daSize(&s->data)) return false;
-    const char* valPtr = (const char*)daGet(&s->data, index);
-    if (!valPtr) return false;
+    if (!outStr) return false;
+    const char* valPtr = NULL;
+    size_t len = 0;
+    if (!seriesGetStringView(s, index, &valPtr, &len)) return false;
+
+    *outStr = (char*)malloc(len + 1);
+    if (!*outStr) return false;
+    memcpy(*outStr, valPtr, len + 1);
+    return true;
+}
+
+bool seriesGetStringView(const Series* s, size_t index, const char** outStr, size_t* outLen) {
+    if (!s || !outStr || index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    if (s->type == DF_CATEGORY) {
+        return seriesGetStringView(&s->dict->labels,
+                                   readCode(s->values, s->codeWidth, index),
+                                   outStr, outLen);
+    }
+    if (s->type != DF_STRING) return false;
+
+    const uint64_t* offsets = stringOffsets(s);
+    *outStr = s->bytes + offsets[index];
+    if (outLen) {
+        *outLen = (size_t)(offsets[index + 1] - offsets[index]) - 1;
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * In-place setters
+ * --------------------------------------------------------------------------- */
+
+bool seriesSetInt(Series* s, size_t index, int value) {
+    if (!s || s->type != DF_INT || index >= s->length) return false;
+    CHUNK_WRITE(s, index, seriesSetInt(chunk_, row_, value));
+    if (!seriesDetach(s)) return false;
+    ((int*)s->values)[index] = value;
+    markValid(s, index);
+    return true;
+}
+
+bool seriesSetDouble(Series* s, size_t index, double value) {
+    if (!s || s->type != DF_DOUBLE || index >= s->length) return false;
+    CHUNK_WRITE(s, index, seriesSetDouble(chunk_, row_, value));
+    if (!seriesDetach(s)) return false;
+    ((double*)s->values)[index] = value;
+    markValid(s, index);
+    return true;
+}
+
+bool seriesSetDateTime(Series* s, size_t index, long long value) {
+    if (!s || s->type != DF_DATETIME || index >= s->length) return false;
+    CHUNK_WRITE(s, index, seriesSetDateTime(chunk_, row_, value));
+    if (!seriesDetach(s)) return false;
+    ((long long*)s->values)[index] = value;
+    markValid(s, index);
+    return true;
+}
+
+bool seriesSetString(Series* s, size_t index, const char* str) {
+    if (!s || !str || index >= s->length) return false;
+    CHUNK_WRITE(s, index, seriesSetString(chunk_, row_, str));
+    if (!seriesDetach(s)) return false;
+    if (s->type == DF_CATEGORY) {
+        uint32_t code;
+        if (!dictIntern(s->dict, str, &code) || !seriesFitCode(s, code)) return false;
+        writeCode(s->values, s->codeWidth, index, code);
+        markValid(s, index);
+        return true;
+    }
+    if (s->type != DF_STRING) return false;
+
+    uint64_t* offsets = stringOffsets(s);
+    size_t oldStart = (size_t)offsets[index];
+    size_t oldEnd   = (size_t)offsets[index + 1];
+    size_t newLen   = strlen(str) + 1;
+    size_t tail     = s->bytesUsed - oldEnd;
+
+    if (newLen > oldEnd - oldStart) {
+        if (!seriesGrowBytes(s, s->bytesUsed + newLen - (oldEnd - oldStart))) return false;
+    }
+    // shift everything after the old value, then drop the new one in
+    memmove(s->bytes + oldStart + newLen, s->bytes + oldEnd, tail);
+    memcpy(s->bytes + oldStart, str, newLen);
+
+    long long delta = (long long)newLen - (long long)(oldEnd - oldStart);
+    for (size_t i = index + 1; i <= s->length; i++) {
+        offsets[i] = (uint64_t)((long long)offsets[i] + delta);
+    }
+    s->bytesUsed = (size_t)((long long)s->bytesUsed + delta);
+    markValid(s, index);
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Raw buffer access (for column-at-a-time kernels)
+ * --------------------------------------------------------------------------- */
+
+const int* seriesIntData(const Series* s) {
+    if (!s || s->type != DF_INT || s->chunks) return NULL;
+    return (const int*)s->values;
+}
+
+const double* seriesDoubleData(const Series* s) {
+    if (!s || s->type != DF_DOUBLE || s->chunks) return NULL;
+    return (const double*)s->values;
+}
+
+const long long* seriesDateTimeData(const Series* s) {
+    if (!s || s->type != DF_DATETIME || s->chunks) return NULL;
+    return (const long long*)s->values;
+}
+
+/* ---------------------------------------------------------------------------
+ * Bulk append
+ * --------------------------------------------------------------------------- */
+
+bool seriesReserve(Series* s, size_t capacity) {
+    if (!s) return false;
+    if (s->chunks) return true;   // chunks are allocated whole as they fill
+    if (!seriesDetach(s)) return false;
+    // DF_STRING keeps one extra offset slot
+    return seriesGrow(s, capacity + (s->type == DF_STRING ? 1 : 0));
+}
+
+bool seriesAppendInts(Series* s, const int* values, size_t n) {
+    if (!s || s->type != DF_INT || (!values && n > 0)) return false;
+    return seriesPushValues(s, values, n);
+}
+
+bool seriesAppendDoubles(Series* s, const double* values, size_t n) {
+    if (!s || s->type != DF_DOUBLE || (!values && n > 0)) return false;
+    return seriesPushValues(s, values, n);
+}
+
+bool seriesAppendDateTimes(Series* s, const long long* values, size_t n) {
+    if (!s || s->type != DF_DATETIME || (!values && n > 0)) return false;
+    return seriesPushValues(s, values, n);
+}
+
+bool seriesAppendValues(Series* s, const void* values, size_t n) {
+    if (seriesValueSize(s) == 0 || (!values && n > 0)) return false;
+    return seriesPushValues(s, values, n);
+}
+
+bool seriesAppendStrings(Series* s, const char* const* strs, size_t n) {
+    if (!s || (s->type != DF_STRING && s->type != DF_CATEGORY)) return false;
+    if (!strs && n > 0) return false;
+    if (!seriesReserve(s, s->length + n)) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (strs[i]) seriesAddString(s, strs[i]);
+        else seriesAddNull(s);
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Fixed-width numeric types (DF_INT8 ... DF_UINT64, DF_FLOAT)
+ *
+ * They share the typed-buffer layout of DF_INT / DF_DOUBLE, so every
+ * accessor is the same four functions over a different C type.
+ * --------------------------------------------------------------------------- */
+
+#define SERIES_TYPED_ACCESSORS(Name, CType, Tag)                              \
+    void seriesAdd##Name(Series* s, CType value) {                            \
+        if (!s || s->type != (Tag)) return;                                   \
+        seriesPushValue(s, &value);                                           \
+    }                                                                         \
+    bool seriesGet##Name(const Series* s, size_t index, CType* outValue) {    \
+        if (!s || s->type != (Tag) || !outValue) return false;                \
+        if (index >= s->length || isNullAt(s, index)) return false;           \
+        CHUNK_READ(s, index);                                                 \
+        *outValue = ((const CType*)s->values)[index];                         \
+        return true;                                                          \
+    }                                                                         \
+    bool seriesSet##Name(Series* s, size_t index, CType value) {              \
+        if (!s || s->type != (Tag) || index >= s->length) return false;       \
+        CHUNK_WRITE(s, index, seriesSet##Name(chunk_, row_, value));          \
+        if (!seriesDetach(s)) return false;                                   \
+        ((CType*)s->values)[index] = value;                                   \
+        markValid(s, index);                                                  \
+        return true;                                                          \
+    }                                                                         \
+    const CType* series##Name##Data(const Series* s) {                        \
+        if (!s || s->type != (Tag) || s->chunks) return NULL;                 \
+        return (const CType*)s->values;                                       \
+    }
+
+SERIES_TYPED_ACCESSORS(Int8,   int8_t,   DF_INT8)
+SERIES_TYPED_ACCESSORS(Int16,  int16_t,  DF_INT16)
+SERIES_TYPED_ACCESSORS(Int64,  int64_t,  DF_INT64)
+SERIES_TYPED_ACCESSORS(UInt8,  uint8_t,  DF_UINT8)
+SERIES_TYPED_ACCESSORS(UInt16, uint16_t, DF_UINT16)
+SERIES_TYPED_ACCESSORS(UInt32, uint32_t, DF_UINT32)
+SERIES_TYPED_ACCESSORS(UInt64, uint64_t, DF_UINT64)
+SERIES_TYPED_ACCESSORS(Float,  float,    DF_FLOAT)
+
+#undef SERIES_TYPED_ACCESSORS
+
+bool seriesTypeIsNumeric(ColumnType type) {
+    switch (type) {
+        case DF_INT:   case DF_DOUBLE:
+        case DF_INT8:  case DF_INT16:  case DF_INT64:
+        case DF_UINT8: case DF_UINT16: case DF_UINT32: case DF_UINT64:
+        case DF_FLOAT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Value at `index` of a fixed-width column as a double (no null check). */
+static double numericAt(const Series* s, size_t index)
+{
+    switch (s->type) {
+        case DF_INT:      return ((const int*)s->values)[index];
+        case DF_DOUBLE:   return ((const double*)s->values)[index];
+        case DF_DATETIME: return (double)((const long long*)s->values)[index];
+        case DF_INT8:     return ((const int8_t*)s->values)[index];
+        case DF_INT16:    return ((const int16_t*)s->values)[index];
+        case DF_INT64:    return (double)((const int64_t*)s->values)[index];
+        case DF_UINT8:    return ((const uint8_t*)s->values)[index];
+        case DF_UINT16:   return ((const uint16_t*)s->values)[index];
+        case DF_UINT32:   return ((const uint32_t*)s->values)[index];
+        case DF_UINT64:   return (double)((const uint64_t*)s->values)[index];
+        case DF_FLOAT:    return ((const float*)s->values)[index];
+        default:          return 0.0;
+    }
+}
+
+bool seriesGetAsDouble(const Series* s, size_t index, double* outValue) {
+    if (!s || !outValue || index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    if (!seriesTypeIsNumeric(s->type) && s->type != DF_DATETIME) return false;
+    *outValue = numericAt(s, index);
+    return true;
+}
+
+size_t seriesValueSize(const Series* s) {
+    if (!s || s->type == DF_STRING || s->type == DF_CATEGORY) return 0;
+    return seriesElementSize(s);
+}
+
+bool seriesGetValue(const Series* s, size_t index, void* out) {
+    size_t size = seriesValueSize(s);
+    if (size == 0 || !out || index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    memcpy(out, (const char*)s->values + index * size, size);
+    return true;
+}
+
+void seriesAddValue(Series* s, const void* in) {
+    if (seriesValueSize(s) == 0 || !in) return;
+    seriesPushValue(s, in);
+}
+
+bool seriesSetValue(Series* s, size_t index, const void* in) {
+    size_t size = seriesValueSize(s);
+    if (size == 0 || !in || index >= s->length) return false;
+    CHUNK_WRITE(s, index, seriesSetValue(chunk_, row_, in));
+    if (!seriesDetach(s)) return false;
+    memcpy((char*)s->values + index * size, in, size);
+    markValid(s, index);
+    return true;
+}
+
+/* `value` cast to an integer type, saturating at [lo, hi] (NaN => 0) */
+#define SATURATE(value, lo, hi) \
+    ((value) != (value) ? 0 : (value) <= (double)(lo) ? (lo) : (value) >= (double)(hi) ? (hi) : (value))
+
+/*
+ * The 64-bit bounds round up to 2^63 / 2^64 as doubles, which the cast back
+ * cannot represent, so these clamp against the exact powers of two and
+ * return the integer limits directly.
+ */
+static int64_t saturateInt64(double value)
+{
+    if (value != value) return 0;
+    if (value >= 0x1p63) return INT64_MAX;
+    if (value < -0x1p63) return INT64_MIN;
+    return (int64_t)value;
+}
+
+static uint64_t saturateUInt64(double value)
+{
+    if (value != value || value <= 0) return 0;
+    if (value >= 0x1p64) return UINT64_MAX;
+    return (uint64_t)value;
+}
+
+void seriesAddNumber(Series* s, double value) {
+    if (!s) return;
+    switch (s->type) {
+        case DF_INT:      seriesAddInt(s, (int)SATURATE(value, INT32_MIN, INT32_MAX)); break;
+        case DF_DOUBLE:   seriesAddDouble(s, value); break;
+        case DF_DATETIME: seriesAddDateTime(s, (long long)saturateInt64(value)); break;
+        case DF_INT8:     seriesAddInt8(s, (int8_t)SATURATE(value, INT8_MIN, INT8_MAX)); break;
+        case DF_INT16:    seriesAddInt16(s, (int16_t)SATURATE(value, INT16_MIN, INT16_MAX)); break;
+        case DF_INT64:    seriesAddInt64(s, saturateInt64(value)); break;
+        case DF_UINT8:    seriesAddUInt8(s, (uint8_t)SATURATE(value, 0, UINT8_MAX)); break;
+        case DF_UINT16:   seriesAddUInt16(s, (uint16_t)SATURATE(value, 0, UINT16_MAX)); break;
+        case DF_UINT32:   seriesAddUInt32(s, (uint32_t)SATURATE(value, 0, UINT32_MAX)); break;
+        case DF_UINT64:   seriesAddUInt64(s, saturateUInt64(value)); break;
+        case DF_FLOAT:    seriesAddFloat(s, (float)value); break;
+        case DF_STRING:
+        case DF_CATEGORY:
+            break;
+    }
+}
 
-    *outStr = safeStrdup(valPtr);
-    return (*outStr != NULL);
+#undef SATURATE
+
+/* ---------------------------------------------------------------------------
+ * Per-type kernels, one set per SERIES_FIXED_TYPES entry
+ * --------------------------------------------------------------------------- */
+
+/* splitmix64 finalizer: spreads every input bit over the whole word */
+static inline uint64_t mixBits(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+#define SERIES_KERNELS(Tag, CType, Name)                                      \
+    static void gather##Name(const void* src, const size_t* idx, size_t n, void* dst) { \
+        const CType* in_ = (const CType*)src;                                 \
+        CType* out_ = (CType*)dst;                                            \
+        size_t i = 0;                                                         \
+        for (; i + SERIES_PREFETCH_DISTANCE < n; i++) {                       \
+            SERIES_PREFETCH(&in_[idx[i + SERIES_PREFETCH_DISTANCE]]);         \
+            out_[i] = in_[idx[i]];                                            \
+        }                                                                     \
+        for (; i < n; i++) out_[i] = in_[idx[i]];                             \
+    }                                                                         \
+    static void scatter##Name(const void* src, const size_t* idx, size_t n, void* dst) { \
+        const CType* in_ = (const CType*)src;                                 \
+        CType* out_ = (CType*)dst;                                            \
+        for (size_t i = 0; i < n; i++) out_[idx[i]] = in_[i];                 \
+    }                                                                         \
+    static int compare##Name(const void* a, size_t i, const void* b, size_t j) { \
+        CType x_ = ((const CType*)a)[i];                                      \
+        CType y_ = ((const CType*)b)[j];                                      \
+        return (x_ > y_) - (x_ < y_);                                         \
+    }                                                                         \
+    static bool equal##Name(const void* a, size_t i, const void* b, size_t j) { \
+        return ((const CType*)a)[i] == ((const CType*)b)[j];                  \
+    }                                                                         \
+    static uint64_t hash##Name(const void* values, size_t i) {                \
+        CType v_ = ((const CType*)values)[i];                                 \
+        if (v_ == 0) v_ = 0;   /* -0.0 hashes like 0.0 */                     \
+        uint64_t bits_ = 0;                                                   \
+        memcpy(&bits_, &v_, sizeof(v_));                                      \
+        return mixBits(bits_);                                                \
+    }                                                                         \
+    static void copy##Name(const void* src, size_t n, void* dst) {            \
+        memcpy(dst, src, n * sizeof(CType));                                  \
+    }
+
+SERIES_FIXED_TYPES(SERIES_KERNELS)
+
+#define SERIES_KERNEL_ENTRY(Tag, CType, Name)                                 \
+    [Tag] = { Tag, sizeof(CType), gather##Name, scatter##Name, compare##Name, \
+              equal##Name, hash##Name, copy##Name },
+
+static const SeriesKernels g_kernels[] = { SERIES_FIXED_TYPES(SERIES_KERNEL_ENTRY) };
+
+#undef SERIES_KERNEL_ENTRY
+#undef SERIES_KERNELS
+
+const SeriesKernels* seriesKernels(ColumnType type) {
+    if ((size_t)type >= sizeof(g_kernels) / sizeof(g_kernels[0])) return NULL;
+    return g_kernels[type].width ? &g_kernels[type] : NULL;
+}
+
+int seriesCompareRows(const Series* s, size_t a, size_t b) {
+    if (!s || a >= s->length || b >= s->length) return 0;
+    if (isNullAt(s, a) || isNullAt(s, b)) return 0;
+    // the rows of a chunked Series may sit in different chunks
+    const Series* sa = s;
+    const Series* sb = s;
+    CHUNK_READ(sa, a);
+    CHUNK_READ(sb, b);
+    const SeriesKernels* k = seriesKernels(s->type);
+    if (k) return k->compare(sa->values, a, sb->values, b);
+
+    const char* strA = NULL;
+    const char* strB = NULL;
+    seriesGetStringView(sa, a, &strA, NULL);
+    seriesGetStringView(sb, b, &strB, NULL);
+    return strcmp(strA, strB);
+}
+
+bool seriesFormatNumber(const Series* s, size_t index, char* buf, size_t bufSize) {
+    if (!buf || bufSize == 0) return false;
+    buf[0] = '\0';
+    if (!s || index >= s->length || isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    const void* v = s->values;
+    switch (s->type) {
+        case DF_INT:      snprintf(buf, bufSize, "%d", ((const int*)v)[index]); break;
+        case DF_DATETIME: snprintf(buf, bufSize, "%lld", ((const long long*)v)[index]); break;
+        case DF_INT8:     snprintf(buf, bufSize, "%d", ((const int8_t*)v)[index]); break;
+        case DF_INT16:    snprintf(buf, bufSize, "%d", ((const int16_t*)v)[index]); break;
+        case DF_INT64:    snprintf(buf, bufSize, "%" PRId64, ((const int64_t*)v)[index]); break;
+        case DF_UINT8:    snprintf(buf, bufSize, "%u", ((const uint8_t*)v)[index]); break;
+        case DF_UINT16:   snprintf(buf, bufSize, "%u", ((const uint16_t*)v)[index]); break;
+        case DF_UINT32:   snprintf(buf, bufSize, "%" PRIu32, ((const uint32_t*)v)[index]); break;
+        case DF_UINT64:   snprintf(buf, bufSize, "%" PRIu64, ((const uint64_t*)v)[index]); break;
+        case DF_DOUBLE:   snprintf(buf, bufSize, "%g", ((const double*)v)[index]); break;
+        case DF_FLOAT:    snprintf(buf, bufSize, "%g", ((const float*)v)[index]); break;
+        default: return false;
+    }
+    return true;
 }
 
 void seriesPrint(const Series* s) {
@@ -123,10 +1479,25 @@ void seriesPrint(const Series* s) {
         case DF_DATETIME:
             printf("datetime (milliseconds)");
             break;
+        case DF_CATEGORY:
+            printf("category, %zu labels", seriesCategoryCount(s));
+            break;
+        case DF_INT8:   printf("int8");   break;
+        case DF_INT16:  printf("int16");  break;
+        case DF_INT64:  printf("int64");  break;
+        case DF_UINT8:  printf("uint8");  break;
+        case DF_UINT16: printf("uint16"); break;
+        case DF_UINT32: printf("uint32"); break;
+        case DF_UINT64: printf("uint64"); break;
+        case DF_FLOAT:  printf("float");  break;
     }
     printf("), size = %zu\n", seriesSize(s));
 
     for (size_t i = 0; i < seriesSize(s); i++) {
+        if (seriesIsNull(s, i)) {
+            printf("  [%zu] null\n", i);
+            continue;
+        }
         switch (s->type) {
             case DF_INT: {
                 int val;
@@ -140,11 +1511,11 @@ void seriesPrint(const Series* s) {
                     printf("  [%zu] %.6f\n", i, val);
                 }
             } break;
-            case DF_STRING: {
-                char* str = NULL;
-                if (seriesGetString(s, i, &str)) {
+            case DF_STRING:
+            case DF_CATEGORY: {
+                const char* str = NULL;
+                if (seriesGetStringView(s, i, &str, NULL)) {
                     printf("  [%zu] \"%s\"\n", i, str);
-                    free(str);
                 }
             } break;
             case DF_DATETIME: {
@@ -155,6 +1526,313 @@ void seriesPrint(const Series* s) {
                     printf("  [%zu] %lld\n", i, dtVal);
                 }
             } break;
+            default: {
+                char buf[64];
+                if (seriesFormatNumber(s, i, buf, sizeof(buf))) {
+                    printf("  [%zu] %s\n", i, buf);
+                }
+            } break;
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Categorical helpers
+ * --------------------------------------------------------------------------- */
+
+bool seriesToCategory(const Series* src, Series* out) {
+    if (!src || !out) return false;
+    if (src->type == DF_CATEGORY) {
+        seriesCopy(src, out);
+        return true;
+    }
+    if (src->type != DF_STRING) return false;
+
+    seriesInit(out, src->name, DF_CATEGORY);
+    for (size_t i = 0; i < src->length; i++) {
+        const char* str = NULL;
+        seriesGetStringView(src, i, &str, NULL);
+        seriesAddString(out, str);
+    }
+    return true;
+}
+
+bool seriesGetCode(const Series* s, size_t index, uint32_t* outCode) {
+    if (!s || s->type != DF_CATEGORY || !outCode || index >= s->length) return false;
+    if (isNullAt(s, index)) return false;
+    CHUNK_READ(s, index);
+    *outCode = readCode(s->values, s->codeWidth, index);
+    return true;
+}
+
+size_t seriesCategoryCount(const Series* s) {
+    if (!s || s->type != DF_CATEGORY || !s->dict) return 0;
+    return seriesSize(&s->dict->labels);
+}
+
+bool seriesCategoryLabel(const Series* s, uint32_t code, const char** outStr, size_t* outLen) {
+    if (!s || s->type != DF_CATEGORY || !s->dict) return false;
+    return seriesGetStringView(&s->dict->labels, code, outStr, outLen);
+}
+
+bool seriesCategoryFind(const Series* s, const char* label, uint32_t* outCode) {
+    if (!s || s->type != DF_CATEGORY || !s->dict || !label || !outCode) return false;
+    size_t slot = dictProbe(s->dict, label, strlen(label));
+    if (s->dict->slots[slot] == 0) return false;
+    *outCode = s->dict->slots[slot] - 1;
+    return true;
+}
+
+bool seriesSameDictionary(const Series* a, const Series* b) {
+    return a && b && a->type == DF_CATEGORY && b->type == DF_CATEGORY
+        && a->dict == b->dict;
+}
+
+/* ---------------------------------------------------------------------------
+ * Chunked Series
+ * --------------------------------------------------------------------------- */
+
+static bool chunksReserve(SeriesChunks* c, size_t count)
+{
+    if (count <= c->cap) return true;
+    size_t newCap = c->cap ? c->cap * 2 : 8;
+    while (newCap < count) newCap *= 2;
+    Series* items = (Series*)dfRealloc(c->items, newCap * sizeof(Series));
+    if (!items) return false;
+    c->items = items;
+    size_t* starts = (size_t*)dfRealloc(c->starts, (newCap + 1) * sizeof(size_t));
+    if (!starts) return false;
+    c->starts = starts;
+    c->cap = newCap;
+    return true;
+}
+
+/* Add `chunk` (moved in) after the last chunk of `s`. */
+static void chunkPush(Series* s, Series* chunk)
+{
+    SeriesChunks* c = s->chunks;
+    if (!chunksReserve(c, c->count + 1)) {
+        seriesFree(chunk);
+        return;
+    }
+    c->items[c->count++] = *chunk;
+    s->length += chunk->length;
+    s->nullCount += chunk->nullCount;
+    c->starts[c->count] = s->length;
+}
+
+/*
+ * The chunk appends go to: the last one while it is not full. A shared last
+ * chunk (linked from another Series) is copied first, which costs at most
+ * one chunk and keeps repeated small appends from leaving a trail of
+ * partly filled chunks.
+ */
+static Series* chunkTail(Series* s)
+{
+    SeriesChunks* c = s->chunks;
+    if (c->count > 0) {
+        Series* last = &c->items[c->count - 1];
+        if (last->length < c->chunkRows && seriesDetach(last)) return last;
+    }
+
+    Series chunk;
+    seriesInit(&chunk, NULL, s->type);
+    if (s->type == DF_CATEGORY) {
+        // all chunks encode against the Series' dictionary
+        dictRelease(chunk.dict);
+        chunk.dict = s->dict;
+        dictRetain(s->dict);
+    }
+    // the whole chunk up front, so filling it never reallocates
+    seriesGrow(&chunk, c->chunkRows + (s->type == DF_STRING ? 1 : 0));
+    size_t before = c->count;
+    chunkPush(s, &chunk);
+    return (c->count > before) ? &c->items[c->count - 1] : NULL;
+}
+
+static void chunkGrew(Series* s, const Series* chunk, size_t oldLength, size_t oldNulls)
+{
+    s->length += chunk->length - oldLength;
+    s->nullCount = s->nullCount - oldNulls + chunk->nullCount;
+    s->chunks->starts[s->chunks->count] = s->length;
+}
+
+void seriesInitChunked(Series* s, const char* name, ColumnType type, size_t chunkRows)
+{
+    if (!s) return;
+    seriesInit(s, name, type);
+    s->chunks = (SeriesChunks*)dfCalloc(1, sizeof(SeriesChunks));
+    if (!s->chunks) return;   // falls back to a contiguous Series
+    s->chunks->chunkRows = chunkRows ? chunkRows : SERIES_CHUNK_ROWS;
+    chunksReserve(s->chunks, 1);
+    if (s->chunks->starts) s->chunks->starts[0] = 0;
+}
+
+/* Empty chunked Series with the name, type, chunk size and dictionary of `src`. */
+static void chunkedLike(const Series* src, Series* dst)
+{
+    seriesInitChunked(dst, src->name, src->type, src->chunks->chunkRows);
+    if (src->type == DF_CATEGORY) {
+        dictRelease(dst->dict);
+        dst->dict = src->dict;
+        dictRetain(dst->dict);
+    }
+}
+
+static void chunkedCopy(const Series* src, Series* dst)
+{
+    chunkedLike(src, dst);
+    for (size_t k = 0; k < src->chunks->count; k++) {
+        Series chunk;
+        seriesCopy(&src->chunks->items[k], &chunk);
+        chunkPush(dst, &chunk);
+    }
+}
+
+static void chunkedShare(const Series* src, Series* dst)
+{
+    chunkedLike(src, dst);
+    for (size_t k = 0; k < src->chunks->count; k++) {
+        Series chunk;
+        seriesShare(&src->chunks->items[k], &chunk);
+        chunkPush(dst, &chunk);
+    }
+}
+
+static void chunkedSlice(const Series* src, size_t start, size_t count, Series* dst)
+{
+    chunkedLike(src, dst);
+    const SeriesChunks* c = src->chunks;
+    size_t end = start + count;
+    for (size_t k = 0; k < c->count; k++) {
+        size_t lo = c->starts[k], hi = c->starts[k + 1];
+        if (hi <= start || lo >= end) continue;
+        size_t from = (start > lo) ? start - lo : 0;
+        size_t to = ((end < hi) ? end : hi) - lo;
+        Series chunk;
+        seriesSlice(&c->items[k], from, to - from, &chunk);
+        chunkPush(dst, &chunk);
+    }
+}
+
+static void chunkedFree(Series* s)
+{
+    for (size_t k = 0; k < s->chunks->count; k++) {
+        seriesFree(&s->chunks->items[k]);
+    }
+    dfFree(s->chunks->items);
+    dfFree(s->chunks->starts);
+    dfFree(s->chunks);
+    s->chunks = NULL;
+}
+
+bool seriesIsChunked(const Series* s) {
+    return s && s->chunks;
+}
+
+size_t seriesChunkCount(const Series* s) {
+    if (!s) return 0;
+    return s->chunks ? s->chunks->count : 1;
+}
+
+const Series* seriesChunk(const Series* s, size_t k) {
+    if (!s) return NULL;
+    if (!s->chunks) return (k == 0) ? s : NULL;
+    return (k < s->chunks->count) ? &s->chunks->items[k] : NULL;
+}
+
+bool seriesAppendChunks(Series* dst, const Series* src) {
+    if (!dst || !src || src == dst || !dst->chunks) return false;
+    bool stringish = (dst->type == DF_STRING || dst->type == DF_CATEGORY)
+                  && (src->type == DF_STRING || src->type == DF_CATEGORY);
+    if (dst->type != src->type && !stringish) return false;
+
+    for (size_t k = 0; k < seriesChunkCount(src); k++) {
+        const Series* chunk = seriesChunk(src, k);
+        if (chunk->length == 0) continue;
+        // big chunks are linked as-is; small ones are copied into the tail
+        // so that many tiny batches do not fragment the column
+        bool link = chunk->type == dst->type
+                 && chunk->length * 2 >= dst->chunks->chunkRows
+                 && (chunk->type != DF_CATEGORY || chunk->dict == dst->dict);
+        if (link) {
+            Series shared;
+            seriesShare(chunk, &shared);
+            chunkPush(dst, &shared);
+        } else {
+            for (size_t r = 0; r < chunk->length; r++) {
+                seriesAppendFrom(dst, chunk, r);
+            }
         }
     }
+    return true;
+}
+
+/* ---------------------------------------------------------------------------
+ * Memory accounting
+ * --------------------------------------------------------------------------- */
+
+/* `withDict` = also count the category dictionary (chunks share their parent's). */
+static void memoryUsage(const Series* s, bool deep, bool withDict, SeriesMemory* out)
+{
+    memset(out, 0, sizeof(*out));
+
+    out->overhead = sizeof(Series) + (s->name ? strlen(s->name) + 1 : 0);
+
+    if (s->chunks) {
+        const SeriesChunks* c = s->chunks;
+        if (deep) {
+            out->overhead += sizeof(SeriesChunks) + c->cap * sizeof(Series)
+                           + (c->cap + 1) * sizeof(size_t);
+        } else {
+            out->overhead += c->count * (sizeof(Series) + sizeof(size_t));
+        }
+        for (size_t k = 0; k < c->count; k++) {
+            SeriesMemory part;
+            memoryUsage(&c->items[k], deep, false, &part);
+            out->data += part.data;
+            out->strings += part.strings;
+            out->validity += part.validity;
+            out->overhead += part.overhead - sizeof(Series);
+        }
+    } else if (deep) {
+        // what the allocator handed out, slack and whole shared buffers included
+        size_t elemSize = seriesElementSize(s);
+        if (s->shared) {
+            out->data = s->shared->valuesSize;
+            out->strings = s->shared->bytesSize;
+            out->validity = s->shared->validitySize;
+            out->overhead += sizeof(SeriesShared);
+        } else {
+            out->data = s->values ? valuesAllocSize(s->capacity, elemSize) : 0;
+            out->strings = s->bytesCapacity;
+            out->validity = s->validity ? validityAllocSize(s->capacity) : 0;
+        }
+    } else {
+        // just the bytes holding this Series' rows
+        out->data = (s->length + (s->type == DF_STRING && s->length ? 1 : 0)) * seriesElementSize(s);
+        if (s->type == DF_STRING && s->length > 0) {
+            const uint64_t* offsets = stringOffsets(s);
+            out->strings = (size_t)(offsets[s->length] - offsets[0]);
+        }
+        out->validity = s->validity ? SERIES_VALIDITY_WORDS(s->length) * sizeof(uint64_t) : 0;
+    }
+
+    if (withDict && s->type == DF_CATEGORY && s->dict) {
+        SeriesMemory labels;
+        memoryUsage(&s->dict->labels, deep, true, &labels);
+        out->strings += labels.data + labels.strings;
+        if (deep) {
+            out->overhead += sizeof(SeriesDictionary) + s->dict->slotCount * sizeof(uint32_t);
+        }
+    }
+}
+
+void seriesMemoryUsage(const Series* s, bool deep, SeriesMemory* out) {
+    if (!out) return;
+    if (!s) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    memoryUsage(s, deep, true, out);
 }
@@ -3,8 +3,13 @@
 #include <math.h>    // for fabs, sqrt
 #include <float.h>   // for DBL_MAX
 #include <string.h>  // for strcmp
+#include <limits.h>  // for INT_MAX
+#include <stdlib.h>  // for qsort
 #include "dataframe.h"
 #include "series.h"
+#include "dfreduce.h"
+#include "dfstats.h"
+#include "dfsketch.h"
 
 // A small helper to compare floating results with some tolerance
 static void assertAlmostEqual(double val, double expected, double tol) {
@@ -27,10 +32,10 @@ static void testDfSum(void)
     for (int i = 1; i <= 4; i++) {
         seriesAddInt(&s, i);
     }
-    bool ok = df.addSeries(&df, &s);
+    bool ok = df.ops->addSeries(&df, &s);
     assert(ok);
 
-    double sumRes = df.sum(&df, 0);
+    double sumRes = df.ops->sum(&df, 0);
     assertAlmostEqual(sumRes, 1+2+3+4, 1e-9);
 
     seriesFree(&s);
@@ -55,10 +60,10 @@ static void testDfMean(void)
     for (int i=0; i<4; i++){
         seriesAddDouble(&s, arr[i]);
     }
-    bool ok = df.addSeries(&df, &s);
+    bool ok = df.ops->addSeries(&df, &s);
     assert(ok);
 
-    double m = df.mean(&df, 0);
+    double m = df.ops->mean(&df, 0);
     // average = (1+2+3+4)/4 = 2.5
     assertAlmostEqual(m, 2.5, 1e-9);
 
@@ -82,10 +87,10 @@ static void testDfMin(void)
     seriesAddDouble(&s, 10.5);
     seriesAddDouble(&s, 2.2);
     seriesAddDouble(&s, 7.7);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double mn = df.min(&df, 0);
+    double mn = df.ops->min(&df, 0);
     assertAlmostEqual(mn, 2.2, 1e-9);
 
     DataFrame_Destroy(&df);
@@ -107,10 +112,10 @@ static void testDfMax(void)
     seriesAddInt(&s, 3);
     seriesAddInt(&s, 9);
     seriesAddInt(&s, 1);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double mx = df.max(&df, 0);
+    double mx = df.ops->max(&df, 0);
     assertAlmostEqual(mx, 9, 1e-9);
 
     DataFrame_Destroy(&df);
@@ -133,10 +138,10 @@ static void testDfCount(void)
     seriesAddString(&s, "banana");
     seriesAddString(&s, "orange");
     seriesAddString(&s, "kiwi");
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double c = df.count(&df, 0);
+    double c = df.ops->count(&df, 0);
     // 4 non-null strings => count=4
     assertAlmostEqual(c, 4.0, 1e-9);
 
@@ -160,10 +165,10 @@ static void testDfMedian(void)
     seriesAddDouble(&s, 4.0);
     seriesAddDouble(&s, 6.0);
     seriesAddDouble(&s, 8.0);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double med = df.median(&df, 0);
+    double med = df.ops->median(&df, 0);
     assertAlmostEqual(med, 5.0, 1e-9);
 
     DataFrame_Destroy(&df);
@@ -187,10 +192,10 @@ static void testDfMode(void)
     seriesAddInt(&s, 5);
     seriesAddInt(&s, 2);
     seriesAddInt(&s, 5);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double modeVal = df.mode(&df, 0);
+    double modeVal = df.ops->mode(&df, 0);
     assertAlmostEqual(modeVal, 2.0, 1e-9);
 
     DataFrame_Destroy(&df);
@@ -213,10 +218,10 @@ static void testDfVar(void)
     for (int i=1; i<=4; i++){
         seriesAddDouble(&s, i);
     }
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double v = df.var(&df, 0);
+    double v = df.ops->var(&df, 0);
     // population var=1.25, sample var= 1.6666667 (2 decimal=1.67)
     // 1->1,2->4,3->9,4->16 => mean=2.5 => squares ~ (1.5^2 +0.5^2+0.5^2+1.5^2)=1.5^2=2.25 => sum=5 => /3=1.6667
     assert(fabs(v - 1.6666667) < 1e-5);
@@ -242,10 +247,10 @@ static void testDfStd(void)
     seriesAddDouble(&s, 2.0);
     seriesAddDouble(&s, 3.0);
     seriesAddDouble(&s, 4.0);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double stdev = df.std(&df, 0);
+    double stdev = df.ops->std(&df, 0);
     // Expect ~1.290994 (since sample var=1.6667)
     assert(fabs(stdev - 1.290994) < 1e-5);
 
@@ -269,10 +274,10 @@ static void testDfRange(void)
     seriesAddInt(&s, 7);
     seriesAddInt(&s, 1);
     seriesAddInt(&s, 9);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double r = df.range(&df, 0);
+    double r = df.ops->range(&df, 0);
     assertAlmostEqual(r, 8.0, 1e-9);
 
     DataFrame_Destroy(&df);
@@ -295,14 +300,14 @@ static void testDfQuantile(void)
     seriesAddDouble(&s, 20);
     seriesAddDouble(&s, 30);
     seriesAddDouble(&s, 40);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double q25 = df.quantile(&df, 0, 0.25); 
+    double q25 = df.ops->quantile(&df, 0, 0.25); 
     // sorted => [10,20,30,40], 0.25*(4-1)=0.75 => idxBelow=0, idxAbove=1 => interpol => 17.5
     assertAlmostEqual(q25, 17.5, 1e-9);
 
-    double q75 = df.quantile(&df, 0, 0.75); 
+    double q75 = df.ops->quantile(&df, 0, 0.75); 
     // pos=0.75*(3)=2.25 => idxBelow=2 => 30 => fraction=0.25 => next=40 => 30+0.25*(10)=32.5
     assertAlmostEqual(q75, 32.5, 1e-9);
 
@@ -326,10 +331,10 @@ static void testDfIQR(void)
     seriesAddInt(&s, 4);
     seriesAddInt(&s, 6);
     seriesAddInt(&s, 8);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double iqrVal = df.iqr(&df, 0);
+    double iqrVal = df.ops->iqr(&df, 0);
     // Based on interpolation => q1=3.5, q3=6.5 => iqr=3
     // We'll allow small tolerance check
     assertAlmostEqual(iqrVal, 3.0, 0.1);
@@ -354,7 +359,7 @@ static void testDfNullCount(void)
     seriesInit(&s, "NullTest", DF_STRING);
     seriesAddString(&s, "hi");   // 1 row => "hi"
 
-    bool ok = df.addSeries(&df, &s);
+    bool ok = df.ops->addSeries(&df, &s);
     seriesFree(&s);
     assert(ok);
 
@@ -364,19 +369,56 @@ static void testDfNullCount(void)
     rowData[0] = (const void*)row2;
 
     // Attempt to add a second row. This should fail (strPtr == NULL => no new row).
-    if (df.numColumns(&df) == 1) {
-        bool added = df.addRow(&df, rowData);
+    if (df.ops->numColumns(&df) == 1) {
+        bool added = df.ops->addRow(&df, rowData);
         assert(!added);
     }
 
     // So only 1 valid row => "hi" => nullCount=0
-    double nCount = df.nullCount(&df, 0);
+    double nCount = df.ops->nullCount(&df, 0);
     assert(nCount == 0.0);
 
     DataFrame_Destroy(&df);
     printf("testDfNullCount passed.\n");
 }
 
+/* --------------------------------------------------------------------------
+ * testDfNullSkipping
+ * -------------------------------------------------------------------------- */
+static void testDfNullSkipping(void)
+{
+    printf("Running testDfNullSkipping...\n");
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    // 130 rows => 1..130, every 10th row null (spans three bitmap words)
+    Series s;
+    seriesInit(&s, "Vals", DF_DOUBLE);
+    double expectedSum = 0.0;
+    size_t valid = 0;
+    for (int i = 1; i <= 130; i++) {
+        if (i % 10 == 0) {
+            seriesAddNull(&s);
+        } else {
+            seriesAddDouble(&s, (double)i);
+            expectedSum += i;
+            valid++;
+        }
+    }
+    df.ops->addSeries(&df,&s);
+    seriesFree(&s);
+
+    assertAlmostEqual(df.ops->nullCount(&df,0), 13.0, 1e-9);
+    assertAlmostEqual(df.ops->count(&df,0), (double)valid, 1e-9);
+    assertAlmostEqual(df.ops->sum(&df,0), expectedSum, 1e-9);
+    assertAlmostEqual(df.ops->mean(&df,0), expectedSum / (double)valid, 1e-9);
+    assertAlmostEqual(df.ops->min(&df,0), 1.0, 1e-9);
+    assertAlmostEqual(df.ops->max(&df,0), 129.0, 1e-9);
+
+    DataFrame_Destroy(&df);
+    printf("testDfNullSkipping passed.\n");
+}
+
 /* --------------------------------------------------------------------------
  * testDfUniqueCount
  * -------------------------------------------------------------------------- */
@@ -393,10 +435,10 @@ static void testDfUniqueCount(void)
     seriesAddInt(&s,2);
     seriesAddInt(&s,2);
     seriesAddInt(&s,3);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double uniq = df.uniqueCount(&df, 0);
+    double uniq = df.ops->uniqueCount(&df, 0);
     // distinct= {1,2,3} => 3
     assert(uniq==3.0);
 
@@ -404,6 +446,109 @@ static void testDfUniqueCount(void)
     printf("testDfUniqueCount passed.\n");
 }
 
+/* --------------------------------------------------------------------------
+ * testDfApproxUniqueCount: HyperLogLog daily sketches rolled up into a week
+ * -------------------------------------------------------------------------- */
+static bool sameRegisters(const DfHyperLogLog* a, const DfHyperLogLog* b)
+{
+    return a->precision == b->precision &&
+           memcmp(a->registers, b->registers, (size_t)1 << a->precision) == 0;
+}
+
+static void testDfApproxUniqueCount(void)
+{
+    printf("Running testDfApproxUniqueCount...\n");
+    // day d sees user ids [d * 20000, d * 20000 + 60000), each twice
+    enum { DAYS = 7, SHIFT = 20000, SPAN = 60000 };
+    DfHyperLogLog week, direct;
+    assert(dfHllInit(&week, 0) && week.precision == DF_HLL_DEFAULT_PRECISION);
+    assert(dfHllInit(&direct, 0));
+    for (int d = 0; d < DAYS; d++) {
+        DataFrame df;
+        DataFrame_Create(&df);
+        Series ids;
+        seriesInit(&ids, "UserId", DF_INT64);
+        for (int i = 0; i < 2 * SPAN; i++) {
+            if (i % 1000 == 0) seriesAddNull(&ids);
+            seriesAddInt64(&ids, (int64_t)d * SHIFT + i % SPAN + 1000000000LL);
+        }
+        df.ops->addSeries(&df, &ids);
+        double daily = df.ops->approxUniqueCount(&df, 0, 14);
+        assert(fabs(daily - SPAN) < 0.03 * SPAN);
+
+        // persist the day's registers, reload and roll up
+        DfHyperLogLog day, copy;
+        assert(dfHllInit(&day, 14) && dfHllAddSeries(&day, &ids, 0));
+        assert(dfHllAddSeries(&direct, &ids, 0));
+        size_t len = dfHllSerialize(&day, NULL, 0);
+        uint8_t* bytes = (uint8_t*)malloc(len);
+        assert(bytes && dfHllSerialize(&day, bytes, len) == len);
+        assert(dfHllDeserialize(&copy, bytes, len) && sameRegisters(&copy, &day));
+        assert(dfHllMerge(&week, &copy));
+        free(bytes);
+        dfHllFree(&copy);
+        dfHllFree(&day);
+        seriesFree(&ids);
+        DataFrame_Destroy(&df);
+    }
+    // merging is exact: the rolled-up week equals one sketch over every row
+    assert(sameRegisters(&week, &direct));
+    double weekly = (DAYS - 1) * SHIFT + SPAN;
+    assert(fabs(dfHllEstimate(&week) - weekly) < 0.03 * weekly);
+
+    // the same values hash alike whatever the column type
+    Series ints, doubles, strs, cats;
+    seriesInit(&ints, "I", DF_INT);
+    seriesInit(&doubles, "D", DF_DOUBLE);
+    seriesInit(&strs, "S", DF_STRING);
+    char label[32];
+    for (int i = 0; i < 5000; i++) {
+        seriesAddInt(&ints, i % 1234);
+        seriesAddDouble(&doubles, (double)(i % 1234));
+        snprintf(label, sizeof(label), "user-%d", i % 1234);
+        seriesAddString(&strs, label);
+    }
+    assert(seriesToCategory(&strs, &cats));
+    DfHyperLogLog a, b;
+    assert(dfHllInit(&a, 12) && dfHllInit(&b, 12));
+    assert(dfHllAddSeries(&a, &ints, 0) && dfHllAddSeries(&b, &doubles, 0));
+    assert(sameRegisters(&a, &b));
+    assert(fabs(dfHllEstimate(&a) - 1234.0) < 0.05 * 1234.0);
+    dfHllFree(&a);
+    dfHllFree(&b);
+    assert(dfHllInit(&a, 12) && dfHllInit(&b, 12));
+    assert(dfHllAddSeries(&a, &strs, 0) && dfHllAddSeries(&b, &cats, 0));
+    assert(sameRegisters(&a, &b));
+
+    // a finer sketch folds down to exactly the coarser one
+    DfHyperLogLog fine;
+    assert(dfHllInit(&fine, 16) && dfHllAddSeries(&fine, &strs, 0));
+    dfHllFree(&b);
+    assert(dfHllInit(&b, 12) && dfHllMerge(&b, &fine) && sameRegisters(&a, &b));
+    assert(!dfHllMerge(&fine, &a));
+    dfHllFree(&fine);
+    dfHllFree(&a);
+    dfHllFree(&b);
+
+    // small counts: only rows [4990, 5000), ten distinct ids
+    DfHyperLogLog few;
+    assert(dfHllInit(&few, 0) && dfHllAddSeries(&few, &ints, 4990));
+    assert(fabs(dfHllEstimate(&few) - 10.0) < 0.5);
+    dfHllFree(&few);
+
+    uint8_t junk[16] = { 0 };
+    DfHyperLogLog bad;
+    assert(!dfHllDeserialize(&bad, junk, sizeof(junk)));
+
+    seriesFree(&ints);
+    seriesFree(&doubles);
+    seriesFree(&strs);
+    seriesFree(&cats);
+    dfHllFree(&week);
+    dfHllFree(&direct);
+    printf("testDfApproxUniqueCount passed.\n");
+}
+
 /* --------------------------------------------------------------------------
  * testDfProduct
  * -------------------------------------------------------------------------- */
@@ -419,16 +564,263 @@ static void testDfProduct(void)
     seriesAddInt(&s,2);
     seriesAddInt(&s,3);
     seriesAddInt(&s,4);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double prod = df.product(&df, 0);
+    double prod = df.ops->product(&df, 0);
     assert(prod==24.0);
 
     DataFrame_Destroy(&df);
     printf("testDfProduct passed.\n");
 }
 
+/* --------------------------------------------------------------------------
+ * testDfSimdReductions: every kernel set the CPU has agrees with a plain loop
+ * -------------------------------------------------------------------------- */
+static void testDfSimdReductions(void)
+{
+    printf("Running testDfSimdReductions...\n");
+    enum { N = 203 };   // odd length => every kernel runs its tail loop
+    int ints[N];
+    double dbls[N];
+    long long dts[N];
+    for (int i = 0; i < N; i++) {
+        ints[i] = (i * 7919) % 2001 - 1000;
+        dbls[i] = (double)ints[i] / 8.0;
+        dts[i]  = 1700000000000LL + (long long)ints[i] * 1000;
+    }
+    dbls[150] = NAN;   // never picked as min / max
+
+    long long sumI = 0;
+    double sumD = 0.0, sumT = 0.0;
+    int minI = ints[0], maxI = ints[0];
+    long long minT = dts[0], maxT = dts[0];
+    for (int i = 0; i < N; i++) {
+        sumI += ints[i];
+        sumT += (double)dts[i];
+        if (i < 150) sumD += dbls[i];
+        if (ints[i] < minI) minI = ints[i];
+        if (ints[i] > maxI) maxI = ints[i];
+        if (dts[i] < minT) minT = dts[i];
+        if (dts[i] > maxT) maxT = dts[i];
+    }
+
+    DfIsa original = dfReduceIsa();
+    DfIsa isas[3] = { DF_ISA_SCALAR, DF_ISA_SSE2, DF_ISA_AVX2 };
+    for (int k = 0; k < 3; k++) {
+        if (!dfReduceSetIsa(isas[k])) continue;
+        assert(dfReduceIsa() == isas[k]);
+        assert(dfReduceSumInt32(ints, N) == sumI);
+        assert(dfReduceMinInt32(ints, N) == minI && dfReduceMaxInt32(ints, N) == maxI);
+        assert(dfReduceMinInt64(dts, N) == minT && dfReduceMaxInt64(dts, N) == maxT);
+        assertAlmostEqual(dfReduceSumInt64(dts, N), sumT, 1e-3);
+        assertAlmostEqual(dfReduceSumDouble(dbls, 150), sumD, 1e-9);
+        assert(dfReduceMinDouble(dbls, N) == minI / 8.0 && dfReduceMaxDouble(dbls, N) == maxI / 8.0);
+        assert(dfReduceMinInt32(ints, 0) == INT_MAX && dfReduceProductDouble(dbls, 0) == 1.0);
+
+        double twos[40];
+        for (int i = 0; i < 40; i++) twos[i] = (i % 2) ? 2.0 : 0.5;
+        twos[39] = 3.0;
+        assert(dfReduceProductDouble(twos, 40) == 1.5);   // 0.5^20 * 2^19 * 3, exact in any order
+        assert(dfReduceProductInt32(ints + 1, 9) == (double)ints[1] * ints[2] * ints[3] * ints[4] *
+               ints[5] * ints[6] * ints[7] * ints[8] * ints[9]);
+
+        // through the frame: nulls split the column into vector runs
+        DataFrame df;
+        DataFrame_Create(&df);
+        Series s;
+        seriesInit(&s, "Px", DF_INT);
+        long long expected = 0;
+        int lo = INT_MAX, hi = INT_MIN;
+        for (int i = 0; i < N; i++) {
+            if (i == 70 || i == 71 || i == 190) {
+                seriesAddNull(&s);
+            } else {
+                seriesAddInt(&s, ints[i]);
+                expected += ints[i];
+                if (ints[i] < lo) lo = ints[i];
+                if (ints[i] > hi) hi = ints[i];
+            }
+        }
+        df.ops->addSeries(&df, &s);
+        seriesFree(&s);
+        assert(df.ops->sum(&df, 0) == (double)expected);
+        assert(df.ops->min(&df, 0) == (double)lo && df.ops->max(&df, 0) == (double)hi);
+        DataFrame_Destroy(&df);
+    }
+    dfReduceSetIsa(original);
+    printf("testDfSimdReductions passed.\n");
+}
+
+/* --------------------------------------------------------------------------
+ * testDfSelection: order statistics without sorting agree with a sort
+ * -------------------------------------------------------------------------- */
+static int cmpDoubleAsc(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void testDfSelection(void)
+{
+    printf("Running testDfSelection...\n");
+    // random, few distinct values, sorted and reversed; > 600 rows uses Floyd-Rivest sampling
+    enum { N = 5003 };
+    static double data[N], sorted[N], work[N];
+    for (int shape = 0; shape < 4; shape++) {
+        unsigned x = 12345u;
+        for (int i = 0; i < N; i++) {
+            x = x * 1103515245u + 12345u;
+            switch (shape) {
+                case 0:  data[i] = (double)(x >> 8) / 1024.0; break;
+                case 1:  data[i] = (double)((x >> 16) % 7);   break;
+                case 2:  data[i] = (double)i;                 break;
+                default: data[i] = (double)(N - i);           break;
+            }
+        }
+        memcpy(sorted, data, sizeof(data));
+        qsort(sorted, N, sizeof(double), cmpDoubleAsc);
+
+        size_t ks[5] = { 0, 17, N / 2, N - 2, N - 1 };
+        for (int k = 0; k < 5; k++) {
+            memcpy(work, data, sizeof(data));
+            assert(dfSelectInPlace(work, N, ks[k]) == sorted[ks[k]]);
+            for (size_t i = 0; i < ks[k]; i++) assert(work[i] <= work[ks[k]]);
+        }
+        size_t ranks[4] = { 3, 1250, 1251, 4000 };
+        memcpy(work, data, sizeof(data));
+        dfSelectRanksInPlace(work, N, ranks, 4);
+        for (int k = 0; k < 4; k++) assert(work[ranks[k]] == sorted[ranks[k]]);
+    }
+
+    // through the frame: nulls skipped, several q from one call
+    DataFrame df;
+    DataFrame_Create(&df);
+    Series s;
+    seriesInit(&s, "Latency", DF_INT);
+    for (int i = 0; i < 1000; i++) {
+        if (i % 10 == 3) seriesAddNull(&s);
+        else seriesAddInt(&s, (i * 37) % 1000);
+    }
+    df.ops->addSeries(&df, &s);
+    seriesFree(&s);
+
+    double qs[4] = { 0.5, 0.99, 0.0, 0.25 };
+    double out[4];
+    assert(df.ops->quantiles(&df, 0, qs, 4, out));
+    for (int k = 0; k < 4; k++) {
+        assertAlmostEqual(out[k], df.ops->quantile(&df, 0, qs[k]), 1e-12);
+    }
+    assertAlmostEqual(out[0], df.ops->median(&df, 0), 1e-12);
+    assertAlmostEqual(df.ops->iqr(&df, 0), df.ops->quantile(&df, 0, 0.75) - out[3], 1e-12);
+    assert(df.ops->nthSmallest(&df, 0, 1) == out[2]);
+    assert(df.ops->nthLargest(&df, 0, 1) == df.ops->max(&df, 0));
+    assert(df.ops->nthLargest(&df, 0, 901) == 0.0);   // only 900 non-null values
+
+    DataFrame_Destroy(&df);
+    printf("testDfSelection passed.\n");
+}
+
+/* --------------------------------------------------------------------------
+ * testDfApproxQuantile: t-digest sketches vs exact ranks
+ * -------------------------------------------------------------------------- */
+
+/* Fraction of sorted[0..n) below x: the rank error of an estimate is |rank - q|. */
+static double rankOf(const double* sorted, size_t n, double x)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (sorted[mid] < x) lo = mid + 1; else hi = mid;
+    }
+    return (double)lo / (double)n;
+}
+
+static void testDfApproxQuantile(void)
+{
+    printf("Running testDfApproxQuantile...\n");
+    // 200k skewed "latencies", 4 partitions of 50k
+    enum { N = 200000, PARTS = 4 };
+    static double sorted[N];
+    DataFrame df;
+    DataFrame_Create(&df);
+    Series s;
+    seriesInit(&s, "LatencyMs", DF_DOUBLE);
+    unsigned x = 777u;
+    for (int i = 0; i < N; i++) {
+        x = x * 1103515245u + 12345u;
+        double u = ((double)(x >> 8) + 0.5) / 16777216.0;
+        sorted[i] = -log(u) * 20.0;          // exponential, long right tail
+        seriesAddDouble(&s, sorted[i]);
+    }
+    df.ops->addSeries(&df, &s);
+    qsort(sorted, N, sizeof(double), cmpDoubleAsc);
+
+    const double qs[3] = { 0.5, 0.99, 0.999 };
+    for (int k = 0; k < 3; k++) {
+        double est = df.ops->approxQuantile(&df, 0, qs[k], 0.01);
+        assert(fabs(rankOf(sorted, N, est) - qs[k]) < 0.01);
+    }
+
+    // per-partition sketches, serialized, shipped and merged
+    DfQuantileSketch merged;
+    assert(dfSketchInit(&merged, 0.001));
+    for (int p = 0; p < PARTS; p++) {
+        Series part;
+        seriesSlice(&s, (size_t)p * (N / PARTS), N / PARTS, &part);
+        DfQuantileSketch sk;
+        assert(dfSketchInit(&sk, 0.001));
+        assert(dfSketchAddSeries(&sk, &part, 0));
+        seriesFree(&part);
+
+        size_t len = dfSketchSerialize(&sk, NULL, 0);
+        uint8_t* bytes = (uint8_t*)malloc(len);
+        assert(bytes && dfSketchSerialize(&sk, bytes, len) == len);
+        DfQuantileSketch copy;
+        assert(dfSketchDeserialize(&copy, bytes, len));
+        assert(dfSketchQuantile(&copy, 0.99) == dfSketchQuantile(&sk, 0.99));
+        free(bytes);
+
+        assert(dfSketchMerge(&merged, &copy));
+        dfSketchFree(&copy);
+        dfSketchFree(&sk);
+    }
+    assert(dfSketchCount(&merged) == (double)N);
+    for (int k = 0; k < 3; k++) {
+        double est = dfSketchQuantile(&merged, qs[k]);
+        assert(fabs(rankOf(sorted, N, est) - qs[k]) < 0.001);
+    }
+    assert(dfSketchQuantile(&merged, 0.0) == sorted[0] && dfSketchQuantile(&merged, 1.0) == sorted[N - 1]);
+    dfSketchFree(&merged);
+
+    // incremental: follow a growing column
+    DfQuantileSketch live;
+    assert(dfSketchInit(&live, 0.01));
+    Series grow;
+    seriesInit(&grow, "Grow", DF_INT);
+    size_t seen = 0;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 1000; i++) {
+            if (i % 100 == 0) seriesAddNull(&grow);
+            else seriesAddInt(&grow, round * 1000 + i);
+        }
+        assert(dfSketchAddSeries(&live, &grow, seen));
+        seen = seriesSize(&grow);
+    }
+    assert(dfSketchCount(&live) == 2970.0);
+    assert(fabs(dfSketchQuantile(&live, 0.5) - 1500.0) < 30.0);
+    dfSketchFree(&live);
+    seriesFree(&grow);
+
+    uint8_t junk[8] = { 0 };
+    DfQuantileSketch bad;
+    assert(!dfSketchDeserialize(&bad, junk, sizeof(junk)));
+
+    seriesFree(&s);
+    DataFrame_Destroy(&df);
+    printf("testDfApproxQuantile passed.\n");
+}
+
 /* --------------------------------------------------------------------------
  * testDfNthLargest
  * -------------------------------------------------------------------------- */
@@ -446,13 +838,13 @@ static void testDfNthLargest(void)
     seriesAddDouble(&s,1);
     seriesAddDouble(&s,9);
     seriesAddDouble(&s,20);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // sorted desc => [20,10,9,5,1]
     // nth largest(1) => 20, nth largest(3) => 9
-    double l1 = df.nthLargest(&df,0,1);
-    double l3 = df.nthLargest(&df,0,3);
+    double l1 = df.ops->nthLargest(&df,0,1);
+    double l3 = df.ops->nthLargest(&df,0,3);
     assert(l1==20.0);
     assert(l3==9.0);
 
@@ -476,12 +868,12 @@ static void testDfNthSmallest(void)
     seriesAddInt(&s,3);
     seriesAddInt(&s,5);
     seriesAddInt(&s,7);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // sorted ascending => [3,5,7,10], so 1st => 3, 2nd => 5
-    double s1 = df.nthSmallest(&df,0,1);
-    double s2 = df.nthSmallest(&df,0,2);
+    double s1 = df.ops->nthSmallest(&df,0,1);
+    double s2 = df.ops->nthSmallest(&df,0,2);
     assert(s1==3.0);
     assert(s2==5.0);
 
@@ -505,10 +897,10 @@ static void testDfSkewness(void)
     for (int i=0; i<5; i++){
         seriesAddDouble(&s, arr[i]);
     }
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double sk = df.skewness(&df, 0);
+    double sk = df.ops->skewness(&df, 0);
     // We'll just check it's >0
     assert(sk>0.0);
 
@@ -532,10 +924,10 @@ static void testDfKurtosis(void)
     for (int i=0; i<5; i++){
         seriesAddDouble(&s, arr[i]);
     }
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    double kurt = df.kurtosis(&df, 0);
+    double kurt = df.ops->kurtosis(&df, 0);
     // Check it's > 0. Typically big outlier => large positive kurt
     assert(kurt>0.0);
 
@@ -563,13 +955,13 @@ static void testDfCovariance(void)
     seriesAddInt(&sy,4);
     seriesAddInt(&sy,6);
 
-    df.addSeries(&df, &sx);
-    df.addSeries(&df, &sy);
+    df.ops->addSeries(&df, &sx);
+    df.ops->addSeries(&df, &sy);
 
     seriesFree(&sx);
     seriesFree(&sy);
 
-    double cov = df.covariance(&df, 0,1);
+    double cov = df.ops->covariance(&df, 0,1);
     // Y=2X => perfect correlation => sample cov>0
     assert(cov>0.0);
 
@@ -599,12 +991,12 @@ static void testDfCorrelation(void)
     seriesAddInt(&sy,40);
     seriesAddInt(&sy,60);
 
-    df.addSeries(&df, &sx);
-    df.addSeries(&df, &sy);
+    df.ops->addSeries(&df, &sx);
+    df.ops->addSeries(&df, &sy);
     seriesFree(&sx);
     seriesFree(&sy);
 
-    double corr = df.correlation(&df, 0,1);
+    double corr = df.ops->correlation(&df, 0,1);
     // should be near 1
     assertAlmostEqual(corr,1.0,1e-5);
 
@@ -629,12 +1021,12 @@ static void testDfUniqueValues(void)
     seriesAddInt(&s,5);
     seriesAddInt(&s,7);
     seriesAddInt(&s,5);
-    df.addSeries(&df,&s);
+    df.ops->addSeries(&df,&s);
     seriesFree(&s);
 
-    DataFrame uniqueDF = df.uniqueValues(&df, 0);
+    DataFrame uniqueDF = df.ops->uniqueValues(&df, 0);
     // distinct => {2,5,7} => expect 3 rows
-    size_t rowCount = uniqueDF.numRows(&uniqueDF);
+    size_t rowCount = uniqueDF.ops->numRows(&uniqueDF);
     assert(rowCount==3);
 
     DataFrame_Destroy(&uniqueDF);
@@ -657,12 +1049,12 @@ static void testDfValueCounts(void)
     seriesAddString(&s, "apple");
     seriesAddString(&s, "apple");
     seriesAddString(&s, "banana");
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    DataFrame vc = df.valueCounts(&df, 0);
+    DataFrame vc = df.ops->valueCounts(&df, 0);
     // Expect 2 distinct => ("apple"(2), "banana"(1))
-    size_t rowCount = vc.numRows(&vc);
+    size_t rowCount = vc.ops->numRows(&vc);
     assert(rowCount==2);
 
     DataFrame_Destroy(&vc);
@@ -685,12 +1077,12 @@ static void testDfCumulativeSum(void)
     seriesAddDouble(&s,1.0);
     seriesAddDouble(&s,2.0);
     seriesAddDouble(&s,3.0);
-    df.addSeries(&df,&s);
+    df.ops->addSeries(&df,&s);
     seriesFree(&s);
 
-    DataFrame cs = df.cumulativeSum(&df, 0);
+    DataFrame cs = df.ops->cumulativeSum(&df, 0);
     // col "cumsum" => [1.0, 3.0, 6.0]
-    const Series* csumCol = cs.getSeries(&cs, 0);
+    const Series* csumCol = cs.ops->getSeries(&cs, 0);
     assert(csumCol && csumCol->type==DF_DOUBLE);
 
     double v0,v1,v2;
@@ -721,12 +1113,12 @@ static void testDfCumulativeProduct(void)
     seriesAddInt(&s,2);
     seriesAddInt(&s,2);
     seriesAddInt(&s,3);
-    df.addSeries(&df,&s);
+    df.ops->addSeries(&df,&s);
     seriesFree(&s);
 
-    DataFrame cp = df.cumulativeProduct(&df,0);
+    DataFrame cp = df.ops->cumulativeProduct(&df,0);
     // expect => [2,4,12]
-    const Series* cprodCol = cp.getSeries(&cp, 0);
+    const Series* cprodCol = cp.ops->getSeries(&cp, 0);
     double v0,v1,v2;
     seriesGetDouble(cprodCol,0,&v0);
     seriesGetDouble(cprodCol,1,&v1);
@@ -756,12 +1148,12 @@ static void testDfCumulativeMax(void)
     seriesAddInt(&s,3);
     seriesAddInt(&s,2);
     seriesAddInt(&s,5);
-    df.addSeries(&df,&s);
+    df.ops->addSeries(&df,&s);
     seriesFree(&s);
 
-    DataFrame cm = df.cumulativeMax(&df,0);
+    DataFrame cm = df.ops->cumulativeMax(&df,0);
     // row0 =>1, row1=>3, row2=>3, row3=>5
-    const Series* cmaxCol = cm.getSeries(&cm,0);
+    const Series* cmaxCol = cm.ops->getSeries(&cm,0);
     double v0,v1,v2,v3;
     seriesGetDouble(cmaxCol,0,&v0);
     seriesGetDouble(cmaxCol,1,&v1);
@@ -793,12 +1185,12 @@ static void testDfCumulativeMin(void)
     seriesAddInt(&s,2);
     seriesAddInt(&s,5);
     seriesAddInt(&s,1);
-    df.addSeries(&df,&s);
+    df.ops->addSeries(&df,&s);
     seriesFree(&s);
 
-    DataFrame cmi = df.cumulativeMin(&df,0);
+    DataFrame cmi = df.ops->cumulativeMin(&df,0);
     // row0=>3, row1=>2, row2=>2, row3=>1
-    const Series* cminCol = cmi.getSeries(&cmi,0);
+    const Series* cminCol = cmi.ops->getSeries(&cmi,0);
     double v0,v1,v2,v3;
     seriesGetDouble(cminCol,0,&v0);
     seriesGetDouble(cminCol,1,&v1);
@@ -831,12 +1223,12 @@ static void testDfGroupBy(void)
     seriesAddString(&s,"banana");
     seriesAddString(&s,"banana");
     seriesAddString(&s,"apple");
-    df.addSeries(&df,&s);
+    df.ops->addSeries(&df,&s);
     seriesFree(&s);
 
-    DataFrame g = df.groupBy(&df,0);
+    DataFrame g = df.ops->groupBy(&df,0);
     // We expect 2 rows => group => "apple", "banana"
-    size_t r = g.numRows(&g);
+    size_t r = g.ops->numRows(&g);
     assert(r==2);
 
     DataFrame_Destroy(&g);
@@ -844,6 +1236,99 @@ static void testDfGroupBy(void)
     printf("testDfGroupBy passed.\n");
 }
 
+/* --------------------------------------------------------------------------
+ * testDfGroupByCategory
+ *   groupBy / valueCounts / uniqueCount on a DF_CATEGORY column count codes.
+ * -------------------------------------------------------------------------- */
+static void testDfGroupByCategory(void)
+{
+    printf("Running testDfGroupByCategory...\n");
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    // DF_CATEGORY => ["AAPL","MSFT","AAPL","IBM","AAPL"]
+    const char* tickers[] = {"AAPL","MSFT","AAPL","IBM","AAPL"};
+    Series s;
+    seriesInit(&s, "Ticker", DF_CATEGORY);
+    for (int i = 0; i < 5; i++) {
+        seriesAddString(&s, tickers[i]);
+    }
+    df.ops->addSeries(&df,&s);
+    seriesFree(&s);
+
+    DataFrame g = df.ops->groupBy(&df,0);
+    assert(g.ops->numRows(&g)==3);
+    const Series* grp = g.ops->getSeries(&g,0);
+    const Series* cnt = g.ops->getSeries(&g,1);
+    const char* label = NULL;
+    int c = 0;
+    // first-appearance order => AAPL(3), MSFT(1), IBM(1)
+    assert(seriesGetStringView(grp,0,&label,NULL) && strcmp(label,"AAPL")==0);
+    assert(seriesGetInt(cnt,0,&c) && c==3);
+    assert(seriesGetStringView(grp,2,&label,NULL) && strcmp(label,"IBM")==0);
+    assert(seriesGetInt(cnt,2,&c) && c==1);
+    DataFrame_Destroy(&g);
+
+    DataFrame vc = df.ops->valueCounts(&df,0);
+    assert(vc.ops->numRows(&vc)==3);
+    assert(seriesGetInt(vc.ops->getSeries(&vc,1),0,&c) && c==3);
+    DataFrame_Destroy(&vc);
+
+    assertAlmostEqual(df.ops->uniqueCount(&df,0), 3.0, 1e-9);
+
+    DataFrame_Destroy(&df);
+    printf("testDfGroupByCategory passed.\n");
+}
+
+static void testDfNarrowTypes(void)
+{
+    printf("Running testDfNarrowTypes...\n");
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    // uint16 codes 3, 60000, 3, null, 7 and int64 volumes
+    Series codes, vols;
+    seriesInit(&codes, "Code", DF_UINT16);
+    seriesInit(&vols, "Volume", DF_INT64);
+    uint16_t codeVals[] = { 3, 60000, 3, 0, 7 };
+    for (int i = 0; i < 5; i++) {
+        if (i == 3) seriesAddNull(&codes);
+        else seriesAddUInt16(&codes, codeVals[i]);
+        seriesAddInt64(&vols, (int64_t)(i + 1) * 3000000000LL);
+    }
+    df.ops->addSeriesMove(&df, &codes);
+    df.ops->addSeriesMove(&df, &vols);
+
+    assertAlmostEqual(df.ops->sum(&df,0), 60013.0, 1e-9);
+    assertAlmostEqual(df.ops->min(&df,0), 3.0, 1e-9);
+    assertAlmostEqual(df.ops->max(&df,0), 60000.0, 1e-9);
+    assertAlmostEqual(df.ops->median(&df,0), 5.0, 1e-9);
+    assertAlmostEqual(df.ops->max(&df,1), 15000000000.0, 1e-9);
+    assertAlmostEqual(df.ops->mean(&df,1), 9000000000.0, 1e-9);
+
+    // distinct values keep the column's type
+    DataFrame vc = df.ops->valueCounts(&df, 0);
+    const Series* value = vc.ops->getSeries(&vc, 0);
+    assert(value->type == DF_UINT16 && seriesSize(value) == 3);
+    int cnt = 0;
+    assert(seriesGetInt(vc.ops->getSeries(&vc, 1), 0, &cnt) && cnt == 2);
+    DataFrame_Destroy(&vc);
+
+    DataFrame uv = df.ops->uniqueValues(&df, 1);
+    assert(uv.ops->getSeries(&uv, 0)->type == DF_INT64);
+    assert(uv.ops->numRows(&uv) == 5);
+    DataFrame_Destroy(&uv);
+
+    DataFrame gb = df.ops->groupBy(&df, 0);
+    const char* key = NULL;
+    assert(gb.ops->numRows(&gb) == 4);   // 3, 60000, 7 and the null row
+    assert(seriesGetStringView(gb.ops->getSeries(&gb, 0), 1, &key, NULL) && strcmp(key, "60000") == 0);
+    DataFrame_Destroy(&gb);
+
+    DataFrame_Destroy(&df);
+    printf("testDfNarrowTypes passed.\n");
+}
+
 /* --------------------------------------------------------------------------
  * Master aggregator test function
  * -------------------------------------------------------------------------- */
@@ -863,8 +1348,14 @@ void testAggregate(void)
     testDfQuantile();
     testDfIQR();
     testDfNullCount();
+    testDfNullSkipping();
+    testDfNarrowTypes();
     testDfUniqueCount();
+    testDfApproxUniqueCount();
     testDfProduct();
+    testDfSimdReductions();
+    testDfSelection();
+    testDfApproxQuantile();
     testDfNthLargest();
     testDfNthSmallest();
     testDfSkewness();
@@ -878,6 +1369,7 @@ void testAggregate(void)
     testDfCumulativeMax();
     testDfCumulativeMin();
     testDfGroupBy();
+    testDfGroupByCategory();
 
     printf("All aggregator tests passed successfully!\n");
 }
@@ -43,12 +43,12 @@ static void testConcatBasic(void)
     const char* col2_top[] = { "Alpha", "Beta", "Gamma" };
 
     Series s1 = buildIntSeries("Numbers", col1_top, 3);
-    bool ok = top.addSeries(&top, &s1);
+    bool ok = top.ops->addSeries(&top, &s1);
     assert(ok);
     seriesFree(&s1);
 
     Series s2 = buildStringSeries("Words", col2_top, 3);
-    ok = top.addSeries(&top, &s2);
+    ok = top.ops->addSeries(&top, &s2);
     assert(ok);
     seriesFree(&s2);
 
@@ -60,22 +60,22 @@ static void testConcatBasic(void)
     const char* col2_bot[] = { "Delta", "Epsilon" };
 
     Series s3 = buildIntSeries("Numbers", col1_bot, 2);
-    bottom.addSeries(&bottom, &s3);
+    bottom.ops->addSeries(&bottom, &s3);
     seriesFree(&s3);
 
     Series s4 = buildStringSeries("Words", col2_bot, 2);
-    bottom.addSeries(&bottom, &s4);
+    bottom.ops->addSeries(&bottom, &s4);
     seriesFree(&s4);
 
     // Now concat
-    DataFrame concatDF = top.concat(&top, &bottom);
+    DataFrame concatDF = top.ops->concat(&top, &bottom);
 
     // Expect 5 rows, 2 columns
-    assert(concatDF.numColumns(&concatDF)==2);
-    assert(concatDF.numRows(&concatDF)==5);
+    assert(concatDF.ops->numColumns(&concatDF)==2);
+    assert(concatDF.ops->numRows(&concatDF)==5);
 
     // Check data in "Numbers"
-    const Series* numbers = concatDF.getSeries(&concatDF, 0);
+    const Series* numbers = concatDF.ops->getSeries(&concatDF, 0);
     assert(strcmp(numbers->name, "Numbers")==0);
     // row0 =>10, row1 =>20, row2=>30, row3=>40, row4=>50
     for (size_t r=0; r<5; r++) {
@@ -87,7 +87,7 @@ static void testConcatBasic(void)
     }
 
     // Check data in "Words"
-    const Series* words = concatDF.getSeries(&concatDF,1);
+    const Series* words = concatDF.ops->getSeries(&concatDF,1);
     assert(strcmp(words->name,"Words")==0);
     // row0=>"Alpha", row1=>"Beta", row2=>"Gamma", row3=>"Delta", row4=>"Epsilon"
     const char* expectedWords[5] = {"Alpha","Beta","Gamma","Delta","Epsilon"};
@@ -106,6 +106,55 @@ static void testConcatBasic(void)
     printf(" - dfConcat_impl test passed.\n");
 }
 
+// ------------------------------------------------------------------
+// 1b) dfConcat_impl over chunked columns: chunks are linked, not copied
+// ------------------------------------------------------------------
+static void testConcatChunked(void)
+{
+    printf("Testing dfConcat_impl with chunked columns...\n");
+
+    // an ingest frame whose column is chunked by 4 rows
+    DataFrame feed;
+    DataFrame_Create(&feed);
+    Series px;
+    seriesInitChunked(&px, "Px", DF_DOUBLE, 4);
+    for (int i = 0; i < 6; i++) seriesAddDouble(&px, 100.0 + i);
+    feed.ops->addSeriesMove(&feed, &px);
+
+    // a batch big enough to be linked whole
+    DataFrame batch;
+    DataFrame_Create(&batch);
+    Series b;
+    seriesInit(&b, "Px", DF_DOUBLE);
+    for (int i = 0; i < 4; i++) seriesAddDouble(&b, 200.0 + i);
+    batch.ops->addSeriesMove(&batch, &b);
+
+    DataFrame all = feed.ops->concat(&feed, &batch);
+    const Series* col = all.ops->getSeries(&all, 0);
+    assert(all.ops->numRows(&all) == 10 && seriesIsChunked(col));
+    assert(seriesDoubleData(seriesChunk(col, seriesChunkCount(col) - 1))
+           == seriesDoubleData(batch.ops->getSeries(&batch, 0)));
+
+    // read kernels walk the chunks
+    assert(all.ops->sum(&all, 0) == 6 * 100.0 + 15.0 + 4 * 200.0 + 6.0);
+    assert(all.ops->min(&all, 0) == 100.0);
+    assert(all.ops->max(&all, 0) == 203.0);
+
+    // appending rows only touches the tail chunk
+    const void* row[1];
+    double v = 300.0;
+    row[0] = &v;
+    assert(all.ops->addRow(&all, row));
+    assert(all.ops->max(&all, 0) == 300.0 && all.ops->numRows(&all) == 11);
+    double got = 0.0;
+    assert(seriesGetDouble(batch.ops->getSeries(&batch, 0), 3, &got) && got == 203.0);
+
+    DataFrame_Destroy(&all);
+    DataFrame_Destroy(&batch);
+    DataFrame_Destroy(&feed);
+    printf(" - dfConcat_impl chunked test passed.\n");
+}
+
 // ------------------------------------------------------------------
 // 2) Test dfMerge_impl
 // ------------------------------------------------------------------
@@ -122,11 +171,11 @@ static void testMergeBasic(void)
     int colA[]     = {100,200,300,400};
 
     Series sKeyLeft = buildIntSeries("Key", keysLeft, 4);
-    left.addSeries(&left, &sKeyLeft);
+    left.ops->addSeries(&left, &sKeyLeft);
     seriesFree(&sKeyLeft);
 
     Series sA = buildIntSeries("A", colA, 4);
-    left.addSeries(&left, &sA);
+    left.ops->addSeries(&left, &sA);
     seriesFree(&sA);
 
     // Right DF => columns: "kid"(int), "B"(string)
@@ -138,25 +187,25 @@ static void testMergeBasic(void)
     const char* colB[] = {"two","three","five"};
 
     Series sKid = buildIntSeries("kid", keysRight, 3);
-    right.addSeries(&right, &sKid);
+    right.ops->addSeries(&right, &sKid);
     seriesFree(&sKid);
 
     Series sB = buildStringSeries("B", colB, 3);
-    right.addSeries(&right, &sB);
+    right.ops->addSeries(&right, &sB);
     seriesFree(&sB);
 
     // Merge => leftKey="Key", rightKey="kid"
-    DataFrame merged = left.merge(&left, &right, "Key","kid");
+    DataFrame merged = left.ops->merge(&left, &right, "Key","kid");
     // We expect an inner join => matches on key=2,3 => so 2 rows
     // columns => [ Key, A, B ]
-    assert(merged.numColumns(&merged)==3);
-    assert(merged.numRows(&merged)==2);
+    assert(merged.ops->numColumns(&merged)==3);
+    assert(merged.ops->numRows(&merged)==2);
 
     // check row0 => Key=2 => A=200 => B="two"
     // check row1 => Key=3 => A=300 => B="three"
-    const Series* keyMerged = merged.getSeries(&merged,0);
-    const Series* aMerged   = merged.getSeries(&merged,1);
-    const Series* bMerged   = merged.getSeries(&merged,2);
+    const Series* keyMerged = merged.ops->getSeries(&merged,0);
+    const Series* aMerged   = merged.ops->getSeries(&merged,1);
+    const Series* bMerged   = merged.ops->getSeries(&merged,2);
 
     assert(strcmp(keyMerged->name,"Key")==0);
     assert(strcmp(aMerged->name,"A")==0);
@@ -211,11 +260,11 @@ static void testJoinBasic(void)
     int colA[]     = {100,200,300,400};
 
     Series sKeyLeft = buildIntSeries("Key", keysLeft, 4);
-    left.addSeries(&left, &sKeyLeft);
+    left.ops->addSeries(&left, &sKeyLeft);
     seriesFree(&sKeyLeft);
 
     Series sA = buildIntSeries("A", colA, 4);
-    left.addSeries(&left, &sA);
+    left.ops->addSeries(&left, &sA);
     seriesFree(&sA);
 
     DataFrame right;
@@ -225,24 +274,24 @@ static void testJoinBasic(void)
     const char* colC[] = {"two","four","five"};
 
     Series sKeyRight = buildIntSeries("Key2", keysRight, 3);
-    right.addSeries(&right, &sKeyRight);
+    right.ops->addSeries(&right, &sKeyRight);
     seriesFree(&sKeyRight);
 
     Series sC = buildStringSeries("C", colC, 3);
-    right.addSeries(&right, &sC);
+    right.ops->addSeries(&right, &sC);
     seriesFree(&sC);
 
     // a) JOIN_INNER => matches are Key=2,4 => expect 2 rows => columns => [Key, A, C]
     {
-        DataFrame joined = left.join(&left, &right, "Key","Key2", JOIN_INNER);
-        assert(joined.numColumns(&joined)==3);
-        assert(joined.numRows(&joined)==2);
+        DataFrame joined = left.ops->join(&left, &right, "Key","Key2", JOIN_INNER);
+        assert(joined.ops->numColumns(&joined)==3);
+        assert(joined.ops->numRows(&joined)==2);
 
         // row0 => Key=2 => A=200 => C="two"
         // row1 => Key=4 => A=400 => C="four"
-        const Series* k = joined.getSeries(&joined, 0);
-        const Series* a = joined.getSeries(&joined, 1);
-        const Series* c = joined.getSeries(&joined, 2);
+        const Series* k = joined.ops->getSeries(&joined, 0);
+        const Series* a = joined.ops->getSeries(&joined, 1);
+        const Series* c = joined.ops->getSeries(&joined, 2);
 
         int kv; seriesGetInt(k, 0, &kv); assert(kv==2);
         int av; seriesGetInt(a, 0, &av); assert(av==200);
@@ -255,20 +304,20 @@ static void testJoinBasic(void)
         DataFrame_Destroy(&joined);
     }
 
-    // b) JOIN_LEFT => keep unmatched left => Key=1,3 => those rows => right columns => "NA"
+    // b) JOIN_LEFT => keep unmatched left => Key=1,3 => those rows => right columns => null
     {
-        DataFrame joined = left.join(&left, &right, "Key","Key2", JOIN_LEFT);
+        DataFrame joined = left.ops->join(&left, &right, "Key","Key2", JOIN_LEFT);
         // matched => Key=2,4 => 2 rows
         // unmatched => Key=1,3 => 2 rows => total 4 rows
         // columns => [Key,A,C]
-        assert(joined.numColumns(&joined)==3);
-        assert(joined.numRows(&joined)==4);
+        assert(joined.ops->numColumns(&joined)==3);
+        assert(joined.ops->numRows(&joined)==4);
 
-        const Series* k = joined.getSeries(&joined,0);
-        const Series* a = joined.getSeries(&joined,1);
-        const Series* c = joined.getSeries(&joined,2);
+        const Series* k = joined.ops->getSeries(&joined,0);
+        const Series* a = joined.ops->getSeries(&joined,1);
+        const Series* c = joined.ops->getSeries(&joined,2);
 
-        // row0 => key=1 => A=100 => c="NA"
+        // row0 => key=1 => A=100 => c=null
         {
             int kv; bool g= seriesGetInt(k, 0, &kv);
             assert(g && kv==1);
@@ -276,8 +325,7 @@ static void testJoinBasic(void)
             assert(g && av==100);
             char* st=NULL;
             g= seriesGetString(c,0,&st);
-            assert(g && strcmp(st,"NA")==0);
-            free(st);
+            assert(!g && seriesIsNull(c,0));
         }
         // row1 => key=2 => c="two"
         {
@@ -289,16 +337,20 @@ static void testJoinBasic(void)
             assert(strcmp(st,"two")==0);
             free(st);
         }
-        // row2 => key=3 => c="NA"
+        // row2 => key=3 => c=null
         {
             int kv; seriesGetInt(k,2,&kv);
             assert(kv==3);
             int av; seriesGetInt(a,2,&av);
             assert(av==300);
-            char* st=NULL; seriesGetString(c,2,&st);
-            assert(strcmp(st,"NA")==0);
-            free(st);
+            assert(seriesIsNull(c,2));
         }
+        assert(seriesNullCount(c)==2);
+
+        // dropNA removes the unmatched (padded) rows
+        DataFrame matched = joined.ops->dropNA(&joined);
+        assert(matched.ops->numRows(&matched)==2);
+        DataFrame_Destroy(&matched);
         // row3 => key=4 => c="four"
         {
             int kv; seriesGetInt(k,3,&kv);
@@ -313,18 +365,18 @@ static void testJoinBasic(void)
         DataFrame_Destroy(&joined);
     }
 
-    // c) JOIN_RIGHT => keep unmatched right => Key2=5 => that row => left columns => "NA"
+    // c) JOIN_RIGHT => keep unmatched right => Key2=5 => that row => left columns => null
     {
-        DataFrame joined = left.join(&left, &right, "Key","Key2", JOIN_RIGHT);
+        DataFrame joined = left.ops->join(&left, &right, "Key","Key2", JOIN_RIGHT);
         // matched => Key=2,4 => 2 rows
         // unmatched => Key2=5 => 1 row => total 3 rows
         // columns => [Key,A,C]
-        assert(joined.numColumns(&joined)==3);
-        assert(joined.numRows(&joined)==3);
+        assert(joined.ops->numColumns(&joined)==3);
+        assert(joined.ops->numRows(&joined)==3);
 
-        const Series* k = joined.getSeries(&joined, 0);
-        const Series* a = joined.getSeries(&joined, 1);
-        const Series* c = joined.getSeries(&joined, 2);
+        const Series* k = joined.ops->getSeries(&joined, 0);
+        const Series* a = joined.ops->getSeries(&joined, 1);
+        const Series* c = joined.ops->getSeries(&joined, 2);
 
         // row0 => key=2 => a=200 => c="two"
         {
@@ -346,12 +398,12 @@ static void testJoinBasic(void)
             assert(g && strcmp(st,"four")==0);
             free(st);
         }
-        // row2 => Key=0 => A=0 => c="five" 
+        // row2 => Key=null => A=null => c="five"
         {
             int kv; bool g= seriesGetInt(k,2,&kv);
-            assert(g && kv==0);  // we store int "NA" as 0
+            assert(!g && seriesIsNull(k,2));
             int av; g= seriesGetInt(a,2,&av);
-            assert(g && av==0);
+            assert(!g && seriesIsNull(a,2));
             char* st=NULL; g= seriesGetString(c,2,&st);
             assert(g && strcmp(st,"five")==0);
             free(st);
@@ -378,27 +430,27 @@ static void testUnion(void)
     DataFrame_Create(&dfA);
     int arrA[] = {1,2,2};
     Series sA = buildIntSeries("Val", arrA, 3);
-    dfA.addSeries(&dfA, &sA);
+    dfA.ops->addSeries(&dfA, &sA);
     seriesFree(&sA);
 
     DataFrame dfB;
     DataFrame_Create(&dfB);
     int arrB[] = {2,3};
     Series sB = buildIntSeries("Val", arrB, 2);
-    dfB.addSeries(&dfB, &sB);
+    dfB.ops->addSeries(&dfB, &sB);
     seriesFree(&sB);
 
     // union => [1,2,3]
-    DataFrame un = dfA.unionDF(&dfA, &dfB);
+    DataFrame un = dfA.ops->unionDF(&dfA, &dfB);
     // expect 1 col, 3 rows => distinct => 1,2,3
-    assert(un.numColumns(&un)==1);
-    assert(un.numRows(&un)==3);
+    assert(un.ops->numColumns(&un)==1);
+    assert(un.ops->numRows(&un)==3);
 
     // check that the set is {1,2,3}
     // we won't check order strictly, but let's read them:
     bool found1=false, found2=false, found3=false;
-    const Series* sU = un.getSeries(&un,0);
-    size_t nr = un.numRows(&un);
+    const Series* sU = un.ops->getSeries(&un,0);
+    size_t nr = un.ops->numRows(&un);
     for (size_t r=0; r< nr; r++){
         int v; seriesGetInt(sU, r, &v);
         if (v==1) found1=true;
@@ -425,26 +477,26 @@ static void testIntersection(void)
     DataFrame_Create(&dfA);
     int arrA[] = {2,2,3,4};
     Series sA = buildIntSeries("Num", arrA, 4);
-    dfA.addSeries(&dfA, &sA);
+    dfA.ops->addSeries(&dfA, &sA);
     seriesFree(&sA);
 
     DataFrame dfB;
     DataFrame_Create(&dfB);
     int arrB[] = {2,4,4,5};
     Series sB = buildIntSeries("Num", arrB, 4);
-    dfB.addSeries(&dfB, &sB);
+    dfB.ops->addSeries(&dfB, &sB);
     seriesFree(&sB);
 
-    DataFrame inter = dfA.intersectionDF(&dfA, &dfB);
+    DataFrame inter = dfA.ops->intersectionDF(&dfA, &dfB);
     // expect {2,4} => 2 distinct rows
-    assert(inter.numColumns(&inter)==1);
-    size_t nr= inter.numRows(&inter);
+    assert(inter.ops->numColumns(&inter)==1);
+    size_t nr= inter.ops->numRows(&inter);
     // might have duplicates if implemented literally. If you do a "drop duplicates" approach, expect 2. 
     // We'll assume your code does set-like intersection => 2 unique rows.
 
     assert(nr==2);
 
-    const Series* sI = inter.getSeries(&inter,0);
+    const Series* sI = inter.ops->getSeries(&inter,0);
     bool found2=false, found4=false;
     for (size_t r=0; r< nr; r++){
         int v=0;
@@ -472,24 +524,24 @@ static void testDifference(void)
     DataFrame_Create(&dfA);
     int arrA[] = {1,2,3};
     Series sA = buildIntSeries("Val", arrA, 3);
-    dfA.addSeries(&dfA, &sA);
+    dfA.ops->addSeries(&dfA, &sA);
     seriesFree(&sA);
 
     DataFrame dfB;
     DataFrame_Create(&dfB);
     int arrB[] = {2,4};
     Series sB = buildIntSeries("Val", arrB, 2);
-    dfB.addSeries(&dfB, &sB);
+    dfB.ops->addSeries(&dfB, &sB);
     seriesFree(&sB);
 
-    DataFrame diff = dfA.differenceDF(&dfA, &dfB);
+    DataFrame diff = dfA.ops->differenceDF(&dfA, &dfB);
     // expect [1,3]
-    assert(diff.numColumns(&diff)==1);
-    size_t nr= diff.numRows(&diff);
+    assert(diff.ops->numColumns(&diff)==1);
+    size_t nr= diff.ops->numRows(&diff);
     // might be 2 rows => val=1, val=3
     assert(nr==2);
 
-    const Series* sD = diff.getSeries(&diff,0);
+    const Series* sD = diff.ops->getSeries(&diff,0);
     bool found1=false, found3=false;
     for (size_t r=0; r<nr; r++){
         int v=0;
@@ -519,10 +571,10 @@ static void testSemiJoin(void)
     int keyA[] = {1,2,3};
     int colX[] = {10,20,30};
     Series sKeyA = buildIntSeries("Key", keyA, 3);
-    left.addSeries(&left, &sKeyA);
+    left.ops->addSeries(&left, &sKeyA);
     seriesFree(&sKeyA);
     Series sXA = buildIntSeries("X", colX, 3);
-    left.addSeries(&left, &sXA);
+    left.ops->addSeries(&left, &sXA);
     seriesFree(&sXA);
 
     DataFrame right;
@@ -531,20 +583,20 @@ static void testSemiJoin(void)
     int keyB[] = {2,4};
     const char* colY[] = {"two","four"};
     Series sKeyB = buildIntSeries("Key2", keyB, 2);
-    right.addSeries(&right, &sKeyB);
+    right.ops->addSeries(&right, &sKeyB);
     seriesFree(&sKeyB);
     Series sYB = buildStringSeries("Y", colY, 2);
-    right.addSeries(&right, &sYB);
+    right.ops->addSeries(&right, &sYB);
     seriesFree(&sYB);
 
-    // semiJoin => left->semiJoin(leftKey="Key", rightKey="Key2")
-    DataFrame semi = left.semiJoin(&left, &right, "Key","Key2");
+    // semiJoin => left->ops->semiJoin(leftKey="Key", rightKey="Key2")
+    DataFrame semi = left.ops->semiJoin(&left, &right, "Key","Key2");
     // expect 1 row => Key=2, X=20
-    assert(semi.numColumns(&semi)==2);
-    assert(semi.numRows(&semi)==1);
+    assert(semi.ops->numColumns(&semi)==2);
+    assert(semi.ops->numRows(&semi)==1);
 
-    const Series* k = semi.getSeries(&semi,0);
-    const Series* x = semi.getSeries(&semi,1);
+    const Series* k = semi.ops->getSeries(&semi,0);
+    const Series* x = semi.ops->getSeries(&semi,1);
 
     int kv=0; seriesGetInt(k,0,&kv);
     assert(kv==2);
@@ -570,27 +622,27 @@ static void testAntiJoin(void)
     int keyA[] = {1,2,3};
     int colX[] = {10,20,30};
     Series sKeyA = buildIntSeries("Key", keyA, 3);
-    left.addSeries(&left, &sKeyA);
+    left.ops->addSeries(&left, &sKeyA);
     seriesFree(&sKeyA);
     Series sXA = buildIntSeries("X", colX, 3);
-    left.addSeries(&left, &sXA);
+    left.ops->addSeries(&left, &sXA);
     seriesFree(&sXA);
 
     DataFrame right;
     DataFrame_Create(&right);
     int keyB[] = {2,4};
     Series sKeyB = buildIntSeries("Key2", keyB, 2);
-    right.addSeries(&right, &sKeyB);
+    right.ops->addSeries(&right, &sKeyB);
     seriesFree(&sKeyB);
 
     // do the antiJoin
-    DataFrame anti = left.antiJoin(&left, &right, "Key","Key2");
+    DataFrame anti = left.ops->antiJoin(&left, &right, "Key","Key2");
     // expected => 2 rows => Key=1 => colX=10, Key=3 => colX=30
-    assert(anti.numColumns(&anti)==2);
-    assert(anti.numRows(&anti)==2);
+    assert(anti.ops->numColumns(&anti)==2);
+    assert(anti.ops->numRows(&anti)==2);
 
-    const Series* k = anti.getSeries(&anti,0);
-    const Series* x = anti.getSeries(&anti,1);
+    const Series* k = anti.ops->getSeries(&anti,0);
+    const Series* x = anti.ops->getSeries(&anti,1);
 
     // row0 => Key=1 => X=10
     {
@@ -627,7 +679,7 @@ static void testCrossJoin(void)
     seriesInit(&sLeft, "L", DF_INT);
     seriesAddInt(&sLeft, leftVals[0]);
     seriesAddInt(&sLeft, leftVals[1]);
-    left.addSeries(&left, &sLeft);
+    left.ops->addSeries(&left, &sLeft);
     seriesFree(&sLeft);
 
     // 2) Create a "right" DataFrame with 1 column => "R" = [10,20,30]
@@ -640,21 +692,21 @@ static void testCrossJoin(void)
     for (int i = 0; i < 3; i++) {
         seriesAddInt(&sRight, rightVals[i]);
     }
-    right.addSeries(&right, &sRight);
+    right.ops->addSeries(&right, &sRight);
     seriesFree(&sRight);
 
     // 3) Call crossJoin => expect (2 * 3) = 6 rows
-    DataFrame cross = left.crossJoin(&left, &right);
+    DataFrame cross = left.ops->crossJoin(&left, &right);
     // We expect 2 columns => "L" and "R"
-    assert(cross.numColumns(&cross) == 2);
+    assert(cross.ops->numColumns(&cross) == 2);
 
     // Should produce 6 rows
-    size_t nRows = cross.numRows(&cross);
+    size_t nRows = cross.ops->numRows(&cross);
     assert(nRows == 6);
 
     // 4) Retrieve the Series => "L" is col0, "R" is col1
-    const Series* colL = cross.getSeries(&cross, 0);
-    const Series* colR = cross.getSeries(&cross, 1);
+    const Series* colL = cross.ops->getSeries(&cross, 0);
+    const Series* colR = cross.ops->getSeries(&cross, 1);
     assert(strcmp(colL->name, "L") == 0);
     assert(strcmp(colR->name, "R") == 0);
 
@@ -688,6 +740,115 @@ static void testCrossJoin(void)
     printf(" - dfCrossJoin_impl test passed.\n");
 }
 
+// ------------------------------------------------------------------
+// Join on DF_CATEGORY keys with different dictionaries
+// ------------------------------------------------------------------
+static void testJoinCategoryKeys(void)
+{
+    printf("Testing dfJoin_impl on DF_CATEGORY keys...\n");
+
+    // Left => Region = [eu, us, apac, us] ; Amount = 1..4
+    // Right => Region = [us, eu, latam] ; Manager = ...
+    // The two key columns are built separately, so their codes differ.
+    const char* regionsL[] = {"eu","us","apac","us"};
+    int amounts[] = {1,2,3,4};
+    const char* regionsR[] = {"us","eu","latam"};
+    const char* managers[] = {"Ann","Bob","Cid"};
+
+    DataFrame left;
+    DataFrame_Create(&left);
+    Series kL;
+    seriesInit(&kL, "Region", DF_CATEGORY);
+    for (int i = 0; i < 4; i++) seriesAddString(&kL, regionsL[i]);
+    left.ops->addSeries(&left, &kL);
+    seriesFree(&kL);
+    Series sA = buildIntSeries("Amount", amounts, 4);
+    left.ops->addSeries(&left, &sA);
+    seriesFree(&sA);
+
+    DataFrame right;
+    DataFrame_Create(&right);
+    Series kR;
+    seriesInit(&kR, "Region", DF_CATEGORY);
+    for (int i = 0; i < 3; i++) seriesAddString(&kR, regionsR[i]);
+    right.ops->addSeries(&right, &kR);
+    seriesFree(&kR);
+    Series sM = buildStringSeries("Manager", managers, 3);
+    right.ops->addSeries(&right, &sM);
+    seriesFree(&sM);
+
+    DataFrame joined = left.ops->join(&left, &right, "Region", "Region", JOIN_INNER);
+    // eu->Bob, us->Ann (twice) => 3 rows, apac unmatched
+    assert(joined.ops->numRows(&joined) == 3);
+    assert(joined.ops->numColumns(&joined) == 3);
+    const Series* key = joined.ops->getSeries(&joined, 0);
+    const Series* mgr = joined.ops->getSeries(&joined, 2);
+    assert(key->type == DF_CATEGORY);
+    const char* v = NULL;
+    assert(seriesGetStringView(key, 0, &v, NULL) && strcmp(v, "eu") == 0);
+    assert(seriesGetStringView(mgr, 0, &v, NULL) && strcmp(v, "Bob") == 0);
+    assert(seriesGetStringView(key, 2, &v, NULL) && strcmp(v, "us") == 0);
+    assert(seriesGetStringView(mgr, 2, &v, NULL) && strcmp(v, "Ann") == 0);
+    DataFrame_Destroy(&joined);
+
+    DataFrame_Destroy(&left);
+    DataFrame_Destroy(&right);
+    printf(" - dfJoin_impl DF_CATEGORY key test passed.\n");
+}
+
+static void testJoinHashedKeys(void)
+{
+    printf("Testing dfJoin_impl on hashed fixed-width keys...\n");
+
+    // Left => Id = [3, 1, null, 3, 7]  ; Right => Key = [3, 9, 3, null, 1]
+    DataFrame left;
+    DataFrame_Create(&left);
+    Series id;
+    seriesInit(&id, "Id", DF_INT64);
+    int64_t ids[] = {3, 1, 0, 3, 7};
+    for (int i = 0; i < 5; i++) seriesAddInt64(&id, ids[i]);
+    seriesSetNull(&id, 2);
+    left.ops->addSeriesMove(&left, &id);
+
+    DataFrame right;
+    DataFrame_Create(&right);
+    Series key, tag;
+    seriesInit(&key, "Key", DF_INT64);
+    seriesInit(&tag, "Tag", DF_INT);
+    int64_t keys[] = {3, 9, 3, 0, 1};
+    for (int i = 0; i < 5; i++) {
+        seriesAddInt64(&key, keys[i]);
+        seriesAddInt(&tag, i);
+    }
+    seriesSetNull(&key, 3);
+    right.ops->addSeriesMove(&right, &key);
+    right.ops->addSeriesMove(&right, &tag);
+
+    // inner: left order, right order within a key; null keys never match
+    DataFrame inner = left.ops->join(&left, &right, "Id", "Key", JOIN_INNER);
+    int expectTag[] = {0, 2, 4, 0, 2};
+    assert(inner.ops->numRows(&inner) == 5);
+    for (size_t r = 0; r < 5; r++) {
+        int t = -1;
+        assert(seriesGetInt(inner.ops->getSeries(&inner, 1), r, &t) && t == expectTag[r]);
+    }
+    DataFrame_Destroy(&inner);
+
+    // left: the null and 7 rows are padded; right: 9 and the null key are
+    DataFrame lj = left.ops->join(&left, &right, "Id", "Key", JOIN_LEFT);
+    assert(lj.ops->numRows(&lj) == 7);
+    DataFrame rj = left.ops->join(&left, &right, "Id", "Key", JOIN_RIGHT);
+    assert(rj.ops->numRows(&rj) == 7);
+    int t = -1;
+    assert(seriesGetInt(rj.ops->getSeries(&rj, 1), 5, &t) && t == 1);
+    DataFrame_Destroy(&rj);
+    DataFrame_Destroy(&lj);
+
+    DataFrame_Destroy(&left);
+    DataFrame_Destroy(&right);
+    printf(" - dfJoin_impl hashed key test passed.\n");
+}
+
 // ------------------------------------------------------------------
 // Main test driver for combine: concat, merge, join, + new functions
 // ------------------------------------------------------------------
@@ -697,6 +858,7 @@ void testCombine(void)
 
     // existing
     testConcatBasic();
+    testConcatChunked();
     testMergeBasic();
     testJoinBasic();
     testUnion();
@@ -705,5 +867,7 @@ void testCombine(void)
     testSemiJoin();
     testAntiJoin();
     testCrossJoin();
+    testJoinCategoryKeys();
+    testJoinHashedKeys();
     printf("All DataFrame combine tests passed successfully!\n");
 }
@@ -5,9 +5,11 @@
 #include <time.h>
 #include <math.h>
 #include <assert.h>
+#include <stdint.h>
 #include "core_test.h"
 #include "dataframe.h"
 #include "series.h"
+#include "dfalloc.h"
 
 // Existing testCore prototypes:
 extern void testCore(void);
@@ -88,13 +90,13 @@ static void testDifferentColumnTypes(void)
     Series sString = buildStringSeries("StrCol", stringVals, 4);
     Series sDatetime = buildDatetimeSeries("TimeCol", datetimeVals, 4);
 
-    bool ok = df.addSeries(&df, &sInt);
+    bool ok = df.ops->addSeries(&df, &sInt);
     assert(ok);
-    ok = df.addSeries(&df, &sDouble);
+    ok = df.ops->addSeries(&df, &sDouble);
     assert(ok);
-    ok = df.addSeries(&df, &sString);
+    ok = df.ops->addSeries(&df, &sString);
     assert(ok);
-    ok = df.addSeries(&df, &sDatetime);
+    ok = df.ops->addSeries(&df, &sDatetime);
     assert(ok);
 
     // We can free the local series copies now
@@ -104,14 +106,14 @@ static void testDifferentColumnTypes(void)
     seriesFree(&sDatetime);
 
     // 2) Check row/col counts
-    assert(df.numColumns(&df) == 4);
-    assert(df.numRows(&df) == 4);
+    assert(df.ops->numColumns(&df) == 4);
+    assert(df.ops->numRows(&df) == 4);
 
     // 3) Retrieve some values
-    const Series* colInt = df.getSeries(&df, 0);
-    const Series* colDouble = df.getSeries(&df, 1);
-    const Series* colString = df.getSeries(&df, 2);
-    const Series* colTime = df.getSeries(&df, 3);
+    const Series* colInt = df.ops->getSeries(&df, 0);
+    const Series* colDouble = df.ops->getSeries(&df, 1);
+    const Series* colString = df.ops->getSeries(&df, 2);
+    const Series* colTime = df.ops->getSeries(&df, 3);
 
     assert(colInt && colDouble && colString && colTime);
 
@@ -134,10 +136,10 @@ static void testDifferentColumnTypes(void)
     assert(gotDT && dtVal == 1677612500LL);
 
     // 4) Test aggregations on numeric columns
-    double sumInt = df.sum(&df, 0);   // sum of IntCol => 10+20+30+40=100
-    double sumDbl = df.sum(&df, 1);   // sum of DoubleCol => 1.5+2.5+3.25+4.75=12.0
-    double meanInt = df.mean(&df, 0); // => 100 / 4 = 25
-    double meanDbl = df.mean(&df, 1); // => 12.0 / 4 = 3.0
+    double sumInt = df.ops->sum(&df, 0);   // sum of IntCol => 10+20+30+40=100
+    double sumDbl = df.ops->sum(&df, 1);   // sum of DoubleCol => 1.5+2.5+3.25+4.75=12.0
+    double meanInt = df.ops->mean(&df, 0); // => 100 / 4 = 25
+    double meanDbl = df.ops->mean(&df, 1); // => 12.0 / 4 = 3.0
 
     assert(nearlyEqual(sumInt, 100.0, 1e-9));
     assert(nearlyEqual(sumDbl, 12.0, 1e-9));
@@ -145,18 +147,18 @@ static void testDifferentColumnTypes(void)
     assert(nearlyEqual(meanDbl, 3.0, 1e-9));
 
     // 5) Test slicing: head(2), tail(2)
-    DataFrame head2 = df.head(&df, 2);
-    assert(head2.numRows(&head2) == 2);
-    assert(head2.numColumns(&head2) == 4);
+    DataFrame head2 = df.ops->head(&df, 2);
+    assert(head2.ops->numRows(&head2) == 2);
+    assert(head2.ops->numColumns(&head2) == 4);
     // check row 1 col 0 => 20
-    const Series* h0 = head2.getSeries(&head2, 0);
+    const Series* h0 = head2.ops->getSeries(&head2, 0);
     seriesGetInt(h0, 1, &ival);
     assert(ival == 20);
     DataFrame_Destroy(&head2);
 
-    DataFrame tail2 = df.tail(&df, 2);
-    assert(tail2.numRows(&tail2) == 2);
-    const Series* t0 = tail2.getSeries(&tail2, 0);
+    DataFrame tail2 = df.ops->tail(&df, 2);
+    assert(tail2.ops->numRows(&tail2) == 2);
+    const Series* t0 = tail2.ops->getSeries(&tail2, 0);
     seriesGetInt(t0, 0, &ival);
     assert(ival == 30);
     seriesGetInt(t0, 1, &ival);
@@ -177,13 +179,13 @@ static void testAddRow(void)
     // Initially empty
     Series timeSeries;
     seriesInit(&timeSeries, "EventTime", DF_DATETIME);
-    bool ok = df.addSeries(&df, &timeSeries);
+    bool ok = df.ops->addSeries(&df, &timeSeries);
     seriesFree(&timeSeries);
     assert(ok);
 
     Series descSeries;
     seriesInit(&descSeries, "Description", DF_STRING);
-    ok = df.addSeries(&df, &descSeries);
+    ok = df.ops->addSeries(&df, &descSeries);
     seriesFree(&descSeries);
     assert(ok);
 
@@ -192,28 +194,28 @@ static void testAddRow(void)
     long long e1 = 1678000000LL;
     const char* d1 = "Start process";
     const void* row1[] = { &e1, d1 };
-    ok = df.addRow(&df, row1);
+    ok = df.ops->addRow(&df, row1);
     assert(ok);
 
     long long e2 = 1678000100LL;
     const char* d2 = "Middle process";
     const void* row2[] = { &e2, d2 };
-    ok = df.addRow(&df, row2);
+    ok = df.ops->addRow(&df, row2);
     assert(ok);
 
     long long e3 = 1678000200LL;
     const char* d3 = "End process";
     const void* row3[] = { &e3, d3 };
-    ok = df.addRow(&df, row3);
+    ok = df.ops->addRow(&df, row3);
     assert(ok);
 
     // Check final counts
-    assert(df.numColumns(&df) == 2);
-    assert(df.numRows(&df) == 3);
+    assert(df.ops->numColumns(&df) == 2);
+    assert(df.ops->numRows(&df) == 3);
 
     // Verify the data
-    const Series* tsCol = df.getSeries(&df, 0);
-    const Series* descCol = df.getSeries(&df, 1);
+    const Series* tsCol = df.ops->getSeries(&df, 0);
+    const Series* descCol = df.ops->getSeries(&df, 1);
     assert(tsCol && descCol);
 
 
@@ -248,9 +250,9 @@ static void testGetRow(void)
     }
 
     // 2) Add columns to the DataFrame
-    bool ok = df.addSeries(&df, &colInt);  assert(ok);
-    ok = df.addSeries(&df, &colStr);      assert(ok);
-    ok = df.addSeries(&df, &colDT);       assert(ok);
+    bool ok = df.ops->addSeries(&df, &colInt);  assert(ok);
+    ok = df.ops->addSeries(&df, &colStr);      assert(ok);
+    ok = df.ops->addSeries(&df, &colDT);       assert(ok);
 
     // (We can free local Series if we like, DataFrame holds its own copy)
     seriesFree(&colInt);
@@ -258,12 +260,12 @@ static void testGetRow(void)
     seriesFree(&colDT);
 
     // Check row/col count
-    assert(df.numColumns(&df) == 3);
-    assert(df.numRows(&df) == 4);
+    assert(df.ops->numColumns(&df) == 3);
+    assert(df.ops->numRows(&df) == 4);
 
     // 3) Test dfGetRow_impl on row 2 (zero-based => 3rd item)
     void** rowData = NULL;
-    ok = df.getRow(&df, 2, &rowData);
+    ok = df.ops->getRow(&df, 2, &rowData);
     assert(ok);
     // rowData is now an array of 3 pointers, one per column
 
@@ -288,7 +290,7 @@ static void testGetRow(void)
     // 4) Check out-of-range row
     // e.g. rowIndex=99 => should fail
     void** badRowData = NULL;
-    ok = df.getRow(&df, 99, &badRowData);
+    ok = df.ops->getRow(&df, 99, &badRowData);
     assert(!ok); // should fail
 
     // 5) Destroy the DataFrame
@@ -310,17 +312,17 @@ static void testBasicAddSeriesAndRows(void)
     DataFrame_Create(&df);
 
     // Initially, no columns, no rows:
-    assert(df.numColumns(&df) == 0);
-    assert(df.numRows(&df) == 0);
+    assert(df.ops->numColumns(&df) == 0);
+    assert(df.ops->numRows(&df) == 0);
 
     // Build a small Series of 3 integers
     int v1[] = { 10, 20, 30 };
     Series s1 = buildIntSeries("ColumnA", v1, 3);
 
-    bool ok = df.addSeries(&df, &s1);
+    bool ok = df.ops->addSeries(&df, &s1);
     assert(ok == true);
-    assert(df.numColumns(&df) == 1);
-    assert(df.numRows(&df) == 3);  // matches series length
+    assert(df.ops->numColumns(&df) == 1);
+    assert(df.ops->numRows(&df) == 3);  // matches series length
 
     seriesFree(&s1);  // we can free local copy, df has its own
 
@@ -328,10 +330,10 @@ static void testBasicAddSeriesAndRows(void)
     int v2[] = { 100, 200, 300 };
     Series s2 = buildIntSeries("ColumnB", v2, 3);
 
-    ok = df.addSeries(&df, &s2);
+    ok = df.ops->addSeries(&df, &s2);
     assert(ok == true);
-    assert(df.numColumns(&df) == 2);
-    assert(df.numRows(&df) == 3);
+    assert(df.ops->numColumns(&df) == 2);
+    assert(df.ops->numRows(&df) == 3);
 
     seriesFree(&s2);
 
@@ -341,12 +343,12 @@ static void testBasicAddSeriesAndRows(void)
     int newValB = 400;
     const void* rowData[] = { &newValA, &newValB };
 
-    ok = df.addRow(&df, rowData);
+    ok = df.ops->addRow(&df, rowData);
     assert(ok == true);
-    assert(df.numRows(&df) == 4);
+    assert(df.ops->numRows(&df) == 4);
 
     // Let's verify the data in column 1, row 3 (zero-based)
-    const Series* colA = df.getSeries(&df, 0);
+    const Series* colA = df.ops->getSeries(&df, 0);
     assert(colA != NULL);
     int checkVal = 0;
     bool gotIt = seriesGetInt(colA, 3, &checkVal);
@@ -354,7 +356,7 @@ static void testBasicAddSeriesAndRows(void)
     assert(checkVal == 40);
 
     // Similarly, verify column 2, row 3
-    const Series* colB = df.getSeries(&df, 1);
+    const Series* colB = df.ops->getSeries(&df, 1);
     assert(colB != NULL);
     gotIt = seriesGetInt(colB, 3, &checkVal);
     assert(gotIt == true);
@@ -384,14 +386,14 @@ static void testStress(void)
     seriesInit(&s3, "Col3", DF_INT);
 
     // Add them to df. Now df->nrows is 0.
-    bool ok = df.addSeries(&df, &s1); assert(ok == true);
-    ok = df.addSeries(&df, &s2);     assert(ok == true);
-    ok = df.addSeries(&df, &s3);     assert(ok == true);
+    bool ok = df.ops->addSeries(&df, &s1); assert(ok == true);
+    ok = df.ops->addSeries(&df, &s2);     assert(ok == true);
+    ok = df.ops->addSeries(&df, &s3);     assert(ok == true);
     seriesFree(&s1); // local copy
     seriesFree(&s2);
     seriesFree(&s3);
-    assert(df.numColumns(&df) == 3);
-    assert(df.numRows(&df) == 0);
+    assert(df.ops->numColumns(&df) == 3);
+    assert(df.ops->numRows(&df) == 0);
 
     // Now let's add N rows with random int values
     srand((unsigned)time(NULL));
@@ -400,15 +402,15 @@ static void testStress(void)
         int vB = rand() % 100000;
         int vC = rand() % 100000;
         const void* rowData[] = { &vA, &vB, &vC };
-        ok = df.addRow(&df, rowData);
+        ok = df.ops->addRow(&df, rowData);
         assert(ok == true);
     }
-    assert(df.numRows(&df) == N);
+    assert(df.ops->numRows(&df) == N);
 
     // Spot check a few random rows
-    const Series* col1 = df.getSeries(&df, 0);
-    const Series* col2 = df.getSeries(&df, 1);
-    const Series* col3 = df.getSeries(&df, 2);
+    const Series* col1 = df.ops->getSeries(&df, 0);
+    const Series* col2 = df.ops->getSeries(&df, 1);
+    const Series* col3 = df.ops->getSeries(&df, 2);
     assert(col1 != NULL && col2 != NULL && col3 != NULL);
 
     for (int trial = 0; trial < 10; trial++) {
@@ -425,6 +427,222 @@ static void testStress(void)
     DataFrame_Destroy(&df);
 }
 
+/**
+ * @brief testAddSeriesMove
+ * addSeriesMove takes the Series' buffers as-is and leaves the caller's
+ * Series empty; a length mismatch still consumes it.
+ */
+static void testAddSeriesMove(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    const char* names[] = { "alpha", "beta", "gamma" };
+    Series sStr = buildStringSeries("Names", names, 3);
+    const char* arena = sStr.bytes;
+    seriesAddNull(&sStr);
+
+    assert(df.ops->addSeriesMove(&df, &sStr));
+    assert(sStr.name == NULL && sStr.values == NULL && seriesSize(&sStr) == 0);
+    seriesFree(&sStr);   // harmless after a move
+
+    const Series* moved = df.ops->getSeries(&df, 0);
+    assert(moved && moved->bytes == arena);   // no copy was made
+    assert(df.ops->numRows(&df) == 4);
+    assert(seriesNullCount(moved) == 1);
+    const char* v = NULL;
+    assert(seriesGetStringView(moved, 1, &v, NULL) && strcmp(v, "beta") == 0);
+
+    int vals[] = { 1, 2 };
+    Series sShort = buildIntSeries("Short", vals, 2);
+    assert(!df.ops->addSeriesMove(&df, &sShort));
+    assert(sShort.values == NULL && sShort.name == NULL);
+    assert(df.ops->numColumns(&df) == 1);
+
+    DataFrame_Destroy(&df);
+    printf(" - testAddSeriesMove passed.\n");
+}
+
+/**
+ * @brief testSharedOps
+ * All frames, including operator results, point at one method table.
+ */
+static void testSharedOps(void)
+{
+    DataFrame a, b;
+    DataFrame_Create(&a);
+    DataFrame_Create(&b);
+    assert(a.ops != NULL && a.ops == b.ops);
+
+    int vals[] = { 3, 1, 2 };
+    Series s = buildIntSeries("V", vals, 3);
+    a.ops->addSeriesMove(&a, &s);
+    DataFrame sorted = a.ops->sort(&a, 0, true);
+    assert(sorted.ops == a.ops);
+
+    DataFrame_Destroy(&sorted);
+    DataFrame_Destroy(&b);
+    DataFrame_Destroy(&a);
+    printf(" - testSharedOps passed.\n");
+}
+
+/**
+ * @brief testColumnIndex
+ * Name lookups go through the frame's hash index, which follows inserts,
+ * in-place renames and duplicate names.
+ */
+static void testColumnIndex(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+    assert(df.ops->columnIndex(&df, "c0") == (size_t)-1);
+
+    int vals[] = { 1, 2 };
+    char name[32];
+    for (int c = 0; c < 3000; c++) {
+        snprintf(name, sizeof(name), "c%d", c);
+        Series s = buildIntSeries(name, vals, 2);
+        df.ops->addSeriesMove(&df, &s);
+    }
+    assert(df.ops->columnIndex(&df, "c0") == 0);
+    assert(df.ops->columnIndex(&df, "c2999") == 2999);
+    assert(df.ops->columnIndex(&df, "c3000") == (size_t)-1);
+
+    // a duplicate name resolves to the first column, then walks on
+    Series dup = buildIntSeries("c7", vals, 2);
+    df.ops->addSeriesMove(&df, &dup);
+    assert(df.ops->columnIndex(&df, "c7") == 7);
+    assert(dfColumnIndexFrom(&df, "c7", 8) == 3000);
+    assert(dfColumnIndexFrom(&df, "c7", 3001) == (size_t)-1);
+
+    DataFrame renamed = df.ops->renameColumn(&df, "c5", "five");
+    assert(renamed.ops->columnIndex(&renamed, "c5") == (size_t)-1);
+    assert(renamed.ops->columnIndex(&renamed, "five") == 5);
+
+    const char* drop[] = { "c7", "c0" };
+    DataFrame dropped = df.ops->drop(&df, drop, 2);
+    assert(dropped.ops->numColumns(&dropped) == 2998);
+    assert(dropped.ops->columnIndex(&dropped, "c7") == (size_t)-1);
+    assert(dropped.ops->columnIndex(&dropped, "c8") == 6);
+
+    DataFrame_Destroy(&dropped);
+    DataFrame_Destroy(&renamed);
+    DataFrame_Destroy(&df);
+    printf(" - testColumnIndex passed.\n");
+}
+
+/**
+ * @brief testAppendColumns
+ * Batches given column-wise land in every column at once.
+ */
+static void testAppendColumns(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+    Series px, qty, sym;
+    seriesInit(&px, "Px", DF_DOUBLE);
+    seriesInit(&qty, "Qty", DF_INT64);
+    seriesInit(&sym, "Sym", DF_CATEGORY);
+    df.ops->addSeriesMove(&df, &px);
+    df.ops->addSeriesMove(&df, &qty);
+    df.ops->addSeriesMove(&df, &sym);
+
+    double prices[] = { 10.5, 10.25, 10.75 };
+    int64_t sizes[] = { 100, 5000000000LL, 300 };
+    const char* syms[] = { "AAPL", "MSFT", "AAPL" };
+    const void* batch[] = { prices, sizes, syms };
+    assert(df.ops->appendColumns(&df, batch, 3));
+    assert(df.ops->appendColumns(&df, batch, 2));
+    assert(df.ops->numRows(&df) == 5);
+
+    int64_t q = 0;
+    assert(seriesGetInt64(df.ops->getSeries(&df, 1), 4, &q) && q == 5000000000LL);
+    assert(seriesCategoryCount(df.ops->getSeries(&df, 2)) == 2);
+
+    // a missing column array appends nothing
+    const void* partial[] = { prices, NULL, syms };
+    assert(!df.ops->appendColumns(&df, partial, 3));
+    assert(df.ops->numRows(&df) == 5 && seriesSize(df.ops->getSeries(&df, 0)) == 5);
+
+    DataFrame_Destroy(&df);
+    printf(" - testAppendColumns passed.\n");
+}
+
+static bool everyRow(const DataFrame* df, size_t rowIndex)
+{
+    (void)df;
+    (void)rowIndex;
+    return true;
+}
+
+/**
+ * @brief testMemoryUsage
+ * memoryUsage reports one row per column plus the frame itself, and the
+ * allocation stats attribute allocations to the operator that made them.
+ */
+static void testMemoryUsage(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+    Series px, sym;
+    seriesInit(&px, "Px", DF_DOUBLE);
+    seriesInit(&sym, "Sym", DF_STRING);
+    for (int i = 0; i < 50; i++) {
+        seriesAddDouble(&px, 50.0 - i);
+        seriesAddString(&sym, (i % 2) ? "MSFT" : "AAPL");
+    }
+    df.ops->addSeriesMove(&df, &px);
+    df.ops->addSeriesMove(&df, &sym);
+
+    DataFrame mem = df.ops->memoryUsage(&df, false);
+    assert(mem.ops->numColumns(&mem) == 6 && mem.ops->numRows(&mem) == 3);
+    const Series* data = mem.ops->getSeries(&mem, mem.ops->columnIndex(&mem, "data"));
+    const Series* strings = mem.ops->getSeries(&mem, mem.ops->columnIndex(&mem, "strings"));
+    int64_t v = 0;
+    assert(seriesGetInt64(data, 0, &v) && v == 50 * (int64_t)sizeof(double));
+    assert(seriesGetInt64(strings, 1, &v) && v == 250);   // 5 bytes per label, NUL included
+    char* name = NULL;
+    assert(seriesGetString(mem.ops->getSeries(&mem, 0), 2, &name) && strcmp(name, "(frame)") == 0);
+    free(name);
+
+    DataFrame deep = df.ops->memoryUsage(&df, true);
+    int64_t shallowTotal = 0, deepTotal = 0;
+    seriesGetInt64(mem.ops->getSeries(&mem, 5), 0, &shallowTotal);
+    seriesGetInt64(deep.ops->getSeries(&deep, 5), 0, &deepTotal);
+    assert(deepTotal >= shallowTotal);
+    DataFrame_Destroy(&deep);
+    DataFrame_Destroy(&mem);
+
+    dfStatsReset();
+    dfStatsEnable(true);
+    DataFrame sorted = df.ops->sort(&df, 0, true);
+    dfStatsEnable(false);
+    const DfOpStats* st = NULL;
+    for (size_t i = 0; i < dfStatsCount(); i++) {
+        if (strcmp(dfStatsAt(i)->op, "dfSort_impl") == 0) st = dfStatsAt(i);
+    }
+    assert(st && st->calls == 1 && st->allocs > 0 && st->bytes > 0);
+    assert(dfStatsBytes() >= st->bytes);
+    dfStatsReset();
+
+    // operator scratch outside column storage counts too: the selection vector
+    dfStatsEnable(true);
+    DfSelection all = df.ops->filterSelection(&df, everyRow, NULL);
+    dfStatsEnable(false);
+    st = NULL;
+    for (size_t i = 0; i < dfStatsCount(); i++) {
+        if (strcmp(dfStatsAt(i)->op, "dfFilterSelection_impl") == 0) st = dfStatsAt(i);
+    }
+    assert(all.count == 50);
+    assert(st && st->allocs > 0 && st->bytes >= 50 * sizeof(size_t));
+    dfSelectionFree(&all);
+    dfStatsReset();
+
+    DataFrame_Destroy(&sorted);
+    DataFrame_Destroy(&df);
+    printf(" - testMemoryUsage passed.\n");
+}
+
 /**
  * @brief testCore
  * Main test driver for dataframe_core. 
@@ -437,6 +655,11 @@ void testCore(void)
     testAddRow();
     testGetRow();
     testBasicAddSeriesAndRows();
+    testAddSeriesMove();
+    testSharedOps();
+    testColumnIndex();
+    testAppendColumns();
+    testMemoryUsage();
     testStress();
     printf("All DataFrame core tests passed successfully!\n");
 }
@@ -30,16 +30,16 @@ static void testConvertToDatetime_impl()
         seriesAddString(&s, dates[i]);
     }
 
-    bool ok = df.addSeries(&df, &s);
+    bool ok = df.ops->addSeries(&df, &s);
     seriesFree(&s); // free local copy
     assert(ok);
 
     // Convert => final col is DF_DATETIME
     // If your code no longer accepts a bool toMillis, remove that argument or pass 'false'.
-    ok = df.convertToDatetime(&df, 0, "%Y-%m-%d %H:%M:%S");
+    ok = df.ops->convertToDatetime(&df, 0, "%Y-%m-%d %H:%M:%S");
     assert(ok);
 
-    const Series* converted = df.getSeries(&df, 0);
+    const Series* converted = df.ops->getSeries(&df, 0);
     assert(converted != NULL);
     assert(converted->type == DF_DATETIME);
 
@@ -70,16 +70,16 @@ static void testDatetimeToString_impl()
     for (int i=0; i<4; i++) {
         seriesAddDateTime(&sd, epochs[i]);
     }
-    bool ok = df.addSeries(&df, &sd);
+    bool ok = df.ops->addSeries(&df, &sd);
     seriesFree(&sd);
     assert(ok);
 
     // Convert => DF_STRING
-    ok = df.datetimeToString(&df, 0, "%Y-%m-%d %H:%M:%S");
+    ok = df.ops->datetimeToString(&df, 0, "%Y-%m-%d %H:%M:%S");
     assert(ok);
 
     // Check results
-    const Series* s2 = df.getSeries(&df, 0);
+    const Series* s2 = df.ops->getSeries(&df, 0);
     assert(s2 && s2->type == DF_STRING);
     char* strVal = NULL;
     bool got = seriesGetString(s2, 2, &strVal);
@@ -109,18 +109,18 @@ static void testDatetimeAdd_impl()
     for (int i = 0; i < 3; i++) {
         seriesAddDateTime(&sdt, baseMs + (i * 3600000LL));
     }
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // We want to add 1 day => 86,400 seconds => 86,400,000 ms
     // (Assuming your "df.datetimeAdd" now expects ms to add)
     long long oneDayMs = 86400000LL;
-    ok = df.datetimeAdd(&df, 0, oneDayMs);
+    ok = df.ops->datetimeAdd(&df, 0, oneDayMs);
     assert(ok);
 
     // Check the first row's new value
-    const Series* s2 = df.getSeries(&df, 0);
+    const Series* s2 = df.ops->getSeries(&df, 0);
     long long val = 0;
     bool got = seriesGetDateTime(s2, 0, &val);
 
@@ -155,9 +155,9 @@ static void testDatetimeDiff_impl()
         seriesAddDateTime(&sStart, starts[i]);
         seriesAddDateTime(&sEnd,   ends[i]);
     }
-    bool ok = df.addSeries(&df, &sStart);
+    bool ok = df.ops->addSeries(&df, &sStart);
     assert(ok);
-    ok = df.addSeries(&df, &sEnd);
+    ok = df.ops->addSeries(&df, &sEnd);
     assert(ok);
 
     seriesFree(&sStart);
@@ -165,10 +165,10 @@ static void testDatetimeDiff_impl()
 
     // Diff => new DF with one column named "Diff"
     // Now returns difference in ms
-    DataFrame diffDF = df.datetimeDiff(&df, 0, 1, "Diff");
-    assert(diffDF.numColumns(&diffDF) == 1);
+    DataFrame diffDF = df.ops->datetimeDiff(&df, 0, 1, "Diff");
+    assert(diffDF.ops->numColumns(&diffDF) == 1);
 
-    const Series* diffS = diffDF.getSeries(&diffDF, 0);
+    const Series* diffS = diffDF.ops->getSeries(&diffDF, 0);
     assert(diffS && diffS->type == DF_INT);
 
     // Check the results
@@ -202,15 +202,15 @@ static void testDatetimeFilter_impl()
     for (int i=1; i<=4; i++) {
         seriesAddDateTime(&sdt, i*1000LL);
     }
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // Filter => keep [2000..3000]
-    DataFrame filtered = df.datetimeFilter(&df, 0, 2000LL, 3000LL);
-    assert(filtered.numRows(&filtered)==2);
+    DataFrame filtered = df.ops->datetimeFilter(&df, 0, 2000LL, 3000LL);
+    assert(filtered.ops->numRows(&filtered)==2);
 
-    const Series* fcol = filtered.getSeries(&filtered, 0);
+    const Series* fcol = filtered.ops->getSeries(&filtered, 0);
     long long val=0;
     bool got = seriesGetDateTime(fcol, 0, &val);
     assert(got && val==2000);
@@ -233,16 +233,16 @@ static void testDatetimeTruncate_impl()
     Series sdt;
     seriesInit(&sdt, "TruncTest", DF_DATETIME);
     seriesAddDateTime(&sdt, eMs);
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // Truncate => "day"
-    ok = df.datetimeTruncate(&df, 0, "day");
+    ok = df.ops->datetimeTruncate(&df, 0, "day");
     assert(ok);
 
     // Now should be ~1678838400 => "2023-03-15 00:00:00"
-    const Series* sc = df.getSeries(&df, 0);
+    const Series* sc = df.ops->getSeries(&df, 0);
     long long msVal = 0;
     bool got = seriesGetDateTime(sc, 0, &msVal);
 
@@ -265,40 +265,40 @@ static void testDatetimeExtract_impl()
     Series sdt;
     seriesInit(&sdt, "DTExtract", DF_DATETIME);
     seriesAddDateTime(&sdt, e);
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // Extract => year, month, day, hour, minute, second
     const char* fields[] = {"year","month","day","hour","minute","second"};
-    DataFrame extracted = df.datetimeExtract(&df, 0, fields, 6);
-    assert(extracted.numColumns(&extracted)==6);
+    DataFrame extracted = df.ops->datetimeExtract(&df, 0, fields, 6);
+    assert(extracted.ops->numColumns(&extracted)==6);
 
     // row0 => year=2023, month=3, day=15, hour=12, minute=14, second=56 (for this epoch)
-    const Series* sy = extracted.getSeries(&extracted, 0);
+    const Series* sy = extracted.ops->getSeries(&extracted, 0);
     int val=0;
     bool gotVal = seriesGetInt(sy, 0, &val);
     assert(gotVal && val==2023);
 
-    const Series* sm = extracted.getSeries(&extracted, 1);
+    const Series* sm = extracted.ops->getSeries(&extracted, 1);
     seriesGetInt(sm, 0, &val);
     assert(val==3);
 
-    const Series* sd = extracted.getSeries(&extracted, 2);
+    const Series* sd = extracted.ops->getSeries(&extracted, 2);
     seriesGetInt(sd, 0, &val);
     assert(val==15);
 
-    const Series* sh = extracted.getSeries(&extracted, 3);
+    const Series* sh = extracted.ops->getSeries(&extracted, 3);
     seriesGetInt(sh, 0, &val);
     // should be 12 if that epoch is correct
     assert(val==12);
 
-    const Series* smin = extracted.getSeries(&extracted, 4);
+    const Series* smin = extracted.ops->getSeries(&extracted, 4);
     seriesGetInt(smin, 0, &val);
     // we expect 14 from that epoch
     assert(val==14);
 
-    const Series* ssec = extracted.getSeries(&extracted, 5);
+    const Series* ssec = extracted.ops->getSeries(&extracted, 5);
     seriesGetInt(ssec, 0, &val);
     assert(val==56);
 
@@ -322,15 +322,15 @@ static void testDatetimeGroupBy_impl()
     seriesAddDateTime(&sdt, day1_0);
     seriesAddDateTime(&sdt, day1_1);
     seriesAddDateTime(&sdt, day2_0);
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // group by day
-    DataFrame grouped = df.datetimeGroupBy(&df, 0, "day");
+    DataFrame grouped = df.ops->datetimeGroupBy(&df, 0, "day");
     // We'll do a minimal check => at least 2 distinct days => 2 rows
-    assert(grouped.numRows(&grouped)==2);
-    // df.print(&grouped);
+    assert(grouped.ops->numRows(&grouped)==2);
+    // df.ops->print(&grouped);
 
     DataFrame_Destroy(&grouped);
     DataFrame_Destroy(&df);
@@ -367,18 +367,18 @@ static void testDatetimeRound_impl()
     for (int i = 0; i < 5; i++) {
         seriesAddDateTime(&sdt, times[i]);
     }
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // We'll test a single rounding unit first: "second"
-    ok = df.datetimeRound(&df, 0, "second");
+    ok = df.ops->datetimeRound(&df, 0, "second");
     assert(ok);
 
     // Validate row 0 => original remainder .789 => >= 500 => +1 sec
     // row0 was 1678871696789 => break that into (seconds=1678871696, remainder=789).
     // => final => 1678871697 in seconds => *1000 => 1678871697000
-    const Series* col = df.getSeries(&df, 0);
+    const Series* col = df.ops->getSeries(&df, 0);
     long long val = 0;
     bool gotVal = seriesGetDateTime(col, 0, &val);
     assert(gotVal);
@@ -402,13 +402,13 @@ static void testDatetimeRound_impl()
     for (int i = 0; i < 5; i++) {
         seriesAddDateTime(&sdt, times[i]);
     }
-    df.addSeries(&df, &sdt);
+    df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
 
     // Round to minute
-    df.datetimeRound(&df, 0, "minute");
+    df.ops->datetimeRound(&df, 0, "minute");
 
-    col = df.getSeries(&df, 0);
+    col = df.ops->getSeries(&df, 0);
     seriesGetDateTime(col, 0, &val);
     // base => "12:34:56.789" => second=56 => >=30 => round up => minute=35 => new time=12:35:00
     // Let's check the resulting epoch in UTC
@@ -446,13 +446,13 @@ static void testDatetimeBetween_impl()
         // multiply by 1000. But we'll store seconds for clarity here.
         seriesAddDateTime(&sdt, times[i]);
     }
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
     // We'll keep rows between "2023-03-15 12:00:00" and "2023-03-16 00:00:00" inclusive
     // => start=1678862400, end=1678924800
-    DataFrame result = df.datetimeBetween(
+    DataFrame result = df.ops->datetimeBetween(
         &df,              // inDF
         0,                // dateColIndex
         "2023-03-15 9:13:00",  // start
@@ -463,9 +463,9 @@ static void testDatetimeBetween_impl()
     // The only rows in that range:
     //   times[1] = 1678871696000 => ~ 2023-03-15 12:34:56
     //   times[2] = 1678924800000 => 2023-03-16 00:00:00 (inclusive)
-    assert(result.numRows(&result) == 2);
-    result.print(&result);
-    const Series* sres = result.getSeries(&result, 0);
+    assert(result.ops->numRows(&result) == 2);
+    result.ops->print(&result);
+    const Series* sres = result.ops->getSeries(&result, 0);
     long long val=0;
     // row0 => 1678871696
     bool gotVal = seriesGetDateTime(sres, 0, &val);
@@ -497,7 +497,7 @@ static void testDatetimeRebase_impl()
     for (int i=0; i<4; i++) {
         seriesAddDateTime(&sdt, times[i]);
     }
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
@@ -506,10 +506,10 @@ static void testDatetimeRebase_impl()
     //        row1=2000 => 500
     //        row2=3000 => 1500
     //        row3=500  => -1000 => clamp=0
-    ok = df.datetimeRebase(&df, 0, 1500LL);
+    ok = df.ops->datetimeRebase(&df, 0, 1500LL);
     assert(ok);
 
-    const Series* col = df.getSeries(&df, 0);
+    const Series* col = df.ops->getSeries(&df, 0);
     long long val=0;
     seriesGetDateTime(col, 0, &val);
     assert(val == 0LL);
@@ -541,7 +541,7 @@ static void testDatetimeClamp_impl()
     for (int i=0; i<4; i++) {
         seriesAddDateTime(&sdt, vals[i]);
     }
-    bool ok = df.addSeries(&df, &sdt);
+    bool ok = df.ops->addSeries(&df, &sdt);
     seriesFree(&sdt);
     assert(ok);
 
@@ -550,10 +550,10 @@ static void testDatetimeClamp_impl()
     // => 50 => 50
     // => 100 => 100
     // => 9999 => 9000
-    ok = df.datetimeClamp(&df, 0, 20LL, 9000LL);
+    ok = df.ops->datetimeClamp(&df, 0, 20LL, 9000LL);
     assert(ok);
 
-    const Series* col = df.getSeries(&df, 0);
+    const Series* col = df.ops->getSeries(&df, 0);
     long long val=0;
 
     seriesGetDateTime(col, 0, &val);
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include "test_series.h"
 #include "core_test.h"
 #include "query_test.h"
 #include "print_test.h"
@@ -12,6 +13,7 @@
 
 int main(void)
 {
+    testSeries();
     testCore();
     testDate();
     testAggregate();
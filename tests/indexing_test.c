@@ -44,20 +44,20 @@ static void testDfAt(void)
     const char* words[] = {"Alpha","Beta","Gamma","Delta","Epsilon"};
 
     Series sNums = buildIntSeries("Nums", nums, 5);
-    df.addSeries(&df, &sNums);
+    df.ops->addSeries(&df, &sNums);
     seriesFree(&sNums);
 
     Series sWords = buildStringSeries("Words", words, 5);
-    df.addSeries(&df, &sWords);
+    df.ops->addSeries(&df, &sWords);
     seriesFree(&sWords);
 
     // 1) Normal usage: at(row=2, colName="Nums") => should produce a 1×1 DF with "Nums"[0] = 30
     {
-        DataFrame cellDF = df.at(&df, 2, "Nums");
-        assert(cellDF.numColumns(&cellDF)==1);
-        assert(cellDF.numRows(&cellDF)==1);
+        DataFrame cellDF = df.ops->at(&df, 2, "Nums");
+        assert(cellDF.ops->numColumns(&cellDF)==1);
+        assert(cellDF.ops->numRows(&cellDF)==1);
 
-        const Series* c = cellDF.getSeries(&cellDF, 0);
+        const Series* c = cellDF.ops->getSeries(&cellDF, 0);
         assert(strcmp(c->name, "Nums")==0);
         int val=0;
         bool got = seriesGetInt(c, 0, &val);
@@ -68,17 +68,17 @@ static void testDfAt(void)
 
     // 2) Out-of-range row => empty DF
     {
-        DataFrame emptyDF = df.at(&df, 10, "Nums");
-        assert(emptyDF.numColumns(&emptyDF)==0);
-        assert(emptyDF.numRows(&emptyDF)==0);
+        DataFrame emptyDF = df.ops->at(&df, 10, "Nums");
+        assert(emptyDF.ops->numColumns(&emptyDF)==0);
+        assert(emptyDF.ops->numRows(&emptyDF)==0);
         DataFrame_Destroy(&emptyDF);
     }
 
     // 3) colName not found => empty DF
     {
-        DataFrame noCol = df.at(&df, 1, "Bogus");
-        assert(noCol.numColumns(&noCol)==0);
-        assert(noCol.numRows(&noCol)==0);
+        DataFrame noCol = df.ops->at(&df, 1, "Bogus");
+        assert(noCol.ops->numColumns(&noCol)==0);
+        assert(noCol.ops->numRows(&noCol)==0);
         DataFrame_Destroy(&noCol);
     }
 
@@ -100,20 +100,20 @@ static void testDfIat(void)
     const char* words[] = {"Alpha","Beta","Gamma","Delta","Epsilon"};
 
     Series sNums = buildIntSeries("Nums", nums, 5);
-    df.addSeries(&df, &sNums);
+    df.ops->addSeries(&df, &sNums);
     seriesFree(&sNums);
 
     Series sWords = buildStringSeries("Words", words, 5);
-    df.addSeries(&df, &sWords);
+    df.ops->addSeries(&df, &sWords);
     seriesFree(&sWords);
 
     // 1) dfIat(row=3, col=1) => should produce "Words" row => "Delta"
     {
-        DataFrame cDF = df.iat(&df, 3, 1);
-        assert(cDF.numColumns(&cDF)==1);
-        assert(cDF.numRows(&cDF)==1);
+        DataFrame cDF = df.ops->iat(&df, 3, 1);
+        assert(cDF.ops->numColumns(&cDF)==1);
+        assert(cDF.ops->numRows(&cDF)==1);
 
-        const Series* col = cDF.getSeries(&cDF, 0);
+        const Series* col = cDF.ops->getSeries(&cDF, 0);
         assert(strcmp(col->name,"Words")==0);
         char* st=NULL;
         bool got = seriesGetString(col, 0, &st);
@@ -125,17 +125,17 @@ static void testDfIat(void)
 
     // 2) row out-of-range => empty
     {
-        DataFrame eDF = df.iat(&df, 10, 1);
-        assert(eDF.numColumns(&eDF)==0);
-        assert(eDF.numRows(&eDF)==0);
+        DataFrame eDF = df.ops->iat(&df, 10, 1);
+        assert(eDF.ops->numColumns(&eDF)==0);
+        assert(eDF.ops->numRows(&eDF)==0);
         DataFrame_Destroy(&eDF);
     }
 
     // 3) col out-of-range => empty
     {
-        DataFrame e2 = df.iat(&df, 1, 5);
-        assert(e2.numColumns(&e2)==0);
-        assert(e2.numRows(&e2)==0);
+        DataFrame e2 = df.ops->iat(&df, 1, 5);
+        assert(e2.ops->numColumns(&e2)==0);
+        assert(e2.ops->numRows(&e2)==0);
         DataFrame_Destroy(&e2);
     }
 
@@ -159,34 +159,34 @@ static void testDfLoc(void)
     const char* arrC[] = {"X","Y","Z","P","Q"};
 
     Series sA = buildIntSeries("A", arrA, 5);
-    df.addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sA);
     seriesFree(&sA);
 
     Series sB = buildIntSeries("B", arrB, 5);
-    df.addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sB);
     seriesFree(&sB);
 
     Series sC = buildStringSeries("C", arrC, 5);
-    df.addSeries(&df, &sC);
+    df.ops->addSeries(&df, &sC);
     seriesFree(&sC);
 
     // 1) rowIndices => {0,2,4}, colNames => {"A","C"}
     {
         size_t rowIdx[] = {0,2,4};
         const char* colNames[] = {"A","C"};
-        DataFrame subDF = df.loc(&df, rowIdx, 3, colNames, 2);
-        assert(subDF.numColumns(&subDF)==2);
-        assert(subDF.numRows(&subDF)==3);
+        DataFrame subDF = df.ops->loc(&df, rowIdx, 3, colNames, 2);
+        assert(subDF.ops->numColumns(&subDF)==2);
+        assert(subDF.ops->numRows(&subDF)==3);
 
         // col0 => "A" => row0 =>10, row1 =>30, row2 =>50
-        const Series* c0 = subDF.getSeries(&subDF, 0);
+        const Series* c0 = subDF.ops->getSeries(&subDF, 0);
         assert(strcmp(c0->name,"A")==0);
         int val=0;
         bool got = seriesGetInt(c0, 2, &val);
         assert(got && val==50);
 
         // col1 => "C" => row1 => "Z"
-        const Series* c1 = subDF.getSeries(&subDF, 1);
+        const Series* c1 = subDF.ops->getSeries(&subDF, 1);
         char* st=NULL;
         got = seriesGetString(c1, 1, &st);
         assert(got && strcmp(st,"Z")==0);
@@ -199,9 +199,9 @@ static void testDfLoc(void)
     {
         size_t rowIdx2[] = {0,1,2};
         const char* colNames2[] = {"A","Bogus","C"};
-        DataFrame skipDF = df.loc(&df, rowIdx2, 3, colNames2, 3);
+        DataFrame skipDF = df.ops->loc(&df, rowIdx2, 3, colNames2, 3);
         // => col "A","C" only
-        assert(skipDF.numColumns(&skipDF)==2);
+        assert(skipDF.ops->numColumns(&skipDF)==2);
         DataFrame_Destroy(&skipDF);
     }
 
@@ -209,10 +209,10 @@ static void testDfLoc(void)
     {
         size_t rowIdx3[] = {1,9}; 
         const char* coln[] = {"B"};
-        DataFrame part = df.loc(&df, rowIdx3, 2, coln, 1);
+        DataFrame part = df.ops->loc(&df, rowIdx3, 2, coln, 1);
         // => only row1 is valid => 1 row
-        assert(part.numColumns(&part)==1);
-        assert(part.numRows(&part)==1);
+        assert(part.ops->numColumns(&part)==1);
+        assert(part.ops->numRows(&part)==1);
         DataFrame_Destroy(&part);
     }
 
@@ -233,35 +233,35 @@ static void testDfIloc(void)
     // 3 columns => "X"(string), "Y"(int), "Z"(int)
     const char* vx[] = {"cat","dog","bird","fish","lion"};
     Series sX = buildStringSeries("X", vx, 5);
-    df.addSeries(&df, &sX);
+    df.ops->addSeries(&df, &sX);
     seriesFree(&sX);
 
     int vy[] = {1,2,3,4,5};
     Series sY = buildIntSeries("Y", vy, 5);
-    df.addSeries(&df, &sY);
+    df.ops->addSeries(&df, &sY);
     seriesFree(&sY);
 
     int vz[] = {10,20,30,40,50};
     Series sZ = buildIntSeries("Z", vz, 5);
-    df.addSeries(&df, &sZ);
+    df.ops->addSeries(&df, &sZ);
     seriesFree(&sZ);
 
     // 1) rows => [1..4) => row1,row2,row3 => columns => col0("X"), col2("Z")
     {
         size_t wantedCols[] = {0,2};
-        DataFrame slice = df.iloc(&df, 1, 4, wantedCols, 2);
-        assert(slice.numColumns(&slice)==2);
-        assert(slice.numRows(&slice)==3);
+        DataFrame slice = df.ops->iloc(&df, 1, 4, wantedCols, 2);
+        assert(slice.ops->numColumns(&slice)==2);
+        assert(slice.ops->numRows(&slice)==3);
 
         // col0 => "X", row2 => originally row3 => "fish"
-        const Series* cX = slice.getSeries(&slice, 0);
+        const Series* cX = slice.ops->getSeries(&slice, 0);
         char* st=NULL;
         bool got = seriesGetString(cX, 2, &st);
         assert(got && strcmp(st,"fish")==0);
         free(st);
 
         // col1 => "Z", row0 => originally row1 => 20
-        const Series* cZ = slice.getSeries(&slice, 1);
+        const Series* cZ = slice.ops->getSeries(&slice, 1);
         int val=0;
         got = seriesGetInt(cZ, 0, &val);
         assert(got && val==20);
@@ -272,19 +272,19 @@ static void testDfIloc(void)
     // 2) rowStart >= nRows => empty
     {
         size_t wantedCols2[] = {0,1};
-        DataFrame eDF = df.iloc(&df, 10, 12, wantedCols2, 2);
-        assert(eDF.numColumns(&eDF)==0);
-        assert(eDF.numRows(&eDF)==0);
+        DataFrame eDF = df.ops->iloc(&df, 10, 12, wantedCols2, 2);
+        assert(eDF.ops->numColumns(&eDF)==0);
+        assert(eDF.ops->numRows(&eDF)==0);
         DataFrame_Destroy(&eDF);
     }
 
     // 3) colIndices out-of-range => skip
     {
         size_t bigCols[] = {1,5};
-        DataFrame skipCols = df.iloc(&df, 0, 2, bigCols, 2);
+        DataFrame skipCols = df.ops->iloc(&df, 0, 2, bigCols, 2);
         // => only col1 => "Y"
-        assert(skipCols.numColumns(&skipCols)==1);
-        assert(skipCols.numRows(&skipCols)==2);
+        assert(skipCols.ops->numColumns(&skipCols)==1);
+        assert(skipCols.ops->numRows(&skipCols)==2);
         DataFrame_Destroy(&skipCols);
     }
 
@@ -310,9 +310,9 @@ static void testDfDrop(void)
     Series sB = buildIntSeries("B", colB, 3);
     Series sC = buildStringSeries("C", colC, 3);
 
-    df.addSeries(&df, &sA);
-    df.addSeries(&df, &sB);
-    df.addSeries(&df, &sC);
+    df.ops->addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sC);
 
     seriesFree(&sA);
     seriesFree(&sB);
@@ -321,13 +321,13 @@ static void testDfDrop(void)
     // drop "B"
     {
         const char* dropNames[] = {"B"};
-        DataFrame dropped = df.drop(&df, dropNames, 1);
-        assert(dropped.numColumns(&dropped)==2);
-        assert(dropped.numRows(&dropped)==3);
+        DataFrame dropped = df.ops->drop(&df, dropNames, 1);
+        assert(dropped.ops->numColumns(&dropped)==2);
+        assert(dropped.ops->numRows(&dropped)==3);
 
-        const Series* c0 = dropped.getSeries(&dropped, 0);
+        const Series* c0 = dropped.ops->getSeries(&dropped, 0);
         assert(strcmp(c0->name,"A")==0);
-        const Series* c1 = dropped.getSeries(&dropped, 1);
+        const Series* c1 = dropped.ops->getSeries(&dropped, 1);
         assert(strcmp(c1->name,"C")==0);
 
         DataFrame_Destroy(&dropped);
@@ -336,12 +336,12 @@ static void testDfDrop(void)
     // drop multiple => e.g. "A","C"
     {
         const char* dropMulti[] = {"A","C"};
-        DataFrame d2 = df.drop(&df, dropMulti, 2);
+        DataFrame d2 = df.ops->drop(&df, dropMulti, 2);
         // => only "B" remains
-        assert(d2.numColumns(&d2)==1);
-        assert(d2.numRows(&d2)==3);
+        assert(d2.ops->numColumns(&d2)==1);
+        assert(d2.ops->numRows(&d2)==3);
 
-        const Series* onlyCol = d2.getSeries(&d2, 0);
+        const Series* onlyCol = d2.ops->getSeries(&d2, 0);
         assert(strcmp(onlyCol->name,"B")==0);
 
         DataFrame_Destroy(&d2);
@@ -366,15 +366,15 @@ static void testDfPop(void)
     const char* colC[] = {"apple","banana","cherry"};
 
     Series sA = buildIntSeries("A", colA, 3);
-    df.addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sA);
     seriesFree(&sA);
 
     Series sB = buildIntSeries("B", colB, 3);
-    df.addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sB);
     seriesFree(&sB);
 
     Series sC = buildStringSeries("C", colC, 3);
-    df.addSeries(&df, &sC);
+    df.ops->addSeries(&df, &sC);
     seriesFree(&sC);
 
     // pop "B"
@@ -382,15 +382,15 @@ static void testDfPop(void)
         DataFrame poppedCol;
         DataFrame_Create(&poppedCol);
 
-        DataFrame afterPop = df.pop(&df, "B", &poppedCol);
+        DataFrame afterPop = df.ops->pop(&df, "B", &poppedCol);
         // afterPop => "A","C" => 2 cols, 3 rows
         // poppedCol => "B" => 1 col, 3 rows
-        assert(afterPop.numColumns(&afterPop)==2);
-        assert(afterPop.numRows(&afterPop)==3);
-        assert(poppedCol.numColumns(&poppedCol)==1);
-        assert(poppedCol.numRows(&poppedCol)==3);
+        assert(afterPop.ops->numColumns(&afterPop)==2);
+        assert(afterPop.ops->numRows(&afterPop)==3);
+        assert(poppedCol.ops->numColumns(&poppedCol)==1);
+        assert(poppedCol.ops->numRows(&poppedCol)==3);
 
-        const Series* poppedSeries = poppedCol.getSeries(&poppedCol, 0);
+        const Series* poppedSeries = poppedCol.ops->getSeries(&poppedCol, 0);
         assert(strcmp(poppedSeries->name,"B")==0);
         int val=0;
         bool got = seriesGetInt(poppedSeries,2,&val);
@@ -419,8 +419,8 @@ static void testDfInsert(void)
     Series sA = buildIntSeries("A", colA, 3);
     Series sB = buildIntSeries("B", colB, 3);
 
-    df.addSeries(&df, &sA);
-    df.addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sB);
 
     seriesFree(&sA);
     seriesFree(&sB);
@@ -432,10 +432,10 @@ static void testDfInsert(void)
     seriesAddInt(&sZ,200);
     seriesAddInt(&sZ,300);
 
-    DataFrame insDF = df.insert(&df,1,&sZ);
+    DataFrame insDF = df.ops->insert(&df,1,&sZ);
     // => columns => ["A"(0), "Z"(1), "B"(2)] => total 3 columns
-    assert(insDF.numColumns(&insDF)==3);
-    const Series* zCol = insDF.getSeries(&insDF, 1);
+    assert(insDF.ops->numColumns(&insDF)==3);
+    const Series* zCol = insDF.ops->getSeries(&insDF, 1);
     assert(strcmp(zCol->name,"Z")==0);
     int val=0;
     bool got = seriesGetInt(zCol, 2, &val);
@@ -450,9 +450,9 @@ static void testDfInsert(void)
     seriesAddInt(&sBad,999);
     seriesAddInt(&sBad,111);
 
-    DataFrame mismatch = df.insert(&df,1,&sBad);
+    DataFrame mismatch = df.ops->insert(&df,1,&sBad);
     // => should remain 2 columns => "A","B"
-    assert(mismatch.numColumns(&mismatch)==2);
+    assert(mismatch.ops->numColumns(&mismatch)==2);
 
     DataFrame_Destroy(&mismatch);
     seriesFree(&sBad);
@@ -476,18 +476,18 @@ static void testDfIndex(void)
     int colY[] = {100,200,300,400};
     Series sX = buildIntSeries("X", colX, 4);
     Series sY = buildIntSeries("Y", colY, 4);
-    df.addSeries(&df, &sX);
-    df.addSeries(&df, &sY);
+    df.ops->addSeries(&df, &sX);
+    df.ops->addSeries(&df, &sY);
 
     seriesFree(&sX);
     seriesFree(&sY);
 
     // df.index => single col => "index" => [0,1,2,3]
-    DataFrame idxDF = df.index(&df);
-    assert(idxDF.numColumns(&idxDF)==1);
-    assert(idxDF.numRows(&idxDF)==4);
+    DataFrame idxDF = df.ops->index(&df);
+    assert(idxDF.ops->numColumns(&idxDF)==1);
+    assert(idxDF.ops->numRows(&idxDF)==4);
 
-    const Series* idxS = idxDF.getSeries(&idxDF, 0);
+    const Series* idxS = idxDF.ops->getSeries(&idxDF, 0);
     assert(strcmp(idxS->name,"index")==0);
     int val=0;
     bool got = seriesGetInt(idxS,3,&val);
@@ -512,25 +512,25 @@ static void testDfColumns(void)
     // 3 columns => "One","Two","Three"
     int col1[] = {10,20};
     Series s1 = buildIntSeries("One", col1, 2);
-    df.addSeries(&df, &s1);
+    df.ops->addSeries(&df, &s1);
     seriesFree(&s1);
 
     int col2[] = {100,200};
     Series s2 = buildIntSeries("Two", col2, 2);
-    df.addSeries(&df, &s2);
+    df.ops->addSeries(&df, &s2);
     seriesFree(&s2);
 
     const char* arr3[] = {"Hello","World"};
     Series s3 = buildStringSeries("Three", arr3, 2);
-    df.addSeries(&df,&s3);
+    df.ops->addSeries(&df,&s3);
     seriesFree(&s3);
 
     // df.columns => single col => "columns" => rows => "One","Two","Three"
-    DataFrame colsDF = df.cols(&df);
-    assert(colsDF.numColumns(&colsDF)==1);
-    assert(colsDF.numRows(&colsDF)==3);
+    DataFrame colsDF = df.ops->cols(&df);
+    assert(colsDF.ops->numColumns(&colsDF)==1);
+    assert(colsDF.ops->numRows(&colsDF)==3);
 
-    const Series* colSer = colsDF.getSeries(&colsDF, 0);
+    const Series* colSer = colsDF.ops->getSeries(&colsDF, 0);
     assert(strcmp(colSer->name,"columns")==0);
 
     char* st=NULL;
@@ -549,9 +549,9 @@ static void testDfColumns(void)
 static void copyDataFrame(const DataFrame* src, DataFrame* dst)
 {
     DataFrame_Create(dst);
-    size_t nCols = src->numColumns(src);
+    size_t nCols = src->ops->numColumns(src);
     for (size_t c = 0; c < nCols; c++) {
-        const Series* s = src->getSeries(src, c);
+        const Series* s = src->ops->getSeries(src, c);
         if (!s) continue;
         // build a copy series
         Series copyS;
@@ -572,7 +572,8 @@ static void copyDataFrame(const DataFrame* src, DataFrame* dst)
                         seriesAddDouble(&copyS, dv);
                     }
                 } break;
-                case DF_STRING: {
+                case DF_STRING:
+                case DF_CATEGORY: {
                     char* strVal = NULL;
                     if (seriesGetString(s, r, &strVal)) {
                         seriesAddString(&copyS, strVal);
@@ -585,9 +586,12 @@ static void copyDataFrame(const DataFrame* src, DataFrame* dst)
                         seriesAddDateTime(&copyS, dtVal);
                     }
                 } break;
+                default:
+                    seriesAppendFrom(&copyS, s, r);
+                    break;
             }
         }
-        dst->addSeries(dst, &copyS);
+        dst->ops->addSeries(dst, &copyS);
         seriesFree(&copyS);
     }
 }
@@ -603,14 +607,14 @@ static void testSetValue(void)
 
     int colA[] = {10,20,30};
     Series sA = buildIntSeries("A", colA, 3);
-    df.addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sA);
     seriesFree(&sA);
 
     // set cell => row=1,col=0 => from 20 => let's set it to 999
     int newVal = 999;
-    DataFrame updated = df.setValue(&df, 1, 0, &newVal);
+    DataFrame updated = df.ops->setValue(&df, 1, 0, &newVal);
     // check if updated => col0 => row1 => 999
-    const Series* updCol = updated.getSeries(&updated, 0);
+    const Series* updCol = updated.ops->getSeries(&updated, 0);
     int val=0;
     bool got = seriesGetInt(updCol, 1, &val);
     assert(got && val==999);
@@ -638,8 +642,8 @@ static void testSetRow(void)
     int colB[] = {10,20,30,40};
     Series sA = buildIntSeries("A", colA, 4);
     Series sB = buildIntSeries("B", colB, 4);
-    df.addSeries(&df, &sA);
-    df.addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sB);
 
     seriesFree(&sA);
     seriesFree(&sB);
@@ -651,11 +655,11 @@ static void testSetRow(void)
     rowVals[0] = &newValA; // for col0 => "A"
     rowVals[1] = &newValB; // for col1 => "B"
 
-    DataFrame updated = df.setRow(&df, 2, rowVals, 2);
+    DataFrame updated = df.ops->setRow(&df, 2, rowVals, 2);
     // check => row2 => col"A"=777, col"B"=888
     {
-        const Series* cA = updated.getSeries(&updated, 0);
-        const Series* cB = updated.getSeries(&updated, 1);
+        const Series* cA = updated.ops->getSeries(&updated, 0);
+        const Series* cB = updated.ops->getSeries(&updated, 1);
         int vA=0, vB=0;
         bool gotA = seriesGetInt(cA, 2, &vA);
         bool gotB = seriesGetInt(cB, 2, &vB);
@@ -665,7 +669,7 @@ static void testSetRow(void)
     }
     // check row1 => still 2,20
     {
-        const Series* cA = updated.getSeries(&updated, 0);
+        const Series* cA = updated.ops->getSeries(&updated, 0);
         int valA=0;
         seriesGetInt(cA,1,&valA);
         assert(valA==2);
@@ -691,8 +695,8 @@ static void testSetColumn(void)
     int cY[] = {100,200,300};
     Series sY = buildIntSeries("Y", cY, 3);
 
-    df.addSeries(&df, &sX);
-    df.addSeries(&df, &sY);
+    df.ops->addSeries(&df, &sX);
+    df.ops->addSeries(&df, &sY);
 
     seriesFree(&sX);
     seriesFree(&sY);
@@ -706,12 +710,12 @@ static void testSetColumn(void)
     }
 
     // setColumn => oldName="Y" => newCol => sNew
-    DataFrame updated = df.setColumn(&df, "Y", &sNew);
+    DataFrame updated = df.ops->setColumn(&df, "Y", &sNew);
     // check => col0 => "X" unchanged => row0 => 11, col1 => "Y" data => now [999,999,999], but name => "NewY"? 
     // Actually we keep the new name => "NewY" or you can keep old name. Up to your implementation.
     // We'll assume we replaced with exactly newCol => name => "NewY".
-    const Series* c0 = updated.getSeries(&updated, 0);
-    const Series* c1 = updated.getSeries(&updated, 1);
+    const Series* c0 = updated.ops->getSeries(&updated, 0);
+    const Series* c1 = updated.ops->getSeries(&updated, 1);
     assert(strcmp(c0->name,"X")==0);
     assert(strcmp(c1->name,"NewY")==0);
 
@@ -737,26 +741,26 @@ static void testRenameColumn(void)
 
     int colA[] = {1,2,3};
     Series sA = buildIntSeries("A", colA, 3);
-    df.addSeries(&df,&sA);
+    df.ops->addSeries(&df,&sA);
     seriesFree(&sA);
 
     int colB[] = {10,20,30};
     Series sB = buildIntSeries("B", colB, 3);
-    df.addSeries(&df,&sB);
+    df.ops->addSeries(&df,&sB);
     seriesFree(&sB);
 
     // rename "A" => "Alpha"
-    DataFrame renamed = df.renameColumn(&df, "A","Alpha");
+    DataFrame renamed = df.ops->renameColumn(&df, "A","Alpha");
     // check => col0 => name="Alpha", col1 => name="B"
-    const Series* c0 = renamed.getSeries(&renamed, 0);
-    const Series* c1 = renamed.getSeries(&renamed, 1);
+    const Series* c0 = renamed.ops->getSeries(&renamed, 0);
+    const Series* c1 = renamed.ops->getSeries(&renamed, 1);
     assert(strcmp(c0->name,"Alpha")==0);
     assert(strcmp(c1->name,"B")==0);
 
     // rename non-existing => "Bogus" => "Nope" => skip
-    DataFrame skip = df.renameColumn(&df, "Bogus","Nope");
+    DataFrame skip = df.ops->renameColumn(&df, "Bogus","Nope");
     // col0 => "A", col1=>"B"
-    const Series* sc0 = skip.getSeries(&skip, 0);
+    const Series* sc0 = skip.ops->getSeries(&skip, 0);
     assert(strcmp(sc0->name,"A")==0);
 
     DataFrame_Destroy(&renamed);
@@ -778,21 +782,22 @@ static void testReindex(void)
 
     int arr1[] = {10,20,30,40};
     Series s1 = buildIntSeries("One", arr1, 4);
-    df.addSeries(&df,&s1);
+    df.ops->addSeries(&df,&s1);
     seriesFree(&s1);
 
-    // reindex => e.g. newIndices => {0,2,5}, size=3 => row0=>0, row1=>2, row2=>5 => out-of-range => NA
+    // reindex => e.g. newIndices => {0,2,5}, size=3 => row0=>0, row1=>2, row2=>5 => out-of-range => null
     size_t newIdx[] = {0,2,5};
-    DataFrame rdx = df.reindex(&df, newIdx, 3);
+    DataFrame rdx = df.ops->reindex(&df, newIdx, 3);
 
-    // col0 => "One", row0 => 10, row1 =>30, row2 => NA(0?)
-    const Series* col0 = rdx.getSeries(&rdx, 0);
+    // col0 => "One", row0 => 10, row1 =>30, row2 => null
+    const Series* col0 = rdx.ops->getSeries(&rdx, 0);
     int val=0;
     bool got = seriesGetInt(col0, 1, &val);
     assert(got && val==30);
     got = seriesGetInt(col0, 2, &val);
-    // row2 => old row5 => out-of-range => NA => 0 if int
-    assert(got && val==0);
+    // row2 => old row5 => out-of-range => null
+    assert(!got && seriesIsNull(col0, 2));
+    assert(rdx.ops->nullCount(&rdx, 0) == 1.0);
 
     DataFrame_Destroy(&rdx);
     DataFrame_Destroy(&df);
@@ -811,17 +816,17 @@ static void testTake(void)
 
     int arrA[] = {10,20,30};
     Series sA = buildIntSeries("A", arrA, 3);
-    df.addSeries(&df,&sA);
+    df.ops->addSeries(&df,&sA);
     seriesFree(&sA);
 
     // e.g. take => {2,2,0} => duplicates => row2, row2, row0
     size_t tIdx[] = {2,2,0};
-    DataFrame took = df.take(&df, tIdx, 3);
+    DataFrame took = df.ops->take(&df, tIdx, 3);
     // => 1 column => "A", 3 rows => row0 => old row2 => 30, row1 => old row2 => 30, row2 => old row0 => 10
-    assert(took.numColumns(&took)==1);
-    assert(took.numRows(&took)==3);
+    assert(took.ops->numColumns(&took)==1);
+    assert(took.ops->numRows(&took)==3);
 
-    const Series* col = took.getSeries(&took,0);
+    const Series* col = took.ops->getSeries(&took,0);
     int val=0;
     bool got = seriesGetInt(col,0,&val);
     assert(got && val==30);
@@ -851,9 +856,9 @@ static void testReorderColumns(void)
     Series sB = buildIntSeries("B", colB, 3);
     Series sC = buildIntSeries("C", colC, 3);
 
-    df.addSeries(&df,&sA);
-    df.addSeries(&df,&sB);
-    df.addSeries(&df,&sC);
+    df.ops->addSeries(&df,&sA);
+    df.ops->addSeries(&df,&sB);
+    df.ops->addSeries(&df,&sC);
 
     seriesFree(&sA);
     seriesFree(&sB);
@@ -861,12 +866,12 @@ static void testReorderColumns(void)
 
     // reorder => e.g. newOrder => {2,0,1} => means col2->A, col0->B, col1->C
     size_t newOrd[] = {2,0,1};
-    DataFrame reordered = df.reorderColumns(&df, newOrd, 3);
+    DataFrame reordered = df.ops->reorderColumns(&df, newOrd, 3);
     // => columns => 3 => col0 => old2 => "C", col1 => old0 => "A", col2 => old1 => "B"
 
-    const Series* c0 = reordered.getSeries(&reordered,0);
-    const Series* c1 = reordered.getSeries(&reordered,1);
-    const Series* c2 = reordered.getSeries(&reordered,2);
+    const Series* c0 = reordered.ops->getSeries(&reordered,0);
+    const Series* c1 = reordered.ops->getSeries(&reordered,1);
+    const Series* c2 = reordered.ops->getSeries(&reordered,2);
     assert(strcmp(c0->name,"C")==0);
     assert(strcmp(c1->name,"A")==0);
     assert(strcmp(c2->name,"B")==0);
@@ -43,25 +43,26 @@ static void testReadingSmallCsv(void)
     DataFrame df;
     DataFrame_Create(&df);
 
-    bool ok = df.readCsv(&df, tmpFile);
+    bool ok = df.ops->readCsv(&df, tmpFile);
     assert(ok == true);
 
     // Verify shape
-    assert(df.numColumns(&df) == 3);
-    assert(df.numRows(&df) == 3);
+    assert(df.ops->numColumns(&df) == 3);
+    assert(df.ops->numRows(&df) == 3);
 
     // Check each column name
-    const Series* col0 = df.getSeries(&df, 0);
-    const Series* col1 = df.getSeries(&df, 1);
-    const Series* col2 = df.getSeries(&df, 2);
+    const Series* col0 = df.ops->getSeries(&df, 0);
+    const Series* col1 = df.ops->getSeries(&df, 1);
+    const Series* col2 = df.ops->getSeries(&df, 2);
 
     assert(col0 && strcmp(col0->name, "ID") == 0);
     assert(col1 && strcmp(col1->name, "Value") == 0);
     assert(col2 && strcmp(col2->name, "Name") == 0);
 
-    // Check types: ID => DF_INT (inferred), Value => DF_DOUBLE, Name => DF_STRING
-    assert(col0->type == DF_INT);
-    assert(col1->type == DF_DOUBLE);
+    // Check types: ID => DF_INT8 (narrowest), Value => DF_FLOAT (fits exactly),
+    // Name => DF_STRING
+    assert(col0->type == DF_INT8);
+    assert(col1->type == DF_FLOAT);
     assert(col2->type == DF_STRING);
 
     // Spot check data
@@ -100,16 +101,16 @@ static void testReadingEmptyCsv(void)
     DataFrame df;
     DataFrame_Create(&df);
 
-    bool ok = df.readCsv(&df, tmpFile);
+    bool ok = df.ops->readCsv(&df, tmpFile);
     assert(ok == true);
 
     // We expect 3 columns, 0 rows
-    assert(df.numColumns(&df) == 3);
-    assert(df.numRows(&df) == 0);
+    assert(df.ops->numColumns(&df) == 3);
+    assert(df.ops->numRows(&df) == 0);
 
     // The columns should be DF_STRING type by default (since no data to infer).
-    for (size_t c = 0; c < df.numColumns(&df); c++) {
-        const Series* s = df.getSeries(&df, c);
+    for (size_t c = 0; c < df.ops->numColumns(&df); c++) {
+        const Series* s = df.ops->getSeries(&df, c);
         assert(s);
         assert(s->type == DF_STRING);
     }
@@ -136,16 +137,16 @@ static void testReadingSingleColumnCsv(void)
     DataFrame df;
     DataFrame_Create(&df);
 
-    bool ok = df.readCsv(&df, tmpFile);
+    bool ok = df.ops->readCsv(&df, tmpFile);
     assert(ok == true);
 
     // Expect 1 column, 4 rows
-    assert(df.numColumns(&df) == 1);
-    assert(df.numRows(&df) == 4);
+    assert(df.ops->numColumns(&df) == 1);
+    assert(df.ops->numRows(&df) == 4);
 
-    const Series* col = df.getSeries(&df, 0);
+    const Series* col = df.ops->getSeries(&df, 0);
     assert(col && strcmp(col->name, "Numbers") == 0);
-    assert(col->type == DF_INT);
+    assert(col->type == DF_INT8);
 
     // check data
     int val = 0;
@@ -183,20 +184,20 @@ static void testReadingLargeCsv(void)
     DataFrame df;
     DataFrame_Create(&df);
 
-    bool ok = df.readCsv(&df, tmpFile);
+    bool ok = df.ops->readCsv(&df, tmpFile);
     assert(ok == true);
 
     // Expect 2 columns, 100k rows
-    assert(df.numColumns(&df) == 2);
-    assert(df.numRows(&df) == N);
+    assert(df.ops->numColumns(&df) == 2);
+    assert(df.ops->numRows(&df) == N);
 
-    const Series* c0 = df.getSeries(&df, 0);
-    const Series* c1 = df.getSeries(&df, 1);
+    const Series* c0 = df.ops->getSeries(&df, 0);
+    const Series* c1 = df.ops->getSeries(&df, 1);
     assert(c0 && c1);
 
-    // c0 => DF_INT, c1 => DF_DOUBLE
+    // c0 => DF_INT (needs 32 bits), c1 => DF_FLOAT (at most "99999.5")
     assert(c0->type == DF_INT);
-    assert(c1->type == DF_DOUBLE);
+    assert(c1->type == DF_FLOAT);
 
     // Spot check first row
     int iVal = 0;
@@ -221,6 +222,205 @@ static void testReadingLargeCsv(void)
     remove(tmpFile);
 }
 
+/**
+ * Numeric columns get the narrowest type that holds every value.
+ */
+static void testReadingNarrowTypes(void)
+{
+    const char* csvContent =
+        "Flag,Small,Big,Neg,Huge,Price,Precise\n"
+        "0,200,5000000000,-40000,18446744073709551615,1.25,0.1234567\n"
+        "1,7,1,-1,1,99.5,2\n";
+    const char* tmpFile = "test_narrow.csv";
+    createTempCsvFile(tmpFile, csvContent);
+
+    DataFrame df;
+    DataFrame_Create(&df);
+    assert(df.ops->readCsv(&df, tmpFile));
+
+    assert(df.ops->getSeries(&df, 0)->type == DF_INT8);
+    assert(df.ops->getSeries(&df, 1)->type == DF_UINT8);
+    assert(df.ops->getSeries(&df, 2)->type == DF_INT64);
+    assert(df.ops->getSeries(&df, 3)->type == DF_INT);
+    assert(df.ops->getSeries(&df, 4)->type == DF_UINT64);
+    assert(df.ops->getSeries(&df, 5)->type == DF_FLOAT);
+    assert(df.ops->getSeries(&df, 6)->type == DF_DOUBLE);
+
+    uint8_t u8 = 0;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    float f = 0.0f;
+    assert(seriesGetUInt8(df.ops->getSeries(&df, 1), 0, &u8) && u8 == 200);
+    assert(seriesGetInt64(df.ops->getSeries(&df, 2), 0, &i64) && i64 == 5000000000LL);
+    assert(seriesGetUInt64(df.ops->getSeries(&df, 4), 0, &u64) && u64 == UINT64_MAX);
+    assert(seriesGetFloat(df.ops->getSeries(&df, 5), 1, &f) && f == 99.5f);
+
+    // the narrow columns still aggregate and sort like DF_INT / DF_DOUBLE
+    assert(df.ops->sum(&df, 1) == 207.0);
+    assert(df.ops->min(&df, 3) == -40000.0);
+    assert(df.ops->max(&df, 2) == 5000000000.0);
+    assert(df.ops->mean(&df, 5) == 50.375);
+    DataFrame sorted = df.ops->sort(&df, 1, true);
+    assert(seriesGetUInt8(sorted.ops->getSeries(&sorted, 1), 0, &u8) && u8 == 7);
+    assert(sorted.ops->getSeries(&sorted, 1)->type == DF_UINT8);
+    DataFrame_Destroy(&sorted);
+
+    DataFrame_Destroy(&df);
+    remove(tmpFile);
+
+    // few digits is not enough: 0.1 has no exact float, so it stays DF_DOUBLE
+    createTempCsvFile(tmpFile, "Px\n0.1\n0.2\n0.3\n");
+    DataFrame_Create(&df);
+    assert(df.ops->readCsv(&df, tmpFile));
+    const Series* px = df.ops->getSeries(&df, 0);
+    assert(px->type == DF_DOUBLE);
+    double d = 0.0;
+    size_t atMost = 0;
+    for (size_t r = 0; r < seriesSize(px); r++) {
+        if (seriesGetDouble(px, r, &d) && d <= 0.2) atMost++;
+    }
+    assert(atMost == 2);
+    assert(seriesGetDouble(px, 2, &d) && d == 0.3);
+    assert(df.ops->sum(&df, 0) == 0.1 + 0.2 + 0.3);
+    DataFrame_Destroy(&df);
+    remove(tmpFile);
+}
+
+/**
+ * A repetitive string column (few distinct values, enough rows) is loaded
+ * as DF_CATEGORY; a column of distinct strings stays DF_STRING.
+ */
+static void testReadingCategoryCsv(void)
+{
+    const char* tmpFile = "test_category.csv";
+    FILE* fp = fopen(tmpFile, "w");
+    assert(fp != NULL);
+    fputs("Side,OrderId\n", fp);
+    for (int i = 0; i < 100; i++) {
+        fprintf(fp, "%s,ord-%d\n", (i % 3 == 0) ? "sell" : "buy", i);
+    }
+    fclose(fp);
+
+    DataFrame df;
+    DataFrame_Create(&df);
+    bool ok = df.ops->readCsv(&df, tmpFile);
+    assert(ok);
+
+    const Series* side = df.ops->getSeries(&df, 0);
+    const Series* id   = df.ops->getSeries(&df, 1);
+    assert(side->type == DF_CATEGORY);
+    assert(seriesCategoryCount(side) == 2);
+    assert(id->type == DF_STRING);
+
+    const char* v = NULL;
+    assert(seriesGetStringView(side, 0, &v, NULL) && strcmp(v, "sell") == 0);
+    assert(seriesGetStringView(side, 1, &v, NULL) && strcmp(v, "buy") == 0);
+
+    DataFrame_Destroy(&df);
+    remove(tmpFile);
+}
+
+/**
+ * readCsvScan keeps the listed columns (in file order) and only the rows
+ * passing every filter; dates compare as epoch seconds.
+ */
+static void testReadingCsvScan(void)
+{
+    const char* tmpFile = "test_scan.csv";
+    FILE* fp = fopen(tmpFile, "w");
+    assert(fp != NULL);
+    fputs("Id,Px,Sym,When\n", fp);
+    for (int i = 0; i < 20; i++) {
+        fprintf(fp, "%d,%g,s%d,2024-01-%02d\n", i, i * 1.5, i, i + 1);
+    }
+    fclose(fp);
+
+    const char* cols[] = { "Px", "Id" };
+    DfCsvFilter filters[] = {
+        { "Id",   DF_CMP_GE, 10.0 },
+        { "When", DF_CMP_LT, 1705276800.0 },   // 2024-01-15 00:00:00 UTC
+        { "Sym",  DF_CMP_NE, 0.0 }             // text cells never match
+    };
+    DfCsvScan scan = { cols, 2, filters, 2, false };
+
+    DataFrame df;
+    DataFrame_Create(&df);
+    assert(df.ops->readCsvScan(&df, tmpFile, &scan));
+    assert(df.ops->numColumns(&df) == 2 && df.ops->numRows(&df) == 4);
+    assert(strcmp(df.ops->getSeries(&df, 0)->name, "Id") == 0);
+    int iVal;
+    assert(seriesGetInt(df.ops->getSeries(&df, 0), 0, &iVal) && iVal == 10);
+    assert(seriesGetInt(df.ops->getSeries(&df, 0), 3, &iVal) && iVal == 13);
+    DataFrame_Destroy(&df);
+
+    scan.filterCount = 3;
+    DataFrame_Create(&df);
+    assert(df.ops->readCsvScan(&df, tmpFile, &scan));
+    assert(df.ops->numColumns(&df) == 2 && df.ops->numRows(&df) == 0);
+    DataFrame_Destroy(&df);
+
+    // header only: every column, as empty strings
+    DfCsvScan header = { NULL, 0, NULL, 0, true };
+    DataFrame_Create(&df);
+    assert(df.ops->readCsvScan(&df, tmpFile, &header));
+    assert(df.ops->numColumns(&df) == 4 && df.ops->numRows(&df) == 0);
+    DataFrame_Destroy(&df);
+
+    // an unknown column fails the whole read
+    const char* bad[] = { "Nope" };
+    DfCsvScan unknown = { bad, 1, NULL, 0, false };
+    DataFrame_Create(&df);
+    assert(!df.ops->readCsvScan(&df, tmpFile, &unknown));
+    DataFrame_Destroy(&df);
+
+    // types come from every row, not just the ones a filter keeps
+    fp = fopen(tmpFile, "w");
+    assert(fp != NULL);
+    fputs("Px,Qty,Note,Sym\n", fp);
+    fputs("1,100000,abc,s0\n", fp);
+    fputs("200,5,7,s1\n", fp);
+    fputs("300,6,8,s2\n", fp);
+    for (int i = 0; i < 40; i++) {
+        fprintf(fp, "%d,1,n%d,s%d\n", 400 + i, i, i % 3);
+    }
+    fclose(fp);
+
+    DataFrame eager;
+    DataFrame_Create(&eager);
+    assert(eager.ops->readCsv(&eager, tmpFile));
+    assert(eager.ops->getSeries(&eager, 1)->type == DF_INT);
+    assert(eager.ops->getSeries(&eager, 2)->type == DF_STRING);
+    assert(eager.ops->getSeries(&eager, 3)->type == DF_CATEGORY);
+
+    DfCsvFilter pxOver[] = { { "Px", DF_CMP_GT, 100.0 }, { "Px", DF_CMP_LT, 400.0 } };
+    DfCsvScan filtered = { NULL, 0, pxOver, 2, false };
+    for (size_t n = 1; n <= 2; n++) {
+        // n == 2 keeps 2 rows, too few for a category on their own
+        filtered.filterCount = n;
+        DataFrame_Create(&df);
+        assert(df.ops->readCsvScan(&df, tmpFile, &filtered));
+        assert(df.ops->numRows(&df) == (n == 1 ? 42u : 2u));
+        for (size_t c = 0; c < 4; c++) {
+            assert(df.ops->getSeries(&df, c)->type == eager.ops->getSeries(&eager, c)->type);
+        }
+        DataFrame_Destroy(&df);
+    }
+
+    // a scan that drops every row still reports the file's types
+    DfCsvFilter none[] = { { "Px", DF_CMP_LT, 0.0 } };
+    DfCsvScan empty = { NULL, 0, none, 1, false };
+    DataFrame_Create(&df);
+    assert(df.ops->readCsvScan(&df, tmpFile, &empty));
+    assert(df.ops->numRows(&df) == 0);
+    for (size_t c = 0; c < 4; c++) {
+        assert(df.ops->getSeries(&df, c)->type == eager.ops->getSeries(&eager, c)->type);
+    }
+    DataFrame_Destroy(&df);
+    DataFrame_Destroy(&eager);
+
+    remove(tmpFile);
+}
+
 /**
  * @brief testIO
  * Main test driver for dataframe_io (df.readCsv).
@@ -242,5 +442,14 @@ void testIO(void)
     testReadingLargeCsv();
     printf(" - Large CSV stress test passed.\n");
 
+    testReadingCategoryCsv();
+    printf(" - Category CSV test passed.\n");
+
+    testReadingNarrowTypes();
+    printf(" - Narrow numeric types test passed.\n");
+
+    testReadingCsvScan();
+    printf(" - CSV scan test passed.\n");
+
     printf("All dataframe_io tests passed successfully!\n");
 }
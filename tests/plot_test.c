@@ -21,13 +21,13 @@ static void testPlotLine(void)
     for (int i = 0; i < 5; i++) {
         seriesAddInt(&s, data[i]);
     }
-    bool ok = df.addSeries(&df, &s);
+    bool ok = df.ops->addSeries(&df, &s);
     assert(ok == true);
     seriesFree(&s);
 
-    // Now call df.plot(...). We'll save to a file "plot_line_test.png"
+    // Now call df.ops->plot(...). We'll save to a file "plot_line_test.png"
     const size_t yCols[] = {0};  // only the first column
-    df.plot(&df, (size_t)-1, yCols, 1, "line", "plot_line_test.png");
+    df.ops->plot(&df, (size_t)-1, yCols, 1, "line", "plot_line_test.png");
 
     // Optional: check if "plot_line_test.png" was created
     // If you want to skip this, you can remove or #ifdef it.
@@ -58,7 +58,7 @@ static void testPlotScatter(void)
     for (int i = 0; i < 5; i++) {
         seriesAddInt(&sx, i);
     }
-    bool ok = df.addSeries(&df, &sx);
+    bool ok = df.ops->addSeries(&df, &sx);
     assert(ok == true);
     seriesFree(&sx);
 
@@ -69,7 +69,7 @@ static void testPlotScatter(void)
     for (int i = 0; i < 5; i++) {
         seriesAddDouble(&sy1, dataY1[i]);
     }
-    ok = df.addSeries(&df, &sy1);
+    ok = df.ops->addSeries(&df, &sy1);
     assert(ok == true);
     seriesFree(&sy1);
 
@@ -80,14 +80,14 @@ static void testPlotScatter(void)
     for (int i = 0; i < 5; i++) {
         seriesAddInt(&sy2, dataY2[i]);
     }
-    ok = df.addSeries(&df, &sy2);
+    ok = df.ops->addSeries(&df, &sy2);
     assert(ok == true);
     seriesFree(&sy2);
 
     // Now we have 3 columns: Xvals(0), Y1(1), Y2(2).
     // We'll do scatter plot with yCols = {1,2}, using col 0 as X.
     const size_t yCols[] = {1, 2};
-    df.plot(&df, 0, yCols, 2, "scatter", "plot_scatter_test.png");
+    df.ops->plot(&df, 0, yCols, 2, "scatter", "plot_scatter_test.png");
 
     // Optional: check for the output file
     if (access("plot_scatter_test.png", F_OK) == 0) {
@@ -117,7 +117,7 @@ static void testPlotHloc(void)
     for (int i = 0; i < 5; i++) {
         seriesAddInt(&sTime, timeData[i]);
     }
-    bool ok = df.addSeries(&df, &sTime);
+    bool ok = df.ops->addSeries(&df, &sTime);
     assert(ok == true);
     seriesFree(&sTime);
 
@@ -128,7 +128,7 @@ static void testPlotHloc(void)
     for (int i = 0; i < 5; i++) {
         seriesAddDouble(&sOpen, openData[i]);
     }
-    ok = df.addSeries(&df, &sOpen);
+    ok = df.ops->addSeries(&df, &sOpen);
     assert(ok == true);
     seriesFree(&sOpen);
 
@@ -139,7 +139,7 @@ static void testPlotHloc(void)
     for (int i = 0; i < 5; i++) {
         seriesAddDouble(&sHigh, highData[i]);
     }
-    ok = df.addSeries(&df, &sHigh);
+    ok = df.ops->addSeries(&df, &sHigh);
     assert(ok == true);
     seriesFree(&sHigh);
 
@@ -150,7 +150,7 @@ static void testPlotHloc(void)
     for (int i = 0; i < 5; i++) {
         seriesAddDouble(&sLow, lowData[i]);
     }
-    ok = df.addSeries(&df, &sLow);
+    ok = df.ops->addSeries(&df, &sLow);
     assert(ok == true);
     seriesFree(&sLow);
 
@@ -161,7 +161,7 @@ static void testPlotHloc(void)
     for (int i = 0; i < 5; i++) {
         seriesAddDouble(&sClose, closeData[i]);
     }
-    ok = df.addSeries(&df, &sClose);
+    ok = df.ops->addSeries(&df, &sClose);
     assert(ok == true);
     seriesFree(&sClose);
 
@@ -173,7 +173,7 @@ static void testPlotHloc(void)
     // 4 => "Close"
     // For an "hloc" plot, we typically do xColIndex=0, yCols = {1,2,3,4}
     const size_t yCols[] = {1,2,3,4};
-    df.plot(&df, 0, yCols, 4, "hloc", "plot_hloc_test.png");
+    df.ops->plot(&df, 0, yCols, 4, "hloc", "plot_hloc_test.png");
 
     // Optional check
     if (access("plot_hloc_test.png", F_OK) == 0) {
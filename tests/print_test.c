@@ -42,23 +42,23 @@ static void testPrintBasic(void)
     // First column (int)
     int colA[] = { 10, 20, 30, 40, 50 };
     Series sA = buildIntSeries("IntCol", colA, 5);
-    bool ok = df.addSeries(&df, &sA);
+    bool ok = df.ops->addSeries(&df, &sA);
     assert(ok == true);
     seriesFree(&sA);
 
     // Second column (strings)
     const char* colB[] = { "Alice", "Bob", "Charlie", "Diana", "Ethan" };
     Series sB = buildStringSeries("NameCol", colB, 5);
-    ok = df.addSeries(&df, &sB);
+    ok = df.ops->addSeries(&df, &sB);
     assert(ok == true);
     seriesFree(&sB);
 
     // Check df shape
-    assert(df.numColumns(&df) == 2);
-    assert(df.numRows(&df) == 5);
+    assert(df.ops->numColumns(&df) == 2);
+    assert(df.ops->numRows(&df) == 5);
 
     // Now call df.print
-    df.print(&df); 
+    df.ops->print(&df); 
     // We won't parse output automatically, 
     // but at least we confirm no crash/segfault.
 
@@ -75,9 +75,9 @@ static void testPrintEdgeCases(void)
     {
         DataFrame df;
         DataFrame_Create(&df);
-        assert(df.numColumns(&df) == 0);
-        assert(df.numRows(&df) == 0);
-        df.print(&df);  // Should print "Empty DataFrame"
+        assert(df.ops->numColumns(&df) == 0);
+        assert(df.ops->numRows(&df) == 0);
+        df.ops->print(&df);  // Should print "Empty DataFrame"
         DataFrame_Destroy(&df);
     }
 
@@ -89,21 +89,21 @@ static void testPrintEdgeCases(void)
         // Create an int column with 0 entries
         Series s1;
         seriesInit(&s1, "EmptyInt", DF_INT);
-        bool ok = df.addSeries(&df, &s1);
+        bool ok = df.ops->addSeries(&df, &s1);
         assert(ok == true);
         seriesFree(&s1);
 
         // Create a string column with 0 entries
         Series s2;
         seriesInit(&s2, "EmptyString", DF_STRING);
-        ok = df.addSeries(&df, &s2);
+        ok = df.ops->addSeries(&df, &s2);
         assert(ok == true);
         seriesFree(&s2);
 
-        assert(df.numColumns(&df) == 2);
-        assert(df.numRows(&df) == 0);
+        assert(df.ops->numColumns(&df) == 2);
+        assert(df.ops->numRows(&df) == 0);
 
-        df.print(&df); // should show "Empty DataFrame"
+        df.ops->print(&df); // should show "Empty DataFrame"
 
         DataFrame_Destroy(&df);
     }
@@ -123,14 +123,14 @@ static void testPrintStress(void)
     // Column 1:
     Series s1;
     seriesInit(&s1, "LargeInt1", DF_INT);
-    bool ok = df.addSeries(&df, &s1);
+    bool ok = df.ops->addSeries(&df, &s1);
     assert(ok == true);
     seriesFree(&s1);
 
     // Column 2:
     Series s2;
     seriesInit(&s2, "LargeInt2", DF_INT);
-    ok = df.addSeries(&df, &s2);
+    ok = df.ops->addSeries(&df, &s2);
     assert(ok == true);
     seriesFree(&s2);
 
@@ -139,15 +139,15 @@ static void testPrintStress(void)
         int val1 = (int)i;
         int val2 = (int)(i * 2);
         const void* rowData[] = { &val1, &val2 };
-        bool rowOk = df.addRow(&df, rowData);
+        bool rowOk = df.ops->addRow(&df, rowData);
         assert(rowOk == true);
     }
 
-    assert(df.numRows(&df) == N);
-    assert(df.numColumns(&df) == 2);
+    assert(df.ops->numRows(&df) == N);
+    assert(df.ops->numColumns(&df) == 2);
 
     // Now call df.print => should print top 5, "..." row, bottom 5
-    df.print(&df);
+    df.ops->print(&df);
 
     DataFrame_Destroy(&df);
 }
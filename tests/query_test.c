@@ -2,9 +2,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "query_test.h"  // the header for this test suite
 #include "dataframe.h"
 #include "series.h"
+#include "dfmask.h"
+#include "dfquery.h"
 /***************************************************************
  * HELPER ROUTINES
  ***************************************************************/
@@ -39,17 +42,17 @@ static void testHead(void)
 
     int col1[] = {10,20,30,40,50,60};
     Series s1 = buildIntSeries("Nums", col1, 6);
-    bool ok = df.addSeries(&df, &s1);
+    bool ok = df.ops->addSeries(&df, &s1);
     assert(ok);
     seriesFree(&s1);
 
     // HEAD(3) => expect 3 rows
-    DataFrame headDF = df.head(&df, 3);
-    assert(headDF.numColumns(&headDF) == 1);
-    assert(headDF.numRows(&headDF) == 3);
+    DataFrame headDF = df.ops->head(&df, 3);
+    assert(headDF.ops->numColumns(&headDF) == 1);
+    assert(headDF.ops->numRows(&headDF) == 3);
 
     // Spot check values
-    const Series* s = headDF.getSeries(&headDF, 0);
+    const Series* s = headDF.ops->getSeries(&headDF, 0);
     int val=0;
     bool got = seriesGetInt(s, 0, &val);
     assert(got && val==10);
@@ -71,16 +74,16 @@ static void testTail(void)
 
     int col1[] = {100,200,300,400,500};
     Series s1 = buildIntSeries("Data", col1, 5);
-    bool ok = df.addSeries(&df, &s1);
+    bool ok = df.ops->addSeries(&df, &s1);
     assert(ok);
     seriesFree(&s1);
 
     // TAIL(2) => last 2 rows => [400, 500]
-    DataFrame tailDF = df.tail(&df, 2);
-    assert(tailDF.numColumns(&tailDF) == 1);
-    assert(tailDF.numRows(&tailDF) == 2);
+    DataFrame tailDF = df.ops->tail(&df, 2);
+    assert(tailDF.ops->numColumns(&tailDF) == 1);
+    assert(tailDF.ops->numRows(&tailDF) == 2);
 
-    const Series* s = tailDF.getSeries(&tailDF, 0);
+    const Series* s = tailDF.ops->getSeries(&tailDF, 0);
     int val=0;
     // row0 => 400, row1 => 500
     bool got = seriesGetInt(s, 0, &val);
@@ -104,26 +107,76 @@ static void testDescribe(void)
     // We'll add 2 numeric columns
     int col1[] = {10,20,30,40};
     Series s1 = buildIntSeries("C1", col1, 4);
-    df.addSeries(&df, &s1);
+    df.ops->addSeries(&df, &s1);
     seriesFree(&s1);
 
     int col2[] = {5,5,10,20};
     Series s2 = buildIntSeries("C2", col2, 4);
-    df.addSeries(&df, &s2);
+    df.ops->addSeries(&df, &s2);
     seriesFree(&s2);
 
-    // describe => should produce 2 rows (one per col), each with 5 columns: 
-    // colName, count, min, max, mean
-    DataFrame descDF = df.describe(&df);
-    // expect 2 rows, 5 columns
-    assert(descDF.numRows(&descDF)==2);
-    assert(descDF.numColumns(&descDF)==5);
+    // describe => should produce 2 rows (one per col), each with 12 columns: 
+    // colName, count, min, max, mean, nulls, std, skew, kurtosis, 25%, 50%, 75%
+    DataFrame descDF = df.ops->describe(&df);
+    // expect 2 rows, 12 columns
+    assert(descDF.ops->numRows(&descDF)==2);
+    assert(descDF.ops->numColumns(&descDF)==12);
+
+    double v = 0.0;
+    const Series* q25 = descDF.ops->getSeries(&descDF, descDF.ops->columnIndex(&descDF, "25%"));
+    assert(q25 && seriesGetDouble(q25, 0, &v) && fabs(v - 17.5) < 1e-9);
+    const Series* stdS = descDF.ops->getSeries(&descDF, descDF.ops->columnIndex(&descDF, "std"));
+    assert(stdS && seriesGetDouble(stdS, 1, &v) && fabs(v - df.ops->std(&df, 1)) < 1e-9);
 
     DataFrame_Destroy(&descDF);
     DataFrame_Destroy(&df);
     printf("testDescribe passed.\n");
 }
 
+static void testDescribeFused(void)
+{
+    // 3 columns x 40000 rows => summarized on worker threads
+    DataFrame df;
+    DataFrame_Create(&df);
+    Series px, qty, ts;
+    seriesInit(&px,  "Px",  DF_DOUBLE);
+    seriesInit(&qty, "Qty", DF_INT);
+    seriesInit(&ts,  "Ts",  DF_DATETIME);
+    for (int i = 0; i < 40000; i++) {
+        int r = (i * 7919) % 40009;
+        seriesAddDouble(&px, 100.0 + (double)(r % 1000) / 7.0 + (r % 13 == 0 ? 50.0 : 0.0));
+        if (i % 97 == 0) seriesAddNull(&qty);
+        else seriesAddInt(&qty, r % 500);
+        seriesAddDateTime(&ts, 1700000000LL + r);
+    }
+    df.ops->addSeries(&df, &px);
+    df.ops->addSeries(&df, &qty);
+    df.ops->addSeries(&df, &ts);
+    seriesFree(&px);
+    seriesFree(&qty);
+    seriesFree(&ts);
+
+    DataFrame d = df.ops->describe(&df);
+    assert(d.ops->numRows(&d) == 3);
+    const char* cols[] = { "count", "nulls", "min", "max", "mean", "std", "skew", "kurtosis", "25%", "50%", "75%" };
+    for (size_t c = 0; c < 3; c++) {
+        double expected[11] = {
+            df.ops->count(&df, c), df.ops->nullCount(&df, c), df.ops->min(&df, c), df.ops->max(&df, c),
+            df.ops->mean(&df, c), df.ops->std(&df, c), df.ops->skewness(&df, c), df.ops->kurtosis(&df, c),
+            df.ops->quantile(&df, c, 0.25), df.ops->median(&df, c), df.ops->quantile(&df, c, 0.75)
+        };
+        for (size_t k = 0; k < 11; k++) {
+            const Series* s = d.ops->getSeries(&d, d.ops->columnIndex(&d, cols[k]));
+            double v = 0.0;
+            assert(s && seriesGetAsDouble(s, c, &v));
+            assert(fabs(v - expected[k]) <= 1e-9 * (1.0 + fabs(expected[k])));
+        }
+    }
+    DataFrame_Destroy(&d);
+    DataFrame_Destroy(&df);
+    printf("testDescribeFused passed.\n");
+}
+
 /***************************************************************
  *  TEST SLICE
  ***************************************************************/
@@ -135,14 +188,14 @@ static void testSlice(void)
     // Single column => 6 values => 0..5
     int arr[] = {0,1,2,3,4,5};
     Series s = buildIntSeries("Vals", arr, 6);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // SLICE(2..5) => rows 2,3,4 => total 3
-    DataFrame sliceDF = df.slice(&df, 2, 5);
-    assert(sliceDF.numRows(&sliceDF)==3);
+    DataFrame sliceDF = df.ops->slice(&df, 2, 5);
+    assert(sliceDF.ops->numRows(&sliceDF)==3);
     {
-        const Series* c = sliceDF.getSeries(&sliceDF, 0);
+        const Series* c = sliceDF.ops->getSeries(&sliceDF, 0);
         int val;
         seriesGetInt(c, 0, &val); // originally row2 => 2
         assert(val==2);
@@ -155,6 +208,52 @@ static void testSlice(void)
     printf("testSlice passed.\n");
 }
 
+/***************************************************************
+ *  TEST ROW VIEWS + MATERIALIZE
+ ***************************************************************/
+static void testRowViews(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    int nums[] = {1,2,3,4,5,6,7,8};
+    const char* names[] = {"a","b","c","d","e","f","g","h"};
+    Series sN = buildIntSeries("N", nums, 8);
+    Series sS = buildStringSeries("S", names, 8);
+    df.ops->addSeriesMove(&df, &sN);
+    df.ops->addSeriesMove(&df, &sS);
+
+    // tail/slice/iloc reference the parent's rows instead of copying them
+    DataFrame t = df.ops->tail(&df, 3);
+    DataFrame sl = df.ops->slice(&df, 2, 5);
+    size_t cols[] = {1};
+    DataFrame il = df.ops->iloc(&df, 4, 6, cols, 1);
+    const int* parent = seriesIntData(df.ops->getSeries(&df, 0));
+    assert(seriesIntData(t.ops->getSeries(&t, 0)) == parent + 5);
+    assert(seriesIntData(sl.ops->getSeries(&sl, 0)) == parent + 2);
+    assert(sl.ops->numRows(&sl) == 3 && il.ops->numRows(&il) == 2);
+
+    // the views keep the parent's data alive
+    DataFrame_Destroy(&df);
+    int v = 0;
+    const char* str = NULL;
+    assert(seriesGetInt(t.ops->getSeries(&t, 0), 0, &v) && v == 6);
+    assert(seriesGetStringView(il.ops->getSeries(&il, 0), 1, &str, NULL) && strcmp(str, "f") == 0);
+
+    // materialize => compact, independent copy
+    DataFrame m = t.ops->materialize(&t);
+    const Series* ms = m.ops->getSeries(&m, 1);
+    assert(m.ops->numRows(&m) == 3 && ms->bytesUsed == 6);
+    assert(seriesIntData(m.ops->getSeries(&m, 0)) != seriesIntData(t.ops->getSeries(&t, 0)));
+    assert(seriesGetStringView(ms, 2, &str, NULL) && strcmp(str, "h") == 0);
+
+    DataFrame_Destroy(&m);
+    DataFrame_Destroy(&il);
+    DataFrame_Destroy(&sl);
+    DataFrame_Destroy(&t);
+    printf("testRowViews passed.\n");
+}
+
 /***************************************************************
  *  TEST SAMPLE
  ***************************************************************/
@@ -165,13 +264,13 @@ static void testSample(void)
 
     int arr[] = {10,11,12,13,14,15};
     Series s = buildIntSeries("Rand", arr, 6);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // sample(3) => random subset of 3
-    DataFrame samp = df.sample(&df, 3);
-    assert(samp.numRows(&samp)==3);
-    assert(samp.numColumns(&samp)==1);
+    DataFrame samp = df.ops->sample(&df, 3);
+    assert(samp.ops->numRows(&samp)==3);
+    assert(samp.ops->numColumns(&samp)==1);
 
     DataFrame_Destroy(&samp);
     DataFrame_Destroy(&df);
@@ -195,9 +294,9 @@ static void testSelectColumns(void)
     Series sB = buildIntSeries("B", colB, 3);
     Series sC = buildStringSeries("C", colC, 3);
 
-    df.addSeries(&df, &sA);
-    df.addSeries(&df, &sB);
-    df.addSeries(&df, &sC);
+    df.ops->addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sC);
 
     seriesFree(&sA);
     seriesFree(&sB);
@@ -205,12 +304,12 @@ static void testSelectColumns(void)
 
     // We want to select columns #1 and #2 => "B","C"
     size_t indices[] = {1,2};
-    DataFrame sel = df.selectColumns(&df, indices, 2);
-    assert(sel.numColumns(&sel)==2);
-    assert(sel.numRows(&sel)==3);
+    DataFrame sel = df.ops->selectColumns(&df, indices, 2);
+    assert(sel.ops->numColumns(&sel)==2);
+    assert(sel.ops->numRows(&sel)==3);
 
     // check col0 => "B"
-    const Series* s0 = sel.getSeries(&sel, 0);
+    const Series* s0 = sel.ops->getSeries(&sel, 0);
     assert(strcmp(s0->name,"B")==0);
 
     DataFrame_Destroy(&sel);
@@ -218,6 +317,52 @@ static void testSelectColumns(void)
     printf("testSelectColumns passed.\n");
 }
 
+/***************************************************************
+ *  TEST COLUMN SHARING (copy-on-write)
+ ***************************************************************/
+static void testColumnSharing(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    int colA[] = {1,2,3};
+    const char* colB[] = {"X","Y","Z"};
+    Series sA = buildIntSeries("A", colA, 3);
+    Series sB = buildStringSeries("B", colB, 3);
+    df.ops->addSeriesMove(&df, &sA);
+    df.ops->addSeriesMove(&df, &sB);
+
+    // projection + rename share the buffers instead of copying them
+    size_t indices[] = {1,0};
+    DataFrame sel = df.ops->selectColumns(&df, indices, 2);
+    const char* oldNames[] = {"A"};
+    const char* newNames[] = {"Alpha"};
+    DataFrame ren = df.ops->renameColumns(&df, oldNames, newNames, 1);
+    assert(sel.ops->getSeries(&sel, 1)->values == df.ops->getSeries(&df, 0)->values);
+    assert(sel.ops->getSeries(&sel, 0)->bytes == df.ops->getSeries(&df, 1)->bytes);
+    assert(ren.ops->getSeries(&ren, 0)->values == df.ops->getSeries(&df, 0)->values);
+    assert(strcmp(ren.ops->getSeries(&ren, 0)->name, "Alpha")==0);
+
+    // a write through one frame copies first; the others are untouched
+    int newVal = 99;
+    DataFrame upd = sel.ops->setValue(&sel, 0, 1, &newVal);
+    int v = 0;
+    assert(seriesGetInt(upd.ops->getSeries(&upd, 1), 0, &v) && v==99);
+    assert(seriesGetInt(sel.ops->getSeries(&sel, 1), 0, &v) && v==1);
+    assert(seriesGetInt(df.ops->getSeries(&df, 0), 0, &v) && v==1);
+
+    // the source can go first; the views keep the data alive
+    DataFrame_Destroy(&df);
+    const char* str = NULL;
+    assert(seriesGetStringView(sel.ops->getSeries(&sel, 0), 2, &str, NULL) && strcmp(str,"Z")==0);
+    assert(seriesGetInt(ren.ops->getSeries(&ren, 0), 2, &v) && v==3);
+
+    DataFrame_Destroy(&upd);
+    DataFrame_Destroy(&ren);
+    DataFrame_Destroy(&sel);
+    printf("testColumnSharing passed.\n");
+}
+
 /***************************************************************
  *  TEST DROP COLUMNS
  ***************************************************************/
@@ -239,9 +384,9 @@ static void testDropColumns(void)
         seriesAddInt(&sC, colC[i]);
     }
 
-    df.addSeries(&df, &sA);
-    df.addSeries(&df, &sB);
-    df.addSeries(&df, &sC);
+    df.ops->addSeries(&df, &sA);
+    df.ops->addSeries(&df, &sB);
+    df.ops->addSeries(&df, &sC);
 
     seriesFree(&sA);
     seriesFree(&sB);
@@ -249,13 +394,13 @@ static void testDropColumns(void)
 
     // drop columns #1 => that is "B"
     size_t dropIdx[] = {1};
-    DataFrame dropped = df.dropColumns(&df, dropIdx, 1);
+    DataFrame dropped = df.ops->dropColumns(&df, dropIdx, 1);
     // we keep "A","C"
-    assert(dropped.numColumns(&dropped)==2);
-    assert(dropped.numRows(&dropped)==3);
+    assert(dropped.ops->numColumns(&dropped)==2);
+    assert(dropped.ops->numRows(&dropped)==3);
 
     // check first col => "A"
-    const Series* c0 = dropped.getSeries(&dropped, 0);
+    const Series* c0 = dropped.ops->getSeries(&dropped, 0);
     assert(strcmp(c0->name, "A")==0);
 
     DataFrame_Destroy(&dropped);
@@ -273,16 +418,16 @@ static void testRenameColumns(void)
 
     int arr[] = {9,8,7};
     Series s = buildIntSeries("OldName", arr, 3);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // rename OldName => NewName
     const char* oldN[] = {"OldName"};
     const char* newN[] = {"NewName"};
-    DataFrame ren = df.renameColumns(&df, oldN, newN, 1);
+    DataFrame ren = df.ops->renameColumns(&df, oldN, newN, 1);
 
     // check col0 => "NewName"
-    const Series* c0 = ren.getSeries(&ren, 0);
+    const Series* c0 = ren.ops->getSeries(&ren, 0);
     assert(strcmp(c0->name,"NewName")==0);
 
     DataFrame_Destroy(&ren);
@@ -296,7 +441,7 @@ static void testRenameColumns(void)
 static bool filterPredicateExample(const DataFrame* df, size_t rowIdx)
 {
     // keep if col0 < 50
-    const Series* s = df->getSeries(df, 0);
+    const Series* s = df->ops->getSeries(df, 0);
     int val=0;
     if(!seriesGetInt(s, rowIdx, &val)) return false;
     return val<50;
@@ -309,18 +454,393 @@ static void testFilter(void)
 
     int arr[] = {10,20,50,60};
     Series sCol = buildIntSeries("Col", arr, 4);
-    df.addSeries(&df, &sCol);
+    df.ops->addSeries(&df, &sCol);
     seriesFree(&sCol);
 
-    DataFrame filtered = df.filter(&df, filterPredicateExample);
+    DataFrame filtered = df.ops->filter(&df, filterPredicateExample);
     // keep rows where col<50 => that is row0=10, row1=20 => total 2
-    assert(filtered.numRows(&filtered)==2);
+    assert(filtered.ops->numRows(&filtered)==2);
 
     DataFrame_Destroy(&filtered);
     DataFrame_Destroy(&df);
     printf("testFilter passed.\n");
 }
 
+static bool isEvenRow(const DataFrame* df, size_t rowIdx)
+{
+    (void)df;
+    return rowIdx % 2 == 0;
+}
+
+static void testFilterSelection(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    int vals[] = {10,20,50,60,5,40,70,30};
+    const char* syms[] = {"A","B","A","B","B","A","A","B"};
+    Series v = buildIntSeries("Col", vals, 8);
+    Series g = buildStringSeries("Sym", syms, 8);
+    seriesSetNull(&v, 4);
+    df.ops->addSeries(&df, &v);
+    df.ops->addSeries(&df, &g);
+    seriesFree(&v);
+    seriesFree(&g);
+
+    // col<50 => rows 0,1,5,7 (row 4 is null); then even rows => 0
+    DfSelection lt = df.ops->filterSelection(&df, filterPredicateExample, NULL);
+    assert(lt.count == 4 && lt.rows[2] == 5);
+    DfSelection both = df.ops->filterSelection(&df, isEvenRow, &lt);
+    assert(both.count == 1 && both.rows[0] == 0);
+
+    assert(df.ops->sumSelection(&df, 0, &lt) == 100.0);
+    assert(df.ops->meanSelection(&df, 0, &lt) == 25.0);
+    assert(df.ops->sumSelection(&df, 0, NULL) == df.ops->sum(&df, 0));
+
+    // A: 10,40 / B: 20,30
+    DataFrame grouped = df.ops->groupBySelection(&df, 1, &lt);
+    assert(grouped.ops->numRows(&grouped) == 2);
+    int cnt = 0;
+    assert(seriesGetInt(grouped.ops->getSeries(&grouped, 1), 0, &cnt) && cnt == 2);
+
+    // descending by value, then copy the rows out only at the end
+    DfSelection order = df.ops->sortSelection(&df, 0, false, &lt);
+    assert(order.count == 4 && order.rows[0] == 5 && order.rows[3] == 0);
+    DataFrame out = df.ops->takeSelection(&df, &order);
+    assert(out.ops->numRows(&out) == 4);
+    int first = 0;
+    assert(seriesGetInt(out.ops->getSeries(&out, 0), 0, &first) && first == 40);
+
+    DfSelection none = df.ops->filterSelection(&df, filterPredicateExample, &(DfSelection){ NULL, 0 });
+    assert(none.count == 0 && none.rows == NULL);
+
+    DataFrame_Destroy(&out);
+    DataFrame_Destroy(&grouped);
+    dfSelectionFree(&order);
+    dfSelectionFree(&both);
+    dfSelectionFree(&lt);
+    DataFrame_Destroy(&df);
+    printf("testFilterSelection passed.\n");
+}
+
+static void testMaskKernels(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    // 150 rows over 64-row words; Px = row, Sym cycles A/B/C, Px null at 70
+    Series px, sym, cat;
+    seriesInitChunked(&px, "Px", DF_INT, 50);   // chunks do not line up with words
+    seriesInit(&sym, "Sym", DF_STRING);
+    for (int r = 0; r < 150; r++) {
+        if (r == 70) seriesAddNull(&px);
+        else seriesAddInt(&px, r);
+        seriesAddString(&sym, (r % 3 == 0) ? "A" : (r % 3 == 1) ? "B" : "C");
+    }
+    assert(seriesToCategory(&sym, &cat));
+    df.ops->addSeriesMove(&df, &px);
+    df.ops->addSeriesMove(&df, &sym);
+    df.ops->addSeriesMove(&df, &cat);
+    const Series* pxCol = df.ops->getSeries(&df, 0);
+
+    DfMask lt, band, in, isA, isAcat;
+    assert(dfMaskCompare(pxCol, DF_CMP_LT, 100.0, &lt));
+    assert(dfMaskCount(&lt) == 99);                       // 0..99 minus the null
+    assert(!dfMaskGet(&lt, 70) && dfMaskGet(&lt, 99) && !dfMaskGet(&lt, 100));
+    assert(dfMaskBetween(pxCol, 60.0, 80.0, &band) && dfMaskCount(&band) == 20);
+    double wanted[] = { 149.0, 3.0, 70.0, 64.0 };
+    assert(dfMaskIsIn(pxCol, wanted, 4, &in) && dfMaskCount(&in) == 3);
+    assert(dfMaskEqString(df.ops->getSeries(&df, 1), "A", &isA) && dfMaskCount(&isA) == 50);
+    const char* ac[] = { "A", "C", "Z" };
+    assert(dfMaskIsInStrings(df.ops->getSeries(&df, 2), ac, 3, &isAcat));
+    assert(dfMaskCount(&isAcat) == 100);
+
+    // (Px in [60,80]) AND Sym == "A" => 60,63,...,78 => 7 rows
+    assert(dfMaskAnd(&band, &isA) && dfMaskCount(&band) == 7);
+    assert(dfMaskOr(&band, &in) && dfMaskCount(&band) == 10);  // + 3, 64 and 149
+    dfMaskNot(&lt);
+    assert(dfMaskCount(&lt) == 51 && dfMaskGet(&lt, 70));     // NOT keeps the null row
+
+    DataFrame picked = df.ops->filterMask(&df, &band);
+    assert(picked.ops->numRows(&picked) == 10);
+    int v = 0;
+    assert(seriesGetInt(picked.ops->getSeries(&picked, 0), 9, &v) && v == 149);
+
+    DataFrame masked = df.ops->whereMask(&df, &isA, -1.0);
+    assert(masked.ops->numRows(&masked) == 150);
+    assert(seriesGetInt(masked.ops->getSeries(&masked, 0), 1, &v) && v == -1);
+    assert(seriesGetInt(masked.ops->getSeries(&masked, 0), 3, &v) && v == 3);
+
+    DfSelection sel = dfMaskToSelection(&isA);
+    assert(sel.count == 50 && sel.rows[1] == 3);
+
+    // numeric kernels reject string columns; masks must match the frame
+    DfMask bad;
+    assert(!dfMaskCompare(df.ops->getSeries(&df, 1), DF_CMP_EQ, 1.0, &bad));
+    assert(dfMaskInit(&bad, 10));
+    DataFrame none = df.ops->filterMask(&df, &bad);
+    assert(none.ops->numColumns(&none) == 0);
+    DataFrame_Destroy(&none);
+    dfMaskFree(&bad);
+
+    dfSelectionFree(&sel);
+    DataFrame_Destroy(&masked);
+    DataFrame_Destroy(&picked);
+    dfMaskFree(&lt);
+    dfMaskFree(&band);
+    dfMaskFree(&in);
+    dfMaskFree(&isA);
+    dfMaskFree(&isAcat);
+    DataFrame_Destroy(&df);
+    printf("testMaskKernels passed.\n");
+}
+
+static bool firstColumnIsOdd(const DataFrame* df, size_t rowIdx)
+{
+    double v = 0;
+    return seriesGetAsDouble(df->ops->getSeries(df, 0), rowIdx, &v) && ((long)v % 2) != 0;
+}
+
+static void testLazyQuery(void)
+{
+    DataFrame df;
+    DataFrame_Create(&df);
+
+    // Id = 0..99, Px = (Id * 37) % 100 (a permutation), Sym unused by the plan
+    Series id, px, sym;
+    seriesInit(&id, "Id", DF_INT);
+    seriesInit(&px, "Px", DF_DOUBLE);
+    seriesInit(&sym, "Sym", DF_STRING);
+    for (int i = 0; i < 100; i++) {
+        seriesAddInt(&id, i);
+        seriesAddDouble(&px, (double)((i * 37) % 100));
+        seriesAddString(&sym, "X");
+    }
+    df.ops->addSeriesMove(&df, &id);
+    df.ops->addSeriesMove(&df, &px);
+    df.ops->addSeriesMove(&df, &sym);
+
+    // select -> filter -> sort -> head, collected as a top-k
+    DFQuery q;
+    dfQueryInit(&q, &df);
+    const char* cols[] = { "Px", "Id" };
+    assert(dfQuerySelect(&q, cols, 2));
+    assert(dfQueryFilter(&q, firstColumnIsOdd));          // sees Px as column 0
+    assert(dfQueryHead(dfQuerySort(dfQueryWhere(&q, "Id", DF_CMP_LT, 50.0), "Px", false), 3));
+    DataFrame top = dfQueryCollect(&q);
+    assert(top.ops->numColumns(&top) == 2 && top.ops->numRows(&top) == 3);
+
+    // the same thing eagerly: odd Px, Id < 50, largest Px first
+    double expect[3];
+    size_t found = 0;
+    for (int p = 99; p >= 0 && found < 3; p -= 2) {
+        for (int i = 0; i < 50; i++) {
+            if ((i * 37) % 100 == p) expect[found++] = p;
+        }
+    }
+    for (size_t r = 0; r < 3; r++) {
+        double got = 0;
+        assert(seriesGetDouble(top.ops->getSeries(&top, 0), r, &got) && got == expect[r]);
+    }
+
+    // collect twice gives the same result
+    DataFrame again = dfQueryCollect(&q);
+    assert(again.ops->numRows(&again) == 3);
+    DataFrame_Destroy(&again);
+    DataFrame_Destroy(&top);
+    dfQueryFree(&q);
+
+    // head before a filter only tests the leading rows; rename is visible downstream
+    dfQueryInit(&q, &df);
+    dfQueryHead(&q, 10);
+    dfQueryRename(&q, "Id", "Key");
+    dfQueryWhere(&q, "Key", DF_CMP_GE, 5.0);
+    DataFrame renamed = dfQueryCollect(&q);
+    assert(renamed.ops->numRows(&renamed) == 5);
+    assert(renamed.ops->columnIndex(&renamed, "Key") == 0);
+    dfQueryFree(&q);
+    DataFrame_Destroy(&renamed);
+
+    // no row step => the result is a row view of the source
+    dfQueryInit(&q, &df);
+    dfQueryHead(&q, 4);
+    DataFrame view = dfQueryCollect(&q);
+    assert(view.ops->numRows(&view) == 4 && view.ops->numColumns(&view) == 3);
+    DataFrame_Destroy(&view);
+    dfQueryFree(&q);
+
+    // unknown columns are reported at collect time
+    dfQueryInit(&q, &df);
+    dfQuerySort(&q, "Nope", true);
+    DataFrame bad = dfQueryCollect(&q);
+    assert(bad.ops->numColumns(&bad) == 0);
+    DataFrame_Destroy(&bad);
+    dfQueryFree(&q);
+
+    DataFrame_Destroy(&df);
+    printf("testLazyQuery passed.\n");
+}
+
+static void testQueryOptimizer(void)
+{
+    // left: Id = 0..99, Px = (Id * 37) % 100, Sym
+    DataFrame df;
+    DataFrame_Create(&df);
+    Series id, px, sym;
+    seriesInit(&id, "Id", DF_INT);
+    seriesInit(&px, "Px", DF_DOUBLE);
+    seriesInit(&sym, "Sym", DF_STRING);
+    for (int i = 0; i < 100; i++) {
+        seriesAddInt(&id, i);
+        seriesAddDouble(&px, (double)((i * 37) % 100));
+        seriesAddString(&sym, "X");
+    }
+    df.ops->addSeriesMove(&df, &id);
+    df.ops->addSeriesMove(&df, &px);
+    df.ops->addSeriesMove(&df, &sym);
+
+    // right: Key = 0, 2, .. 98, Qty = Key, plus two columns nobody reads
+    DataFrame right;
+    DataFrame_Create(&right);
+    Series key, qty, note, extra;
+    seriesInit(&key, "Key", DF_INT);
+    seriesInit(&qty, "Qty", DF_DOUBLE);
+    seriesInit(&note, "Note", DF_STRING);
+    seriesInit(&extra, "Extra", DF_INT);
+    for (int i = 0; i < 50; i++) {
+        seriesAddInt(&key, 2 * i);
+        seriesAddDouble(&qty, 2.0 * i);
+        seriesAddString(&note, "n");
+        seriesAddInt(&extra, i);
+    }
+    right.ops->addSeriesMove(&right, &key);
+    right.ops->addSeriesMove(&right, &qty);
+    right.ops->addSeriesMove(&right, &note);
+    right.ops->addSeriesMove(&right, &extra);
+
+    DFQuery q;
+    dfQueryInit(&q, &df);
+    const char* wide[] = { "Id", "Qty", "Px" };
+    const char* narrow[] = { "Q", "Id" };
+    dfQueryJoin(&q, &right, "Id", "Key", JOIN_INNER);
+    dfQueryWhere(&q, "Px", DF_CMP_LT, 10.0);
+    dfQueryWhere(&q, "Qty", DF_CMP_GT, 20.0);
+    dfQuerySelect(&q, wide, 3);
+    dfQueryRename(&q, "Qty", "Q");
+    dfQuerySelect(&q, narrow, 2);
+
+    // where(Px) runs before the join on just Id, Px; where(Qty) filters the
+    // right frame, which keeps Key and Qty; select + rename + select collapse
+    DFQuery opt;
+    assert(dfQueryOptimize(&q, &opt));
+    assert(opt.count == 4);
+    assert(opt.steps[0].op == DFQ_WHERE && strcmp(opt.steps[0].column, "Px") == 0);
+    assert(opt.steps[1].op == DFQ_SELECT && opt.steps[1].nameCount == 2);
+    assert(opt.steps[2].op == DFQ_JOIN && opt.steps[2].nameCount == 2 && opt.steps[2].filterCount == 1);
+    assert(opt.steps[3].op == DFQ_SELECT && strcmp(opt.steps[3].names[0], "Qty") == 0 &&
+           strcmp(opt.steps[3].aliases[0], "Q") == 0);
+    dfQueryFree(&opt);
+
+    // same rows as the plan run step by step
+    DataFrame out = dfQueryCollect(&q);
+    assert(out.ops->numColumns(&out) == 2);
+    assert(strcmp(out.ops->getSeries(&out, 0)->name, "Q") == 0);
+    size_t r = 0;
+    for (int i = 0; i < 100; i += 2) {
+        if ((i * 37) % 100 >= 10 || i <= 20) continue;
+        int gotId = -1;
+        double gotQ = -1;
+        assert(seriesGetInt(out.ops->getSeries(&out, 1), r, &gotId) && gotId == i);
+        assert(seriesGetDouble(out.ops->getSeries(&out, 0), r, &gotQ) && gotQ == i);
+        r++;
+    }
+    assert(r > 0 && out.ops->numRows(&out) == r);
+    DataFrame_Destroy(&out);
+    dfQueryFree(&q);
+
+    // a left join pads unmatched rows with nulls: a right-side where stays after it
+    dfQueryInit(&q, &df);
+    dfQueryJoin(&q, &right, "Id", "Key", JOIN_LEFT);
+    dfQueryWhere(&q, "Qty", DF_CMP_GT, 20.0);
+    assert(dfQueryOptimize(&q, &opt));
+    assert(opt.count == 2 && opt.steps[0].op == DFQ_JOIN && opt.steps[0].filterCount == 0);
+    dfQueryFree(&opt);
+    out = dfQueryCollect(&q);
+    assert(out.ops->numRows(&out) == 39);   // Key 22 .. 98
+    DataFrame_Destroy(&out);
+    dfQueryFree(&q);
+
+    // a CSV source parses only the used columns and the rows passing where()
+    const char* tmpFile = "test_query_scan.csv";
+    FILE* fp = fopen(tmpFile, "w");
+    assert(fp != NULL);
+    fputs("Id,Px,Sym,Qty\n", fp);
+    for (int i = 0; i < 30; i++) fprintf(fp, "%d,%d,s%d,%d\n", i, (i * 7) % 30, i, i);
+    fclose(fp);
+
+    const char* pxOnly[] = { "Px" };
+    assert(dfQueryInitCsv(&q, tmpFile));
+    dfQueryWhere(&q, "Id", DF_CMP_GE, 25.0);
+    dfQuerySort(&q, "Px", true);
+    dfQuerySelect(&q, pxOnly, 1);
+    assert(dfQueryOptimize(&q, &opt));
+    assert(opt.scanColumnCount == 2 && opt.scanFilterCount == 1);
+    dfQueryFree(&opt);
+    out = dfQueryCollect(&q);
+    assert(out.ops->numColumns(&out) == 1 && out.ops->numRows(&out) == 5);
+    int prev = -1;
+    for (size_t i = 0; i < 5; i++) {
+        int v;
+        assert(seriesGetInt(out.ops->getSeries(&out, 0), i, &v) && v >= prev);
+        prev = v;
+    }
+    DataFrame_Destroy(&out);
+    dfQueryFree(&q);
+    remove(tmpFile);
+
+    DataFrame_Destroy(&right);
+    DataFrame_Destroy(&df);
+    printf("testQueryOptimizer passed.\n");
+}
+
+/*
+ * Collecting a CSV plan loads into frames that were already created (the
+ * header probe and the scan); nothing of theirs may leak. Run under
+ * ASan / LeakSanitizer to check.
+ */
+static void testCsvQueryCollect(void)
+{
+    const char* tmpFile = "test_query_collect.csv";
+    FILE* fp = fopen(tmpFile, "w");
+    assert(fp != NULL);
+    fputs("Id,Px\n", fp);
+    for (int i = 0; i < 10; i++) fprintf(fp, "%d,%d\n", i, i * 2);
+    fclose(fp);
+
+    for (int round = 0; round < 2; round++) {
+        DFQuery q;
+        assert(dfQueryInitCsv(&q, tmpFile));
+        // the second round drops every row
+        dfQueryWhere(&q, "Id", DF_CMP_GE, round == 0 ? 5.0 : 100.0);
+        DataFrame out = dfQueryCollect(&q);
+        assert(out.ops->numColumns(&out) == 2);
+        assert(out.ops->numRows(&out) == (round == 0 ? 5u : 0u));
+        DataFrame_Destroy(&out);
+        dfQueryFree(&q);
+    }
+
+    // reading into a frame that already holds columns replaces them
+    DataFrame df;
+    DataFrame_Create(&df);
+    assert(df.ops->readCsv(&df, tmpFile));
+    assert(df.ops->readCsv(&df, tmpFile));
+    assert(df.ops->numColumns(&df) == 2 && df.ops->numRows(&df) == 10);
+    DataFrame_Destroy(&df);
+
+    remove(tmpFile);
+    printf("testCsvQueryCollect passed.\n");
+}
+
 /***************************************************************
  *  TEST DROPNA
  ***************************************************************/
@@ -329,16 +849,24 @@ static void testDropNA(void)
     DataFrame df;
     DataFrame_Create(&df);
 
-    // 1 column => [0,10,0,20]
-    int arr[] = {0,10,0,20};
-    Series s = buildIntSeries("Values", arr, 4);
-    df.addSeries(&df, &s);
+    // 1 column => [0,10,null,20]
+    Series s;
+    seriesInit(&s, "Values", DF_INT);
+    seriesAddInt(&s, 0);
+    seriesAddInt(&s, 10);
+    seriesAddNull(&s);
+    seriesAddInt(&s, 20);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    // dropNA => remove row if col=0
-    // => we keep row1=10, row3=20 => total 2
-    DataFrame noNA = df.dropNA(&df);
-    assert(noNA.numRows(&noNA)==2);
+    // dropNA => remove the null row; a real 0 is kept
+    // => row0=0, row1=10, row3=20 => total 3
+    DataFrame noNA = df.ops->dropNA(&df);
+    assert(noNA.ops->numRows(&noNA)==3);
+    const Series* kept = noNA.ops->getSeries(&noNA, 0);
+    int v = -1;
+    assert(seriesGetInt(kept, 0, &v) && v == 0);
+    assert(seriesNullCount(kept) == 0);
 
     DataFrame_Destroy(&noNA);
     DataFrame_Destroy(&df);
@@ -355,13 +883,13 @@ static void testSort(void)
 
     int arr[] = {30,10,20};
     Series s = buildIntSeries("Data", arr, 3);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // sort ascending => [10,20,30]
-    DataFrame asc = df.sort(&df, 0, true);
+    DataFrame asc = df.ops->sort(&df, 0, true);
     {
-        const Series* c0 = asc.getSeries(&asc, 0);
+        const Series* c0 = asc.ops->getSeries(&asc, 0);
         int val;
         seriesGetInt(c0, 0, &val); assert(val==10);
         seriesGetInt(c0, 2, &val); assert(val==30);
@@ -369,9 +897,9 @@ static void testSort(void)
     DataFrame_Destroy(&asc);
 
     // sort descending => [30,20,10]
-    DataFrame desc = df.sort(&df, 0, false);
+    DataFrame desc = df.ops->sort(&df, 0, false);
     {
-        const Series* c0 = desc.getSeries(&desc, 0);
+        const Series* c0 = desc.ops->getSeries(&desc, 0);
         int val;
         seriesGetInt(c0, 0, &val); assert(val==30);
         seriesGetInt(c0, 2, &val); assert(val==10);
@@ -392,12 +920,12 @@ static void testDropDuplicates(void)
 
     const char* arr[] = {"Apple","Apple","Banana","Apple"};
     Series s = buildStringSeries("Fruits", arr, 4);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // dropDuplicates => keep first occurrence => Apple, Banana
-    DataFrame dd = df.dropDuplicates(&df, NULL, 0); // entire row
-    assert(dd.numRows(&dd)==2);
+    DataFrame dd = df.ops->dropDuplicates(&df, NULL, 0); // entire row
+    assert(dd.ops->numRows(&dd)==2);
     DataFrame_Destroy(&dd);
 
     DataFrame_Destroy(&df);
@@ -415,12 +943,12 @@ static void testUnique(void)
     // 1 col => repeated strings
     const char* arr[] = {"A","A","B","C","C","C"};
     Series s = buildStringSeries("Letters", arr, 6);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    DataFrame un = df.unique(&df, 0);
+    DataFrame un = df.ops->unique(&df, 0);
     // distinct => "A","B","C"
-    assert(un.numRows(&un)==3);
+    assert(un.ops->numRows(&un)==3);
     DataFrame_Destroy(&un);
 
     DataFrame_Destroy(&df);
@@ -442,19 +970,19 @@ static void testTranspose(void)
     Series sX = buildIntSeries("X", colX, 2);
     Series sY = buildStringSeries("Y", colY, 2);
 
-    df.addSeries(&df, &sX);
-    df.addSeries(&df, &sY);
+    df.ops->addSeries(&df, &sX);
+    df.ops->addSeries(&df, &sY);
 
     seriesFree(&sX);
     seriesFree(&sY);
 
-    DataFrame t = df.transpose(&df);
+    DataFrame t = df.ops->transpose(&df);
     // now we get 2 original rows => so 2 columns in new DF. 
     // each col has 2 strings (since we do a textual transpose).
 
-    assert(t.numColumns(&t)==2);
+    assert(t.ops->numColumns(&t)==2);
     // spot check row count => 2
-    assert(t.numRows(&t)==2);
+    assert(t.ops->numRows(&t)==2);
 
     DataFrame_Destroy(&t);
     DataFrame_Destroy(&df);
@@ -471,15 +999,15 @@ static void testIndexOf(void)
 
     int arr[] = {10,20,30,20};
     Series s = buildIntSeries("Vals", arr, 4);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // indexOf => find first row where col=20 => row1
-    size_t idx = df.indexOf(&df, 0, 20.0);
+    size_t idx = df.ops->indexOf(&df, 0, 20.0);
     assert(idx==1);
 
     // not found => -1
-    size_t idx2 = df.indexOf(&df, 0, 999.0);
+    size_t idx2 = df.ops->indexOf(&df, 0, 999.0);
     assert(idx2 == (size_t)-1);
 
     DataFrame_Destroy(&df);
@@ -492,21 +1020,21 @@ static void testIndexOf(void)
 static void rowFunc(DataFrame* outDF, const DataFrame* inDF, size_t rowIndex)
 {
     // read col0, add 5, store
-    if (outDF->numColumns(outDF)==0) {
+    if (outDF->ops->numColumns(outDF)==0) {
         // create 1 col in outDF
         Series s;
         seriesInit(&s, "OutCol", DF_INT);
-        outDF->addSeries(outDF, &s);
+        outDF->ops->addSeries(outDF, &s);
         seriesFree(&s);
     }
-    const Series* sIn = inDF->getSeries(inDF, 0);
+    const Series* sIn = inDF->ops->getSeries(inDF, 0);
     int val;
     seriesGetInt(sIn, rowIndex, &val);
     val+=5;
     // addRow => { &val }
     const void* rowData[1];
     rowData[0] = &val;
-    outDF->addRow(outDF, rowData);
+    outDF->ops->addRow(outDF, rowData);
 }
 
 static void testApply(void)
@@ -516,13 +1044,13 @@ static void testApply(void)
 
     int arr[] = {1,2,3};
     Series s = buildIntSeries("Base", arr, 3);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
-    DataFrame result = df.apply(&df, rowFunc);
+    DataFrame result = df.ops->apply(&df, rowFunc);
     // => col0 => [1+5, 2+5, 3+5] => [6,7,8]
-    assert(result.numRows(&result)==3);
-    const Series* c0 = result.getSeries(&result, 0);
+    assert(result.ops->numRows(&result)==3);
+    const Series* c0 = result.ops->getSeries(&result, 0);
     int val;
     seriesGetInt(c0, 2, &val);
     assert(val==8);
@@ -538,7 +1066,7 @@ static void testApply(void)
 static bool wherePred(const DataFrame* df, size_t rowIndex)
 {
     // keep if < 50
-    const Series* s = df->getSeries(df, 0);
+    const Series* s = df->ops->getSeries(df, 0);
     int val;
     seriesGetInt(s, rowIndex, &val);
     return (val<50);
@@ -551,15 +1079,15 @@ static void testWhere(void)
 
     int arr[] = {10,20,50};
     Series s = buildIntSeries("Vals", arr, 3);
-    df.addSeries(&df, &s);
+    df.ops->addSeries(&df, &s);
     seriesFree(&s);
 
     // where => if predicate fails => set default=999
     // row0=10 => keep 10, row1=20 => keep 20, row2=50 => 999
-    DataFrame wh = df.where(&df, wherePred, 999.0);
-    assert(wh.numRows(&wh)==3);
+    DataFrame wh = df.ops->where(&df, wherePred, 999.0);
+    assert(wh.ops->numRows(&wh)==3);
     {
-        const Series* c0 = wh.getSeries(&wh, 0);
+        const Series* c0 = wh.ops->getSeries(&wh, 0);
         int val;
         seriesGetInt(c0, 2, &val);
         assert(val==999);
@@ -588,20 +1116,20 @@ static void testExplode(void)
     seriesAddString(&sList, "X");
     seriesAddInt(&sCode, 200);
 
-    df.addSeries(&df, &sList);
-    df.addSeries(&df, &sCode);
+    df.ops->addSeries(&df, &sList);
+    df.ops->addSeries(&df, &sCode);
 
     seriesFree(&sList);
     seriesFree(&sCode);
 
     // explode col0 => "List"
-    DataFrame ex = df.explode(&df, 0);
+    DataFrame ex = df.ops->explode(&df, 0);
     // row0 => "A", code=100
     // row1 => "B", code=100
     // row2 => "X", code=200
-    assert(ex.numRows(&ex)==3);
+    assert(ex.ops->numRows(&ex)==3);
     {
-        const Series* cList = ex.getSeries(&ex, 0);
+        const Series* cList = ex.ops->getSeries(&ex, 0);
         char* st=NULL;
         seriesGetString(cList, 1, &st);
         assert(strcmp(st,"B")==0);
@@ -624,22 +1152,30 @@ void testQuery(void)
     testHead();
     testTail();
     testDescribe();
+    testDescribeFused();
 
     // 2) slice, sample
     testSlice();
+    testRowViews();
     testSample();
 
     // 3) select, drop, rename
     testSelectColumns();
+    testColumnSharing();
     testDropColumns();
     testRenameColumns();
 
     // 4) filter, dropNA
     testFilter();
+    testFilterSelection();
+    testMaskKernels();
     testDropNA();
 
     // 5) sort
     testSort();
+    testLazyQuery();
+    testQueryOptimizer();
+    testCsvQueryCollect();
 
     // 6) dropDuplicates
     testDropDuplicates();
@@ -47,11 +47,11 @@ static void testPivotAndMelt(void)
     seriesAddString(&quartS, "Q2");
     seriesAddInt(&salesS, 25);
 
-    bool ok = df.addSeries(&df, &yearS);
+    bool ok = df.ops->addSeries(&df, &yearS);
     assert(ok);
-    ok = df.addSeries(&df, &quartS);
+    ok = df.ops->addSeries(&df, &quartS);
     assert(ok);
-    ok = df.addSeries(&df, &salesS);
+    ok = df.ops->addSeries(&df, &salesS);
     assert(ok);
 
     seriesFree(&yearS);
@@ -59,20 +59,20 @@ static void testPivotAndMelt(void)
     seriesFree(&salesS);
 
     // pivot => indexCol=0(Year), columnsCol=1(Quarter), valuesCol=2(Sales)
-    DataFrame pivotDF = df.pivot(&df, 0, 1, 2);
+    DataFrame pivotDF = df.ops->pivot(&df, 0, 1, 2);
     // expected result => 
     //  index | Q1   | Q2
     //  2021   10     20
     //  2022   15     25
     // => 2 rows, 3 columns
-    assert(pivotDF.numRows(&pivotDF)==2);
-    assert(pivotDF.numColumns(&pivotDF)==3);
+    assert(pivotDF.ops->numRows(&pivotDF)==2);
+    assert(pivotDF.ops->numColumns(&pivotDF)==3);
     // row0 => index="2021", Q1="10", Q2="20"
     DataFrame_Destroy(&pivotDF);
 
     // melt => pick idCols => say col0=Year => so idCount=1 => we melt Quarter,Sales
     size_t idC[] = {0}; 
-    DataFrame meltDF = df.melt(&df, idC, 1);
+    DataFrame meltDF = df.ops->melt(&df, idC, 1);
     // We get columns => [Year, variable, value], 
     // and #rows => 4(original rows) * 2(= num non-id columns?), Actually "Quarter" & "Sales" => so each row is repeated for those 2 columns
     // but let's see how your code handles. 
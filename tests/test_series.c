@@ -4,8 +4,12 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "test_series.h"
+#include "dfalloc.h"
 
 /*
  * Helper: Compare two strings safely. 
@@ -106,8 +110,835 @@ static void testSeriesFunctions(void) {
 }
 
 
+/*
+ * Numeric Series keep their values in one contiguous, aligned buffer:
+ *   1) the raw pointer sees every appended value in order
+ *   2) the buffer survives many reallocations and stays aligned
+ *   3) in-place setters overwrite values; wrong type / range is rejected
+ */
+static void testSeriesContiguousBuffers(void) {
+    Series ints;
+    seriesInit(&ints, "Ints", DF_INT);
+    for (int i = 0; i < 10000; i++) {
+        seriesAddInt(&ints, i);
+    }
+    assert(seriesSize(&ints) == 10000);
+
+    const int* iv = seriesIntData(&ints);
+    assert(iv != NULL);
+    assert(((uintptr_t)iv % SERIES_ALIGNMENT) == 0);
+    for (int i = 0; i < 10000; i++) {
+        assert(iv[i] == i);
+    }
+    assert(seriesDoubleData(&ints) == NULL);
+
+    assert(seriesSetInt(&ints, 42, -1));
+    int v;
+    assert(seriesGetInt(&ints, 42, &v) && v == -1);
+    assert(!seriesSetInt(&ints, 10000, 5));
+    assert(!seriesSetDouble(&ints, 0, 1.0));
+    seriesFree(&ints);
+
+    Series dts;
+    seriesInit(&dts, "When", DF_DATETIME);
+    seriesAddDateTime(&dts, 1700000000000LL);
+    seriesAddDateTime(&dts, 1700000001000LL);
+    const long long* dv = seriesDateTimeData(&dts);
+    assert(dv && dv[0] == 1700000000000LL && dv[1] == 1700000001000LL);
+    assert(seriesSetDateTime(&dts, 1, 0));
+    long long out;
+    assert(seriesGetDateTime(&dts, 1, &out) && out == 0);
+    seriesFree(&dts);
+
+    Series dbls;
+    seriesInit(&dbls, "Dbls", DF_DOUBLE);
+    assert(seriesSize(&dbls) == 0);
+    for (int i = 0; i < 100; i++) {
+        seriesAddDouble(&dbls, i * 0.5);
+    }
+    const double* dd = seriesDoubleData(&dbls);
+    assert(((uintptr_t)dd % SERIES_ALIGNMENT) == 0);
+    assert(dd[99] == 49.5);
+    seriesFree(&dbls);
+
+    printf("testSeriesContiguousBuffers() passed.\n");
+}
+
+/*
+ * DF_STRING columns use one byte arena + offsets:
+ *   1) views borrow the stored bytes (NUL-terminated) and report lengths
+ *   2) empty strings are ordinary values with length 0
+ *   3) seriesSetString splices shorter / longer values without disturbing
+ *      the neighbours
+ */
+static void testSeriesStringArena(void) {
+    Series s;
+    seriesInit(&s, "Words", DF_STRING);
+    seriesAddString(&s, "alpha");
+    seriesAddString(&s, "");
+    seriesAddString(&s, "charlie");
+
+    const char* v = NULL;
+    size_t len = 0;
+    assert(seriesGetStringView(&s, 0, &v, &len) && len == 5 && strcmp(v, "alpha") == 0);
+    assert(seriesGetStringView(&s, 1, &v, &len) && len == 0 && v[0] == '\0');
+    assert(seriesGetStringView(&s, 2, &v, NULL) && strcmp(v, "charlie") == 0);
+    assert(!seriesGetStringView(&s, 3, &v, &len));
+
+    // views are borrowed: two reads of the same cell hit the same bytes
+    const char* again = NULL;
+    seriesGetStringView(&s, 2, &again, NULL);
+    assert(again == v);
+
+    assert(seriesSetString(&s, 0, "a"));
+    assert(seriesSetString(&s, 1, "a much longer replacement"));
+    const char* expected[] = {"a", "a much longer replacement", "charlie"};
+    for (size_t i = 0; i < 3; i++) {
+        char* got = NULL;
+        assert(seriesGetString(&s, i, &got));
+        assert(safeStrcmp(got, expected[i]) == 0);
+        free(got);
+    }
+
+    // grow the arena well past its initial capacity
+    for (int i = 0; i < 2000; i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "row-%d", i);
+        seriesAddString(&s, buf);
+    }
+    assert(seriesSize(&s) == 2003);
+    assert(seriesGetStringView(&s, 2002, &v, &len) && strcmp(v, "row-1999") == 0 && len == 8);
+
+    seriesFree(&s);
+    printf("testSeriesStringArena() passed.\n");
+}
+
+/*
+ * DF_CATEGORY columns store codes + a shared dictionary:
+ *   1) repeated labels map to the same code, reads return labels
+ *   2) codes widen past 256 / 65536 labels without losing values
+ *   3) copies share the dictionary; seriesToCategory converts DF_STRING
+ */
+static void testSeriesCategory(void) {
+    Series c;
+    seriesInit(&c, "Side", DF_CATEGORY);
+    seriesAddString(&c, "buy");
+    seriesAddString(&c, "sell");
+    seriesAddString(&c, "buy");
+    assert(seriesSize(&c) == 3);
+    assert(seriesCategoryCount(&c) == 2);
+
+    uint32_t c0, c1, c2;
+    assert(seriesGetCode(&c, 0, &c0) && seriesGetCode(&c, 1, &c1) && seriesGetCode(&c, 2, &c2));
+    assert(c0 == c2 && c0 != c1);
+
+    const char* v = NULL;
+    size_t len = 0;
+    assert(seriesGetStringView(&c, 1, &v, &len) && len == 4 && strcmp(v, "sell") == 0);
+    char* copy = NULL;
+    assert(seriesGetString(&c, 2, &copy) && strcmp(copy, "buy") == 0);
+    free(copy);
+
+    uint32_t found;
+    assert(seriesCategoryFind(&c, "sell", &found) && found == c1);
+    assert(!seriesCategoryFind(&c, "hold", &found));
+
+    // push past the uint8 and uint16 code ranges
+    for (int i = 0; i < 70000; i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "label-%d", i);
+        seriesAddString(&c, buf);
+    }
+    assert(c.codeWidth == 4);
+    assert(seriesCategoryCount(&c) == 70002);
+    assert(seriesGetStringView(&c, 0, &v, NULL) && strcmp(v, "buy") == 0);
+    assert(seriesGetStringView(&c, 3 + 300, &v, NULL) && strcmp(v, "label-300") == 0);
+    assert(seriesGetStringView(&c, 3 + 69999, &v, NULL) && strcmp(v, "label-69999") == 0);
+
+    // a copy shares the dictionary => codes are directly comparable
+    Series dup;
+    seriesCopy(&c, &dup);
+    assert(seriesSameDictionary(&c, &dup));
+    assert(seriesGetCode(&dup, 1, &found) && found == c1);
+    seriesFree(&c);
+    assert(seriesGetStringView(&dup, 1, &v, NULL) && strcmp(v, "sell") == 0);
+    seriesFree(&dup);
+
+    // DF_STRING -> DF_CATEGORY
+    Series str;
+    seriesInit(&str, "Venue", DF_STRING);
+    seriesAddString(&str, "NYSE");
+    seriesAddString(&str, "LSE");
+    seriesAddString(&str, "NYSE");
+    Series cat;
+    assert(seriesToCategory(&str, &cat));
+    assert(cat.type == DF_CATEGORY && seriesSize(&cat) == 3);
+    assert(seriesCategoryCount(&cat) == 2);
+    assert(seriesSetString(&cat, 1, "NYSE"));
+    assert(seriesGetStringView(&cat, 1, &v, NULL) && strcmp(v, "NYSE") == 0);
+    seriesFree(&cat);
+    seriesFree(&str);
+
+    printf("testSeriesCategory() passed.\n");
+}
+
+
+static void testSeriesValidity(void) {
+    Series s;
+    seriesInit(&s, "Qty", DF_INT);
+    seriesAddInt(&s, 0);
+    seriesAddNull(&s);
+    seriesAddInt(&s, 7);
+    assert(seriesSize(&s) == 3);
+    assert(seriesNullCount(&s) == 1);
+    assert(!seriesIsNull(&s, 0) && seriesIsNull(&s, 1) && !seriesIsNull(&s, 2));
+
+    // a real zero is a value, a null row cannot be read
+    int v = -1;
+    assert(seriesGetInt(&s, 0, &v) && v == 0);
+    assert(!seriesGetInt(&s, 1, &v));
+
+    // setting a value revives the row, seriesSetNull clears it again
+    assert(seriesSetInt(&s, 1, 5) && seriesNullCount(&s) == 0);
+    assert(seriesGetInt(&s, 1, &v) && v == 5);
+    assert(seriesSetNull(&s, 2) && seriesSetNull(&s, 2));
+    assert(seriesNullCount(&s) == 1);
+
+    // the bitmap grows with the buffer; new rows start out valid
+    for (int i = 0; i < 200; i++) {
+        if (i % 50 == 0) seriesAddNull(&s);
+        else seriesAddInt(&s, i);
+    }
+    assert(seriesSize(&s) == 203);
+    assert(seriesNullCount(&s) == 5);
+    assert(seriesIsNull(&s, 3) && seriesIsNull(&s, 153) && !seriesIsNull(&s, 202));
+
+    // copies keep their nulls
+    Series dup;
+    seriesCopy(&s, &dup);
+    assert(seriesNullCount(&dup) == 5 && seriesIsNull(&dup, 103));
+    seriesFree(&dup);
+
+    // seriesAppendFrom carries a null across
+    Series str, out;
+    seriesInit(&str, "Name", DF_STRING);
+    seriesInit(&out, "Name", DF_STRING);
+    seriesAddString(&str, "");
+    seriesAddNull(&str);
+    assert(seriesAppendFrom(&out, &str, 0) && seriesAppendFrom(&out, &str, 1));
+    assert(!seriesAppendFrom(&out, &s, 0));   // type mismatch
+    const char* view = NULL;
+    size_t len = 1;
+    assert(seriesGetStringView(&out, 0, &view, &len) && len == 0);
+    assert(!seriesGetStringView(&out, 1, &view, NULL));
+    assert(seriesNullCount(&out) == 1);
+    seriesFree(&out);
+    seriesFree(&str);
+
+    seriesFree(&s);
+    printf("testSeriesValidity() passed.\n");
+}
+
+
+static void testSeriesShare(void) {
+    Series a;
+    seriesInit(&a, "Px", DF_DOUBLE);
+    for (int i = 0; i < 10; i++) seriesAddDouble(&a, i * 0.5);
+    seriesSetNull(&a, 3);
+
+    Series b;
+    seriesShare(&a, &b);
+    assert(b.values == a.values && b.validity == a.validity);
+    assert(b.name != a.name && strcmp(b.name, "Px") == 0);
+    assert(seriesNullCount(&b) == 1 && seriesIsNull(&b, 3));
+
+    // writing to b detaches it; a keeps the old data
+    assert(seriesSetDouble(&b, 3, 42.0));
+    assert(b.values != a.values);
+    double d = 0.0;
+    assert(seriesGetDouble(&b, 3, &d) && d == 42.0);
+    assert(seriesIsNull(&a, 3) && seriesNullCount(&a) == 1);
+
+    // appending to a shared Series detaches it too
+    Series c;
+    seriesShare(&a, &c);
+    seriesAddDouble(&a, 9.0);
+    assert(seriesSize(&a) == 11 && seriesSize(&c) == 10);
+    assert(seriesGetDouble(&c, 9, &d) && d == 4.5);
+
+    // string arena: free the original first, the share keeps the bytes
+    Series s1, s2;
+    seriesInit(&s1, "Sym", DF_STRING);
+    seriesAddString(&s1, "AAPL");
+    seriesAddString(&s1, "MSFT");
+    seriesShare(&s1, &s2);
+    seriesFree(&s1);
+    const char* v = NULL;
+    assert(seriesGetStringView(&s2, 1, &v, NULL) && strcmp(v, "MSFT") == 0);
+    assert(seriesSetString(&s2, 0, "IBM"));
+    assert(seriesGetStringView(&s2, 0, &v, NULL) && strcmp(v, "IBM") == 0);
+    seriesFree(&s2);
+
+    seriesFree(&c);
+    seriesFree(&b);
+    seriesFree(&a);
+    printf("testSeriesShare() passed.\n");
+}
+
+/* Slices a const Series over and over; several of these run at once. */
+static void* shareWorker(void* arg) {
+    const Series* src = (const Series*)arg;
+    for (int i = 0; i < 2000; i++) {
+        Series view;
+        seriesSlice(src, (size_t)(i % 50), 10, &view);
+        const char* v = NULL;
+        assert(seriesGetStringView(&view, 0, &v, NULL) && v[0] == 'k');
+        seriesFree(&view);
+    }
+    return NULL;
+}
+
+static void testSeriesConcurrentShare(void) {
+    // sharing only touches atomic counts, so readers need no lock
+    Series c;
+    seriesInit(&c, "Key", DF_CATEGORY);
+    char label[16];
+    for (int i = 0; i < 64; i++) {
+        snprintf(label, sizeof(label), "k%d", i % 7);
+        seriesAddString(&c, label);
+    }
+    pthread_t threads[4];
+    for (int t = 0; t < 4; t++) {
+        assert(pthread_create(&threads[t], NULL, shareWorker, &c) == 0);
+    }
+    for (int t = 0; t < 4; t++) pthread_join(threads[t], NULL);
+
+    // every view is gone: c is the sole owner again and writes in place
+    const void* before = c.values;
+    assert(seriesSetString(&c, 0, "k3") && c.values == before);
+    const char* v = NULL;
+    assert(seriesGetStringView(&c, 0, &v, NULL) && strcmp(v, "k3") == 0);
+    seriesFree(&c);
+    printf("testSeriesConcurrentShare() passed.\n");
+}
+
+static void testSeriesSlice(void) {
+    // 200 ints, every 7th row null
+    Series a;
+    seriesInit(&a, "N", DF_INT);
+    for (int i = 0; i < 200; i++) {
+        if (i % 7 == 0) seriesAddNull(&a);
+        else seriesAddInt(&a, i);
+    }
+
+    // a view starting mid-word sees the right values and nulls
+    Series v;
+    seriesSlice(&a, 70, 100, &v);
+    assert(seriesSize(&v) == 100 && v.shared != NULL);
+    assert(seriesIntData(&v) == seriesIntData(&a) + 70);
+    int x = 0;
+    assert(seriesGetInt(&v, 1, &x) && x == 71);
+    assert(seriesIsNull(&v, 0) && seriesIsNull(&v, 7) && !seriesIsNull(&v, 8));
+    assert(seriesNullCount(&v) == 15);   // 70, 77, ..., 168
+    assert(!(seriesValidityWord(&v, 1) & (1ULL << (84 - 64))));   // row 154
+    assert(seriesValidityWord(&v, 1) >> 36 == (~0ULL >> 36));     // past the end
+
+    // a copy of a view is compact; writing to the view detaches it
+    Series c;
+    seriesCopy(&v, &c);
+    assert(seriesSize(&c) == 100 && seriesNullCount(&c) == 15 && seriesIsNull(&c, 98));
+    assert(seriesSetInt(&v, 0, -1));
+    assert(seriesIntData(&v) != seriesIntData(&a) + 70);
+    assert(seriesGetInt(&v, 0, &x) && x == -1 && seriesNullCount(&v) == 14);
+    assert(seriesIsNull(&a, 70));
+    seriesFree(&c);
+
+    // strings: the view outlives its parent, copies re-base the arena
+    Series str, tail;
+    seriesInit(&str, "S", DF_STRING);
+    seriesAddString(&str, "aa");
+    seriesAddString(&str, "bbb");
+    seriesAddString(&str, "c");
+    seriesSlice(&str, 1, 5, &tail);   // clamped to 2 rows
+    seriesFree(&str);
+    assert(seriesSize(&tail) == 2);
+    const char* sv = NULL;
+    size_t len = 0;
+    assert(seriesGetStringView(&tail, 0, &sv, &len) && len == 3 && strcmp(sv, "bbb") == 0);
+    Series compact;
+    seriesCopy(&tail, &compact);
+    assert(compact.bytesUsed == 6);   // "bbb\0c\0"
+    assert(seriesGetStringView(&compact, 1, &sv, NULL) && strcmp(sv, "c") == 0);
+    seriesAddString(&tail, "dd");
+    assert(seriesGetStringView(&tail, 2, &sv, NULL) && strcmp(sv, "dd") == 0);
+    assert(seriesGetStringView(&tail, 0, &sv, NULL) && strcmp(sv, "bbb") == 0);
+    seriesFree(&compact);
+    seriesFree(&tail);
+
+    seriesFree(&v);
+    seriesFree(&a);
+    printf("testSeriesSlice() passed.\n");
+}
+
+/* Counting allocator: live bytes must drop back to 0 once everything is freed,
+ * which also checks that every release reports the size it was allocated with. */
+typedef struct {
+    size_t allocs;
+    size_t releases;
+    long long liveBytes;
+} CountingCtx;
+
+static void* countingAllocate(void* ctx, size_t size, size_t alignment) {
+    CountingCtx* c = (CountingCtx*)ctx;
+    c->allocs++;
+    c->liveBytes += (long long)size;
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+    return aligned_alloc(alignment, rounded ? rounded : alignment);
+}
+
+static void countingRelease(void* ctx, void* ptr, size_t size) {
+    CountingCtx* c = (CountingCtx*)ctx;
+    c->releases++;
+    c->liveBytes -= (long long)size;
+    free(ptr);
+}
+
+static void testSeriesAllocator(void) {
+    CountingCtx ctx = {0, 0, 0};
+    DfAllocator counting = { countingAllocate, countingRelease, &ctx };
+    dfSetAllocator(&counting);
+    assert(dfGetAllocator()->ctx == &ctx);
+
+    Series a, s, cat, view, copy;
+    seriesInit(&a, "N", DF_INT);
+    for (int i = 0; i < 1000; i++) {
+        if (i % 10 == 0) seriesAddNull(&a);
+        else seriesAddInt(&a, i);
+    }
+    seriesInit(&s, "S", DF_STRING);
+    for (int i = 0; i < 300; i++) {
+        seriesAddString(&s, "some text");
+    }
+    seriesInit(&cat, "C", DF_CATEGORY);
+    for (int i = 0; i < 400; i++) {
+        char label[16];
+        snprintf(label, sizeof(label), "k%d", i);   // widens the codes past 8 bits
+        seriesAddString(&cat, label);
+    }
+    assert(ctx.allocs > 0 && ctx.liveBytes > 0);
+
+    // a view that detaches on write, then a copy of the original
+    seriesSlice(&a, 5, 500, &view);
+    assert(seriesSetInt(&view, 0, 1));
+    seriesCopy(&s, &copy);
+    seriesFree(&a);
+    seriesFree(&s);
+    seriesFree(&cat);
+    seriesFree(&view);
+    seriesFree(&copy);
+    assert(ctx.liveBytes == 0 && ctx.allocs == ctx.releases);
+
+    // arena blocks come from the same hook
+    DfArena arena;
+    dfArenaInit(&arena, 256);
+    int* nums = (int*)dfArenaCalloc(&arena, 10, sizeof(int));
+    assert(nums && nums[9] == 0);
+    char* big = (char*)dfArenaAlloc(&arena, 1000);   // oversized => own block
+    assert(big && ((uintptr_t)big % sizeof(max_align_t)) == 0);
+    char* str = dfArenaStrdup(&arena, "hello");
+    assert(str && strcmp(str, "hello") == 0);
+    assert(arena.used >= 1000 + 40 + 6);
+    dfArenaReset(&arena);
+    assert(arena.used == 0);
+    assert(dfArenaAlloc(&arena, 16) != NULL);
+    dfArenaFree(&arena);
+    assert(ctx.liveBytes == 0 && ctx.allocs == ctx.releases);
+
+    dfSetAllocator(NULL);
+    assert(dfGetAllocator()->ctx == NULL);
+    printf("testSeriesAllocator() passed.\n");
+}
+
+static void testSeriesNumericTypes(void) {
+    Series i8, u64, f;
+    seriesInit(&i8, "I8", DF_INT8);
+    seriesInit(&u64, "U64", DF_UINT64);
+    seriesInit(&f, "F", DF_FLOAT);
+    seriesAddInt8(&i8, -5);
+    seriesAddNull(&i8);
+    seriesAddInt8(&i8, 100);
+    seriesAddUInt64(&u64, UINT64_MAX);
+    seriesAddUInt64(&u64, 3);
+    seriesAddFloat(&f, 1.5f);
+    seriesAddInt(&i8, 1);   // wrong type => ignored
+    assert(seriesSize(&i8) == 3 && seriesNullCount(&i8) == 1);
+
+    // typed and widening reads
+    int8_t v8 = 0;
+    int vi = 0;
+    double vd = 0.0;
+    uint64_t vu = 0;
+    assert(seriesGetInt8(&i8, 2, &v8) && v8 == 100);
+    assert(!seriesGetInt8(&i8, 1, &v8));
+    assert(seriesGetInt(&i8, 0, &vi) && vi == -5);
+    assert(!seriesGetInt(&u64, 0, &vi));
+    assert(seriesGetDouble(&f, 0, &vd) && vd == 1.5);
+    assert(seriesGetUInt64(&u64, 0, &vu) && vu == UINT64_MAX);
+    assert(seriesInt8Data(&i8)[2] == 100 && seriesFloatData(&i8) == NULL);
+    assert(seriesValueSize(&i8) == 1 && seriesValueSize(&u64) == 8);
+
+    // compares in the column's own type (uint64 max stays the largest)
+    assert(seriesCompareRows(&u64, 0, 1) > 0);
+    assert(seriesCompareRows(&i8, 0, 2) < 0);
+
+    char buf[32];
+    assert(seriesFormatNumber(&u64, 0, buf, sizeof(buf)) && strcmp(buf, "18446744073709551615") == 0);
+    assert(!seriesFormatNumber(&i8, 1, buf, sizeof(buf)) && buf[0] == '\0');
+
+    // seriesAddNumber saturates; set/append/copy keep the type
+    seriesAddNumber(&i8, 1000.0);
+    assert(seriesGetInt8(&i8, 3, &v8) && v8 == INT8_MAX);
+
+    // the 64-bit types clamp to their exact limits, NaN => 0
+    Series i64, u64n, dt;
+    seriesInit(&i64, "I64", DF_INT64);
+    seriesInit(&u64n, "U64N", DF_UINT64);
+    seriesInit(&dt, "DT", DF_DATETIME);
+    const double wild[] = { 1e30, -1e30, NAN };
+    for (size_t k = 0; k < 3; k++) {
+        seriesAddNumber(&i64, wild[k]);
+        seriesAddNumber(&u64n, wild[k]);
+        seriesAddNumber(&dt, wild[k]);
+    }
+    int64_t v64 = 0;
+    long long vdt = 0;
+    assert(seriesGetInt64(&i64, 0, &v64) && v64 == INT64_MAX);
+    assert(seriesGetInt64(&i64, 1, &v64) && v64 == INT64_MIN);
+    assert(seriesGetInt64(&i64, 2, &v64) && v64 == 0);
+    assert(seriesGetUInt64(&u64n, 0, &vu) && vu == UINT64_MAX);
+    assert(seriesGetUInt64(&u64n, 1, &vu) && vu == 0);
+    assert(seriesGetUInt64(&u64n, 2, &vu) && vu == 0);
+    assert(seriesGetDateTime(&dt, 0, &vdt) && vdt == INT64_MAX);
+    assert(seriesGetDateTime(&dt, 1, &vdt) && vdt == INT64_MIN);
+    assert(seriesGetDateTime(&dt, 2, &vdt) && vdt == 0);
+    seriesFree(&i64);
+    seriesFree(&u64n);
+    seriesFree(&dt);
+    assert(seriesSetInt8(&i8, 1, 7) && seriesNullCount(&i8) == 0);
+    int8_t raw = -1;
+    assert(seriesSetValue(&i8, 0, &raw) && seriesGetInt8(&i8, 0, &v8) && v8 == -1);
+    Series copy;
+    seriesCopy(&i8, &copy);
+    assert(copy.type == DF_INT8 && seriesAppendFrom(&copy, &i8, 2));
+    assert(!seriesAppendFrom(&copy, &u64, 0));
+    assert(seriesSize(&copy) == 5 && seriesGetInt8(&copy, 4, &v8) && v8 == 100);
+
+    seriesFree(&copy);
+    seriesFree(&i8);
+    seriesFree(&u64);
+    seriesFree(&f);
+    printf("testSeriesNumericTypes() passed.\n");
+}
+
+static void testSeriesChunked(void) {
+    Series s;
+    seriesInitChunked(&s, "Ticks", DF_INT, 4);
+    assert(seriesIsChunked(&s) && seriesSize(&s) == 0);
+    for (int i = 0; i < 10; i++) {
+        if (i == 5) seriesAddNull(&s);
+        else seriesAddInt(&s, i * 10);
+    }
+    assert(seriesSize(&s) == 10 && seriesNullCount(&s) == 1);
+    assert(seriesChunkCount(&s) == 3);
+    assert(seriesSize(seriesChunk(&s, 2)) == 2);
+
+    // getters / setters work across chunk boundaries
+    int v = 0;
+    assert(seriesGetInt(&s, 4, &v) && v == 40);
+    assert(!seriesGetInt(&s, 5, &v) && seriesIsNull(&s, 5));
+    assert(seriesGetInt(&s, 9, &v) && v == 90);
+    assert(seriesSetInt(&s, 5, 55) && seriesNullCount(&s) == 0);
+    assert(seriesSetNull(&s, 8) && seriesNullCount(&s) == 1);
+    assert(seriesValidityWord(&s, 0) == (~0ULL & ~(1ULL << 8)));
+    assert(seriesCompareRows(&s, 1, 9) < 0);
+
+    // raw buffers are per chunk
+    assert(seriesIntData(&s) == NULL);
+    assert(seriesIntData(seriesChunk(&s, 1))[0] == 40);
+
+    // a slice spanning chunks, then a shared copy that diverges on write
+    Series view, other;
+    seriesSlice(&s, 3, 5, &view);
+    assert(seriesIsChunked(&view) && seriesSize(&view) == 5);
+    assert(seriesGetInt(&view, 0, &v) && v == 30);
+    assert(seriesGetInt(&view, 2, &v) && v == 55);
+    assert(seriesNullCount(&view) == 0 && seriesGetInt(&view, 4, &v) && v == 70);
+    seriesShare(&s, &other);
+    seriesAddInt(&other, 100);
+    assert(seriesSize(&other) == 11 && seriesSize(&s) == 10);
+    assert(seriesSetInt(&other, 0, -1));
+    assert(seriesGetInt(&s, 0, &v) && v == 0);
+
+    // big chunks are linked without copying, small ones copied into the tail
+    Series big, small;
+    seriesInit(&big, "Ticks", DF_INT);
+    seriesInit(&small, "Ticks", DF_INT);
+    for (int i = 0; i < 4; i++) seriesAddInt(&big, 1000 + i);
+    seriesAddInt(&small, 7);
+    size_t before = seriesChunkCount(&s);
+    assert(seriesAppendChunks(&s, &big));
+    assert(seriesChunkCount(&s) == before + 1);
+    assert(seriesIntData(seriesChunk(&s, before)) == seriesIntData(&big));
+    assert(seriesAppendChunks(&s, &small));
+    assert(seriesSize(&s) == 15 && seriesGetInt(&s, 14, &v) && v == 7);
+    assert(seriesGetInt(&s, 13, &v) && v == 1003);
+    assert(seriesGetInt(&big, 3, &v) && v == 1003);   // untouched by the append
+
+    // strings and categories
+    Series str, cat;
+    seriesInitChunked(&str, "Sym", DF_STRING, 2);
+    seriesInitChunked(&cat, "Venue", DF_CATEGORY, 2);
+    const char* syms[] = { "AAPL", "MSFT", "IBM", "AAPL", "GOOG" };
+    for (int i = 0; i < 5; i++) {
+        seriesAddString(&str, syms[i]);
+        seriesAddString(&cat, syms[i]);
+    }
+    const char* view0 = NULL;
+    assert(seriesGetStringView(&str, 4, &view0, NULL) && strcmp(view0, "GOOG") == 0);
+    assert(seriesSetString(&str, 2, "ORCL"));
+    assert(seriesGetStringView(&str, 2, &view0, NULL) && strcmp(view0, "ORCL") == 0);
+    uint32_t c0 = 0, c3 = 0;
+    assert(seriesGetCode(&cat, 0, &c0) && seriesGetCode(&cat, 3, &c3) && c0 == c3);
+    assert(seriesCategoryCount(&cat) == 4);
+    Series catCopy;
+    seriesCopy(&cat, &catCopy);
+    assert(seriesChunkCount(&catCopy) == 3 && seriesSameDictionary(&cat, &catCopy));
+
+    seriesFree(&catCopy);
+    seriesFree(&cat);
+    seriesFree(&str);
+    seriesFree(&small);
+    seriesFree(&big);
+    seriesFree(&other);
+    seriesFree(&view);
+    seriesFree(&s);
+    printf("testSeriesChunked() passed.\n");
+}
+
+static void testSeriesBulkAppend(void) {
+    Series a;
+    seriesInit(&a, "Qty", DF_INT);
+    assert(seriesReserve(&a, 1000));
+    const int* before = seriesIntData(&a);
+    int batch[500];
+    for (int i = 0; i < 500; i++) batch[i] = i;
+    assert(seriesAppendInts(&a, batch, 500));
+    assert(seriesAppendInts(&a, batch, 500));
+    assert(seriesIntData(&a) == before);   // reserved => no reallocation
+    int v = 0;
+    assert(seriesSize(&a) == 1000 && seriesGetInt(&a, 999, &v) && v == 499);
+    assert(!seriesAppendDoubles(&a, NULL, 1));   // wrong type
+
+    // after a null the appended rows are still valid
+    seriesAddNull(&a);
+    assert(seriesAppendInts(&a, batch, 3) && seriesNullCount(&a) == 1);
+    assert(seriesGetInt(&a, 1003, &v) && v == 2);
+
+    // a chunked column splits the batch over chunks
+    Series t, u;
+    seriesInitChunked(&t, "Ts", DF_DATETIME, 64);
+    seriesInitChunked(&u, "Venue", DF_UINT16, 0);
+    long long ts[150];
+    uint16_t venues[150];
+    for (int i = 0; i < 150; i++) {
+        ts[i] = 1700000000000LL + i;
+        venues[i] = (uint16_t)(i * 400);
+    }
+    assert(seriesAppendDateTimes(&t, ts, 100) && seriesAppendDateTimes(&t, ts + 100, 50));
+    assert(seriesSize(&t) == 150 && seriesChunkCount(&t) == 3);
+    long long dt = 0;
+    assert(seriesGetDateTime(&t, 64, &dt) && dt == 1700000000064LL);
+    assert(seriesGetDateTime(&t, 149, &dt) && dt == 1700000000149LL);
+    assert(seriesAppendValues(&u, venues, 150));
+    uint16_t venue = 0;
+    assert(seriesGetUInt16(&u, 149, &venue) && venue == (uint16_t)(149 * 400));
+
+    Series str;
+    seriesInit(&str, "Sym", DF_STRING);
+    const char* syms[] = { "AAPL", NULL, "MSFT" };
+    assert(seriesAppendStrings(&str, syms, 3));
+    assert(seriesSize(&str) == 3 && seriesIsNull(&str, 1));
+
+    seriesFree(&str);
+    seriesFree(&u);
+    seriesFree(&t);
+    seriesFree(&a);
+    printf("testSeriesBulkAppend() passed.\n");
+}
+
+static void testSeriesKernels(void) {
+    assert(seriesKernels(DF_STRING) == NULL && seriesKernels(DF_CATEGORY) == NULL);
+    const SeriesKernels* k = seriesKernels(DF_DOUBLE);
+    assert(k && k->type == DF_DOUBLE && k->width == sizeof(double));
+
+    double src[5] = { 4.0, -1.5, 0.0, 9.0, 2.5 };
+    size_t idx[3] = { 3, 0, 3 };
+    double out[5] = { 0 };
+    k->gather(src, idx, 3, out);
+    assert(out[0] == 9.0 && out[1] == 4.0 && out[2] == 9.0);
+
+    size_t perm[5] = { 4, 2, 0, 1, 3 };
+    k->scatter(src, perm, 5, out);
+    assert(out[4] == 4.0 && out[0] == 0.0 && out[3] == 2.5);
+
+    double negZero = -0.0;
+    assert(k->compare(src, 0, src, 1) > 0 && k->compare(src, 1, src, 0) < 0);
+    assert(k->equal(src, 2, &negZero, 0) && k->hash(src, 2) == k->hash(&negZero, 0));
+
+    int ints[4] = { 7, 7, 8, -7 };
+    const SeriesKernels* ki = seriesKernels(DF_INT);
+    assert(ki->hash(ints, 0) == ki->hash(ints, 1) && ki->hash(ints, 0) != ki->hash(ints, 3));
+    int copied[4];
+    ki->copy(ints, 4, copied);
+    assert(copied[3] == -7);
+
+    // bulk row append: gathered, contiguous, nulls carried over
+    Series a, b;
+    seriesInit(&a, "Px", DF_INT16);
+    for (int i = 0; i < 10; i++) seriesAddInt16(&a, (int16_t)(i * 10));
+    seriesSetNull(&a, 4);
+    seriesInit(&b, "Px", DF_INT16);
+    size_t rows[4] = { 9, 4, 0, 4 };
+    assert(seriesAppendRows(&b, &a, rows, 4));
+    size_t run[3] = { 5, 6, 7 };
+    assert(seriesAppendRows(&b, &a, run, 3));
+    int16_t v = 0;
+    assert(seriesSize(&b) == 7 && seriesNullCount(&b) == 2);
+    assert(seriesGetInt16(&b, 0, &v) && v == 90 && seriesIsNull(&b, 3));
+    assert(seriesGetInt16(&b, 6, &v) && v == 70);
+
+    size_t bad[2] = { 1, 10 };
+    assert(!seriesAppendRows(&b, &a, bad, 2) && seriesSize(&b) == 7);
+    Series wrong;
+    seriesInit(&wrong, "Px", DF_INT);
+    assert(!seriesAppendRows(&wrong, &a, rows, 1));
+
+    seriesFree(&wrong);
+    seriesFree(&b);
+    seriesFree(&a);
+    printf("testSeriesKernels() passed.\n");
+}
+
+static void testSeriesGather(void) {
+    Series a, g;
+    seriesInit(&a, "Qty", DF_INT64);
+    for (int64_t i = 0; i < 100; i++) seriesAddInt64(&a, i * 3);
+    seriesSetNull(&a, 50);
+    size_t idx[40];
+    for (size_t i = 0; i < 40; i++) idx[i] = (i * 31 + 50) % 100;   // scattered, starts at the null
+    assert(seriesGather(&a, idx, 40, &g));
+    int64_t v = 0;
+    assert(seriesSize(&g) == 40 && seriesNullCount(&g) == 1 && seriesIsNull(&g, 0));
+    assert(seriesGetInt64(&g, 1, &v) && v == 243 && strcmp(g.name, "Qty") == 0);
+    seriesFree(&g);
+
+    // row views gather relative to the view
+    Series view;
+    seriesSlice(&a, 20, 10, &view);
+    size_t few[3] = { 9, 0, 9 };
+    assert(seriesGather(&view, few, 3, &g));
+    assert(seriesGetInt64(&g, 0, &v) && v == 87 && seriesGetInt64(&g, 1, &v) && v == 60);
+    seriesFree(&g);
+    seriesFree(&view);
+
+    // strings: bytes land in one arena, sized up front
+    Series s;
+    seriesInit(&s, "Sym", DF_STRING);
+    seriesAddString(&s, "AAPL");
+    seriesAddNull(&s);
+    seriesAddString(&s, "MSFT");
+    seriesAddString(&s, "");
+    size_t sidx[5] = { 2, 1, 0, 3, 2 };
+    assert(seriesGather(&s, sidx, 5, &g));
+    const char* str = NULL;
+    size_t len = 0;
+    assert(seriesSize(&g) == 5 && seriesIsNull(&g, 1) && !seriesIsNull(&g, 3));
+    assert(seriesGetStringView(&g, 4, &str, &len) && len == 4 && strcmp(str, "MSFT") == 0);
+    assert(seriesGetStringView(&g, 2, &str, &len) && strcmp(str, "AAPL") == 0);
+    assert(g.bytesUsed == 5 + 1 + 5 + 1 + 5);
+    seriesFree(&g);
+
+    // categories share the dictionary
+    Series c;
+    seriesInit(&c, "Side", DF_CATEGORY);
+    seriesAddString(&c, "buy");
+    seriesAddString(&c, "sell");
+    size_t cidx[3] = { 1, 1, 0 };
+    assert(seriesGather(&c, cidx, 3, &g));
+    assert(g.dict == c.dict && seriesCategoryCount(&g) == 2);
+    assert(seriesGetStringView(&g, 1, &str, &len) && strcmp(str, "sell") == 0);
+    seriesFree(&g);
+
+    size_t bad[2] = { 0, 4 };
+    assert(!seriesGather(&s, bad, 2, &g) && seriesSize(&g) == 0);
+    seriesFree(&g);
+
+    seriesFree(&c);
+    seriesFree(&s);
+    seriesFree(&a);
+    printf("testSeriesGather() passed.\n");
+}
+
+static void testSeriesMemoryUsage(void) {
+    Series a;
+    seriesInit(&a, "Qty", DF_INT64);
+    for (int64_t i = 0; i < 100; i++) seriesAddInt64(&a, i);
+
+    SeriesMemory shallow, deep;
+    seriesMemoryUsage(&a, false, &shallow);
+    seriesMemoryUsage(&a, true, &deep);
+    assert(shallow.data == 100 * sizeof(int64_t));
+    assert(shallow.strings == 0 && shallow.validity == 0);
+    assert(deep.data >= shallow.data);   // spare capacity is counted too
+
+    // a 10-row view only holds 10 rows, but keeps the whole buffer alive
+    Series view;
+    seriesSlice(&a, 20, 10, &view);
+    seriesMemoryUsage(&view, false, &shallow);
+    assert(shallow.data == 10 * sizeof(int64_t));
+    seriesMemoryUsage(&view, true, &deep);
+    assert(deep.data >= 100 * sizeof(int64_t));
+
+    Series str;
+    seriesInit(&str, "Sym", DF_STRING);
+    seriesAddString(&str, "AAPL");
+    seriesAddString(&str, "MSFT");
+    seriesAddNull(&str);
+    seriesMemoryUsage(&str, false, &shallow);
+    assert(shallow.strings == 11 && shallow.validity == sizeof(uint64_t));   // NULs included
+
+    seriesFree(&str);
+    seriesFree(&view);
+    seriesFree(&a);
+    printf("testSeriesMemoryUsage() passed.\n");
+}
+
 void testSeries(void) {
     printf("Running Series tests...\n");
     testSeriesFunctions();
+    testSeriesContiguousBuffers();
+    testSeriesStringArena();
+    testSeriesCategory();
+    testSeriesValidity();
+    testSeriesShare();
+    testSeriesConcurrentShare();
+    testSeriesSlice();
+    testSeriesAllocator();
+    testSeriesNumericTypes();
+    testSeriesChunked();
+    testSeriesBulkAppend();
+    testSeriesKernels();
+    testSeriesGather();
+    testSeriesMemoryUsage();
     printf("All Series tests passed successfully!\n");
 }